@@ -0,0 +1,33 @@
+'use strict';
+const common = require('../common.js');
+
+// Reports the throughput of base64 encoding and decoding in GB/s of binary
+// data, for the standard and the URL-safe alphabet.
+const bench = common.createBenchmark(main, {
+  op: ['encode', 'decode'],
+  encoding: ['base64', 'base64url'],
+  size: [64, 1024, 64 * 1024, 8 << 20],
+  n: [256 << 20]
+}, {
+  test: { size: 1024, n: 1024 }
+});
+
+function main({ op, encoding, size, n }) {
+  const iterations = Math.max(1, Math.floor(n / size));
+  const buf = Buffer.allocUnsafe(size);
+  for (let i = 0; i < size; i++)
+    buf[i] = (i * 131) & 0xff;
+  const str = buf.toString(encoding);
+
+  if (op === 'encode') {
+    bench.start();
+    for (let i = 0; i < iterations; i++)
+      buf.toString(encoding);
+    bench.end(iterations * size / 1e9);
+  } else {
+    bench.start();
+    for (let i = 0; i < iterations; i++)
+      Buffer.from(str, encoding);
+    bench.end(iterations * size / 1e9);
+  }
+}
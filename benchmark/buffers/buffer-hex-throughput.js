@@ -0,0 +1,32 @@
+'use strict';
+const common = require('../common.js');
+
+// Reports the throughput of hex encoding and decoding in GB/s of binary data.
+// crypto's digest('hex') shares the encoding path with Buffer#toString().
+const bench = common.createBenchmark(main, {
+  op: ['encode', 'decode'],
+  size: [1024, 64 * 1024, 1 << 20, 16 << 20],
+  n: [256 << 20]
+}, {
+  test: { size: 1024, n: 1024 }
+});
+
+function main({ op, size, n }) {
+  const iterations = Math.max(1, Math.floor(n / size));
+  const buf = Buffer.allocUnsafe(size);
+  for (let i = 0; i < size; i++)
+    buf[i] = (i * 131) & 0xff;
+  const str = buf.toString('hex');
+
+  if (op === 'encode') {
+    bench.start();
+    for (let i = 0; i < iterations; i++)
+      buf.toString('hex');
+    bench.end(iterations * size / 1e9);
+  } else {
+    bench.start();
+    for (let i = 0; i < iterations; i++)
+      Buffer.from(str, 'hex');
+    bench.end(iterations * size / 1e9);
+  }
+}
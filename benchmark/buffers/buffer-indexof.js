@@ -20,7 +20,7 @@ const searchStrings = [
 const bench = common.createBenchmark(main, {
   search: searchStrings,
   encoding: ['utf8', 'ucs2'],
-  type: ['buffer', 'string'],
+  type: ['buffer', 'string', 'any'],
   n: [5e4]
 });
 
@@ -41,6 +41,17 @@ function main({ n, search, encoding, type }) {
     search = Buffer.from(Buffer.from(search).toString(), encoding);
   }
 
+  if (type === 'any') {
+    // The search string along with delimiters that do not occur in the text.
+    const values = [search, '\r\n\r\n', '\0', 'zyzzyva'];
+    bench.start();
+    for (let i = 0; i < n; i++) {
+      aliceBuffer.indexOfAny(values, 0, encoding);
+    }
+    bench.end(n);
+    return;
+  }
+
   bench.start();
   for (let i = 0; i < n; i++) {
     aliceBuffer.indexOf(search, 0, encoding);
@@ -0,0 +1,57 @@
+'use strict';
+const common = require('../common.js');
+const { isUtf8 } = require('buffer');
+
+// Reports the throughput of UTF-8 decoding and validation in GB/s, for text
+// that is pure ASCII (like most JSON), mostly ASCII, or mostly non-ASCII.
+const bench = common.createBenchmark(main, {
+  op: ['toString', 'TextDecoder', 'isUtf8', 'fromString'],
+  text: ['ascii', 'mixed', 'cjk'],
+  size: [1024, 64 * 1024, 8 << 20],
+  n: [256 << 20]
+}, {
+  test: { size: 1024, n: 1024 }
+});
+
+const samples = {
+  ascii: '{"id":12345,"name":"example","tags":["a","b"],"ok":true},',
+  mixed: '{"name":"Zoë","city":"Köln","price":"12 €","emoji":"👍"},',
+  cjk: '日本語のテキストと中文文本以及한국어 텍스트,'
+};
+
+function main({ op, text, size, n }) {
+  const sample = samples[text];
+  const str = sample.repeat(Math.ceil(size / Buffer.byteLength(sample)));
+  const buf = Buffer.from(str);
+  const iterations = Math.max(1, Math.floor(n / buf.length));
+
+  switch (op) {
+    case 'toString':
+      bench.start();
+      for (let i = 0; i < iterations; i++)
+        buf.toString('utf8');
+      break;
+    case 'TextDecoder': {
+      const decoder = new TextDecoder();
+      bench.start();
+      for (let i = 0; i < iterations; i++)
+        decoder.decode(buf);
+      break;
+    }
+    case 'isUtf8':
+      bench.start();
+      for (let i = 0; i < iterations; i++)
+        isUtf8(buf);
+      break;
+    case 'fromString': {
+      // Large strings are external after decoding, which is the common case
+      // when a decoded body is encoded again.
+      const decoded = buf.toString('utf8');
+      bench.start();
+      for (let i = 0; i < iterations; i++)
+        Buffer.from(decoded, 'utf8');
+      break;
+    }
+  }
+  bench.end(iterations * buf.length / 1e9);
+}
@@ -0,0 +1,60 @@
+'use strict';
+
+const common = require('../common.js');
+const {
+  createHash,
+  hashBatch,
+  webcrypto: {
+    subtle,
+  }
+} = require('crypto');
+
+const bench = common.createBenchmark(main, {
+  api: ['createHash', 'subtle', 'hashBatch'],
+  len: [16, 64, 1024],
+  algo: ['sha256'],
+  n: [1e4],
+});
+
+const kMethods = {
+  'sha1': 'SHA-1',
+  'sha256': 'SHA-256',
+  'sha512': 'SHA-512'
+};
+
+function measureLegacy(inputs, algo) {
+  bench.start();
+  for (let i = 0; i < inputs.length; ++i) {
+    createHash(algo).update(inputs[i]).digest();
+  }
+  bench.end(inputs.length);
+}
+
+function measureSubtle(inputs, algo) {
+  const jobs = new Array(inputs.length);
+  bench.start();
+  for (let i = 0; i < inputs.length; i++)
+    jobs[i] = subtle.digest(kMethods[algo], inputs[i]);
+  Promise.all(jobs).then(() => bench.end(inputs.length)).catch((err) => {
+    process.nextTick(() => { throw err; });
+  });
+}
+
+function measureBatch(inputs, algo) {
+  bench.start();
+  hashBatch(algo, inputs, (err) => {
+    if (err) throw err;
+    bench.end(inputs.length);
+  });
+}
+
+function main({ n, api, len, algo }) {
+  const inputs = [];
+  for (let i = 0; i < n; i++)
+    inputs.push(Buffer.alloc(len, i & 0xff));
+  switch (api) {
+    case 'createHash': return measureLegacy(inputs, algo);
+    case 'subtle': return measureSubtle(inputs, algo);
+    case 'hashBatch': return measureBatch(inputs, algo);
+  }
+}
@@ -0,0 +1,64 @@
+// Test UDP send/recv throughput of socket.sendMany() compared to send()
+'use strict';
+
+const common = require('../common.js');
+const dgram = require('dgram');
+const PORT = common.PORT;
+
+// `num` is the number of datagrams to send each time.
+const bench = common.createBenchmark(main, {
+  len: [64, 256, 1024],
+  num: [100],
+  method: ['send', 'sendMany'],
+  type: ['send', 'recv'],
+  dur: [5]
+});
+
+function main({ dur, len, num, method, type }) {
+  const chunk = Buffer.allocUnsafe(len);
+  const chunks = new Array(num).fill(chunk);
+  let sent = 0;
+  let received = 0;
+  const socket = dgram.createSocket('udp4');
+
+  function onsend() {
+    if (sent++ % num === 0) {
+      // The setImmediate() is necessary to have event loop progress on OSes
+      // that only perform synchronous I/O on nonblocking UDP sockets.
+      setImmediate(() => {
+        for (let i = 0; i < num; i++) {
+          socket.send(chunk, PORT, '127.0.0.1', onsend);
+        }
+      });
+    }
+  }
+
+  function onsendmany() {
+    sent += num;
+    setImmediate(() => {
+      socket.sendMany(chunks, PORT, '127.0.0.1', onsendmany);
+    });
+  }
+
+  socket.on('listening', () => {
+    bench.start();
+    if (method === 'send') {
+      onsend();
+    } else {
+      socket.sendMany(chunks, PORT, '127.0.0.1', onsendmany);
+    }
+
+    setTimeout(() => {
+      const bytes = (type === 'send' ? sent : received) * chunk.length;
+      const gbits = (bytes * 8) / (1024 * 1024 * 1024);
+      bench.end(gbits);
+      process.exit(0);
+    }, dur * 1000);
+  });
+
+  socket.on('message', () => {
+    received++;
+  });
+
+  socket.bind(PORT);
+}
@@ -0,0 +1,83 @@
+// Keep `concurrent` asynchronous fs requests in flight at all times and
+// measure either the throughput or the 99th percentile latency.
+//
+// Compare the threadpool against the io_uring backend with:
+//   NODE_BENCHMARK_FLAGS=--experimental-fs-io-uring node benchmark/run.js fs
+// The p99 metric is reported as its reciprocal (operations per second at
+// that latency), so that higher is better for both metrics.
+'use strict';
+
+const path = require('path');
+const common = require('../common.js');
+const fs = require('fs');
+const { createHistogram } = require('perf_hooks');
+
+const tmpdir = require('../../test/common/tmpdir');
+tmpdir.refresh();
+const filename = path.resolve(tmpdir.path,
+                              `.removeme-benchmark-garbage-${process.pid}`);
+
+const bench = common.createBenchmark(main, {
+  op: ['stat', 'read', 'write'],
+  concurrent: [1, 64, 512],
+  size: [4096],
+  metric: ['throughput', 'p99'],
+  n: [1e5],
+});
+
+function main({ op, concurrent, size, metric, n }) {
+  const blocks = 64;
+  fs.writeFileSync(filename, Buffer.alloc(size * blocks, 'x'));
+  const fd = fs.openSync(filename, 'r+');
+  const buffers = [];
+  for (let i = 0; i < concurrent; i++)
+    buffers.push(Buffer.alloc(size, 'y'));
+
+  const histogram = createHistogram();
+  let issued = 0;
+  let completed = 0;
+
+  function issue(slot) {
+    const start = process.hrtime.bigint();
+    const position = (issued++ % blocks) * size;
+    const done = (err) => {
+      if (err) throw err;
+      histogram.record(process.hrtime.bigint() - start);
+      if (++completed === n) {
+        finish();
+      } else if (issued < n) {
+        issue(slot);
+      }
+    };
+
+    switch (op) {
+      case 'stat':
+        fs.stat(filename, done);
+        break;
+      case 'read':
+        fs.read(fd, buffers[slot], 0, size, position, done);
+        break;
+      case 'write':
+        fs.write(fd, buffers[slot], 0, size, position, done);
+        break;
+      default:
+        throw new Error(`Unsupported op ${op}`);
+    }
+  }
+
+  function finish() {
+    if (metric === 'p99') {
+      bench.report(1e9 / histogram.percentile(99), process.hrtime(startTime));
+    } else {
+      bench.end(n);
+    }
+    fs.closeSync(fd);
+    fs.unlinkSync(filename);
+  }
+
+  const startTime = process.hrtime();
+  if (metric !== 'p99')
+    bench.start();
+  for (let i = 0; i < concurrent && issued < n; i++)
+    issue(i);
+}
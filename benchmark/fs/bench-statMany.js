@@ -0,0 +1,51 @@
+// Compare stat()ing a list of files one by one against a single batched
+// statMany() call on the internal fs binding.
+'use strict';
+
+const common = require('../common');
+const fs = require('fs');
+const path = require('path');
+const { internalBinding } = require('internal/test/binding');
+const binding = internalBinding('fs');
+
+const bench = common.createBenchmark(main, {
+  n: [1e3],
+  files: [10, 100, 1000],
+  method: ['stat', 'statMany'],
+}, { flags: ['--expose-internals'] });
+
+function main({ n, files, method }) {
+  const all = fs.readdirSync(path.join(__dirname, '..', '..', 'lib'))
+    .map((name) => path.join(__dirname, '..', '..', 'lib', name));
+  const paths = [];
+  for (let i = 0; i < files; i++)
+    paths.push(all[i % all.length]);
+
+  let remaining = n;
+  function next() {
+    if (remaining-- === 0)
+      return bench.end(n);
+
+    if (method === 'statMany') {
+      const req = new binding.FSReqCallback(false);
+      req.oncomplete = (err) => {
+        if (err) throw err;
+        next();
+      };
+      binding.statMany(paths, false, true, req);
+      return;
+    }
+
+    let pending = paths.length;
+    for (const p of paths) {
+      fs.stat(p, (err) => {
+        if (err) throw err;
+        if (--pending === 0)
+          next();
+      });
+    }
+  }
+
+  bench.start();
+  next();
+}
@@ -0,0 +1,59 @@
+// Parses requests with either well-known or custom header names and keeps
+// the resulting header arrays alive. With metric=heap, the reported value is
+// the number of heap bytes retained per request (lower is better), which
+// shows how many strings are allocated for the header names.
+'use strict';
+
+const common = require('../common');
+
+const bench = common.createBenchmark(main, {
+  names: ['known', 'custom'],
+  metric: ['rate', 'heap'],
+  n: [1e4]
+}, {
+  flags: ['--expose-internals', '--expose-gc', '--no-warnings']
+});
+
+const knownHeaders = [
+  'Host', 'User-Agent', 'Accept', 'Accept-Language', 'Accept-Encoding',
+  'Referer', 'Connection', 'Cookie', 'Cache-Control', 'If-None-Match',
+  'content-type', 'content-length',
+];
+
+function main({ names, metric, n }) {
+  const { HTTPParser } = common.binding('http_parser');
+  const REQUEST = HTTPParser.REQUEST;
+  const kOnHeadersComplete = HTTPParser.kOnHeadersComplete | 0;
+  const CRLF = '\r\n';
+
+  let request = `GET / HTTP/1.1${CRLF}`;
+  knownHeaders.forEach((name, i) => {
+    request += `${names === 'known' ? name : `X-Custom-${i}`}: v${i}${CRLF}`;
+  });
+  request = Buffer.from(request + CRLF);
+
+  const retained = new Array(n);
+  let count = 0;
+  const parser = new HTTPParser();
+  parser.initialize(REQUEST, {});
+  parser[kOnHeadersComplete] = (major, minor, headers) => {
+    retained[count++] = headers;
+  };
+
+  global.gc();
+  const before = process.memoryUsage().heapUsed;
+  const start = process.hrtime();
+  bench.start();
+  for (let i = 0; i < n; i++) {
+    parser.execute(request, 0, request.length);
+    parser.initialize(REQUEST, {});
+  }
+  if (metric === 'rate')
+    return bench.end(n);
+
+  global.gc();
+  const after = process.memoryUsage().heapUsed;
+  if (count !== n)
+    throw new Error(`Parsed ${count} requests, expected ${n}`);
+  bench.report((after - before) / n, process.hrtime(start));
+}
@@ -3,13 +3,14 @@
 const common = require('../common');
 
 const bench = common.createBenchmark(main, {
-  len: [4, 8, 16, 32],
+  len: [4, 8, 16, 32, 64],
+  frags: [1, 4],
   n: [1e5]
 }, {
   flags: ['--expose-internals', '--no-warnings']
 });
 
-function main({ len, n }) {
+function main({ len, frags, n }) {
   const { HTTPParser } = common.binding('http_parser');
   const REQUEST = HTTPParser.REQUEST;
   const kOnHeaders = HTTPParser.kOnHeaders | 0;
@@ -21,9 +22,17 @@ function main({ len, n }) {
   function processHeader(header, n) {
     const parser = newParser(REQUEST);
 
+    // Split the header into `frags` pieces, as if it had been received
+    // through several reads.
+    const pieces = [];
+    const pieceSize = Math.ceil(header.length / frags);
+    for (let i = 0; i < header.length; i += pieceSize)
+      pieces.push(header.slice(i, i + pieceSize));
+
     bench.start();
     for (let i = 0; i < n; i++) {
-      parser.execute(header, 0, header.length);
+      for (const piece of pieces)
+        parser.execute(piece, 0, piece.length);
       parser.initialize(REQUEST, {});
     }
     bench.end(n);
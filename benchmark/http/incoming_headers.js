@@ -6,12 +6,13 @@ const bench = common.createBenchmark(main, {
   connections: [50], // Concurrent connections
   headers: [20], // Number of header lines to append after the common headers
   w: [0, 6], // Amount of trailing whitespace
+  lazy: [0, 1], // Whether to use the `lazyHeaders` server option
   duration: 5
 });
 
-function main({ connections, headers, w, duration }) {
-  const server = http.createServer((req, res) => {
-    res.end();
+function main({ connections, headers, w, lazy, duration }) {
+  const server = http.createServer({ lazyHeaders: lazy === 1 }, (req, res) => {
+    res.end(req.getHeader('accept'));
   });
 
   server.listen(common.PORT, () => {
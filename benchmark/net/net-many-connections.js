@@ -0,0 +1,64 @@
+// Many connections exchanging small messages. This is dominated by the
+// per-read costs of allocating memory for incoming data, so it is also
+// useful for comparing memory usage and GC activity, e.g. through
+// NODE_BENCHMARK_FLAGS=--trace-gc.
+'use strict';
+
+const common = require('../common.js');
+const net = require('net');
+
+const bench = common.createBenchmark(main, {
+  conns: [100, 1000],
+  len: [64, 1024],
+  dur: [5],
+}, {
+  test: { conns: 10, dur: 0.1 }
+});
+
+function main({ conns, len, dur }) {
+  const message = Buffer.alloc(len, 'x');
+  let received = 0;
+  let running = true;
+
+  const server = net.createServer((socket) => {
+    // Echo everything back to the client.
+    socket.on('data', (chunk) => {
+      if (running)
+        socket.write(chunk);
+    });
+    socket.on('error', () => {});
+  });
+
+  server.listen(0, () => {
+    const { port } = server.address();
+    const clients = [];
+    let connected = 0;
+    for (let i = 0; i < conns; i++) {
+      const client = net.connect(port, () => {
+        if (++connected === conns)
+          start();
+      });
+      client.on('data', (chunk) => {
+        received += chunk.length;
+        if (running)
+          client.write(message);
+      });
+      client.on('error', () => {});
+      clients.push(client);
+    }
+
+    function start() {
+      bench.start();
+      for (const client of clients)
+        client.write(message);
+
+      setTimeout(() => {
+        running = false;
+        bench.end(received / len);
+        for (const client of clients)
+          client.destroy();
+        server.close();
+      }, dur * 1000);
+    }
+  });
+}
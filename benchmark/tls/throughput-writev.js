@@ -0,0 +1,70 @@
+// Measures TLS throughput when every write to the socket consists of
+// several buffers, as with cork()/uncork() or HTTP chunked encoding.
+'use strict';
+const common = require('../common.js');
+const bench = common.createBenchmark(main, {
+  dur: [5],
+  chunks: [2, 8],
+  chunklen: [16, 64 * 1024],
+  tail: [0, 1], // Whether each batch ends with a small buffer, like CRLF
+  kernel: [0, 1], // Whether the kernelTLS option is used
+});
+
+const fixtures = require('../../test/common/fixtures');
+const tls = require('tls');
+
+function main({ dur, chunks, chunklen, tail, kernel }) {
+  const chunk = Buffer.alloc(chunklen, 'b');
+  const crlf = Buffer.from('\r\n');
+  let received = 0;
+
+  const options = {
+    key: fixtures.readKey('rsa_private.pem'),
+    cert: fixtures.readKey('rsa_cert.crt'),
+    ca: fixtures.readKey('rsa_ca.crt'),
+    ciphers: 'AES256-GCM-SHA384',
+    maxVersion: 'TLSv1.2',
+    kernelTLS: !!kernel
+  };
+
+  const server = tls.createServer(options, (socket) => {
+    socket.once('data', () => {
+      socket.on('drain', write);
+      write();
+    });
+
+    function write() {
+      let ok = true;
+      while (ok) {
+        socket.cork();
+        for (let i = 0; i < chunks; i++)
+          ok = socket.write(chunk);
+        if (tail)
+          ok = socket.write(crlf);
+        socket.uncork();
+      }
+    }
+  });
+
+  server.listen(common.PORT, () => {
+    const conn = tls.connect({
+      port: common.PORT,
+      rejectUnauthorized: false,
+      kernelTLS: !!kernel
+    }, () => {
+      setTimeout(done, dur * 1000);
+      bench.start();
+      conn.write('hello');
+    });
+
+    conn.on('data', (data) => {
+      received += data.length;
+    });
+  });
+
+  function done() {
+    const mbits = (received * 8) / (1024 * 1024);
+    bench.end(mbits);
+    process.exit(0);
+  }
+}
@@ -0,0 +1,37 @@
+'use strict';
+const common = require('../common.js');
+const fs = require('fs');
+const zlib = require('zlib');
+
+const bench = common.createBenchmark(main, {
+  method: ['gzip', 'deflate', 'deflateRaw'],
+  parallel: [0, 1, 2, 4, 8],
+  blockSize: [128 * 1024],
+  inputLen: [16 * 1024 * 1024],
+  n: [10]
+}, {
+  test: {
+    inputLen: 1024 * 1024,
+    n: 1
+  }
+});
+
+function main({ method, parallel, blockSize, inputLen, n }) {
+  // Source code compresses about as well as typical text content.
+  const input = Buffer.alloc(inputLen, fs.readFileSync(__filename));
+  // `parallel: 0` measures the ordinary single-threaded stream.
+  const options = parallel > 0 ? { parallel, blockSize } : {};
+  const fn = zlib[method];
+
+  let i = 0;
+  bench.start();
+  (function next(err) {
+    if (err)
+      throw err;
+    if (i++ === n) {
+      // Give result in GB/s of input.
+      return bench.end(n * inputLen / 1e9);
+    }
+    fn(input, options, next);
+  })();
+}
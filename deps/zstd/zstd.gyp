@@ -0,0 +1,56 @@
+{
+  'targets': [
+    {
+      'target_name': 'zstd',
+      'type': 'static_library',
+      'include_dirs': ['lib'],
+      'defines': [
+        # Required for the nbWorkers compression parameter.
+        'ZSTD_MULTITHREAD',
+      ],
+      'conditions': [
+        ['target_arch=="x64" and OS!="win"', {
+          'sources': [ 'lib/decompress/huf_decompress_amd64.S' ],
+        }, {
+          'defines': [ 'ZSTD_DISABLE_ASM' ],
+        }],
+      ],
+      'direct_dependent_settings': {
+        'include_dirs': [ 'lib' ]
+      },
+      'sources': [
+        # Common
+        'lib/common/debug.c',
+        'lib/common/entropy_common.c',
+        'lib/common/error_private.c',
+        'lib/common/fse_decompress.c',
+        'lib/common/pool.c',
+        'lib/common/threading.c',
+        'lib/common/xxhash.c',
+        'lib/common/zstd_common.c',
+
+        # Compressor
+        'lib/compress/fse_compress.c',
+        'lib/compress/hist.c',
+        'lib/compress/huf_compress.c',
+        'lib/compress/zstd_compress.c',
+        'lib/compress/zstd_compress_literals.c',
+        'lib/compress/zstd_compress_sequences.c',
+        'lib/compress/zstd_compress_superblock.c',
+        'lib/compress/zstd_double_fast.c',
+        'lib/compress/zstd_fast.c',
+        'lib/compress/zstd_lazy.c',
+        'lib/compress/zstd_ldm.c',
+        'lib/compress/zstd_opt.c',
+        'lib/compress/zstd_preSplit.c',
+        'lib/compress/zstdmt_compress.c',
+
+        # Decompressor
+        'lib/decompress/huf_decompress.c',
+        'lib/decompress/zstd_ddict.c',
+        'lib/decompress/zstd_decompress.c',
+        'lib/decompress/zstd_decompress_block.c'
+      ]
+    }
+  ]
+}
@@ -22,6 +22,7 @@
 'use strict';
 
 const {
+  ArrayIsArray,
   ArrayPrototypePush,
   FunctionPrototypeCall,
   ObjectDefineProperty,
@@ -33,9 +34,11 @@ const {
 } = primordials;
 
 const Stream = require('stream');
+const { validateString } = require('internal/validators');
 
 const kHeaders = Symbol('kHeaders');
 const kHeadersCount = Symbol('kHeadersCount');
+const kHeaderBlock = Symbol('kHeaderBlock');
 const kTrailers = Symbol('kTrailers');
 const kTrailersCount = Symbol('kTrailersCount');
 
@@ -72,6 +75,7 @@ function IncomingMessage(socket) {
   this.complete = false;
   this[kHeaders] = null;
   this[kHeadersCount] = 0;
+  this[kHeaderBlock] = null;
   this.rawHeaders = [];
   this[kTrailers] = null;
   this[kTrailersCount] = 0;
@@ -145,6 +149,46 @@ ObjectDefineProperty(IncomingMessage.prototype, 'trailers', {
   }
 });
 
+// Replaces the native header block with a regular `rawHeaders` array the
+// first time that `rawHeaders` is used.
+const lazyRawHeaders = {
+  get: function() {
+    const rawHeaders = this[kHeaderBlock].toArray();
+    this.rawHeaders = rawHeaders;
+    return rawHeaders;
+  },
+  set: function(val) {
+    this[kHeaderBlock] = null;
+    ObjectDefineProperty(this, 'rawHeaders', {
+      value: val,
+      writable: true,
+      enumerable: true,
+      configurable: true
+    });
+  },
+  enumerable: true,
+  configurable: true
+};
+
+IncomingMessage.prototype.getHeader = function getHeader(name) {
+  validateString(name, 'name');
+  const key = StringPrototypeToLowerCase(name);
+  const block = this[kHeaderBlock];
+  if (block === null || this[kHeaders])
+    return this.headers[key];
+
+  // Only create strings for the headers with the requested name, but
+  // combine them exactly like the `headers` getter does.
+  const dest = {};
+  const n = this[kHeadersCount];
+  let i = block.find(name, 0);
+  while (i !== -1 && i < n) {
+    this._addHeaderLine(block.get(i), block.get(i + 1), dest);
+    i = block.find(name, i + 2);
+  }
+  return dest[key];
+};
+
 IncomingMessage.prototype.setTimeout = function setTimeout(msecs, callback) {
   if (callback)
     this.on('timeout', callback);
@@ -195,9 +239,17 @@ function _addHeaderLines(headers, n) {
       this[kTrailersCount] = n;
       dest = this[kTrailers];
     } else {
-      this.rawHeaders = headers;
+      if (ArrayIsArray(headers)) {
+        this.rawHeaders = headers;
+      } else {
+        // A native header block, from a parser with `lazyHeaders` enabled.
+        this[kHeaderBlock] = headers;
+        ObjectDefineProperty(this, 'rawHeaders', lazyRawHeaders);
+      }
       this[kHeadersCount] = n;
       dest = this[kHeaders];
+      if (dest)
+        headers = this.rawHeaders;
     }
 
     if (dest) {
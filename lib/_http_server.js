@@ -382,6 +382,11 @@ function Server(options, requestListener) {
     validateBoolean(insecureHTTPParser, 'options.insecureHTTPParser');
   this.insecureHTTPParser = insecureHTTPParser;
 
+  const lazyHeaders = options.lazyHeaders;
+  if (lazyHeaders !== undefined)
+    validateBoolean(lazyHeaders, 'options.lazyHeaders');
+  this.lazyHeaders = lazyHeaders;
+
   FunctionPrototypeCall(net.Server, this, { allowHalfOpen: true });
 
   if (requestListener) {
@@ -464,6 +469,7 @@ function connectionListenerInternal(server, socket) {
     server.insecureHTTPParser === undefined ?
       isLenient() : server.insecureHTTPParser,
     server.headersTimeout || 0,
+    server.lazyHeaders === true,
   );
   parser.socket = socket;
   socket.parser = parser;
@@ -910,9 +916,10 @@ function parserOnIncoming(server, socket, state, req, keepAlive) {
          FunctionPrototypeBind(resOnFinish, undefined,
                                req, res, socket, state, server));
 
-  if (req.headers.expect !== undefined &&
+  const expect = req.getHeader('expect');
+  if (expect !== undefined &&
       (req.httpVersionMajor === 1 && req.httpVersionMinor === 1)) {
-    if (RegExpPrototypeTest(continueExpression, req.headers.expect)) {
+    if (RegExpPrototypeTest(continueExpression, expect)) {
       res._expect_continue = true;
 
       if (server.listenerCount('checkContinue') > 0) {
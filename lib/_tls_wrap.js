@@ -84,6 +84,7 @@ const {
   getAllowUnauthorized,
 } = require('internal/options');
 const {
+  validateBoolean,
   validateBuffer,
   validateCallback,
   validateObject,
@@ -103,6 +104,7 @@ const kHandshakeTimeout = Symbol('handshake-timeout');
 const kRes = Symbol('res');
 const kSNICallback = Symbol('snicallback');
 const kEnableTrace = Symbol('enableTrace');
+const kKernelTLS = Symbol('kernelTLS');
 const kPskCallback = Symbol('pskcallback');
 const kPskIdentityHint = Symbol('pskidentityhint');
 const kPendingSession = Symbol('pendingSession');
@@ -472,6 +474,10 @@ function TLSSocket(socket, opts) {
       'options.enableTrace', 'boolean', enableTrace);
   }
 
+  const kernelTLS = tlsOptions.kernelTLS;
+  if (kernelTLS !== undefined)
+    validateBoolean(kernelTLS, 'options.kernelTLS');
+
   if (tlsOptions.ALPNProtocols)
     tls.convertALPNProtocols(tlsOptions.ALPNProtocols, tlsOptions);
 
@@ -527,6 +533,9 @@ function TLSSocket(socket, opts) {
   if (enableTrace && this._handle)
     this._handle.enableTrace();
 
+  if (kernelTLS && this._handle)
+    this._handle.enableKernelTLS();
+
   // Read on next tick so the caller has a chance to setup listeners
   process.nextTick(initRead, this, socket);
 }
@@ -1095,6 +1104,7 @@ function tlsConnectionListener(rawSocket) {
     ALPNProtocols: this.ALPNProtocols,
     SNICallback: this[kSNICallback] || SNICallback,
     enableTrace: this[kEnableTrace],
+    kernelTLS: this[kKernelTLS],
     pauseOnConnect: this.pauseOnConnect,
     pskCallback: this[kPskCallback],
     pskIdentityHint: this[kPskIdentityHint],
@@ -1238,6 +1248,7 @@ function Server(options, listener) {
   }
 
   this[kEnableTrace] = options.enableTrace;
+  this[kKernelTLS] = options.kernelTLS;
 }
 
 ObjectSetPrototypeOf(Server.prototype, net.Server.prototype);
@@ -1624,6 +1635,7 @@ exports.connect = function connect(...args) {
     ALPNProtocols: options.ALPNProtocols,
     requestOCSP: options.requestOCSP,
     enableTrace: options.enableTrace,
+    kernelTLS: options.kernelTLS,
     pskCallback: options.pskCallback,
     highWaterMark: options.highWaterMark,
     onread: options.onread,
@@ -25,6 +25,7 @@ const {
   Array,
   ArrayIsArray,
   ArrayPrototypeForEach,
+  DataViewPrototypeGetBuffer,
   Error,
   MathFloor,
   MathMin,
@@ -43,6 +44,7 @@ const {
   StringPrototypeTrim,
   SymbolSpecies,
   SymbolToPrimitive,
+  TypedArrayPrototypeGetBuffer,
   TypedArrayPrototypeGetByteLength,
   TypedArrayPrototypeFill,
   TypedArrayPrototypeSet,
@@ -56,9 +58,12 @@ const {
   compareOffset,
   createFromString,
   fill: bindingFill,
+  indexOfAny: _indexOfAny,
   indexOfBuffer,
   indexOfNumber,
   indexOfString,
+  isAscii: bindingIsAscii,
+  isUtf8: bindingIsUtf8,
   swap16: _swap16,
   swap32: _swap32,
   swap64: _swap64,
@@ -81,6 +86,7 @@ const {
 const {
   isAnyArrayBuffer,
   isArrayBufferView,
+  isDataView,
   isUint8Array
 } = require('internal/util/types');
 const {
@@ -94,6 +100,7 @@ const {
     ERR_INVALID_ARG_TYPE,
     ERR_INVALID_ARG_VALUE,
     ERR_INVALID_BUFFER_SIZE,
+    ERR_INVALID_STATE,
     ERR_OUT_OF_RANGE,
     ERR_UNKNOWN_ENCODING
   },
@@ -969,6 +976,49 @@ Buffer.prototype.includes = function includes(val, byteOffset, encoding) {
   return this.indexOf(val, byteOffset, encoding) !== -1;
 };
 
+Buffer.prototype.indexOfAny = function indexOfAny(values, byteOffset,
+                                                  encoding) {
+  validateArray(values, 'values');
+
+  if (typeof byteOffset === 'string') {
+    encoding = byteOffset;
+    byteOffset = 0;
+  } else if (byteOffset > 0x7fffffff) {
+    byteOffset = 0x7fffffff;
+  } else if (byteOffset < -0x80000000) {
+    byteOffset = -0x80000000;
+  }
+  byteOffset = +byteOffset;
+  if (NumberIsNaN(byteOffset))
+    byteOffset = 0;
+
+  let ops;
+  if (encoding === undefined)
+    ops = encodingOps.utf8;
+  else
+    ops = getEncodingOps(encoding);
+
+  const needles = new Array(values.length);
+  for (let i = 0; i < values.length; i++) {
+    const val = values[i];
+    if (typeof val === 'number') {
+      needles[i] = new FastBuffer(1);
+      needles[i][0] = val;
+    } else if (typeof val === 'string') {
+      if (ops === undefined)
+        throw new ERR_UNKNOWN_ENCODING(encoding);
+      needles[i] = fromStringFast(val, ops);
+    } else if (isUint8Array(val)) {
+      needles[i] = val;
+    } else {
+      throw new ERR_INVALID_ARG_TYPE(
+        `values[${i}]`, ['number', 'string', 'Buffer', 'Uint8Array'], val
+      );
+    }
+  }
+  return _indexOfAny(this, needles, byteOffset);
+};
+
 // Usage:
 //    buffer.fill(number[, offset[, end]])
 //    buffer.fill(buffer[, offset[, end]])
@@ -1180,6 +1230,44 @@ Buffer.prototype.swap64 = function swap64() {
 
 Buffer.prototype.toLocaleString = Buffer.prototype.toString;
 
+// A detached buffer has no contents that could be validated, unlike an empty
+// one. Only ArrayBuffers can be detached, and views on them refuse to be
+// created afterwards.
+function validateNotDetached(buffer) {
+  try {
+    new Uint8Array(buffer);
+  } catch {
+    throw new ERR_INVALID_STATE('Cannot validate on a detached buffer');
+  }
+}
+
+function toValidationView(input) {
+  if (isArrayBufferView(input)) {
+    // The length of a DataView cannot be read once its buffer is detached,
+    // and a detached TypedArray looks empty.
+    if (isDataView(input))
+      validateNotDetached(DataViewPrototypeGetBuffer(input));
+    else if (TypedArrayPrototypeGetByteLength(input) === 0)
+      validateNotDetached(TypedArrayPrototypeGetBuffer(input));
+    return input;
+  }
+  if (isAnyArrayBuffer(input)) {
+    validateNotDetached(input);
+    return new Uint8Array(input);
+  }
+  throw new ERR_INVALID_ARG_TYPE('input',
+                                 ['ArrayBuffer', 'Buffer', 'TypedArray'],
+                                 input);
+}
+
+function isUtf8(input) {
+  return bindingIsUtf8(toValidationView(input));
+}
+
+function isAscii(input) {
+  return bindingIsAscii(toValidationView(input));
+}
+
 let transcode;
 if (internalBinding('config').hasIntl) {
   const {
@@ -1216,6 +1304,8 @@ module.exports = {
   Buffer,
   SlowBuffer,
   transcode,
+  isUtf8,
+  isAscii,
   // Legacy
   kMaxLength,
   kStringMaxLength
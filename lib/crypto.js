@@ -109,7 +109,8 @@ const {
 } = require('internal/crypto/sig');
 const {
   Hash,
-  Hmac
+  Hmac,
+  hashBatch,
 } = require('internal/crypto/hash');
 const {
   X509Certificate
@@ -196,6 +197,7 @@ module.exports = {
   getCurves,
   getDiffieHellman: createDiffieHellmanGroup,
   getHashes,
+  hashBatch,
   hkdf,
   hkdfSync,
   pbkdf2,
@@ -53,6 +53,9 @@ const {
 const {
   isInt32,
   validateAbortSignal,
+  validateArray,
+  validateBoolean,
+  validateInteger,
   validateString,
   validateNumber,
   validatePort,
@@ -84,6 +87,9 @@ const CONNECT_STATE_CONNECTED = 2;
 const RECV_BUFFER = true;
 const SEND_BUFFER = false;
 
+// The largest payload of a UDP datagram.
+const kMaxSegmentSize = 65507;
+
 // Lazily loaded
 let cluster = null;
 
@@ -104,6 +110,8 @@ function Socket(type, listener) {
     lookup = options.lookup;
     recvBufferSize = options.recvBufferSize;
     sendBufferSize = options.sendBufferSize;
+    if (options.gro !== undefined)
+      validateBoolean(options.gro, 'options.gro');
   }
 
   const handle = newHandle(type, lookup);
@@ -124,7 +132,8 @@ function Socket(type, listener) {
     reuseAddr: options && options.reuseAddr, // Use UV_UDP_REUSEADDR if true.
     ipv6Only: options && options.ipv6Only,
     recvBufferSize,
-    sendBufferSize
+    sendBufferSize,
+    gro: options && options.gro,
   };
 
   if (options?.signal !== undefined) {
@@ -154,6 +163,11 @@ function startListening(socket) {
   const state = socket[kStateSymbol];
 
   state.handle.onmessage = onMessage;
+  state.handle.onmessages = onMessages;
+  // Generic receive offload is only available on Linux. Elsewhere, datagrams
+  // are simply received one by one.
+  if (state.gro)
+    state.handle.setGRO(true);
   // Todo: handle errors
   state.handle.recvStart();
   state.receiving = true;
@@ -176,6 +190,8 @@ function replaceHandle(self, newHandle) {
   newHandle.lookup = oldHandle.lookup;
   newHandle.bind = oldHandle.bind;
   newHandle.send = oldHandle.send;
+  newHandle.sendMany = oldHandle.sendMany;
+  newHandle.sendSegments = oldHandle.sendSegments;
   newHandle[owner_symbol] = self;
 
   // Replace the existing handle by the handle we got from master.
@@ -725,6 +741,185 @@ function afterSend(err, sent) {
   this.callback(err, sent);
 }
 
+
+// Sends each element of `messages` as a separate datagram. Most of them are
+// usually sent synchronously, with a single system call where possible.
+// valid combinations
+// For connectionless sockets
+// sendMany(messages, port, address, callback)
+// sendMany(messages, port, address)
+// sendMany(messages, port, callback)
+// sendMany(messages, port)
+// For connected sockets
+// sendMany(messages, callback)
+// sendMany(messages)
+Socket.prototype.sendMany = function(messages, port, address, callback) {
+  validateArray(messages, 'messages');
+
+  const state = this[kStateSymbol];
+  const connected = state.connectState === CONNECT_STATE_CONNECTED;
+  if (connected) {
+    if (typeof port === 'function') {
+      callback = port;
+      port = undefined;
+    }
+    if (port || address)
+      throw new ERR_SOCKET_DGRAM_IS_CONNECTED();
+  } else {
+    port = validatePort(port, 'Port', { allowZero: false });
+  }
+
+  if (typeof address === 'function') {
+    callback = address;
+    address = undefined;
+  } else if (address && typeof address !== 'string') {
+    throw new ERR_INVALID_ARG_TYPE('address', ['string', 'falsy'], address);
+  }
+
+  if (typeof callback !== 'function')
+    callback = undefined;
+
+  const list = new Array(messages.length);
+  for (let i = 0; i < messages.length; i++) {
+    const message = messages[i];
+    if (typeof message === 'string') {
+      list[i] = Buffer.from(message);
+    } else if (isArrayBufferView(message)) {
+      list[i] = Buffer.from(message.buffer, message.byteOffset,
+                            message.byteLength);
+    } else {
+      throw new ERR_INVALID_ARG_TYPE(`messages[${i}]`,
+                                     ['Buffer',
+                                      'TypedArray',
+                                      'DataView',
+                                      'string'],
+                                     message);
+    }
+  }
+
+  healthCheck(this);
+
+  if (state.bindState === BIND_STATE_UNBOUND)
+    this.bind({ port: 0, exclusive: true }, null);
+
+  if (state.bindState !== BIND_STATE_BOUND) {
+    enqueue(this, FunctionPrototypeBind(this.sendMany, this,
+                                        list, port, address, callback));
+    return;
+  }
+
+  const afterDns = (ex, ip) => {
+    defaultTriggerAsyncIdScope(
+      this[async_id_symbol],
+      doSendMany,
+      ex, this, ip, list, address, port, callback
+    );
+  };
+
+  if (!connected) {
+    state.handle.lookup(address, afterDns);
+  } else {
+    afterDns(null, null);
+  }
+};
+
+function doSendMany(ex, self, ip, list, address, port, callback) {
+  const state = self[kStateSymbol];
+
+  if (ex) {
+    if (typeof callback === 'function') {
+      process.nextTick(callback, ex);
+      return;
+    }
+
+    process.nextTick(() => self.emit('error', ex));
+    return;
+  } else if (!state.handle) {
+    return;
+  }
+
+  let sent;
+  if (port)
+    sent = state.handle.sendMany(list, list.length, port, ip);
+  else
+    sent = state.handle.sendMany(list, list.length);
+
+  if (sent < 0) {
+    if (callback) {
+      // Don't emit as error, dgram_legacy.js compatibility
+      const ex = exceptionWithHostPort(sent, 'send', address, port);
+      process.nextTick(callback, ex);
+    }
+    return;
+  }
+
+  let bytes = 0;
+  for (let i = 0; i < sent; i++)
+    bytes += list[i].length;
+
+  sendEach(self, list, sent, bytes, ip, address, port, callback);
+}
+
+// The datagrams that could not be sent right away are sent one by one,
+// which lets libuv queue them.
+function sendEach(self, list, start, bytes, ip, address, port, callback) {
+  const state = self[kStateSymbol];
+  const context = {
+    callback,
+    error: null,
+    bytes,
+    pending: list.length - start,
+  };
+
+  for (let i = start; i < list.length; i++) {
+    const req = new SendWrap();
+    req.list = [list[i]];  // Keep reference alive.
+    req.address = address;
+    req.port = port;
+    req.context = context;
+    if (callback)
+      req.oncomplete = afterSendMany;
+
+    let err;
+    if (port)
+      err = state.handle.send(req, req.list, 1, port, ip, !!callback);
+    else
+      err = state.handle.send(req, req.list, 1, !!callback);
+
+    if (err >= 1) {
+      // Synchronous finish, see doSend().
+      context.pending--;
+      context.bytes += err - 1;
+    } else if (err) {
+      context.pending--;
+      context.error ??= exceptionWithHostPort(err, 'send', address, port);
+    }
+  }
+
+  if (callback && context.pending === 0) {
+    if (context.error)
+      process.nextTick(callback, context.error);
+    else
+      process.nextTick(callback, null, context.bytes);
+  }
+}
+
+function afterSendMany(err, sent) {
+  const context = this.context;
+  if (err)
+    context.error ??= exceptionWithHostPort(err, 'send', this.address,
+                                            this.port);
+  else
+    context.bytes += sent;
+
+  if (--context.pending === 0) {
+    if (context.error)
+      context.callback(context.error);
+    else
+      context.callback(null, context.bytes);
+  }
+}
+
 Socket.prototype.close = function(callback) {
   const state = this[kStateSymbol];
   const queue = state.queue;
@@ -910,6 +1105,126 @@ function healthCheck(socket) {
 }
 
 
+// Splits `buffer` into datagrams of `segmentSize` bytes each, the last one
+// possibly being shorter. Where the operating system supports UDP
+// segmentation offload, the kernel or the network card does the splitting.
+// valid combinations
+// For connectionless sockets
+// sendSegments(buffer, segmentSize, port, address, callback)
+// sendSegments(buffer, segmentSize, port, address)
+// sendSegments(buffer, segmentSize, port, callback)
+// sendSegments(buffer, segmentSize, port)
+// For connected sockets
+// sendSegments(buffer, segmentSize, callback)
+// sendSegments(buffer, segmentSize)
+Socket.prototype.sendSegments = function(buffer,
+                                         segmentSize,
+                                         port,
+                                         address,
+                                         callback) {
+  if (typeof buffer === 'string') {
+    buffer = Buffer.from(buffer);
+  } else if (isArrayBufferView(buffer)) {
+    buffer = Buffer.from(buffer.buffer, buffer.byteOffset, buffer.byteLength);
+  } else {
+    throw new ERR_INVALID_ARG_TYPE('buffer',
+                                   ['Buffer',
+                                    'TypedArray',
+                                    'DataView',
+                                    'string'],
+                                   buffer);
+  }
+  validateInteger(segmentSize, 'segmentSize', 1, kMaxSegmentSize);
+
+  const state = this[kStateSymbol];
+  const connected = state.connectState === CONNECT_STATE_CONNECTED;
+  if (connected) {
+    if (typeof port === 'function') {
+      callback = port;
+      port = undefined;
+    }
+    if (port || address)
+      throw new ERR_SOCKET_DGRAM_IS_CONNECTED();
+  } else {
+    port = validatePort(port, 'Port', { allowZero: false });
+  }
+
+  if (typeof address === 'function') {
+    callback = address;
+    address = undefined;
+  } else if (address && typeof address !== 'string') {
+    throw new ERR_INVALID_ARG_TYPE('address', ['string', 'falsy'], address);
+  }
+
+  if (typeof callback !== 'function')
+    callback = undefined;
+
+  healthCheck(this);
+
+  if (state.bindState === BIND_STATE_UNBOUND)
+    this.bind({ port: 0, exclusive: true }, null);
+
+  if (state.bindState !== BIND_STATE_BOUND) {
+    enqueue(this, FunctionPrototypeBind(this.sendSegments, this, buffer,
+                                        segmentSize, port, address, callback));
+    return;
+  }
+
+  const afterDns = (ex, ip) => {
+    defaultTriggerAsyncIdScope(
+      this[async_id_symbol],
+      doSendSegments,
+      ex, this, ip, buffer, segmentSize, address, port, callback
+    );
+  };
+
+  if (!connected) {
+    state.handle.lookup(address, afterDns);
+  } else {
+    afterDns(null, null);
+  }
+};
+
+function doSendSegments(ex, self, ip, buffer, segmentSize, address, port,
+                        callback) {
+  const state = self[kStateSymbol];
+
+  if (ex) {
+    if (typeof callback === 'function') {
+      process.nextTick(callback, ex);
+      return;
+    }
+
+    process.nextTick(() => self.emit('error', ex));
+    return;
+  } else if (!state.handle) {
+    return;
+  }
+
+  let sent;
+  if (port)
+    sent = state.handle.sendSegments(buffer, segmentSize, port, ip);
+  else
+    sent = state.handle.sendSegments(buffer, segmentSize);
+
+  if (sent < 0) {
+    if (callback) {
+      // Don't emit as error, dgram_legacy.js compatibility
+      const ex = exceptionWithHostPort(sent, 'send', address, port);
+      process.nextTick(callback, ex);
+    }
+    return;
+  }
+
+  // Whatever was not sent with segmentation offload is sent one segment at
+  // a time. `sent` is always a multiple of the segment size here.
+  const list = [];
+  for (let offset = sent; offset < buffer.length; offset += segmentSize)
+    ArrayPrototypePush(list, buffer.slice(offset, offset + segmentSize));
+  sendEach(self, list, 0, sent, ip, address, port, callback);
+}
+
+
 function stopReceiving(socket) {
   const state = socket[kStateSymbol];
 
@@ -921,16 +1236,35 @@ function stopReceiving(socket) {
 }
 
 
-function onMessage(nread, handle, buf, rinfo) {
+function onMessage(nread, handle, buf, rinfo, segmentSize) {
   const self = handle[owner_symbol];
   if (nread < 0) {
     return self.emit('error', errnoException(nread, 'recvmsg'));
   }
   rinfo.size = buf.length; // compatibility
+  // Set when the kernel coalesced several datagrams into `buf`, see the
+  // `gro` option.
+  if (segmentSize !== undefined)
+    rinfo.segmentSize = segmentSize;
   self.emit('message', buf, rinfo);
 }
 
 
+// Datagrams that were received together through recvmmsg().
+function onMessages(handle, buffers, rinfos) {
+  const self = handle[owner_symbol];
+  const state = self[kStateSymbol];
+  for (let i = 0; i < buffers.length; i++) {
+    // A 'message' listener may have closed the socket.
+    if (!state.receiving)
+      return;
+    const rinfo = rinfos[i];
+    rinfo.size = buffers[i].length; // compatibility
+    self.emit('message', buffers[i], rinfo);
+  }
+}
+
+
 Socket.prototype.ref = function() {
   const handle = this[kStateSymbol].handle;
 
@@ -9,6 +9,7 @@ const {
   getPackedSettings,
   getUnpackedSettings,
   sensitiveHeaders,
+  setMemoryBudget,
   Http2ServerRequest,
   Http2ServerResponse
 } = require('internal/http2/core');
@@ -22,6 +23,7 @@ module.exports = {
   getPackedSettings,
   getUnpackedSettings,
   sensitiveHeaders,
+  setMemoryBudget,
   Http2ServerRequest,
   Http2ServerResponse
 };
@@ -1,6 +1,8 @@
 'use strict';
 
 const {
+  Array,
+  FunctionPrototypeCall,
   ObjectSetPrototypeOf,
   ReflectApply,
   Symbol,
@@ -8,6 +10,8 @@ const {
 
 const {
   Hash: _Hash,
+  HashBatchJob,
+  HashFileJob,
   HashJob,
   Hmac: _Hmac,
   kCryptoJobAsync,
@@ -37,16 +41,21 @@ const {
     ERR_CRYPTO_HASH_FINALIZED,
     ERR_CRYPTO_HASH_UPDATE_FAILED,
     ERR_INVALID_ARG_TYPE,
+    ERR_UNKNOWN_ENCODING,
   }
 } = require('internal/errors');
 
 const {
+  validateArray,
+  validateCallback,
   validateEncoding,
+  validateObject,
   validateString,
   validateUint32,
 } = require('internal/validators');
 
 const {
+  isAnyArrayBuffer,
   isArrayBufferView,
 } = require('internal/util/types');
 
@@ -161,6 +170,80 @@ Hmac.prototype.digest = function digest(outputEncoding) {
 Hmac.prototype._flush = Hash.prototype._flush;
 Hmac.prototype._transform = Hash.prototype._transform;
 
+// Hashes all of `data` in a single threadpool task, which is a lot cheaper
+// than creating a Hash object for each of many small inputs.
+function hashBatch(algorithm, data, options, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = undefined;
+  }
+
+  validateString(algorithm, 'algorithm');
+  validateArray(data, 'data');
+  let outputLength;
+  let encoding = 'buffer';
+  if (options !== undefined) {
+    validateObject(options, 'options');
+    outputLength = options.outputLength;
+    if (outputLength !== undefined)
+      validateUint32(outputLength, 'options.outputLength');
+    if (options.encoding !== undefined) {
+      validateString(options.encoding, 'options.encoding');
+      encoding = options.encoding;
+      if (encoding !== 'buffer' && !Buffer.isEncoding(encoding))
+        throw new ERR_UNKNOWN_ENCODING(encoding);
+    }
+  }
+  validateCallback(callback);
+
+  const inputs = new Array(data.length);
+  for (let i = 0; i < data.length; i++) {
+    const input = data[i];
+    if (typeof input === 'string') {
+      inputs[i] = Buffer.from(input, 'utf8');
+    } else if (isArrayBufferView(input) || isAnyArrayBuffer(input)) {
+      inputs[i] = input;
+    } else {
+      throw new ERR_INVALID_ARG_TYPE(
+        `data[${i}]`,
+        ['string', 'ArrayBuffer', 'Buffer', 'TypedArray', 'DataView'],
+        input);
+    }
+  }
+
+  const job = new HashBatchJob(
+    kCryptoJobAsync,
+    algorithm,
+    inputs,
+    outputLength);
+
+  job.ondone = (err, result) => {
+    if (err !== undefined)
+      return FunctionPrototypeCall(callback, job, err);
+    // All digests share the memory of `result`.
+    const length = inputs.length > 0 ? result.byteLength / inputs.length : 0;
+    const digests = new Array(inputs.length);
+    for (let i = 0; i < inputs.length; i++) {
+      const digest = Buffer.from(result, i * length, length);
+      digests[i] = encoding === 'buffer' ? digest : digest.toString(encoding);
+    }
+    FunctionPrototypeCall(callback, job, null, digests);
+  };
+
+  job.run();
+}
+
+// Implementation for filehandle.hash(). The file is read and hashed on the
+// threadpool, and the digests resolve to an array of ArrayBuffers.
+function hashFile(fd, algorithms, position, length) {
+  return jobPromise(new HashFileJob(
+    kCryptoJobAsync,
+    fd,
+    algorithms,
+    position,
+    length));
+}
+
 // Implementation for WebCrypto subtle.digest()
 
 async function asyncDigest(algorithm, data) {
@@ -182,4 +265,6 @@ module.exports = {
   Hash,
   Hmac,
   asyncDigest,
+  hashBatch,
+  hashFile,
 };
@@ -54,6 +54,8 @@ function newHandle(type, lookup) {
     handle.bind = handle.bind6;
     handle.connect = handle.connect6;
     handle.send = handle.send6;
+    handle.sendMany = handle.sendMany6;
+    handle.sendSegments = handle.sendSegments6;
     return handle;
   }
 
@@ -10,6 +10,7 @@ const kReadFileMaxChunkSize = 2 ** 14;
 const kWriteFileMaxChunkSize = 2 ** 14;
 
 const {
+  ArrayIsArray,
   ArrayPrototypePush,
   Error,
   MathMax,
@@ -40,6 +41,7 @@ const {
   ERR_INVALID_ARG_TYPE,
   ERR_INVALID_ARG_VALUE,
   ERR_METHOD_NOT_IMPLEMENTED,
+  ERR_UNKNOWN_ENCODING,
 } = codes;
 const { isArrayBufferView } = require('internal/util/types');
 const { rimrafPromises } = require('internal/fs/rimraf');
@@ -69,10 +71,12 @@ const {
   validateBoolean,
   validateBuffer,
   validateInteger,
+  validateObject,
+  validateString,
   validateUint32
 } = require('internal/validators');
 const pathModule = require('path');
-const { promisify } = require('internal/util');
+const { assertCrypto, promisify } = require('internal/util');
 const { EventEmitterMixin } = require('internal/event_target');
 const { watch } = require('internal/fs/watchers');
 
@@ -93,6 +97,8 @@ const {
 const getDirectoryEntriesPromise = promisify(getDirents);
 const validateRmOptionsPromise = promisify(validateRmOptions);
 
+let hashFile;
+
 let DOMException;
 const lazyDOMException = hideStackFrames((message, name) => {
   if (DOMException === undefined)
@@ -138,6 +144,10 @@ class FileHandle extends EventEmitterMixin(JSTransferable) {
     return fsCall(fsync, this);
   }
 
+  hash(algorithm, options) {
+    return fsCall(hashFileHandle, this, algorithm, options);
+  }
+
   read(buffer, offset, length, position) {
     return fsCall(read, this, buffer, offset, length, position);
   }
@@ -338,6 +348,52 @@ async function readFileHandle(filehandle, options) {
   return options.encoding ? result.toString(options.encoding) : result;
 }
 
+async function hashFileHandle(filehandle, algorithm, options) {
+  assertCrypto();
+  let algorithms;
+  if (ArrayIsArray(algorithm)) {
+    algorithms = algorithm;
+    for (let i = 0; i < algorithms.length; i++)
+      validateString(algorithms[i], `algorithm[${i}]`);
+  } else {
+    validateString(algorithm, 'algorithm');
+    algorithms = [algorithm];
+  }
+
+  let position = -1;
+  let length = -1;
+  let encoding;
+  if (options != null) {
+    validateObject(options, 'options');
+    if (options.position != null) {
+      validateInteger(options.position, 'options.position', 0);
+      position = options.position;
+    }
+    if (options.length !== undefined) {
+      validateInteger(options.length, 'options.length', 0);
+      length = options.length;
+    }
+    if (options.encoding != null) {
+      validateString(options.encoding, 'options.encoding');
+      if (!Buffer.isEncoding(options.encoding))
+        throw new ERR_UNKNOWN_ENCODING(options.encoding);
+      encoding = options.encoding;
+    }
+  }
+
+  let digests = [];
+  if (algorithms.length > 0) {
+    if (hashFile === undefined)
+      hashFile = require('internal/crypto/hash').hashFile;
+    digests = await hashFile(filehandle.fd, algorithms, position, length);
+  }
+  for (let i = 0; i < digests.length; i++) {
+    const digest = Buffer.from(digests[i]);
+    digests[i] = encoding === undefined ? digest : digest.toString(encoding);
+  }
+  return ArrayIsArray(algorithm) ? digests : digests[0];
+}
+
 // All of the functions are defined as async in order to ensure that errors
 // thrown cause promise rejections rather than being thrown synchronously.
 async function access(path, mode = F_OK) {
@@ -2,9 +2,13 @@
 
 const {
   Array,
+  ArrayPrototypeIndexOf,
+  ArrayPrototypePush,
+  ArrayPrototypeSplice,
   FunctionPrototypeBind,
   MathMin,
   ObjectDefineProperty,
+  ObjectPrototypeHasOwnProperty,
   ObjectSetPrototypeOf,
   PromisePrototypeThen,
   ReflectApply,
@@ -12,10 +16,13 @@ const {
 } = primordials;
 
 const {
-  ERR_INVALID_ARG_TYPE,
-  ERR_OUT_OF_RANGE,
-  ERR_METHOD_NOT_IMPLEMENTED,
-} = require('internal/errors').codes;
+  codes: {
+    ERR_INVALID_ARG_TYPE,
+    ERR_OUT_OF_RANGE,
+    ERR_METHOD_NOT_IMPLEMENTED,
+  },
+  uvException,
+} = require('internal/errors');
 const { deprecate } = require('internal/util');
 const {
   validateFunction,
@@ -31,8 +38,15 @@ const {
 } = require('internal/fs/utils');
 const { Readable, Writable, finished } = require('stream');
 const { toPathIfFileURL } = require('internal/url');
+const { FileHandle: FileHandleWrap } = internalBinding('fs');
+const { Pipe } = internalBinding('pipe_wrap');
+const { StreamPipe } = internalBinding('stream_pipe');
+const { kReadBytesOrError, streamBaseState } = internalBinding('stream_wrap');
+const { TCP } = internalBinding('tcp_wrap');
+const { UV_EOF } = internalBinding('uv');
 const kIoDone = Symbol('kIoDone');
 const kIsPerformingIO = Symbol('kIsPerformingIO');
+const kNativePipe = Symbol('kNativePipe');
 
 const kFs = Symbol('kFs');
 const kHandle = Symbol('kHandle');
@@ -221,6 +235,13 @@ ReadStream.prototype.open = openReadFs;
 ReadStream.prototype._construct = _construct;
 
 ReadStream.prototype._read = function(n) {
+  // Continue once a native pipe has given back control.
+  const nativePipe = this[kNativePipe];
+  if (nativePipe) {
+    nativePipe.pendingRead = n;
+    return;
+  }
+
   n = this.pos !== undefined ?
     MathMin(this.end - this.pos + 1, n) :
     MathMin(this.end - this.bytesRead + 1, n);
@@ -268,7 +289,233 @@ ReadStream.prototype._read = function(n) {
   }
 };
 
+// A ReadStream that is piped into a TCP or IPC socket, and into nothing else,
+// hands the transfer to a native StreamPipe. On Linux, that sends the file
+// with sendfile(), so that the data never passes through JS. As soon as the
+// stream is used in a way that the native pipe cannot follow, e.g. a 'data'
+// listener is added or it is paused, the rest is piped by Readable.
+function canPipeNatively(stream, dest) {
+  const state = stream._readableState;
+  if (stream[kFs] !== fs || stream[kNativePipe] || stream[kIsPerformingIO] ||
+      stream.destroyed || stream.bytesRead !== 0 || state.ended ||
+      state.flowing !== null || state.length !== 0 ||
+      state.pipes.length !== 0 || stream.listenerCount('data') !== 0 ||
+      stream.listenerCount('readable') !== 0) {
+    return false;
+  }
+
+  // Only a connected socket whose writes are all done can be handed over,
+  // and native writes do not refresh the socket timeout.
+  const { Socket } = require('net');
+  if (!(dest instanceof Socket) || dest.connecting || dest.destroyed ||
+      !dest.writable || dest.writableLength !== 0 || dest.timeout ||
+      ObjectPrototypeHasOwnProperty(dest, 'write')) {
+    return false;
+  }
+  const handle = dest._handle;
+  return handle instanceof TCP || handle instanceof Pipe;
+}
+
+function pipeNatively(stream, dest, pipeOpts) {
+  const state = {
+    dest,
+    end: !pipeOpts || pipeOpts.end !== false,
+    pipe: null,
+    eof: false,
+    error: null,
+    cancelled: false,
+    // Whether Readable continues the pipe once the native one is done.
+    fallBack: false,
+    destCorked: false,
+    pendingRead: undefined,
+    onNewListener: (event) => {
+      if (event === 'data' || event === 'readable')
+        fallBackFromNativePipe(stream);
+    },
+  };
+  stream[kNativePipe] = state;
+
+  // The stream is flowing into `dest`, like with Readable.prototype.pipe().
+  const rState = stream._readableState;
+  ArrayPrototypePush(rState.pipes, dest);
+  rState.flowing = true;
+  stream.on('newListener', state.onNewListener);
+
+  // Other writes to the socket could end up in the middle of a sendfile()
+  // call. They are held back until the native pipe is done, and Readable
+  // pipes the rest of the file after them.
+  const write = dest.write;
+  dest.write = function(...args) {
+    if (stream[kNativePipe] === state && !state.destCorked) {
+      state.destCorked = true;
+      dest.cork();
+      fallBackFromNativePipe(stream);
+    }
+    return ReflectApply(write, this, args);
+  };
+
+  dest.emit('pipe', stream);
+
+  if (stream.fd !== null) {
+    startNativePipe(stream, state);
+    return dest;
+  }
+
+  // If opening the file fails, the stream is closed without an 'open' event.
+  const onOpen = () => {
+    stream.removeListener('close', onClose);
+    startNativePipe(stream, state);
+  };
+  const onClose = () => {
+    stream.removeListener('open', onOpen);
+    finishNativePipe(stream, state, 0);
+  };
+  stream.once('open', onOpen);
+  stream.once('close', onClose);
+  return dest;
+}
+
+function startNativePipe(stream, state) {
+  const { dest } = state;
+  if (state.cancelled || stream.destroyed || !dest._handle) {
+    finishNativePipe(stream, state, 0);
+    return;
+  }
+
+  let offset = -1;
+  let length = -1;
+  if (stream.pos !== undefined)
+    offset = stream.pos;
+  if (stream.end !== Infinity)
+    length = stream.end - (offset === -1 ? 0 : offset) + 1;
+
+  const handle = new FileHandleWrap(stream.fd, offset, length);
+  // This is only called once the pipe has returned back control, so it only
+  // has to handle errors and End-of-File.
+  handle.onread = () => {
+    const err = streamBaseState[kReadBytesOrError];
+    if (err === UV_EOF)
+      state.eof = true;
+    else if (err < 0)
+      state.error = uvException({ errno: err, syscall: 'read' });
+  };
+
+  const pipe = new StreamPipe(handle, dest._handle);
+  pipe.onunpipe = () => {
+    // The ReadStream owns the file descriptor.
+    handle.releaseFD();
+    finishNativePipe(stream, state, pipe.bytesPiped());
+  };
+  state.pipe = pipe;
+  stream[kIsPerformingIO] = true;
+  // The socket is ended through dest.end(), so that its JS side knows.
+  pipe.start(false);
+}
+
+// Stops the native pipe at the position it has reached, and lets
+// finishNativePipe() continue with Readable.prototype.pipe().
+function fallBackFromNativePipe(stream) {
+  const state = stream[kNativePipe];
+  if (!state || state.cancelled)
+    return;
+  state.cancelled = true;
+  state.fallBack = true;
+  if (state.pipe !== null)
+    state.pipe.unpipe();
+}
+
+function finishNativePipe(stream, state, bytesPiped) {
+  const { dest } = state;
+  const rState = stream._readableState;
+  stream[kNativePipe] = null;
+  stream.bytesRead += bytesPiped;
+  if (stream.pos !== undefined)
+    stream.pos += bytesPiped;
+  stream.removeListener('newListener', state.onNewListener);
+  const index = ArrayPrototypeIndexOf(rState.pipes, dest);
+  if (index !== -1)
+    ArrayPrototypeSplice(rState.pipes, index, 1);
+  delete dest.write;
+
+  if (stream[kIsPerformingIO]) {
+    stream[kIsPerformingIO] = false;
+    // Tell ._destroy() that it's safe to close the fd now.
+    if (stream.destroyed) {
+      if (state.destCorked)
+        dest.uncork();
+      stream.emit(kIoDone, state.error);
+      return;
+    }
+  }
+
+  if (state.error) {
+    errorOrDestroy(stream, state.error);
+  } else if (state.eof) {
+    stream.push(null);
+    if (rState.flowing !== false)
+      stream.resume();
+    if (state.end)
+      dest.end();
+  }
+
+  // Writes that were made to the socket in the meantime go first.
+  if (state.destCorked)
+    dest.uncork();
+  dest.emit('unpipe', stream);
+
+  if (state.error || state.eof || stream.destroyed)
+    return;
+
+  if (state.fallBack) {
+    const paused = rState.flowing === false;
+    rState.flowing = null;
+    ReflectApply(Readable.prototype.pipe, stream, [dest, { end: state.end }]);
+    if (paused)
+      ReflectApply(Readable.prototype.pause, stream, []);
+  } else {
+    // Like Readable.prototype.unpipe() with the last destination.
+    ReflectApply(Readable.prototype.pause, stream, []);
+  }
+
+  if (state.pendingRead !== undefined)
+    stream._read(state.pendingRead);
+}
+
+ReadStream.prototype.pipe = function(dest, pipeOpts) {
+  if (canPipeNatively(this, dest))
+    return pipeNatively(this, dest, pipeOpts);
+  // Piping into a second destination has to go through JS as well.
+  fallBackFromNativePipe(this);
+  return ReflectApply(Readable.prototype.pipe, this, [dest, pipeOpts]);
+};
+
+ReadStream.prototype.unpipe = function(dest) {
+  const state = this[kNativePipe];
+  if (!state)
+    return ReflectApply(Readable.prototype.unpipe, this, [dest]);
+  if (dest === undefined || dest === state.dest) {
+    // The stream stays paused at the position that was reached.
+    state.cancelled = true;
+    state.fallBack = false;
+    if (state.pipe !== null)
+      state.pipe.unpipe();
+  }
+  return this;
+};
+
+ReadStream.prototype.pause = function() {
+  fallBackFromNativePipe(this);
+  return ReflectApply(Readable.prototype.pause, this, []);
+};
+
 ReadStream.prototype._destroy = function(err, cb) {
+  const nativePipe = this[kNativePipe];
+  if (nativePipe) {
+    nativePipe.cancelled = true;
+    if (nativePipe.pipe !== null)
+      nativePipe.pipe.unpipe();
+  }
+
   // Usually for async IO it is safe to close a file descriptor
   // even when there are pending operations. However, due to platform
   // differences file IO is implemented using synchronous operations
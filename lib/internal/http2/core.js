@@ -17,7 +17,6 @@ const {
   ObjectDefineProperty,
   ObjectPrototypeHasOwnProperty,
   Promise,
-  PromisePrototypeCatch,
   ReflectApply,
   ReflectGetPrototypeOf,
   RegExpPrototypeTest,
@@ -170,16 +169,10 @@ const { kTimeout } = require('internal/timers');
 const { isArrayBufferView } = require('internal/util/types');
 const { format } = require('internal/util/inspect');
 
-const { FileHandle } = internalBinding('fs');
 const binding = internalBinding('http2');
-const {
-  ShutdownWrap,
-  kReadBytesOrError,
-  streamBaseState
-} = internalBinding('stream_wrap');
-const { UV_EOF } = internalBinding('uv');
+const { ShutdownWrap } = internalBinding('stream_wrap');
+const { UV_ECANCELED } = internalBinding('uv');
 
-const { StreamPipe } = internalBinding('stream_pipe');
 const { _connectionListener: httpConnectionListener } = http;
 let debug = require('internal/util/debuglog').debuglog('http2', (fn) => {
   debug = fn;
@@ -224,6 +217,7 @@ const TLSServer = tls.Server;
 const kAlpnProtocol = Symbol('alpnProtocol');
 const kAuthority = Symbol('authority');
 const kEncrypted = Symbol('encrypted');
+const kFileFd = Symbol('file-fd');
 const kID = Symbol('id');
 const kInit = Symbol('init');
 const kInfoHeaders = Symbol('sent-info-headers');
@@ -2385,21 +2379,20 @@ function processHeaders(oldHeaders, options) {
 }
 
 
-function onFileUnpipe() {
-  const stream = this.sink[kOwner];
-  if (stream.ownsFd)
-    PromisePrototypeCatch(this.source.close(),
-                          FunctionPrototypeBind(stream.destroy, stream));
-  else
-    this.source.releaseFD();
-}
-
-// This is only called once the pipe has returned back control, so
-// it only has to handle errors and End-of-File.
-function onPipedFileHandleRead() {
-  const err = streamBaseState[kReadBytesOrError];
-  if (err < 0 && err !== UV_EOF) {
-    this.stream.close(NGHTTP2_INTERNAL_ERROR);
+// Called by the native file reader of the stream once it no longer uses the
+// file descriptor, either because it has read all of the data, or because
+// reading failed or the stream was destroyed.
+function onFileDone(status) {
+  const stream = this[kOwner];
+  const fd = stream[kFileFd];
+  stream[kFileFd] = undefined;
+  if (status < 0 && status !== UV_ECANCELED)
+    stream.close(NGHTTP2_INTERNAL_ERROR);
+  if (stream.ownsFd) {
+    fs.close(fd, (err) => {
+      if (err)
+        stream.destroy(err);
+    });
   }
 }
 
@@ -2434,13 +2427,15 @@ function processRespondWithFD(self, fd, headers, offset = 0, length = -1,
 }
 
 function startFilePipe(self, fd, offset, length) {
-  const handle = new FileHandle(fd, offset, length);
-  handle.onread = onPipedFileHandleRead;
-  handle.stream = self;
-
-  const pipe = new StreamPipe(handle, self[kHandle]);
-  pipe.onunpipe = onFileUnpipe;
-  pipe.start();
+  // The file is read and sent natively, without passing through JS.
+  const handle = self[kHandle];
+  self[kFileFd] = fd;
+  handle.onfiledone = onFileDone;
+  const ret = handle.sendFD(fd, offset, length);
+  if (ret < 0) {
+    FunctionPrototypeCall(onFileDone, handle, UV_ECANCELED);
+    return;
+  }
 
   // Exact length of the file doesn't matter here, since the
   // stream is closing anyway - just use 1 to signify that
@@ -3321,6 +3316,16 @@ function getUnpackedSettings(buf, options = {}) {
   return settings;
 }
 
+// Limits the memory, in megabytes, that all sessions of the process may use
+// together. Like maxSessionMemory, the limit applies to new streams, header
+// blocks and the growth of adaptive flow control windows.
+function setMemoryBudget(budget) {
+  validateNumber(budget, 'budget');
+  if (!(budget >= 0))
+    throw new ERR_OUT_OF_RANGE('budget', '>= 0', budget);
+  binding.setMemoryBudget(budget * 1e6);
+}
+
 binding.setCallbackFunctions(
   onSessionInternalError,
   onPriority,
@@ -3345,6 +3350,7 @@ module.exports = {
   getPackedSettings,
   getUnpackedSettings,
   sensitiveHeaders: kSensitiveHeaders,
+  setMemoryBudget,
   Http2Session,
   Http2Stream,
   Http2ServerRequest,
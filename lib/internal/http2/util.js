@@ -199,6 +199,9 @@ const IDX_SESSION_STATE_REMOTE_WINDOW_SIZE = 5;
 const IDX_SESSION_STATE_OUTBOUND_QUEUE_SIZE = 6;
 const IDX_SESSION_STATE_HD_DEFLATE_DYNAMIC_TABLE_SIZE = 7;
 const IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE = 8;
+const IDX_SESSION_STATE_MEMORY_USAGE = 9;
+const IDX_SESSION_STATE_TOTAL_MEMORY_USAGE = 10;
+const IDX_SESSION_STATE_ADAPTIVE_WINDOW_SIZE = 11;
 const IDX_STREAM_STATE = 0;
 const IDX_STREAM_STATE_WEIGHT = 1;
 const IDX_STREAM_STATE_SUM_DEPENDENCY_WEIGHT = 2;
@@ -216,7 +219,8 @@ const IDX_OPTIONS_MAX_OUTSTANDING_PINGS = 6;
 const IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS = 7;
 const IDX_OPTIONS_MAX_SESSION_MEMORY = 8;
 const IDX_OPTIONS_MAX_SETTINGS = 9;
-const IDX_OPTIONS_FLAGS = 10;
+const IDX_OPTIONS_ADAPTIVE_WINDOW = 10;
+const IDX_OPTIONS_FLAGS = 11;
 
 function updateOptionsBuffer(options) {
   let flags = 0;
@@ -270,6 +274,10 @@ function updateOptionsBuffer(options) {
     optionsBuffer[IDX_OPTIONS_MAX_SETTINGS] =
       MathMax(1, options.maxSettings);
   }
+  if (typeof options.adaptiveWindow === 'boolean') {
+    flags |= (1 << IDX_OPTIONS_ADAPTIVE_WINDOW);
+    optionsBuffer[IDX_OPTIONS_ADAPTIVE_WINDOW] = options.adaptiveWindow ? 1 : 0;
+  }
   optionsBuffer[IDX_OPTIONS_FLAGS] = flags;
 }
 
@@ -416,7 +424,13 @@ function getSessionState(session) {
     deflateDynamicTableSize:
       sessionState[IDX_SESSION_STATE_HD_DEFLATE_DYNAMIC_TABLE_SIZE],
     inflateDynamicTableSize:
-      sessionState[IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE]
+      sessionState[IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE],
+    memoryUsage:
+      sessionState[IDX_SESSION_STATE_MEMORY_USAGE],
+    totalMemoryUsage:
+      sessionState[IDX_SESSION_STATE_TOTAL_MEMORY_USAGE],
+    adaptiveWindowSize:
+      sessionState[IDX_SESSION_STATE_ADAPTIVE_WINDOW_SIZE]
   };
 }
 
@@ -26,18 +26,25 @@ const {
   ArrayPrototypeForEach,
   ArrayPrototypeMap,
   ArrayPrototypePush,
+  ArrayPrototypeShift,
   Error,
   FunctionPrototypeBind,
+  Int32Array,
+  MathMax,
   MathMaxApply,
   NumberIsFinite,
   NumberIsNaN,
+  ObjectCreate,
   ObjectDefineProperties,
   ObjectDefineProperty,
   ObjectFreeze,
+  ObjectGetOwnPropertyDescriptors,
   ObjectGetPrototypeOf,
   ObjectKeys,
   ObjectSetPrototypeOf,
   ReflectApply,
+  SafeMap,
+  SafeSet,
   StringPrototypeStartsWith,
   Symbol,
   TypedArrayPrototypeFill,
@@ -49,8 +56,12 @@ const {
     ERR_BROTLI_INVALID_PARAM,
     ERR_BUFFER_TOO_LARGE,
     ERR_INVALID_ARG_TYPE,
+    ERR_INVALID_ARG_VALUE,
+    ERR_METHOD_NOT_IMPLEMENTED,
     ERR_OUT_OF_RANGE,
+    ERR_STREAM_WRITE_AFTER_END,
     ERR_ZLIB_INITIALIZATION_FAILED,
+    ERR_ZSTD_INVALID_PARAM,
   },
   hideStackFrames
 } = require('internal/errors');
@@ -70,11 +81,23 @@ const {
 } = require('buffer');
 const { owner_symbol } = require('internal/async_hooks').symbols;
 const {
+  validateArray,
   validateFunction,
+  validateInteger,
+  validateObject,
 } = require('internal/validators');
 
 const kFlushFlag = Symbol('kFlushFlag');
 const kError = Symbol('kError');
+const kHandle = Symbol('kHandle');
+const kSize = Symbol('kSize');
+
+const kDefaultParallelBlockSize = 128 * 1024;
+const kMaxParallelBlockSize = 2 ** 30;
+
+// The size of the window of deflate, which is all that it can make use of.
+const kDefaultDictionarySize = 32 * 1024;
+const kMaxDictionarySize = 2 ** 30;
 
 const constants = internalBinding('constants').zlib;
 const {
@@ -86,10 +109,12 @@ const {
   Z_DEFAULT_STRATEGY, Z_DEFAULT_WINDOWBITS, Z_DEFAULT_MEMLEVEL, Z_FIXED,
   // Node's compression stream modes (node_zlib_mode)
   DEFLATE, DEFLATERAW, INFLATE, INFLATERAW, GZIP, GUNZIP, UNZIP,
-  BROTLI_DECODE, BROTLI_ENCODE,
+  BROTLI_DECODE, BROTLI_ENCODE, ZSTD_COMPRESS, ZSTD_DECOMPRESS,
   // Brotli operations (~flush levels)
   BROTLI_OPERATION_PROCESS, BROTLI_OPERATION_FLUSH,
-  BROTLI_OPERATION_FINISH
+  BROTLI_OPERATION_FINISH,
+  // zstd operations (~flush levels)
+  ZSTD_e_continue, ZSTD_e_flush, ZSTD_e_end,
 } = constants;
 
 // Translation table for return codes.
@@ -245,7 +270,7 @@ function ZlibBase(opts, mode, handle, { flush, finishFlush, fullFlush }) {
   // The ZlibBase class is not exported to user land, the mode should only be
   // passed in by us.
   assert(typeof mode === 'number');
-  assert(mode >= DEFLATE && mode <= BROTLI_ENCODE);
+  assert(mode >= DEFLATE && mode <= ZSTD_DECOMPRESS);
 
   if (opts) {
     chunkSize = opts.chunkSize;
@@ -614,9 +639,74 @@ const zlibDefaultOpts = {
   finishFlush: Z_FINISH,
   fullFlush: Z_FULL_FLUSH
 };
-// Base class for all streams actually backed by zlib and using zlib-specific
-// parameters.
-function Zlib(opts, mode) {
+// A dictionary that is shared by all streams that it is passed to, instead
+// of being copied into each of them.
+class Dictionary {
+  constructor(data) {
+    if (isAnyArrayBuffer(data)) {
+      data = Buffer.from(data);
+    } else if (!isArrayBufferView(data)) {
+      throw new ERR_INVALID_ARG_TYPE(
+        'data',
+        ['Buffer', 'TypedArray', 'DataView', 'ArrayBuffer'],
+        data
+      );
+    }
+    this[kHandle] = new binding.ZlibDictionary(data);
+    this[kSize] = data.byteLength;
+  }
+
+  get size() {
+    return this[kSize];
+  }
+}
+
+function getDictionarySamples(samples, options) {
+  validateArray(samples, 'samples');
+  let size = kDefaultDictionarySize;
+  if (options != null) {
+    validateObject(options, 'options');
+    size = checkRangesOrGetDefault(
+      options.size, 'options.size', 0, kMaxDictionarySize, size);
+  }
+
+  const buffers = ArrayPrototypeMap(samples, (sample, i) => {
+    if (typeof sample === 'string')
+      return Buffer.from(sample);
+    if (isAnyArrayBuffer(sample))
+      return Buffer.from(sample);
+    if (!isArrayBufferView(sample)) {
+      throw new ERR_INVALID_ARG_TYPE(
+        `samples[${i}]`,
+        ['string', 'Buffer', 'TypedArray', 'DataView', 'ArrayBuffer'],
+        sample
+      );
+    }
+    return sample;
+  });
+  return { buffers, size };
+}
+
+function trainDictionary(samples, options, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = undefined;
+  }
+  const { buffers, size } = getDictionarySamples(samples, options);
+  validateFunction(callback, 'callback');
+
+  const job = new binding.TrainDictionaryJob();
+  job.oncomplete = (dictionary) => callback(null, dictionary);
+  job.run(buffers, size);
+}
+
+function trainDictionarySync(samples, options) {
+  const { buffers, size } = getDictionarySamples(samples, options);
+  return binding.trainDictionary(buffers, size);
+}
+
+// Validates the zlib-specific options of a stream and fills in the defaults.
+function getZlibOptions(opts, mode) {
   let windowBits = Z_DEFAULT_WINDOWBITS;
   let level = Z_DEFAULT_COMPRESSION;
   let memLevel = Z_DEFAULT_MEMLEVEL;
@@ -656,16 +746,36 @@ function Zlib(opts, mode) {
     if (dictionary !== undefined && !isArrayBufferView(dictionary)) {
       if (isAnyArrayBuffer(dictionary)) {
         dictionary = Buffer.from(dictionary);
+      } else if (dictionary instanceof Dictionary &&
+                 dictionary[kHandle] !== undefined) {
+        dictionary = dictionary[kHandle];
       } else {
         throw new ERR_INVALID_ARG_TYPE(
           'options.dictionary',
-          ['Buffer', 'TypedArray', 'DataView', 'ArrayBuffer'],
+          ['Buffer', 'TypedArray', 'DataView', 'ArrayBuffer',
+           'zlib.Dictionary'],
           dictionary
         );
       }
     }
   }
 
+  return { windowBits, level, memLevel, strategy, dictionary };
+}
+
+// Base class for all streams actually backed by zlib and using zlib-specific
+// parameters.
+function Zlib(opts, mode) {
+  if (opts?.parallel !== undefined) {
+    throw new ERR_INVALID_ARG_VALUE(
+      'options.parallel', opts.parallel,
+      'is only supported by zlib.createDeflate(), zlib.createGzip(), ' +
+      'zlib.createDeflateRaw() and their asynchronous convenience methods');
+  }
+  const {
+    windowBits, level, memLevel, strategy, dictionary
+  } = getZlibOptions(opts, mode);
+
   const handle = new binding.Zlib(mode);
   // Ideally, we could let ZlibBase() set up _writeState. I haven't been able
   // to come up with a good solution that doesn't break our internal API,
@@ -773,6 +883,312 @@ function Unzip(opts) {
 ObjectSetPrototypeOf(Unzip.prototype, Zlib.prototype);
 ObjectSetPrototypeOf(Unzip, Zlib);
 
+// Compresses the input in blocks of `blockSize` bytes, up to `parallel` of
+// them at a time on the threadpool, and concatenates their output. See
+// DeflateBlockJob in src/node_zlib.cc for how the blocks fit together.
+function ParallelDeflate(opts, mode) {
+  assert(mode === DEFLATE || mode === GZIP || mode === DEFLATERAW);
+  const {
+    windowBits, level, memLevel, strategy, dictionary
+  } = getZlibOptions(opts, mode);
+
+  validateInteger(opts.parallel, 'options.parallel', 1);
+  const blockSize = checkRangesOrGetDefault(
+    opts.blockSize, 'options.blockSize',
+    Z_MIN_CHUNK, kMaxParallelBlockSize, kDefaultParallelBlockSize);
+  const maxOutputLength = checkRangesOrGetDefault(
+    opts.maxOutputLength, 'options.maxOutputLength',
+    1, kMaxLength, kMaxLength);
+
+  if (opts.encoding || opts.objectMode || opts.writableObjectMode) {
+    opts = { ...opts };
+    opts.encoding = null;
+    opts.objectMode = false;
+    opts.writableObjectMode = false;
+  }
+  ReflectApply(Transform, this, [{ autoDestroy: true, ...opts }]);
+
+  this.bytesWritten = 0;
+  this._mode = mode;
+  this._level = level;
+  // Raw deflate streams do not support 256-byte windows; zlib uses 512 bytes
+  // instead in the other formats as well.
+  this._windowBits = windowBits === 8 ? 9 : windowBits;
+  this._memLevel = memLevel;
+  this._strategy = strategy;
+  this._dictionary = mode === GZIP ? undefined : dictionary;
+  this._parallel = opts.parallel;
+  this._blockSize = blockSize;
+  this._defaultFullFlushFlag = Z_FULL_FLUSH;
+  this._info = opts.info;
+  this._maxOutputLength = maxOutputLength;
+
+  // The block that is currently being filled.
+  this._block = null;
+  this._blockLength = 0;
+  // The end of the input before the current block, which primes the
+  // compression of the block.
+  this._window = null;
+  this._firstBlock = true;
+  // Whether the last block has been started, by the end of the input or by
+  // a Z_FINISH flush.
+  this._ended = false;
+  // Blocks that wait for a free slot, and all blocks whose output has not
+  // been pushed yet, in order.
+  this._queue = [];
+  this._results = [];
+  this._running = 0;
+  this._writeCallback = null;
+  this._checksum = 0;
+  this._inputLength = 0;
+}
+
+ObjectDefineProperty(ParallelDeflate.prototype, '_closed', {
+  configurable: true,
+  enumerable: true,
+  get() {
+    return this.destroyed;
+  }
+});
+
+ParallelDeflate.prototype.params = function params(level, strategy, callback) {
+  checkRangesOrGetDefault(level, 'level', Z_MIN_LEVEL, Z_MAX_LEVEL);
+  checkRangesOrGetDefault(strategy, 'strategy', Z_DEFAULT_STRATEGY, Z_FIXED);
+
+  // Blocks pick up the parameters when they start, so the new ones apply to
+  // everything written after the flush.
+  if (this._level !== level || this._strategy !== strategy) {
+    this.flush(Z_SYNC_FLUSH, () => {
+      if (!this.destroyed) {
+        this._level = level;
+        this._strategy = strategy;
+        if (callback) callback();
+      }
+    });
+  } else {
+    process.nextTick(callback);
+  }
+};
+
+ParallelDeflate.prototype.reset = function() {
+  throw new ERR_METHOD_NOT_IMPLEMENTED('reset()');
+};
+
+ParallelDeflate.prototype._processChunk = function() {
+  throw new ERR_METHOD_NOT_IMPLEMENTED('_processChunk()');
+};
+
+ParallelDeflate.prototype._transform = function(chunk, encoding, cb) {
+  if (this._ended) {
+    if (chunk.byteLength > 0)
+      return cb(new ERR_STREAM_WRITE_AFTER_END());
+    return this._afterResults(cb);
+  }
+
+  for (let offset = 0; offset < chunk.byteLength;) {
+    // A full block is only compressed once more input arrives, so that the
+    // last block is known to be the last one.
+    if (this._blockLength === this._blockSize)
+      this._endBlock(false, false);
+    if (this._block === null)
+      this._block = Buffer.allocUnsafe(this._blockSize);
+    const end = offset + this._blockSize - this._blockLength;
+    const copied = chunk.copy(this._block, this._blockLength, offset, end);
+    this._blockLength += copied;
+    offset += copied;
+  }
+
+  const flushFlag = chunk[kFlushFlag];
+  if (flushFlag === Z_FINISH) {
+    this._endBlock(true, false);
+    this._afterResults(cb);
+  } else if (typeof flushFlag === 'number' && flushFlag !== Z_NO_FLUSH) {
+    // Every block ends in a sync flush, so flushing only takes compressing
+    // what is buffered and waiting for the output of all blocks.
+    if (this._blockLength > 0)
+      this._endBlock(false, flushFlag === Z_FULL_FLUSH);
+    else if (flushFlag === Z_FULL_FLUSH)
+      this._window = null;
+    this._afterResults(cb);
+  } else if (this._queue.length > 0) {
+    this._writeCallback = cb;
+  } else {
+    cb();
+  }
+};
+
+ParallelDeflate.prototype._flush = function(callback) {
+  if (!this._ended)
+    this._endBlock(true, false);
+  this._afterResults(callback);
+};
+
+ParallelDeflate.prototype._destroy = function(err, callback) {
+  // Blocks that are already running finish in the background.
+  this._queue = [];
+  this._results = [];
+  callback(err);
+};
+
+ParallelDeflate.prototype._endBlock = function(last, fullFlush) {
+  const input = this._block === null ?
+    Buffer.alloc(0) : this._block.slice(0, this._blockLength);
+  this._block = null;
+  this._blockLength = 0;
+
+  if (last)
+    this._ended = true;
+
+  const block = {
+    first: this._firstBlock,
+    last,
+    input,
+    dictionary: this._firstBlock ? this._dictionary : this._window,
+    output: null,
+    checksum: 0,
+    callbacks: null
+  };
+  this._firstBlock = false;
+  this.bytesWritten += input.byteLength;
+
+  // Nothing before a full flush may be referenced after it.
+  const windowSize = 1 << this._windowBits;
+  if (fullFlush) {
+    this._window = null;
+  } else if (input.byteLength >= windowSize || this._window === null) {
+    this._window = input.slice(MathMax(0, input.byteLength - windowSize));
+  } else {
+    const window = Buffer.concat([this._window, input]);
+    this._window = window.slice(MathMax(0, window.byteLength - windowSize));
+  }
+
+  ArrayPrototypePush(this._results, block);
+  ArrayPrototypePush(this._queue, block);
+  this._startBlocks();
+};
+
+ParallelDeflate.prototype._startBlocks = function() {
+  while (this._running < this._parallel && this._queue.length > 0) {
+    const block = ArrayPrototypeShift(this._queue);
+    const job = new binding.DeflateBlock();
+    job[owner_symbol] = this;
+    job.block = block;
+    job.oncomplete = onDeflateBlockComplete;
+    job.onerror = onDeflateBlockError;
+    this._running++;
+    job.run(this._mode, block.first, block.last, this._level,
+            this._windowBits, this._memLevel, this._strategy,
+            block.input, block.dictionary);
+    block.dictionary = null;
+  }
+
+  if (this._queue.length === 0 && this._writeCallback !== null) {
+    const cb = this._writeCallback;
+    this._writeCallback = null;
+    cb();
+  }
+};
+
+// Calls `callback` once the output of all blocks so far has been pushed.
+ParallelDeflate.prototype._afterResults = function(callback) {
+  if (this._results.length === 0)
+    return callback();
+  const block = this._results[this._results.length - 1];
+  if (block.callbacks === null)
+    block.callbacks = [callback];
+  else
+    ArrayPrototypePush(block.callbacks, callback);
+};
+
+function onDeflateBlockComplete(output, checksum) {
+  const self = this[owner_symbol];
+  this.block.output = output;
+  this.block.checksum = checksum;
+  this.block = null;
+  self._running--;
+  if (self.destroyed)
+    return;
+
+  const results = self._results;
+  while (results.length > 0 && results[0].output !== null) {
+    const block = ArrayPrototypeShift(results);
+    const length = block.input.byteLength;
+    if (block.first) {
+      self._checksum = block.checksum;
+    } else if (self._mode === GZIP) {
+      self._checksum = binding.crc32Combine(self._checksum, block.checksum,
+                                            length);
+    } else if (self._mode === DEFLATE) {
+      self._checksum = binding.adler32Combine(self._checksum, block.checksum,
+                                              length);
+    }
+    self._inputLength += length;
+    self.push(block.output);
+
+    // The output of a single block is a complete stream. Otherwise, the
+    // trailer needs to be added here.
+    if (block.last && !block.first) {
+      if (self._mode === GZIP) {
+        const trailer = Buffer.allocUnsafe(8);
+        trailer.writeUInt32LE(self._checksum, 0);
+        trailer.writeUInt32LE(self._inputLength % 2 ** 32, 4);
+        self.push(trailer);
+      } else if (self._mode === DEFLATE) {
+        const trailer = Buffer.allocUnsafe(4);
+        trailer.writeUInt32BE(self._checksum, 0);
+        self.push(trailer);
+      }
+    }
+
+    if (block.callbacks !== null) {
+      for (let i = 0; i < block.callbacks.length; i++)
+        block.callbacks[i]();
+    }
+    if (self.destroyed)
+      return;
+  }
+  self._startBlocks();
+}
+
+function onDeflateBlockError(message, errno, code) {
+  const self = this[owner_symbol];
+  this.block = null;
+  self._running--;
+  // eslint-disable-next-line no-restricted-syntax
+  const error = new Error(message);
+  error.errno = errno;
+  error.code = code;
+  self.destroy(error);
+}
+
+// The parallel streams are instances of the class that they stand in for,
+// with the methods of ParallelDeflate taking the place of those of Zlib.
+const parallelClasses = new SafeMap();
+for (const { 0: ctor, 1: mode } of [[Deflate, DEFLATE],
+                                     [Gzip, GZIP],
+                                     [DeflateRaw, DEFLATERAW]]) {
+  const ParallelStream = function ParallelStream(opts) {
+    ReflectApply(ParallelDeflate, this, [opts, mode]);
+  };
+  ParallelStream.prototype = ObjectCreate(
+    ctor.prototype, ObjectGetOwnPropertyDescriptors(ParallelDeflate.prototype));
+  ObjectDefineProperty(ParallelStream.prototype, 'constructor', {
+    configurable: true,
+    enumerable: false,
+    writable: true,
+    value: ctor
+  });
+  parallelClasses.set(ctor, ParallelStream);
+}
+
+// Streams created through the factory functions and the asynchronous
+// convenience methods compress in parallel if `options.parallel` is set.
+function createEngine(ctor, opts) {
+  if (opts?.parallel !== undefined && parallelClasses.has(ctor))
+    return new (parallelClasses.get(ctor))(opts);
+  return new ctor(opts);
+}
+
 function createConvenienceMethod(ctor, sync) {
   if (sync) {
     return function syncBufferWrapper(buffer, opts) {
@@ -784,7 +1200,7 @@ function createConvenienceMethod(ctor, sync) {
       callback = opts;
       opts = {};
     }
-    return zlibBuffer(new ctor(opts), buffer, callback);
+    return zlibBuffer(createEngine(ctor, opts), buffer, callback);
   };
 }
 
@@ -858,12 +1274,86 @@ ObjectSetPrototypeOf(BrotliDecompress.prototype, Brotli.prototype);
 ObjectSetPrototypeOf(BrotliDecompress, Brotli);
 
 
+function getConstantValues(prefix) {
+  const values = new SafeSet();
+  for (const key of ObjectKeys(constants)) {
+    if (StringPrototypeStartsWith(key, prefix))
+      values.add(constants[key]);
+  }
+  return values;
+}
+
+const zstdCompressParams = getConstantValues('ZSTD_c_');
+const zstdDecompressParams = getConstantValues('ZSTD_d_');
+
+const zstdDefaultOpts = {
+  flush: ZSTD_e_continue,
+  finishFlush: ZSTD_e_end,
+  fullFlush: ZSTD_e_flush
+};
+function Zstd(opts, mode) {
+  assert(mode === ZSTD_COMPRESS || mode === ZSTD_DECOMPRESS);
+
+  const validParams =
+    mode === ZSTD_COMPRESS ? zstdCompressParams : zstdDecompressParams;
+  // Pairs of keys and values, in the order in which they were passed.
+  const initParams = [];
+  if (opts?.params) {
+    const seen = new SafeSet();
+    ArrayPrototypeForEach(ObjectKeys(opts.params), (origKey) => {
+      const key = +origKey;
+      if (!validParams.has(key) || seen.has(key)) {
+        throw new ERR_ZSTD_INVALID_PARAM(origKey);
+      }
+      seen.add(key);
+
+      const value = opts.params[origKey];
+      if (typeof value !== 'number' && typeof value !== 'boolean') {
+        throw new ERR_INVALID_ARG_TYPE('options.params[key]',
+                                       'number', opts.params[origKey]);
+      }
+      ArrayPrototypePush(initParams, key, value);
+    });
+  }
+
+  const handle = mode === ZSTD_COMPRESS ?
+    new binding.ZstdCompress(mode) : new binding.ZstdDecompress(mode);
+
+  this._writeState = new Uint32Array(2);
+  if (!handle.init(new Int32Array(initParams),
+                   this._writeState,
+                   processCallback)) {
+    throw new ERR_ZLIB_INITIALIZATION_FAILED();
+  }
+
+  ReflectApply(ZlibBase, this, [opts, mode, handle, zstdDefaultOpts]);
+}
+ObjectSetPrototypeOf(Zstd.prototype, Zlib.prototype);
+ObjectSetPrototypeOf(Zstd, Zlib);
+
+function ZstdCompress(opts) {
+  if (!(this instanceof ZstdCompress))
+    return new ZstdCompress(opts);
+  ReflectApply(Zstd, this, [opts, ZSTD_COMPRESS]);
+}
+ObjectSetPrototypeOf(ZstdCompress.prototype, Zstd.prototype);
+ObjectSetPrototypeOf(ZstdCompress, Zstd);
+
+function ZstdDecompress(opts) {
+  if (!(this instanceof ZstdDecompress))
+    return new ZstdDecompress(opts);
+  ReflectApply(Zstd, this, [opts, ZSTD_DECOMPRESS]);
+}
+ObjectSetPrototypeOf(ZstdDecompress.prototype, Zstd.prototype);
+ObjectSetPrototypeOf(ZstdDecompress, Zstd);
+
+
 function createProperty(ctor) {
   return {
     configurable: true,
     enumerable: true,
     value: function(options) {
-      return new ctor(options);
+      return createEngine(ctor, options);
     }
   };
 }
@@ -885,6 +1375,11 @@ module.exports = {
   Unzip,
   BrotliCompress,
   BrotliDecompress,
+  ZstdCompress,
+  ZstdDecompress,
+  Dictionary,
+  trainDictionary,
+  trainDictionarySync,
 
   // Convenience methods.
   // compress/decompress a string or buffer in one step.
@@ -906,6 +1401,10 @@ module.exports = {
   brotliCompressSync: createConvenienceMethod(BrotliCompress, true),
   brotliDecompress: createConvenienceMethod(BrotliDecompress, false),
   brotliDecompressSync: createConvenienceMethod(BrotliDecompress, true),
+  zstdCompress: createConvenienceMethod(ZstdCompress, false),
+  zstdCompressSync: createConvenienceMethod(ZstdCompress, true),
+  zstdDecompress: createConvenienceMethod(ZstdDecompress, false),
+  zstdDecompressSync: createConvenienceMethod(ZstdDecompress, true),
 };
 
 ObjectDefineProperties(module.exports, {
@@ -918,6 +1417,8 @@ ObjectDefineProperties(module.exports, {
   createUnzip: createProperty(Unzip),
   createBrotliCompress: createProperty(BrotliCompress),
   createBrotliDecompress: createProperty(BrotliDecompress),
+  createZstdCompress: createProperty(ZstdCompress),
+  createZstdDecompress: createProperty(ZstdDecompress),
   constants: {
     configurable: false,
     enumerable: true,
@@ -933,7 +1434,8 @@ ObjectDefineProperties(module.exports, {
 // These should be considered deprecated
 // expose all the zlib constants
 for (const bkey of ObjectKeys(constants)) {
-  if (StringPrototypeStartsWith(bkey, 'BROTLI')) continue;
+  if (StringPrototypeStartsWith(bkey, 'BROTLI') ||
+      StringPrototypeStartsWith(bkey, 'ZSTD')) continue;
   ObjectDefineProperty(module.exports, bkey, {
     enumerable: false, value: constants[bkey], writable: false
   });
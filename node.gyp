@@ -16,6 +16,7 @@
     'node_module_version%': '',
     'node_shared_brotli%': 'false',
     'node_shared_zlib%': 'false',
+    'node_shared_zstd%': 'false',
     'node_shared_http_parser%': 'false',
     'node_shared_cares%': 'false',
     'node_shared_libuv%': 'false',
@@ -584,14 +585,17 @@
         'src/api/hooks.cc',
         'src/api/utils.cc',
         'src/async_wrap.cc',
+        'src/base64.cc',
         'src/cares_wrap.cc',
         'src/connect_wrap.cc',
         'src/connection_wrap.cc',
         'src/debug_utils.cc',
+        'src/dictionary_trainer.cc',
         'src/env.cc',
         'src/fs_event_wrap.cc',
         'src/handle_wrap.cc',
         'src/heap_utils.cc',
+        'src/hex.cc',
         'src/histogram.cc',
         'src/js_native_api.h',
         'src/js_native_api_types.h',
@@ -616,6 +620,8 @@
         'src/node_errors.cc',
         'src/node_external_reference.cc',
         'src/node_file.cc',
+        'src/node_file_uring.cc',
+        'src/node_http_common.cc',
         'src/node_http_parser.cc',
         'src/node_http2.cc',
         'src/node_i18n.cc',
@@ -636,6 +642,7 @@
         'src/node_report_module.cc',
         'src/node_report_utils.cc',
         'src/node_serdes.cc',
+        'src/node_simd.cc',
         'src/node_snapshotable.cc',
         'src/node_sockaddr.cc',
         'src/node_stat_watcher.cc',
@@ -644,6 +651,7 @@
         'src/node_trace_events.cc',
         'src/node_types.cc',
         'src/node_url.cc',
+        'src/node_utf8.cc',
         'src/node_util.cc',
         'src/node_v8.cc',
         'src/node_wasi.cc',
@@ -653,12 +661,14 @@
         'src/pipe_wrap.cc',
         'src/process_wrap.cc',
         'src/signal_wrap.cc',
+        'src/slab_allocator.cc',
         'src/spawn_sync.cc',
         'src/stream_base.cc',
         'src/stream_pipe.cc',
         'src/stream_wrap.cc',
         'src/string_bytes.cc',
         'src/string_decoder.cc',
+        'src/string_search.cc',
         'src/tcp_wrap.cc',
         'src/timers.cc',
         'src/timer_wrap.cc',
@@ -689,9 +699,11 @@
         'src/connection_wrap.h',
         'src/debug_utils.h',
         'src/debug_utils-inl.h',
+        'src/dictionary_trainer.h',
         'src/env.h',
         'src/env-inl.h',
         'src/handle_wrap.h',
+        'src/hex.h',
         'src/histogram.h',
         'src/histogram-inl.h',
         'src/js_stream.h',
@@ -715,6 +727,7 @@
         'src/node_external_reference.h',
         'src/node_file.h',
         'src/node_file-inl.h',
+        'src/node_file_uring.h',
         'src/node_http_common.h',
         'src/node_http_common-inl.h',
         'src/node_http2.h',
@@ -739,12 +752,14 @@
         'src/node_report.h',
         'src/node_revert.h',
         'src/node_root_certs.h',
+        'src/node_simd.h',
         'src/node_snapshotable.h',
         'src/node_sockaddr.h',
         'src/node_sockaddr-inl.h',
         'src/node_stat_watcher.h',
         'src/node_union_bytes.h',
         'src/node_url.h',
+        'src/node_utf8.h',
         'src/node_version.h',
         'src/node_v8.h',
         'src/node_v8_platform-inl.h',
@@ -754,6 +769,7 @@
         'src/pipe_wrap.h',
         'src/req_wrap.h',
         'src/req_wrap-inl.h',
+        'src/slab_allocator.h',
         'src/spawn_sync.h',
         'src/stream_base.h',
         'src/stream_base-inl.h',
@@ -1320,16 +1336,21 @@
         'test/cctest/test_aliased_buffer.cc',
         'test/cctest/test_base64.cc',
         'test/cctest/test_base_object_ptr.cc',
+        'test/cctest/test_dictionary_trainer.cc',
         'test/cctest/test_node_postmortem_metadata.cc',
         'test/cctest/test_environment.cc',
+        'test/cctest/test_hex.cc',
+        'test/cctest/test_http_common.cc',
         'test/cctest/test_linked_binding.cc',
         'test/cctest/test_per_process.cc',
         'test/cctest/test_platform.cc',
         'test/cctest/test_json_utils.cc',
+        'test/cctest/test_slab_allocator.cc',
         'test/cctest/test_sockaddr.cc',
         'test/cctest/test_traced_value.cc',
         'test/cctest/test_util.cc',
         'test/cctest/test_url.cc',
+        'test/cctest/test_utf8.cc',
       ],
 
       'conditions': [
@@ -55,6 +55,35 @@ bool base64_decode_group_slow(char* const dst, const size_t dstlen,
 }
 
 
+// Only one-byte characters are decoded with vector instructions.
+template <typename TypeName>
+inline size_t base64_decode_prefix(char* const dst, const size_t dstlen,
+                                   const TypeName* const src,
+                                   const size_t srclen,
+                                   size_t* const written) {
+  *written = 0;
+  return 0;
+}
+
+
+inline size_t base64_decode_prefix(char* const dst, const size_t dstlen,
+                                   const char* const src,
+                                   const size_t srclen,
+                                   size_t* const written) {
+  return base64_decode_simd(dst, dstlen,
+                            reinterpret_cast<const uint8_t*>(src), srclen,
+                            written);
+}
+
+
+inline size_t base64_decode_prefix(char* const dst, const size_t dstlen,
+                                   const uint8_t* const src,
+                                   const size_t srclen,
+                                   size_t* const written) {
+  return base64_decode_simd(dst, dstlen, src, srclen, written);
+}
+
+
 template <typename TypeName>
 size_t base64_decode_fast(char* const dst, const size_t dstlen,
                           const TypeName* const src, const size_t srclen,
@@ -62,8 +91,8 @@ size_t base64_decode_fast(char* const dst, const size_t dstlen,
   const size_t available = dstlen < decoded_size ? dstlen : decoded_size;
   const size_t max_k = available / 3 * 3;
   size_t max_i = srclen / 4 * 4;
-  size_t i = 0;
-  size_t k = 0;
+  size_t k;
+  size_t i = base64_decode_prefix(dst, available, src, srclen, &k);
   while (i < max_i && k < max_k) {
     const unsigned char txt[] = {
       static_cast<unsigned char>(unbase64(src[i + 0])),
@@ -136,8 +165,8 @@ inline size_t base64_encode(const char* src,
 
   const char* table = base64_select_table(mode);
 
-  i = 0;
-  k = 0;
+  i = static_cast<unsigned>(base64_encode_simd(src, slen, dst, mode));
+  k = i / 3 * 4;
   n = slen / 3 * 3;
 
   while (i < n) {
@@ -0,0 +1,371 @@
+#include "base64-inl.h"
+#include "node_simd.h"
+
+#if defined(NODE_SIMD_X86)
+#include <immintrin.h>
+#elif defined(NODE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+// Vectorized kernels for the bulk of base64 encoding and decoding. They stop
+// at the first block that they cannot handle (whitespace, padding, invalid
+// characters, or the end of the input) and leave everything from there on to
+// the scalar code in base64-inl.h, which implements the exact semantics.
+//
+// The x86 kernels follow W. Muła and D. Lemire, "Faster Base64 Encoding and
+// Decoding using AVX2 Instructions" (ACM TOW 2018).
+
+namespace node {
+
+namespace {
+
+#if defined(NODE_SIMD_X86)
+
+// Offsets that turn 6-bit values into characters, indexed by the value
+// reduced to 0 (26-51), 1-10 (52-61), 11 (62), 12 (63) or 13 (0-25).
+#define BASE64_ENCODE_SHIFT_LUT(c62, c63)                                     \
+  'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,       \
+  '0' - 52, '0' - 52, '0' - 52, '0' - 52, (c62) - 62, (c63) - 63, 'A', 0, 0
+
+// The decoding tables classify characters by their high and low nibble:
+// a character is invalid if the bits that the two tables return for it
+// overlap. The roll table gives the offset that turns a valid character into
+// its 6-bit value, indexed by its high nibble plus an adjustment for the one
+// character that shares its high nibble with others but needs a different
+// offset ('/' for the standard alphabet, '_' for the URL-safe one).
+struct DecodeTables {
+  int8_t lo[16];
+  int8_t hi[16];
+  int8_t roll[16];
+  char special;
+  int8_t special_adjust;
+};
+
+constexpr DecodeTables kStandardTables = {
+  { 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A },
+  { 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 },
+  { 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 },
+  '/',
+  -1
+};
+
+constexpr DecodeTables kURLTables = {
+  { 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x13, 0x3B, 0x3B, 0x3A, 0x3B, 0x33 },
+  { 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x20,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 },
+  { 0, 0, 17, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, -32, 0, 0 },
+  '_',
+  8
+};
+
+NODE_TARGET_SSE41
+inline __m128i LoadTable(const int8_t* table) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+}
+
+NODE_TARGET_SSE41
+size_t EncodeSSE41(const char* src, size_t slen, char* dst, Base64Mode mode) {
+  const __m128i shift_lut = mode == Base64Mode::NORMAL ?
+      _mm_setr_epi8(BASE64_ENCODE_SHIFT_LUT('+', '/')) :
+      _mm_setr_epi8(BASE64_ENCODE_SHIFT_LUT('-', '_'));
+  const __m128i shuffle =
+      _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+  size_t i = 0;
+  size_t k = 0;
+  // Every iteration reads 16 bytes, of which it encodes 12.
+  for (; i + 16 <= slen; i += 12, k += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    in = _mm_shuffle_epi8(in, shuffle);
+    // Move the four 6-bit fields of each 3-byte group into separate bytes.
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    reduced = _mm_or_si128(reduced, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const __m128i out =
+        _mm_add_epi8(_mm_shuffle_epi8(shift_lut, reduced), indices);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k), out);
+  }
+  return i;
+}
+
+NODE_TARGET_AVX2
+size_t EncodeAVX2(const char* src, size_t slen, char* dst, Base64Mode mode) {
+  const __m256i shift_lut = mode == Base64Mode::NORMAL ?
+      _mm256_setr_epi8(BASE64_ENCODE_SHIFT_LUT('+', '/'),
+                       BASE64_ENCODE_SHIFT_LUT('+', '/')) :
+      _mm256_setr_epi8(BASE64_ENCODE_SHIFT_LUT('-', '_'),
+                       BASE64_ENCODE_SHIFT_LUT('-', '_'));
+  const __m256i shuffle =
+      _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                       1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+  size_t i = 0;
+  size_t k = 0;
+  // Every iteration reads 28 bytes, of which it encodes 24, 12 per lane.
+  for (; i + 28 <= slen; i += 24, k += 32) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    in = _mm256_shuffle_epi8(in, shuffle);
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t1, t3);
+
+    __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    reduced =
+        _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    const __m256i out =
+        _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, reduced), indices);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k), out);
+  }
+  return i;
+}
+
+// Translates 16 characters into their 6-bit values. Returns false if any of
+// them is not part of the alphabet that `tables` describes.
+NODE_TARGET_SSE41
+inline bool TranslateSSE41(__m128i in,
+                           const DecodeTables& tables,
+                           __m128i* values) {
+  const __m128i mask_2f = _mm_set1_epi8(0x2f);
+  const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+  const __m128i lo_nibbles = _mm_and_si128(in, mask_2f);
+  const __m128i lo = _mm_shuffle_epi8(LoadTable(tables.lo), lo_nibbles);
+  const __m128i hi = _mm_shuffle_epi8(LoadTable(tables.hi), hi_nibbles);
+  if (!_mm_testz_si128(lo, hi))
+    return false;
+
+  const __m128i special =
+      _mm_and_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8(tables.special)),
+                    _mm_set1_epi8(tables.special_adjust));
+  const __m128i roll = _mm_shuffle_epi8(LoadTable(tables.roll),
+                                        _mm_add_epi8(special, hi_nibbles));
+  *values = _mm_add_epi8(in, roll);
+  return true;
+}
+
+NODE_TARGET_SSE41
+size_t DecodeSSE41(char* dst, size_t dstlen,
+                   const uint8_t* src, size_t srclen,
+                   size_t* written) {
+  size_t i = 0;
+  size_t k = 0;
+  // Every iteration decodes 16 characters into 12 bytes, but stores 16.
+  for (; i + 16 <= srclen && k + 16 <= dstlen; i += 16, k += 12) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i values;
+    if (!TranslateSSE41(in, kStandardTables, &values) &&
+        !TranslateSSE41(in, kURLTables, &values)) {
+      break;
+    }
+
+    // Pack the four 6-bit values of each group into three bytes.
+    const __m128i merged =
+        _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i packed =
+        _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    const __m128i out = _mm_shuffle_epi8(packed, _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k), out);
+  }
+  *written = k;
+  return i;
+}
+
+NODE_TARGET_AVX2
+inline __m256i LoadTableAVX2(const int8_t* table) {
+  return _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+NODE_TARGET_AVX2
+inline bool TranslateAVX2(__m256i in,
+                          const DecodeTables& tables,
+                          __m256i* values) {
+  const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+  const __m256i hi_nibbles =
+      _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2f);
+  const __m256i lo_nibbles = _mm256_and_si256(in, mask_2f);
+  const __m256i lo = _mm256_shuffle_epi8(LoadTableAVX2(tables.lo), lo_nibbles);
+  const __m256i hi = _mm256_shuffle_epi8(LoadTableAVX2(tables.hi), hi_nibbles);
+  if (!_mm256_testz_si256(lo, hi))
+    return false;
+
+  const __m256i special = _mm256_and_si256(
+      _mm256_cmpeq_epi8(in, _mm256_set1_epi8(tables.special)),
+      _mm256_set1_epi8(tables.special_adjust));
+  const __m256i roll = _mm256_shuffle_epi8(
+      LoadTableAVX2(tables.roll), _mm256_add_epi8(special, hi_nibbles));
+  *values = _mm256_add_epi8(in, roll);
+  return true;
+}
+
+NODE_TARGET_AVX2
+size_t DecodeAVX2(char* dst, size_t dstlen,
+                  const uint8_t* src, size_t srclen,
+                  size_t* written) {
+  size_t i = 0;
+  size_t k = 0;
+  // Every iteration decodes 32 characters into 24 bytes, but stores 32.
+  for (; i + 32 <= srclen && k + 32 <= dstlen; i += 32, k += 24) {
+    const __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i values;
+    if (!TranslateAVX2(in, kStandardTables, &values) &&
+        !TranslateAVX2(in, kURLTables, &values)) {
+      break;
+    }
+
+    const __m256i merged =
+        _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    const __m256i packed =
+        _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+    __m256i out = _mm256_shuffle_epi8(packed, _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    // Move the 12 bytes of the upper lane next to those of the lower one.
+    out = _mm256_permutevar8x32_epi32(
+        out, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k), out);
+  }
+  *written = k;
+  return i;
+}
+
+#undef BASE64_ENCODE_SHIFT_LUT
+
+#elif defined(NODE_SIMD_NEON)
+
+inline uint8x16x4_t LoadTableNEON(const uint8_t* table) {
+  uint8x16x4_t result;
+  result.val[0] = vld1q_u8(table);
+  result.val[1] = vld1q_u8(table + 16);
+  result.val[2] = vld1q_u8(table + 32);
+  result.val[3] = vld1q_u8(table + 48);
+  return result;
+}
+
+size_t EncodeNEON(const char* src, size_t slen, char* dst, Base64Mode mode) {
+  const uint8x16x4_t table = LoadTableNEON(
+      reinterpret_cast<const uint8_t*>(base64_select_table(mode)));
+  const uint8x16_t mask = vdupq_n_u8(0x3f);
+
+  size_t i = 0;
+  size_t k = 0;
+  // Every iteration encodes 48 bytes into 64 characters.
+  for (; i + 48 <= slen; i += 48, k += 64) {
+    const uint8x16x3_t in =
+        vld3q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    uint8x16x4_t indices;
+    indices.val[0] = vshrq_n_u8(in.val[0], 2);
+    indices.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4),
+                                       vshrq_n_u8(in.val[1], 4)), mask);
+    indices.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2),
+                                       vshrq_n_u8(in.val[2], 6)), mask);
+    indices.val[3] = vandq_u8(in.val[2], mask);
+
+    uint8x16x4_t out;
+    out.val[0] = vqtbl4q_u8(table, indices.val[0]);
+    out.val[1] = vqtbl4q_u8(table, indices.val[1]);
+    out.val[2] = vqtbl4q_u8(table, indices.val[2]);
+    out.val[3] = vqtbl4q_u8(table, indices.val[3]);
+    vst4q_u8(reinterpret_cast<uint8_t*>(dst + k), out);
+  }
+  return i;
+}
+
+size_t DecodeNEON(char* dst, size_t dstlen,
+                  const uint8_t* src, size_t srclen,
+                  size_t* written) {
+  // unbase64_table accepts both alphabets and maps everything else, including
+  // whitespace, to negative values. Characters >= 128 are checked separately.
+  const uint8_t* table = reinterpret_cast<const uint8_t*>(unbase64_table);
+  const uint8x16x4_t table_lo = LoadTableNEON(table);
+  const uint8x16x4_t table_hi = LoadTableNEON(table + 64);
+  const uint8x16_t offset = vdupq_n_u8(64);
+
+  size_t i = 0;
+  size_t k = 0;
+  // Every iteration decodes 64 characters into 48 bytes.
+  for (; i + 64 <= srclen && k + 48 <= dstlen; i += 64, k += 48) {
+    const uint8x16x4_t in = vld4q_u8(src + i);
+    uint8x16_t values[4];
+    uint8x16_t error = vdupq_n_u8(0);
+    for (int j = 0; j < 4; j++) {
+      values[j] = vqtbx4q_u8(vqtbl4q_u8(table_lo, in.val[j]),
+                             table_hi,
+                             vsubq_u8(in.val[j], offset));
+      error = vorrq_u8(error, vorrq_u8(values[j],
+                                       vandq_u8(in.val[j], vdupq_n_u8(0x80))));
+    }
+    if (vmaxvq_u8(error) >= 64)
+      break;
+
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(vshlq_n_u8(values[0], 2), vshrq_n_u8(values[1], 4));
+    out.val[1] = vorrq_u8(vshlq_n_u8(values[1], 4), vshrq_n_u8(values[2], 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(values[2], 6), values[3]);
+    vst3q_u8(reinterpret_cast<uint8_t*>(dst + k), out);
+  }
+  *written = k;
+  return i;
+}
+
+#endif  // defined(NODE_SIMD_NEON)
+
+}  // anonymous namespace
+
+size_t base64_encode_simd(const char* src,
+                          size_t slen,
+                          char* dst,
+                          Base64Mode mode) {
+  size_t i = 0;
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kAVX2))
+    i = EncodeAVX2(src, slen, dst, mode);
+  if (simd::Supports(simd::kSSE41))
+    i += EncodeSSE41(src + i, slen - i, dst + i / 3 * 4, mode);
+#elif defined(NODE_SIMD_NEON)
+  i = EncodeNEON(src, slen, dst, mode);
+#endif
+  return i;
+}
+
+size_t base64_decode_simd(char* dst,
+                          size_t dstlen,
+                          const uint8_t* src,
+                          size_t srclen,
+                          size_t* written) {
+  size_t i = 0;
+  size_t k = 0;
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kAVX2))
+    i = DecodeAVX2(dst, dstlen, src, srclen, &k);
+  if (simd::Supports(simd::kSSE41)) {
+    size_t n;
+    i += DecodeSSE41(dst + k, dstlen - k, src + i, srclen - i, &n);
+    k += n;
+  }
+#elif defined(NODE_SIMD_NEON)
+  i = DecodeNEON(dst, dstlen, src, srclen, &k);
+#endif
+  *written = k;
+  return i;
+}
+
+}  // namespace node
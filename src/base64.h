@@ -61,6 +61,26 @@ inline size_t base64_encode(const char* src,
                             char* dst,
                             size_t dlen,
                             Base64Mode mode = Base64Mode::NORMAL);
+
+// Vectorized encoding of a prefix of `src`, implemented in base64.cc for the
+// instruction sets that the CPU supports. Returns the number of bytes of
+// `src` that have been encoded, a multiple of 3 that may be 0. The output
+// for them fills `dst` up to `return value / 3 * 4`.
+size_t base64_encode_simd(const char* src,
+                          size_t slen,
+                          char* dst,
+                          Base64Mode mode);
+
+// Vectorized decoding of a prefix of `src`. Characters from both alphabets
+// are accepted. It stops before the first block of characters that contains
+// anything else, which is then left to the scalar code. Returns the number
+// of characters consumed, a multiple of 4, and sets `*written` to the number
+// of bytes written to `dst`.
+size_t base64_decode_simd(char* dst,
+                          size_t dstlen,
+                          const uint8_t* src,
+                          size_t srclen,
+                          size_t* written);
 }  // namespace node
 
 
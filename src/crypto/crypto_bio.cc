@@ -33,6 +33,92 @@
 namespace node {
 namespace crypto {
 
+NodeBIOPool::NodeBIOPool(Environment* env) : env_(env) {}
+
+
+NodeBIOPool::~NodeBIOPool() {
+  Detach();
+}
+
+
+void NodeBIOPool::Detach() {
+  if (env_ == nullptr)
+    return;
+  for (std::vector<char*>& free_list : free_lists_) {
+    for (char* data : free_list)
+      delete[] data;
+    free_list.clear();
+  }
+  const int64_t size = static_cast<int64_t>(pooled_bytes_ + in_use_bytes_);
+  env_->isolate()->AdjustAmountOfExternalAllocatedMemory(-size);
+  pooled_bytes_ = 0;
+  env_ = nullptr;
+}
+
+
+bool NodeBIOPool::GetSizeClass(size_t size, size_t* index) {
+  size_t chunk_size = kMinChunkSize;
+  for (size_t i = 0; i < kSizeClassCount; i++, chunk_size *= 2) {
+    if (size <= chunk_size) {
+      *index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+char* NodeBIOPool::Allocate(size_t* size) {
+  CHECK_NOT_NULL(env_);
+  size_t index;
+  if (GetSizeClass(*size, &index)) {
+    *size = kMinChunkSize << index;
+    std::vector<char*>& free_list = free_lists_[index];
+    if (!free_list.empty()) {
+      char* data = free_list.back();
+      free_list.pop_back();
+      pooled_bytes_ -= *size;
+      in_use_bytes_ += *size;
+      return data;
+    }
+  }
+
+  char* data = new char[*size];
+  in_use_bytes_ += *size;
+  env_->isolate()->AdjustAmountOfExternalAllocatedMemory(*size);
+  return data;
+}
+
+
+void NodeBIOPool::Free(char* data, size_t size) {
+  CHECK_LE(size, in_use_bytes_);
+  in_use_bytes_ -= size;
+
+  if (env_ == nullptr) {
+    delete[] data;
+    return;
+  }
+
+  size_t index;
+  if (GetSizeClass(size, &index) &&
+      pooled_bytes_ + size <= kMaxPooledBytes) {
+    CHECK_EQ(size, kMinChunkSize << index);
+    free_lists_[index].push_back(data);
+    pooled_bytes_ += size;
+    return;
+  }
+
+  delete[] data;
+  const int64_t len = static_cast<int64_t>(size);
+  env_->isolate()->AdjustAmountOfExternalAllocatedMemory(-len);
+}
+
+
+void NodeBIOPool::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("pooled_chunks", pooled_bytes_);
+}
+
+
 BIOPointer NodeBIO::New(Environment* env) {
   BIOPointer bio(BIO_new(GetMethod()));
   if (bio && env != nullptr)
@@ -96,6 +182,11 @@ int NodeBIO::Read(BIO* bio, char* out, int len) {
 
 
 char* NodeBIO::Peek(size_t* size) {
+  // The buffers may have been released while the BIO was empty.
+  if (read_head_ == nullptr) {
+    *size = 0;
+    return nullptr;
+  }
   *size = read_head_->write_pos_ - read_head_->read_pos_;
   return read_head_->data_ + read_head_->read_pos_;
 }
@@ -106,6 +197,11 @@ size_t NodeBIO::PeekMultiple(char** out, size_t* size, size_t* count) {
   size_t max = *count;
   size_t total = 0;
 
+  if (pos == nullptr) {
+    *count = 0;
+    return 0;
+  }
+
   size_t i;
   for (i = 0; i < max; i++) {
     size[i] = pos->write_pos_ - pos->read_pos_;
@@ -448,7 +544,10 @@ void NodeBIO::TryAllocateForWrite(size_t hint) {
       allocate_hint_ = 0;
     }
 
-    Buffer* next = new Buffer(env_, len);
+    std::shared_ptr<NodeBIOPool> pool;
+    if (env_ != nullptr)
+      pool = env_->nodebio_pool();
+    Buffer* next = new Buffer(std::move(pool), len);
 
     if (w == nullptr) {
       next->next_ = next;
@@ -480,7 +579,18 @@ void NodeBIO::Reset() {
 }
 
 
+void NodeBIO::ReleaseIfEmpty() {
+  if (length_ == 0)
+    FreeAll();
+}
+
+
 NodeBIO::~NodeBIO() {
+  FreeAll();
+}
+
+
+void NodeBIO::FreeAll() {
   if (read_head_ == nullptr)
     return;
 
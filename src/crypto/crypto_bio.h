@@ -29,11 +29,63 @@
 #include "util.h"
 #include "v8.h"
 
+#include <memory>
+#include <vector>
+
 namespace node {
 
 class Environment;
 
 namespace crypto {
+// Recycles the memory chunks of the NodeBIOs of an Environment. Chunks of
+// the sizes that TLS connections usually use are kept in free lists when a
+// connection no longer needs them, so that the next connection does not have
+// to allocate new ones. V8 is only informed about memory that is actually
+// allocated or freed, not about every chunk that changes hands.
+class NodeBIOPool : public MemoryRetainer {
+ public:
+  explicit NodeBIOPool(Environment* env);
+  ~NodeBIOPool() override;
+
+  // Returns a chunk of at least `*size` bytes and updates `*size` to the
+  // actual size of the chunk.
+  char* Allocate(size_t* size);
+
+  // Gives back a chunk that was returned by Allocate().
+  void Free(char* data, size_t size);
+
+  // Called when the Environment is destroyed. The NodeBIOs that still use
+  // chunks keep the pool alive, and the chunks are deleted once they are
+  // given back.
+  void Detach();
+
+  // Bytes in chunks that are currently used by NodeBIOs.
+  size_t in_use_bytes() const { return in_use_bytes_; }
+  // Bytes in chunks that are kept for reuse.
+  size_t pooled_bytes() const { return pooled_bytes_; }
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(NodeBIOPool)
+  SET_SELF_SIZE(NodeBIOPool)
+
+  NodeBIOPool(const NodeBIOPool&) = delete;
+  NodeBIOPool& operator=(const NodeBIOPool&) = delete;
+
+ private:
+  // Chunks of 1 KiB, 2 KiB, ..., 64 KiB are pooled.
+  static constexpr size_t kMinChunkSize = 1024;
+  static constexpr size_t kSizeClassCount = 7;
+  // Limit for the memory that is kept in the free lists.
+  static constexpr size_t kMaxPooledBytes = 4 * 1024 * 1024;
+
+  static bool GetSizeClass(size_t size, size_t* index);
+
+  Environment* env_;
+  std::vector<char*> free_lists_[kSizeClassCount];
+  size_t in_use_bytes_ = 0;
+  size_t pooled_bytes_ = 0;
+};
+
 // This class represents buffers for OpenSSL I/O, implemented as a singly-linked
 // list of chunks. It can be used either for writing data from Node to OpenSSL,
 // or for reading data back, but not both.
@@ -78,6 +130,10 @@ class NodeBIO : public MemoryRetainer {
   // Discard all available data
   void Reset();
 
+  // Free all chunks if there is no data in the BIO, e.g. because the
+  // connection is idle. They are allocated again once needed.
+  void ReleaseIfEmpty();
+
   // Put `len` bytes from `data` into buffer
   void Write(const char* data, size_t size);
 
@@ -132,6 +188,8 @@ class NodeBIO : public MemoryRetainer {
   SET_SELF_SIZE(NodeBIO)
 
  private:
+  void FreeAll();
+
   static int New(BIO* bio);
   static int Free(BIO* bio);
   static int Read(BIO* bio, char* out, int len);
@@ -149,25 +207,26 @@ class NodeBIO : public MemoryRetainer {
 
   class Buffer {
    public:
-    Buffer(Environment* env, size_t len) : env_(env),
-                                           read_pos_(0),
-                                           write_pos_(0),
-                                           len_(len),
-                                           next_(nullptr) {
-      data_ = new char[len];
-      if (env_ != nullptr)
-        env_->isolate()->AdjustAmountOfExternalAllocatedMemory(len);
+    Buffer(std::shared_ptr<NodeBIOPool> pool, size_t len)
+        : pool_(std::move(pool)),
+          read_pos_(0),
+          write_pos_(0),
+          len_(len),
+          next_(nullptr) {
+      if (pool_ != nullptr)
+        data_ = pool_->Allocate(&len_);
+      else
+        data_ = new char[len];
     }
 
     ~Buffer() {
-      delete[] data_;
-      if (env_ != nullptr) {
-        const int64_t len = static_cast<int64_t>(len_);
-        env_->isolate()->AdjustAmountOfExternalAllocatedMemory(-len);
-      }
+      if (pool_ != nullptr)
+        pool_->Free(data_, len_);
+      else
+        delete[] data_;
     }
 
-    Environment* env_;
+    std::shared_ptr<NodeBIOPool> pool_;
     size_t read_pos_;
     size_t write_pos_;
     size_t len_;
@@ -9,11 +9,15 @@
 #include "v8.h"
 
 #include <cstdio>
+#include <limits>
 
 namespace node {
 
+using v8::Array;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
+using v8::Int32;
+using v8::Integer;
 using v8::Just;
 using v8::Local;
 using v8::Maybe;
@@ -21,6 +25,7 @@ using v8::MaybeLocal;
 using v8::Nothing;
 using v8::Object;
 using v8::Uint32;
+using v8::Undefined;
 using v8::Value;
 
 namespace crypto {
@@ -55,6 +60,8 @@ void Hash::Initialize(Environment* env, Local<Object> target) {
   env->SetMethodNoSideEffect(target, "getHashes", GetHashes);
 
   HashJob::Initialize(env, target);
+  HashBatchJob::Initialize(env, target);
+  HashFileJob::Initialize(env, target);
 }
 
 void Hash::New(const FunctionCallbackInfo<Value>& args) {
@@ -302,5 +309,310 @@ bool HashTraits::DeriveBits(
   return true;
 }
 
+HashBatchConfig::HashBatchConfig(HashBatchConfig&& other) noexcept
+    : mode(other.mode),
+      in(std::move(other.in)),
+      offsets(std::move(other.offsets)),
+      digest(other.digest),
+      length(other.length) {}
+
+HashBatchConfig& HashBatchConfig::operator=(
+    HashBatchConfig&& other) noexcept {
+  if (&other == this) return *this;
+  this->~HashBatchConfig();
+  return *new (this) HashBatchConfig(std::move(other));
+}
+
+void HashBatchConfig::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("in", in.size());
+  tracker->TrackFieldWithSize("offsets", offsets.size() * sizeof(size_t));
+}
+
+Maybe<bool> HashBatchTraits::EncodeOutput(
+    Environment* env,
+    const HashBatchConfig& params,
+    ByteSource* out,
+    v8::Local<v8::Value>* result) {
+  *result = out->ToArrayBuffer(env);
+  return Just(!result->IsEmpty());
+}
+
+Maybe<bool> HashBatchTraits::AdditionalConfig(
+    CryptoJobMode mode,
+    const FunctionCallbackInfo<Value>& args,
+    unsigned int offset,
+    HashBatchConfig* params) {
+  Environment* env = Environment::GetCurrent(args);
+
+  params->mode = mode;
+
+  CHECK(args[offset]->IsString());  // Hash algorithm
+  Utf8Value digest(env->isolate(), args[offset]);
+  params->digest = EVP_get_digestbyname(*digest);
+  if (UNLIKELY(params->digest == nullptr)) {
+    THROW_ERR_CRYPTO_INVALID_DIGEST(env);
+    return Nothing<bool>();
+  }
+
+  CHECK(args[offset + 1]->IsArray());  // Inputs
+  Local<Array> inputs = args[offset + 1].As<Array>();
+  const uint32_t count = inputs->Length();
+
+  // The inputs are always copied, into a single allocation. Even when the
+  // job is synchronous that is cheaper than keeping track of every input.
+  std::vector<Local<Value>> values(count);
+  params->offsets.resize(count + 1);
+  params->offsets[0] = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    if (!inputs->Get(env->context(), i).ToLocal(&values[i]))
+      return Nothing<bool>();
+    CHECK(IsAnyByteSource(values[i]));
+    ArrayBufferOrViewContents<char> data(values[i]);
+    if (UNLIKELY(!data.CheckSizeInt32())) {
+      THROW_ERR_OUT_OF_RANGE(env, "data is too big");
+      return Nothing<bool>();
+    }
+    params->offsets[i + 1] = params->offsets[i] + data.size();
+  }
+
+  const size_t total = params->offsets[count];
+  if (total > 0) {
+    char* in = MallocOpenSSL<char>(total);
+    params->in = ByteSource::Allocated(in, total);
+    for (uint32_t i = 0; i < count; i++) {
+      ArrayBufferOrViewContents<char> data(values[i]);
+      if (data.size() > 0)
+        memcpy(in + params->offsets[i], data.data(), data.size());
+    }
+  }
+
+  params->length = EVP_MD_size(params->digest);
+  if (args[offset + 2]->IsUint32()) {
+    // Unlike for HashJob, the length is expressed in bytes.
+    params->length = args[offset + 2].As<Uint32>()->Value();
+    if (params->length != static_cast<unsigned int>(
+            EVP_MD_size(params->digest)) &&
+        (EVP_MD_flags(params->digest) & EVP_MD_FLAG_XOF) == 0) {
+      THROW_ERR_CRYPTO_INVALID_DIGEST(env, "Digest method not supported");
+      return Nothing<bool>();
+    }
+  }
+
+  if (params->length > 0 &&
+      count > std::numeric_limits<size_t>::max() / params->length) {
+    THROW_ERR_OUT_OF_RANGE(env, "output is too big");
+    return Nothing<bool>();
+  }
+
+  return Just(true);
+}
+
+bool HashBatchTraits::DeriveBits(
+    Environment* env,
+    const HashBatchConfig& params,
+    ByteSource* out) {
+  const size_t count = params.offsets.size() - 1;
+  const size_t length = params.length;
+  if (count == 0 || length == 0)
+    return true;
+
+  // A single context is reinitialized for every input. OpenSSL keeps its
+  // state allocation around as long as the digest does not change.
+  EVPMDPointer ctx(EVP_MD_CTX_new());
+  if (UNLIKELY(!ctx))
+    return false;
+
+  char* data = MallocOpenSSL<char>(count * length);
+  ByteSource buf = ByteSource::Allocated(data, count * length);
+  const bool xof = length != static_cast<size_t>(EVP_MD_size(params.digest));
+  for (size_t i = 0; i < count; i++) {
+    unsigned char* ptr = reinterpret_cast<unsigned char*>(data + i * length);
+    unsigned int written = length;
+    if (UNLIKELY(
+            EVP_DigestInit_ex(ctx.get(), params.digest, nullptr) <= 0 ||
+            EVP_DigestUpdate(ctx.get(),
+                             params.in.get() + params.offsets[i],
+                             params.offsets[i + 1] - params.offsets[i]) <= 0 ||
+            (xof ? EVP_DigestFinalXOF(ctx.get(), ptr, length)
+                 : EVP_DigestFinal_ex(ctx.get(), ptr, &written)) != 1)) {
+      return false;
+    }
+  }
+
+  *out = std::move(buf);
+  return true;
+}
+
+HashFileConfig::HashFileConfig(HashFileConfig&& other) noexcept
+    : fd(other.fd),
+      position(other.position),
+      length(other.length),
+      digests(std::move(other.digests)) {}
+
+HashFileConfig& HashFileConfig::operator=(HashFileConfig&& other) noexcept {
+  if (&other == this) return *this;
+  this->~HashFileConfig();
+  return *new (this) HashFileConfig(std::move(other));
+}
+
+void HashFileConfig::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("digests",
+                              digests.size() * sizeof(const EVP_MD*));
+}
+
+void HashFileJob::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+
+  CryptoJobMode mode = GetCryptoJobMode(args[0]);
+
+  HashFileConfig params;
+  CHECK(args[1]->IsInt32());  // File descriptor
+  params.fd = args[1].As<Int32>()->Value();
+
+  CHECK(args[2]->IsArray());  // Hash algorithms
+  Local<Array> algorithms = args[2].As<Array>();
+  params.digests.resize(algorithms->Length());
+  for (uint32_t i = 0; i < algorithms->Length(); i++) {
+    Local<Value> algorithm;
+    if (!algorithms->Get(env->context(), i).ToLocal(&algorithm))
+      return;
+    CHECK(algorithm->IsString());
+    Utf8Value name(env->isolate(), algorithm);
+    params.digests[i] = EVP_get_digestbyname(*name);
+    if (UNLIKELY(params.digests[i] == nullptr))
+      return THROW_ERR_CRYPTO_INVALID_DIGEST(env);
+  }
+
+  CHECK(IsSafeJsInt(args[3]));  // Position
+  CHECK(IsSafeJsInt(args[4]));  // Length
+  params.position = args[3].As<Integer>()->Value();
+  params.length = args[4].As<Integer>()->Value();
+  CHECK_GE(params.position, -1);
+  CHECK_GE(params.length, -1);
+
+  new HashFileJob(env, args.This(), mode, std::move(params));
+}
+
+void HashFileJob::Initialize(Environment* env, Local<Object> target) {
+  CryptoJob<HashFileTraits>::Initialize(New, env, target);
+}
+
+HashFileJob::HashFileJob(
+    Environment* env,
+    Local<Object> object,
+    CryptoJobMode mode,
+    HashFileConfig&& params)
+    : CryptoJob<HashFileTraits>(
+          env,
+          object,
+          HashFileTraits::Provider,
+          mode,
+          std::move(params)) {}
+
+void HashFileJob::DoThreadPoolWork() {
+  const HashFileConfig& params = *CryptoJob<HashFileTraits>::params();
+  CryptoErrorVector* errors = CryptoJob<HashFileTraits>::errors();
+
+  std::vector<EVPMDPointer> contexts(params.digests.size());
+  for (size_t i = 0; i < contexts.size(); i++) {
+    contexts[i].reset(EVP_MD_CTX_new());
+    if (!contexts[i] ||
+        EVP_DigestInit_ex(contexts[i].get(), params.digests[i], nullptr) <= 0) {
+      errors->Capture();
+      if (errors->empty())
+        errors->push_back("Digest method not supported");
+      return;
+    }
+  }
+
+  // This already runs on the threadpool, so the reads are synchronous. Those
+  // do not touch the event loop, which belongs to the main thread.
+  MallocedBuffer<char> chunk(kChunkSize);
+  int64_t position = params.position;
+  int64_t remaining = params.length;
+  while (remaining != 0) {
+    size_t size = kChunkSize;
+    if (remaining > 0 && static_cast<uint64_t>(remaining) < size)
+      size = static_cast<size_t>(remaining);
+    uv_buf_t buf = uv_buf_init(chunk.data, size);
+    uv_fs_t req;
+    const int bytes_read =
+        uv_fs_read(nullptr, &req, params.fd, &buf, 1, position, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (bytes_read < 0) {
+      read_error_ = bytes_read;
+      return;
+    }
+    if (bytes_read == 0)
+      break;  // End of file.
+
+    for (const EVPMDPointer& ctx : contexts) {
+      if (EVP_DigestUpdate(ctx.get(), chunk.data, bytes_read) <= 0) {
+        errors->Capture();
+        if (errors->empty())
+          errors->push_back("Hashing failed");
+        return;
+      }
+    }
+    if (position != -1)
+      position += bytes_read;
+    if (remaining != -1)
+      remaining -= bytes_read;
+  }
+
+  out_.resize(contexts.size());
+  for (size_t i = 0; i < contexts.size(); i++) {
+    unsigned int length = EVP_MD_size(params.digests[i]);
+    char* data = MallocOpenSSL<char>(length);
+    out_[i] = ByteSource::Allocated(data, length);
+    if (EVP_DigestFinal_ex(contexts[i].get(),
+                           reinterpret_cast<unsigned char*>(data),
+                           &length) != 1) {
+      errors->Capture();
+      if (errors->empty())
+        errors->push_back("Hashing failed");
+      return;
+    }
+  }
+  success_ = true;
+}
+
+Maybe<bool> HashFileJob::ToResult(
+    Local<Value>* err,
+    Local<Value>* result) {
+  Environment* env = AsyncWrap::env();
+  if (read_error_ != 0) {
+    *err = UVException(env->isolate(), read_error_, "read");
+    *result = Undefined(env->isolate());
+    return Just(true);
+  }
+
+  CryptoErrorVector* errors = CryptoJob<HashFileTraits>::errors();
+  if (success_) {
+    CHECK(errors->empty());
+    std::vector<Local<Value>> digests(out_.size());
+    for (size_t i = 0; i < out_.size(); i++)
+      digests[i] = out_[i].ToArrayBuffer(env);
+    *err = Undefined(env->isolate());
+    *result = Array::New(env->isolate(), digests.data(), digests.size());
+    return Just(true);
+  }
+
+  if (errors->empty())
+    errors->Capture();
+  CHECK(!errors->empty());
+  *result = Undefined(env->isolate());
+  return Just(errors->ToException(env).ToLocal(err));
+}
+
+void HashFileJob::MemoryInfo(MemoryTracker* tracker) const {
+  size_t size = 0;
+  for (const ByteSource& digest : out_)
+    size += digest.size();
+  tracker->TrackFieldWithSize("out", size);
+  CryptoJob<HashFileTraits>::MemoryInfo(tracker);
+}
+
 }  // namespace crypto
 }  // namespace node
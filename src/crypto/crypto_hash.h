@@ -11,6 +11,8 @@
 #include "memory_tracker.h"
 #include "v8.h"
 
+#include <vector>
+
 namespace node {
 namespace crypto {
 class Hash final : public BaseObject {
@@ -82,6 +84,111 @@ struct HashTraits final {
 
 using HashJob = DeriveBitsJob<HashTraits>;
 
+// Hashes many inputs with the same algorithm in a single job, which avoids
+// the per-object and per-task overhead of hashing them one by one.
+struct HashBatchConfig final : public MemoryRetainer {
+  CryptoJobMode mode;
+  // All inputs back to back. Input i spans [offsets[i], offsets[i + 1]).
+  ByteSource in;
+  std::vector<size_t> offsets;
+  const EVP_MD* digest;
+  unsigned int length;
+
+  HashBatchConfig() = default;
+
+  explicit HashBatchConfig(HashBatchConfig&& other) noexcept;
+
+  HashBatchConfig& operator=(HashBatchConfig&& other) noexcept;
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(HashBatchConfig);
+  SET_SELF_SIZE(HashBatchConfig);
+};
+
+struct HashBatchTraits final {
+  using AdditionalParameters = HashBatchConfig;
+  static constexpr const char* JobName = "HashBatchJob";
+  static constexpr AsyncWrap::ProviderType Provider =
+      AsyncWrap::PROVIDER_HASHREQUEST;
+
+  static v8::Maybe<bool> AdditionalConfig(
+      CryptoJobMode mode,
+      const v8::FunctionCallbackInfo<v8::Value>& args,
+      unsigned int offset,
+      HashBatchConfig* params);
+
+  // The digests of all inputs, back to back.
+  static bool DeriveBits(
+      Environment* env,
+      const HashBatchConfig& params,
+      ByteSource* out);
+
+  static v8::Maybe<bool> EncodeOutput(
+      Environment* env,
+      const HashBatchConfig& params,
+      ByteSource* out,
+      v8::Local<v8::Value>* result);
+};
+
+using HashBatchJob = DeriveBitsJob<HashBatchTraits>;
+
+// Reads a file and feeds it into one or more digests in a single pass, all on
+// the threadpool, so that the contents of the file never reach JavaScript.
+struct HashFileConfig final : public MemoryRetainer {
+  int fd;
+  int64_t position;  // -1 to read from the current file position.
+  int64_t length;    // -1 to read until the end of the file.
+  std::vector<const EVP_MD*> digests;
+
+  HashFileConfig() = default;
+
+  explicit HashFileConfig(HashFileConfig&& other) noexcept;
+
+  HashFileConfig& operator=(HashFileConfig&& other) noexcept;
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(HashFileConfig);
+  SET_SELF_SIZE(HashFileConfig);
+};
+
+struct HashFileTraits final {
+  using AdditionalParameters = HashFileConfig;
+  static constexpr const char* JobName = "HashFileJob";
+  static constexpr AsyncWrap::ProviderType Provider =
+      AsyncWrap::PROVIDER_HASHREQUEST;
+};
+
+// Unlike a DeriveBitsJob, a HashFileJob can fail because of an I/O error,
+// which is reported as a regular libuv exception rather than an OpenSSL one.
+class HashFileJob final : public CryptoJob<HashFileTraits> {
+ public:
+  // The size of the chunks in which the file is read.
+  static constexpr size_t kChunkSize = 512 * 1024;
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Initialize(Environment* env, v8::Local<v8::Object> target);
+
+  HashFileJob(
+      Environment* env,
+      v8::Local<v8::Object> object,
+      CryptoJobMode mode,
+      HashFileConfig&& params);
+
+  void DoThreadPoolWork() override;
+
+  v8::Maybe<bool> ToResult(
+      v8::Local<v8::Value>* err,
+      v8::Local<v8::Value>* result) override;
+
+  SET_SELF_SIZE(HashFileJob);
+  void MemoryInfo(MemoryTracker* tracker) const override;
+
+ private:
+  std::vector<ByteSource> out_;
+  int read_error_ = 0;
+  bool success_ = false;
+};
+
 }  // namespace crypto
 }  // namespace node
 
@@ -34,6 +34,18 @@
 #include "stream_base-inl.h"
 #include "util-inl.h"
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#if defined(TLS_TX) && defined(TCP_ULP) && defined(SOL_TLS)
+#define NODE_HAVE_KERNEL_TLS 1
+#endif
+#endif  // defined(__linux__)
+
 namespace node {
 
 using v8::Array;
@@ -64,6 +76,142 @@ using v8::Value;
 namespace crypto {
 
 namespace {
+#ifdef NODE_HAVE_KERNEL_TLS
+// Derives the key block of a TLS 1.2 connection from its master secret, see
+// RFC 5246, section 6.3. OpenSSL does not expose the keys it uses itself.
+bool DeriveTLS12KeyBlock(SSL* ssl, unsigned char* out, size_t length) {
+  SSL_SESSION* session = SSL_get_session(ssl);
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (session == nullptr || cipher == nullptr)
+    return false;
+
+  unsigned char master_key[SSL_MAX_MASTER_KEY_LENGTH];
+  size_t master_key_length =
+      SSL_SESSION_get_master_key(session, master_key, sizeof(master_key));
+  unsigned char random[2 * SSL3_RANDOM_SIZE];
+  SSL_get_server_random(ssl, random, SSL3_RANDOM_SIZE);
+  SSL_get_client_random(ssl, random + SSL3_RANDOM_SIZE, SSL3_RANDOM_SIZE);
+
+  static const char kLabel[] = "key expansion";
+  EVPKeyCtxPointer ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF, nullptr));
+  bool ok = ctx &&
+      EVP_PKEY_derive_init(ctx.get()) > 0 &&
+      EVP_PKEY_CTX_set_tls1_prf_md(
+          ctx.get(), SSL_CIPHER_get_handshake_digest(cipher)) > 0 &&
+      EVP_PKEY_CTX_set1_tls1_prf_secret(
+          ctx.get(), master_key, master_key_length) > 0 &&
+      EVP_PKEY_CTX_add1_tls1_prf_seed(
+          ctx.get(), kLabel, sizeof(kLabel) - 1) > 0 &&
+      EVP_PKEY_CTX_add1_tls1_prf_seed(ctx.get(), random, sizeof(random)) > 0 &&
+      EVP_PKEY_derive(ctx.get(), out, &length) > 0;
+  OPENSSL_cleanse(master_key, sizeof(master_key));
+  return ok;
+}
+
+template <typename CryptoInfo>
+bool SetKernelTLSTxKey(int fd,
+                       uint16_t cipher_type,
+                       const unsigned char* key,
+                       const unsigned char* salt,
+                       uint64_t sequence_number) {
+  CryptoInfo info {};
+  info.info.version = TLS_1_2_VERSION;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, key, sizeof(info.key));
+  memcpy(info.salt, salt, sizeof(info.salt));
+  for (size_t i = 0; i < sizeof(info.rec_seq); i++) {
+    info.rec_seq[sizeof(info.rec_seq) - 1 - i] =
+        static_cast<unsigned char>(sequence_number >> (8 * i));
+  }
+  // The explicit part of the nonce only has to be unique, the kernel
+  // increments it for every record like the sequence number.
+  static_assert(sizeof(info.iv) == sizeof(info.rec_seq),
+                "The sequence number is used as the explicit nonce");
+  memcpy(info.iv, info.rec_seq, sizeof(info.iv));
+
+  int err = setsockopt(fd, SOL_TLS, TLS_TX, &info, sizeof(info));
+  OPENSSL_cleanse(&info, sizeof(info));
+  return err == 0;
+}
+
+// Installs the keys that `ssl` uses for outgoing records into the socket.
+// Only TLS 1.2 with AES-GCM is supported: for it, the record sequence number
+// is known right after the handshake (the Finished message is the only
+// record that was sent with the new keys), and the kernel supports it since
+// Linux 4.13.
+bool EnableKernelTLSTx(int fd, SSL* ssl, bool is_server) {
+  if (SSL_version(ssl) != TLS1_2_VERSION)
+    return false;
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr)
+    return false;
+
+  size_t key_length;
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+    case NID_aes_128_gcm:
+      key_length = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+      break;
+    case NID_aes_256_gcm:
+      key_length = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+      break;
+    default:
+      return false;
+  }
+
+  // client_write_key, server_write_key, client_write_IV, server_write_IV
+  constexpr size_t kSaltLength = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+  unsigned char key_block[2 * TLS_CIPHER_AES_GCM_256_KEY_SIZE +
+                          2 * kSaltLength];
+  size_t key_block_length = 2 * key_length + 2 * kSaltLength;
+  if (!DeriveTLS12KeyBlock(ssl, key_block, key_block_length))
+    return false;
+
+  const unsigned char* key = key_block + (is_server ? key_length : 0);
+  const unsigned char* salt =
+      key_block + 2 * key_length + (is_server ? kSaltLength : 0);
+  constexpr uint64_t kSequenceNumber = 1;
+
+  static const char kULP[] = "tls";
+  bool ok = setsockopt(fd, SOL_TCP, TCP_ULP, kULP, sizeof(kULP)) == 0;
+  if (ok && key_length == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+    ok = SetKernelTLSTxKey<tls12_crypto_info_aes_gcm_128>(
+        fd, TLS_CIPHER_AES_GCM_128, key, salt, kSequenceNumber);
+  } else if (ok) {
+    ok = SetKernelTLSTxKey<tls12_crypto_info_aes_gcm_256>(
+        fd, TLS_CIPHER_AES_GCM_256, key, salt, kSequenceNumber);
+  }
+  OPENSSL_cleanse(key_block, sizeof(key_block));
+  return ok;
+}
+
+// Sends a record of the given type through a socket that kernel TLS is
+// enabled on. Returns the number of bytes sent or a libuv error code.
+ssize_t SendKernelTLSRecord(int fd,
+                            unsigned char type,
+                            const unsigned char* data,
+                            size_t length) {
+  char control[CMSG_SPACE(sizeof(type))] = {};
+  iovec iov = { const_cast<unsigned char*>(data), length };
+  msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(type));
+  *CMSG_DATA(cmsg) = type;
+  ssize_t sent;
+  do {
+    sent = sendmsg(fd, &msg, MSG_DONTWAIT);
+  } while (sent == -1 && errno == EINTR);
+  if (sent == -1)
+    return uv_translate_sys_error(errno);
+  return sent;
+}
+#endif  // NODE_HAVE_KERNEL_TLS
+
 SSL_SESSION* GetSessionCallback(
     SSL* s,
     const unsigned char* key,
@@ -536,6 +684,8 @@ void TLSWrap::SSLInfoCallback(const SSL* ssl_, int where, int ret) {
     Local<Value> callback;
 
     c->established_ = true;
+    if (c->kernel_tls_ == KernelTLSState::kRequested)
+      c->kernel_tls_ = KernelTLSState::kPending;
 
     if (object->Get(env->context(), env->onhandshakedone_string())
           .ToLocal(&callback) && callback->IsFunction()) {
@@ -576,9 +726,43 @@ void TLSWrap::EncOut() {
     return;
   }
 
+  if (kernel_tls_ == KernelTLSState::kActive) {
+    // OpenSSL still encrypts the records it produces on its own, such as
+    // alerts, with the keys and sequence numbers that the kernel has taken
+    // over. SSLMessageCallback() has kept their plaintext, which is sent
+    // through the kernel instead.
+    if (BIO_pending(enc_out_) != 0)
+      NodeBIO::FromBIO(enc_out_)->Reset();
+    if (!FlushKernelTLSRecords()) {
+      Debug(this, "Returning from EncOut(), waiting for the socket");
+      return;
+    }
+    if (pending_cleartext_input_.size() != 0) {
+      ClearIn();
+      return;
+    }
+    if (pending_shutdown_ != nullptr) {
+      ShutdownWrap* req_wrap = pending_shutdown_;
+      pending_shutdown_ = nullptr;
+      int err = underlying_stream()->DoShutdown(req_wrap);
+      if (err != 0)
+        req_wrap->Done(err);
+    }
+  }
+
   // No encrypted output ready to write to the underlying stream.
   if (BIO_pending(enc_out_) == 0) {
     Debug(this, "No pending encrypted output");
+    if (kernel_tls_ == KernelTLSState::kPending) {
+      // The handshake has been written completely, so the kernel can take
+      // over from here. Write what has been held back in the meantime.
+      StartKernelTLS();
+      if (pending_cleartext_input_.size() != 0) {
+        ClearIn();
+        EncOut();
+        return;
+      }
+    }
     if (pending_cleartext_input_.size() == 0) {
       if (!in_dowrite_) {
         Debug(this, "No pending cleartext input, not inside DoWrite()");
@@ -662,7 +846,10 @@ void TLSWrap::OnStreamAfterWrite(WriteWrap* req_wrap, int status) {
   }
 
   // Commit
-  NodeBIO::FromBIO(enc_out_)->Read(nullptr, write_size_);
+  if (kernel_tls_ == KernelTLSState::kActive)
+    kernel_tls_write_data_ = AllocatedBuffer();
+  else
+    NodeBIO::FromBIO(enc_out_)->Read(nullptr, write_size_);
 
   // Ensure that the progress will be made and `InvokeQueued` will be called.
   ClearIn();
@@ -670,6 +857,7 @@ void TLSWrap::OnStreamAfterWrite(WriteWrap* req_wrap, int status) {
   // Try writing more data
   write_size_ = 0;
   EncOut();
+  ReleaseIdleBuffers();
 }
 
 MaybeLocal<Value> TLSWrap::GetSSLError(int status, int* err, std::string* msg) {
@@ -773,35 +961,33 @@ void TLSWrap::ClearOut() {
 
   MarkPopErrorOnReturn mark_pop_error_on_return;
 
-  char out[kClearOutChunkSize];
   int read;
   for (;;) {
-    read = SSL_read(ssl_.get(), out, sizeof(out));
-    Debug(this, "Read %d bytes of cleartext output", read);
-
+    // Only ask the listener for memory once there is cleartext to read.
+    // SSL_peek() processes the incoming records like SSL_read() does, so
+    // errors and the peer's close_notify show up here.
+    char peek;
+    read = SSL_peek(ssl_.get(), &peek, 1);
     if (read <= 0)
       break;
 
-    char* current = out;
-    while (read > 0) {
-      int avail = read;
-
-      uv_buf_t buf = EmitAlloc(avail);
-      if (static_cast<int>(buf.len) < avail)
-        avail = buf.len;
-      memcpy(buf.base, current, avail);
-      EmitRead(avail, buf);
-
-      // Caveat emptor: OnRead() calls into JS land which can result in
-      // the SSL context object being destroyed.  We have to carefully
-      // check that ssl_ != nullptr afterwards.
-      if (ssl_ == nullptr) {
-        Debug(this, "Returning from read loop, ssl_ == nullptr");
-        return;
-      }
+    // Copy the cleartext straight into the memory that the listener
+    // provides.
+    uv_buf_t buf = EmitAlloc(kClearOutChunkSize);
+    read = SSL_read(ssl_.get(),
+                    buf.base,
+                    std::min(buf.len, static_cast<size_t>(kClearOutChunkSize)));
+    Debug(this, "Read %d bytes of cleartext output", read);
+    CHECK_GT(read, 0);
 
-      read -= avail;
-      current += avail;
+    EmitRead(read, buf);
+
+    // Caveat emptor: OnRead() calls into JS land which can result in
+    // the SSL context object being destroyed.  We have to carefully
+    // check that ssl_ != nullptr afterwards.
+    if (ssl_ == nullptr) {
+      Debug(this, "Returning from read loop, ssl_ == nullptr");
+      return;
     }
   }
 
@@ -855,6 +1041,27 @@ void TLSWrap::ClearIn() {
     return;
   }
 
+  if (kernel_tls_ == KernelTLSState::kPending) {
+    Debug(this, "Returning from ClearIn(), waiting for kernel TLS");
+    return;
+  }
+
+  if (kernel_tls_ == KernelTLSState::kActive) {
+    if (write_size_ != 0 || !kernel_tls_records_.empty()) {
+      Debug(this, "Returning from ClearIn(), kernel TLS write pending");
+      return;
+    }
+    kernel_tls_write_data_ = std::move(pending_cleartext_input_);
+    uv_buf_t buf = uv_buf_init(kernel_tls_write_data_.data(),
+                               kernel_tls_write_data_.size());
+    int err = KernelTLSWrite(&buf, 1);
+    if (err != 0) {
+      write_callback_scheduled_ = true;
+      InvokeQueued(err);
+    }
+    return;
+  }
+
   AllocatedBuffer data = std::move(pending_cleartext_input_);
   MarkPopErrorOnReturn mark_pop_error_on_return;
 
@@ -956,15 +1163,8 @@ int TLSWrap::DoWrite(WriteWrap* w,
 
   size_t length = 0;
   size_t i;
-  size_t nonempty_i = 0;
-  size_t nonempty_count = 0;
-  for (i = 0; i < count; i++) {
+  for (i = 0; i < count; i++)
     length += bufs[i].len;
-    if (bufs[i].len > 0) {
-      nonempty_i = i;
-      nonempty_count += 1;
-    }
-  }
 
   // We want to trigger a Write() on the underlying stream to drive the stream
   // system, but don't want to encrypt empty buffers into a TLS frame, so see
@@ -1005,47 +1205,77 @@ int TLSWrap::DoWrite(WriteWrap* w,
     return 0;
   }
 
-  AllocatedBuffer data;
-  MarkPopErrorOnReturn mark_pop_error_on_return;
+  // While the kernel is still busy with an earlier write or with records
+  // that OpenSSL produced, the data is held back until EncOut() gets to it.
+  bool hold_back = kernel_tls_ == KernelTLSState::kPending ||
+      (kernel_tls_ == KernelTLSState::kActive &&
+       (write_size_ != 0 || !kernel_tls_records_.empty()));
 
+  if (kernel_tls_ == KernelTLSState::kActive && !hold_back) {
+    int err = KernelTLSWrite(bufs, count);
+    if (err != 0)
+      current_write_.reset();
+    return err;
+  }
+
+  MarkPopErrorOnReturn mark_pop_error_on_return;
+  NodeBIO::FromBIO(enc_out_)->set_allocate_tls_hint(length);
+
+  // Encrypt the buffers one after another instead of copying them into a
+  // single allocation first. Runs of small buffers, like the ones that
+  // _http_outgoing.js writes around chunks of data, are still combined.
+  MaybeStackBuffer<char, kSmallWriteBufferSize> small;
+  size_t small_length = 0;
+  size_t done = 0;
   int written = 0;
 
-  // It is common for zero length buffers to be written,
-  // don't copy data if there there is one buffer with data
-  // and one or more zero length buffers.
-  // _http_outgoing.js writes a zero length buffer in
-  // in OutgoingMessage.prototype.end.  If there was a large amount
-  // of data supplied to end() there is no sense allocating
-  // and copying it when it could just be used.
+  auto encrypt = [&](const char* data, size_t size) {
+    written = SSL_write(ssl_.get(), data, size);
+    CHECK(written == -1 || written == static_cast<int>(size));
+    if (written != -1)
+      done += size;
+    return written != -1;
+  };
 
-  if (nonempty_count != 1) {
-    data = AllocatedBuffer::AllocateManaged(env(), length);
-    size_t offset = 0;
-    for (i = 0; i < count; i++) {
-      memcpy(data.data() + offset, bufs[i].base, bufs[i].len);
-      offset += bufs[i].len;
-    }
+  auto flush_small = [&]() {
+    if (small_length == 0)
+      return true;
+    size_t size = small_length;
+    small_length = 0;
+    return encrypt(*small, size);
+  };
 
-    NodeBIO::FromBIO(enc_out_)->set_allocate_tls_hint(length);
-    written = SSL_write(ssl_.get(), data.data(), length);
-  } else {
-    // Only one buffer: try to write directly, only store if it fails
-    uv_buf_t* buf = &bufs[nonempty_i];
-    NodeBIO::FromBIO(enc_out_)->set_allocate_tls_hint(buf->len);
-    written = SSL_write(ssl_.get(), buf->base, buf->len);
-
-    if (written == -1) {
-      data = AllocatedBuffer::AllocateManaged(env(), length);
-      memcpy(data.data(), buf->base, buf->len);
+  // Until the kernel has taken over, the data is held back like data that
+  // SSL_write() did not accept.
+  if (hold_back)
+    written = -1;
+
+  for (i = 0; i < count && written != -1; i++) {
+    const uv_buf_t& buf = bufs[i];
+    if (buf.len == 0)
+      continue;
+
+    if (buf.len < kSmallWriteSize) {
+      if (small_length + buf.len > small.capacity() && !flush_small())
+        break;
+      memcpy(*small + small_length, buf.base, buf.len);
+      small_length += buf.len;
+      continue;
     }
+
+    if (!flush_small() || !encrypt(buf.base, buf.len))
+      break;
   }
+  if (written != -1)
+    flush_small();
 
-  CHECK(written == -1 || written == static_cast<int>(length));
-  Debug(this, "Writing %zu bytes, written = %d", length, written);
+  Debug(this, "Writing %zu bytes, encrypted %zu", length, done);
 
   if (written == -1) {
     int err;
-    MaybeLocal<Value> arg = GetSSLError(written, &err, &error_);
+    MaybeLocal<Value> arg;
+    if (!hold_back)
+      arg = GetSSLError(written, &err, &error_);
 
     // If we stopped writing because of an error, it's fatal, discard the data.
     if (!arg.IsEmpty()) {
@@ -1057,7 +1287,21 @@ int TLSWrap::DoWrite(WriteWrap* w,
 
     Debug(this, "Saving data for later write");
     // Otherwise, save unwritten data so it can be written later by ClearIn().
+    // Only this slow path needs a copy of the data.
     CHECK_EQ(pending_cleartext_input_.size(), 0);
+    AllocatedBuffer data =
+        AllocatedBuffer::AllocateManaged(env(), length - done);
+    size_t offset = 0;
+    for (i = 0; i < count; i++) {
+      if (done >= bufs[i].len) {
+        done -= bufs[i].len;
+        continue;
+      }
+      memcpy(data.data() + offset, bufs[i].base + done, bufs[i].len - done);
+      offset += bufs[i].len - done;
+      done = 0;
+    }
+    CHECK_EQ(offset, data.size());
     pending_cleartext_input_ = std::move(data);
   }
 
@@ -1134,6 +1378,14 @@ int TLSWrap::DoShutdown(ShutdownWrap* req_wrap) {
 
   shutdown_ = true;
   EncOut();
+
+  // The close_notify alert goes through the kernel, and may have to wait
+  // for an earlier write or for the socket to become writable.
+  if (!kernel_tls_records_.empty()) {
+    CHECK_NULL(pending_shutdown_);
+    pending_shutdown_ = req_wrap;
+    return 0;
+  }
   return underlying_stream()->DoShutdown(req_wrap);
 }
 
@@ -1209,20 +1461,60 @@ void TLSWrap::EnableTrace(const FunctionCallbackInfo<Value>& args) {
 #if HAVE_SSL_TRACE
   if (wrap->ssl_) {
     wrap->bio_trace_.reset(BIO_new_fp(stderr,  BIO_NOCLOSE | BIO_FP_TEXT));
-    SSL_set_msg_callback(wrap->ssl_.get(), [](int write_p, int version, int
-          content_type, const void* buf, size_t len, SSL* ssl, void* arg)
-        -> void {
-        // BIO_write(), etc., called by SSL_trace, may error. The error should
-        // be ignored, trace is a "best effort", and its usually because stderr
-        // is a non-blocking pipe, and its buffer has overflowed. Leaving errors
-        // on the stack that can get picked up by later SSL_ calls causes
-        // unwanted failures in SSL_ calls, so keep the error stack unchanged.
-        MarkPopErrorOnReturn mark_pop_error_on_return;
-        SSL_trace(write_p,  version, content_type, buf, len, ssl, arg);
-    });
-    SSL_set_msg_callback_arg(wrap->ssl_.get(), wrap->bio_trace_.get());
+    SSL_set_msg_callback(wrap->ssl_.get(), SSLMessageCallback);
+  }
+#endif
+}
+
+void TLSWrap::SSLMessageCallback(int write_p,
+                                 int version,
+                                 int content_type,
+                                 const void* buf,
+                                 size_t len,
+                                 SSL* ssl,
+                                 void* arg) {
+  TLSWrap* w = static_cast<TLSWrap*>(SSL_get_app_data(ssl));
+
+#if HAVE_SSL_TRACE
+  if (w->bio_trace_) {
+    // BIO_write(), etc., called by SSL_trace, may error. The error should
+    // be ignored, trace is a "best effort", and its usually because stderr
+    // is a non-blocking pipe, and its buffer has overflowed. Leaving errors
+    // on the stack that can get picked up by later SSL_ calls causes
+    // unwanted failures in SSL_ calls, so keep the error stack unchanged.
+    MarkPopErrorOnReturn mark_pop_error_on_return;
+    SSL_trace(write_p,  version, content_type, buf, len, ssl,
+              w->bio_trace_.get());
   }
 #endif
+
+  // Keep the plaintext of the records that OpenSSL writes on its own once
+  // the kernel has taken over, EncOut() sends them through the kernel.
+  if (w->kernel_tls_ == KernelTLSState::kActive && write_p &&
+      (content_type == SSL3_RT_ALERT || content_type == SSL3_RT_HANDSHAKE)) {
+    const unsigned char* data = static_cast<const unsigned char*>(buf);
+    w->kernel_tls_records_.push_back(KernelTLSRecord {
+      static_cast<unsigned char>(content_type),
+      std::vector<unsigned char>(data, data + len)
+    });
+  }
+}
+
+void TLSWrap::EnableKernelTLS(const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK_NOT_NULL(wrap->ssl_);
+  CHECK(!wrap->established_);
+
+  // Whether the kernel supports the negotiated cipher is only known once the
+  // handshake is done, until then it is only a request.
+  wrap->kernel_tls_ = KernelTLSState::kRequested;
+}
+
+void TLSWrap::IsKernelTLSActive(const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  args.GetReturnValue().Set(wrap->kernel_tls_ == KernelTLSState::kActive);
 }
 
 void TLSWrap::DestroySSL(const FunctionCallbackInfo<Value>& args) {
@@ -1242,6 +1534,14 @@ void TLSWrap::Destroy() {
   // And destroy
   InvokeQueued(UV_ECANCELED, "Canceled because of SSL destruction");
 
+  StopKernelTLSPoll();
+  kernel_tls_records_.clear();
+  if (pending_shutdown_ != nullptr) {
+    ShutdownWrap* req_wrap = pending_shutdown_;
+    pending_shutdown_ = nullptr;
+    req_wrap->Done(UV_ECANCELED);
+  }
+
   env()->isolate()->AdjustAmountOfExternalAllocatedMemory(-kExternalSize);
   ssl_.reset();
 
@@ -1501,10 +1801,14 @@ void TLSWrap::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackFieldWithSize("pending_cleartext_input",
                               pending_cleartext_input_.size(),
                               "AllocatedBuffer");
+  tracker->TrackFieldWithSize("kernel_tls_write_data",
+                              kernel_tls_write_data_.size(),
+                              "AllocatedBuffer");
   if (enc_in_ != nullptr)
     tracker->TrackField("enc_in", NodeBIO::FromBIO(enc_in_));
   if (enc_out_ != nullptr)
     tracker->TrackField("enc_out", NodeBIO::FromBIO(enc_out_));
+  tracker->TrackField("read_slab_allocator", read_slab_allocator_);
 }
 
 void TLSWrap::CertCbDone(const FunctionCallbackInfo<Value>& args) {
@@ -2003,6 +2307,156 @@ void TLSWrap::Cycle() {
     // EncIn() doesn't exist, it happens via stream listener callbacks.
     EncOut();
   }
+  ReleaseIdleBuffers();
+}
+
+void TLSWrap::ReleaseIdleBuffers() {
+  // The chunks of the BIOs are only needed while data is buffered in them,
+  // give them back to the pool once everything has been consumed so that
+  // idle connections do not hold on to them. enc_out_ is still referenced by
+  // the underlying stream while a write is in progress.
+  if (ssl_ == nullptr || write_size_ != 0)
+    return;
+  NodeBIO* enc_in = NodeBIO::FromBIO(enc_in_);
+  NodeBIO* enc_out = NodeBIO::FromBIO(enc_out_);
+  if (enc_in->Length() != 0 || enc_out->Length() != 0)
+    return;
+  enc_in->ReleaseIfEmpty();
+  enc_out->ReleaseIfEmpty();
+}
+
+void TLSWrap::StartKernelTLS() {
+  CHECK_EQ(kernel_tls_, KernelTLSState::kPending);
+  kernel_tls_ = KernelTLSState::kOff;
+
+#ifdef NODE_HAVE_KERNEL_TLS
+  // Streams that are not backed by a socket, e.g. JSStreamSocket, have no fd.
+  int fd = GetFD();
+  if (fd < 0 || !EnableKernelTLSTx(fd, ssl_.get(), is_server())) {
+    Debug(this, "Kernel TLS is not available, using OpenSSL");
+    return;
+  }
+
+  // A renegotiation would require OpenSSL to write records again.
+  SSL_set_options(ssl_.get(), SSL_OP_NO_RENEGOTIATION);
+  SSL_set_msg_callback(ssl_.get(), SSLMessageCallback);
+  kernel_tls_ = KernelTLSState::kActive;
+  Debug(this, "Kernel TLS is active");
+#endif  // NODE_HAVE_KERNEL_TLS
+}
+
+int TLSWrap::KernelTLSWrite(uv_buf_t* bufs, size_t count) {
+  CHECK_EQ(kernel_tls_, KernelTLSState::kActive);
+  CHECK_EQ(write_size_, 0);
+
+  size_t length = 0;
+  for (size_t i = 0; i < count; i++)
+    length += bufs[i].len;
+  CHECK_NE(length, 0);
+
+  Debug(this, "Writing %zu bytes through kernel TLS", length);
+  write_callback_scheduled_ = true;
+  StreamWriteResult res = underlying_stream()->Write(bufs, count);
+  if (res.err != 0) {
+    // No callback is coming for a write that failed right away. Callers that
+    // want to report the error through InvokeQueued() set the flag again.
+    write_callback_scheduled_ = false;
+    return res.err;
+  }
+
+  // Like EncOut(), keep other writes away until this one is done.
+  write_size_ = length;
+  if (!res.async) {
+    BaseObjectPtr<TLSWrap> strong_ref{this};
+    env()->SetImmediate([this, strong_ref](Environment* env) {
+      OnStreamAfterWrite(nullptr, 0);
+    });
+  }
+  return 0;
+}
+
+bool TLSWrap::FlushKernelTLSRecords() {
+  CHECK_EQ(write_size_, 0);
+#ifdef NODE_HAVE_KERNEL_TLS
+  while (!kernel_tls_records_.empty()) {
+    if (kernel_tls_poll_ != nullptr)
+      return false;
+
+    KernelTLSRecord& record = kernel_tls_records_.front();
+    ssize_t sent = SendKernelTLSRecord(
+        GetFD(), record.type, record.data.data(), record.data.size());
+    if (sent == UV_EAGAIN) {
+      int err = WaitForKernelTLSWritable();
+      if (err == 0)
+        return false;
+      sent = err;
+    }
+    if (sent < 0) {
+      // The socket is broken, the next write or shutdown reports that.
+      Debug(this, "Sending a record failed (%zd), discarding records", sent);
+      kernel_tls_records_.clear();
+      break;
+    }
+
+    // Handshake messages may be split across records.
+    Debug(this, "Sent a record of type %d through kernel TLS", record.type);
+    if (static_cast<size_t>(sent) < record.data.size())
+      record.data.erase(record.data.begin(), record.data.begin() + sent);
+    else
+      kernel_tls_records_.pop_front();
+  }
+#endif  // NODE_HAVE_KERNEL_TLS
+  return true;
+}
+
+int TLSWrap::WaitForKernelTLSWritable() {
+#ifdef NODE_HAVE_KERNEL_TLS
+  CHECK_NULL(kernel_tls_poll_);
+  // libuv does not allow a second watcher on the fd of the stream.
+  int fd = fcntl(GetFD(), F_DUPFD_CLOEXEC, 0);
+  if (fd == -1)
+    return uv_translate_sys_error(errno);
+
+  uv_poll_t* poll = new uv_poll_t;
+  int err = uv_poll_init(env()->event_loop(), poll, fd);
+  if (err != 0) {
+    delete poll;
+    close(fd);
+    return err;
+  }
+  poll->data = this;
+  kernel_tls_poll_ = poll;
+  kernel_tls_poll_fd_ = fd;
+  err = uv_poll_start(poll, UV_WRITABLE, OnKernelTLSWritable);
+  if (err != 0)
+    StopKernelTLSPoll();
+  return err;
+#else
+  return UV_ENOTSUP;
+#endif  // NODE_HAVE_KERNEL_TLS
+}
+
+void TLSWrap::OnKernelTLSWritable(uv_poll_t* handle, int status, int events) {
+  TLSWrap* wrap = static_cast<TLSWrap*>(handle->data);
+  Environment* env = wrap->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  // Errors are reported by sending the records again.
+  wrap->StopKernelTLSPoll();
+  wrap->EncOut();
+}
+
+void TLSWrap::StopKernelTLSPoll() {
+#ifdef NODE_HAVE_KERNEL_TLS
+  if (kernel_tls_poll_ == nullptr)
+    return;
+  env()->CloseHandle(kernel_tls_poll_, [](uv_poll_t* handle) {
+    delete handle;
+  });
+  close(kernel_tls_poll_fd_);
+  kernel_tls_poll_ = nullptr;
+  kernel_tls_poll_fd_ = -1;
+#endif  // NODE_HAVE_KERNEL_TLS
 }
 
 #ifdef SSL_set_max_send_fragment
@@ -2052,6 +2506,7 @@ void TLSWrap::Initialize(
   env->SetProtoMethod(t, "destroySSL", DestroySSL);
   env->SetProtoMethod(t, "enableCertCb", EnableCertCb);
   env->SetProtoMethod(t, "endParser", EndParser);
+  env->SetProtoMethod(t, "enableKernelTLS", EnableKernelTLS);
   env->SetProtoMethod(t, "enableKeylogCallback", EnableKeylogCallback);
   env->SetProtoMethod(t, "enableSessionCallbacks", EnableSessionCallbacks);
   env->SetProtoMethod(t, "enableTrace", EnableTrace);
@@ -2070,6 +2525,7 @@ void TLSWrap::Initialize(
 
   env->SetProtoMethodNoSideEffect(t, "exportKeyingMaterial",
                                   ExportKeyingMaterial);
+  env->SetProtoMethodNoSideEffect(t, "isKernelTLSActive", IsKernelTLSActive);
   env->SetProtoMethodNoSideEffect(t, "isSessionReused", IsSessionReused);
   env->SetProtoMethodNoSideEffect(t, "getALPNNegotiatedProtocol",
                                   GetALPNNegotiatedProto);
@@ -34,7 +34,9 @@
 
 #include <openssl/ssl.h>
 
+#include <deque>
 #include <string>
+#include <vector>
 
 namespace node {
 namespace crypto {
@@ -121,6 +123,14 @@ class TLSWrap : public AsyncWrap,
   // Maximum number of buffers passed to uv_write()
   static constexpr int kSimultaneousBufferCount = 10;
 
+  // Buffers passed to DoWrite() that are smaller than this are combined
+  // before they are encrypted, so that each of them does not end up in a
+  // TLS record of its own. Larger buffers are encrypted from where they are.
+  static constexpr size_t kSmallWriteSize = 1024;
+
+  // Maximum number of bytes that are combined, the size of a TLS record.
+  static constexpr size_t kSmallWriteBufferSize = 16384;
+
   typedef void (*CertCb)(void* arg);
 
   // Alternative to StreamListener::stream(), that returns a StreamBase instead
@@ -158,6 +168,34 @@ class TLSWrap : public AsyncWrap,
   // underlying stream even if there is no clear text to read or write.
   void Cycle();
 
+  // Give the memory of enc_in_ and enc_out_ back to the pool if neither
+  // holds any data.
+  void ReleaseIdleBuffers();
+
+  // Hand the encryption of outgoing records over to the kernel, if it and
+  // the negotiated cipher support it. Called once the handshake is done and
+  // all of its output has been written.
+  void StartKernelTLS();
+  // Write cleartext to the underlying socket, which encrypts it in the
+  // kernel.
+  int KernelTLSWrite(uv_buf_t* bufs, size_t count);
+  // Send the records in kernel_tls_records_ through the kernel. Returns false
+  // if that has to wait for the socket to become writable.
+  bool FlushKernelTLSRecords();
+  int WaitForKernelTLSWritable();
+  void StopKernelTLSPoll();
+  static void OnKernelTLSWritable(uv_poll_t* handle, int status, int events);
+
+  // Traces messages if EnableTrace() was called, and keeps the records that
+  // OpenSSL writes while kernel TLS is active.
+  static void SSLMessageCallback(int write_p,
+                                 int version,
+                                 int content_type,
+                                 const void* buf,
+                                 size_t len,
+                                 SSL* ssl,
+                                 void* arg);
+
   // Implement StreamListener:
   // Returns buf that points into enc_in_.
   uv_buf_t OnStreamAlloc(size_t size) override;
@@ -173,6 +211,7 @@ class TLSWrap : public AsyncWrap,
   static void CertCbDone(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DestroySSL(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EnableCertCb(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void EnableKernelTLS(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EnableKeylogCallback(
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EnableSessionCallbacks(
@@ -202,6 +241,8 @@ class TLSWrap : public AsyncWrap,
   static void GetTLSTicket(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetWriteQueueSize(
       const v8::FunctionCallbackInfo<v8::Value>& info);
+  static void IsKernelTLSActive(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void IsSessionReused(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void LoadSession(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void NewSessionDone(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -270,14 +311,39 @@ class TLSWrap : public AsyncWrap,
   // TODO(@jasnell): These state flags should be revisited.
   // The established_ flag indicates that the handshake is
   // completed. The write_callback_scheduled_ flag is less
-  // clear -- once it is set to true, it is never set to
-  // false and it is only set to true after established_
-  // is set to true, so it's likely redundant.
+  // clear -- once it is set to true, it is only set to
+  // false again when a kernel TLS write fails right away,
+  // and it is only set to true after established_ is set
+  // to true, so it's likely redundant.
   bool established_ = false;
   bool write_callback_scheduled_ = false;
 
   int cycle_depth_ = 0;
 
+  enum class KernelTLSState {
+    kOff,        // Records are encrypted by OpenSSL.
+    kRequested,  // Switch to kernel TLS once the handshake is done.
+    kPending,    // Handshake done, waiting for its output to be written.
+    kActive      // Records are encrypted by the kernel.
+  };
+  KernelTLSState kernel_tls_ = KernelTLSState::kOff;
+  // Cleartext from pending_cleartext_input_ that is being written through
+  // the kernel.
+  AllocatedBuffer kernel_tls_write_data_;
+  // Plaintext of the alerts and handshake messages that OpenSSL wrote since
+  // the kernel took over, sent before any further cleartext.
+  struct KernelTLSRecord {
+    unsigned char type;
+    std::vector<unsigned char> data;
+  };
+  std::deque<KernelTLSRecord> kernel_tls_records_;
+  // Watches a duplicate of the socket's fd while records wait for the
+  // socket to become writable.
+  uv_poll_t* kernel_tls_poll_ = nullptr;
+  int kernel_tls_poll_fd_ = -1;
+  // A shutdown that waits for the close_notify alert to be sent.
+  ShutdownWrap* pending_shutdown_ = nullptr;
+
   // SSL_set_cert_cb
   CertCb cert_cb_ = nullptr;
   void* cert_cb_arg_ = nullptr;
@@ -0,0 +1,147 @@
+#include "dictionary_trainer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace node {
+
+namespace {
+
+// Length of the substrings that are counted, and of the pieces that are
+// taken from the samples.
+constexpr size_t kDmerLength = 8;
+constexpr size_t kSegmentLength = 256;
+constexpr uint32_t kNoDmer = std::numeric_limits<uint32_t>::max();
+
+inline uint64_t LoadDmer(const unsigned char* data) {
+  uint64_t dmer;
+  memcpy(&dmer, data, sizeof(dmer));
+  return dmer;
+}
+
+}  // anonymous namespace
+
+std::vector<unsigned char> TrainDictionary(
+    const std::vector<DictionarySample>& samples, size_t size) {
+  static_assert(kDmerLength == sizeof(uint64_t), "d-mers must fit a uint64_t");
+
+  // Number every distinct d-mer, and count the samples that contain it.
+  std::vector<unsigned char> data;
+  std::vector<uint32_t> dmers;  // The d-mer that starts at each position.
+  std::vector<uint32_t> frequencies;
+  {
+    std::vector<uint32_t> last_sample;
+    std::unordered_map<uint64_t, uint32_t> ids;
+    for (size_t i = 0; i < samples.size(); i++) {
+      const DictionarySample& sample = samples[i];
+      const size_t offset = data.size();
+      data.insert(data.end(), sample.data, sample.data + sample.length);
+      dmers.resize(data.size(), kNoDmer);
+      for (size_t j = 0; j + kDmerLength <= sample.length; j++) {
+        auto result = ids.emplace(LoadDmer(sample.data + j),
+                                  static_cast<uint32_t>(frequencies.size()));
+        const uint32_t id = result.first->second;
+        if (result.second) {
+          frequencies.push_back(0);
+          last_sample.push_back(kNoDmer);
+        }
+        if (last_sample[id] != i) {
+          last_sample[id] = static_cast<uint32_t>(i);
+          frequencies[id]++;
+        }
+        dmers[offset + j] = id;
+      }
+    }
+  }
+
+  // What only occurs in a single sample is unlikely to occur in the data that
+  // the dictionary is meant for.
+  if (samples.size() > 1) {
+    for (uint32_t& frequency : frequencies) {
+      if (frequency < 2)
+        frequency = 0;
+    }
+  }
+
+  std::vector<unsigned char> dictionary(size);
+  size_t tail = size;
+  if (data.size() < kSegmentLength || size == 0) {
+    dictionary.clear();
+    return dictionary;
+  }
+
+  // The data is split into epochs, and every round picks the best segment
+  // of the next epoch. That spreads the pieces of the dictionary across all
+  // samples, without having to look at all of the data for every segment.
+  size_t epochs = std::max<size_t>(1, size / kSegmentLength / 4);
+  if (data.size() / epochs < 10 * kSegmentLength)
+    epochs = std::max<size_t>(1, data.size() / (10 * kSegmentLength));
+  const size_t epoch_size = data.size() / epochs;
+
+  std::vector<uint32_t> active(frequencies.size());
+  const size_t dmers_per_segment = kSegmentLength - kDmerLength + 1;
+  size_t empty_epochs = 0;
+  for (size_t epoch = 0; tail > 0 && empty_epochs < epochs;
+       epoch = (epoch + 1) % epochs) {
+    const size_t begin = epoch * epoch_size;
+    const size_t end = epoch == epochs - 1 ? data.size() : begin + epoch_size;
+
+    // Slide a window of one segment across the epoch. The score of a
+    // segment is the sum of the frequencies of the distinct d-mers in it.
+    uint64_t score = 0;
+    uint64_t best_score = 0;
+    size_t best_begin = begin;
+    for (size_t pos = begin; pos < end; pos++) {
+      const uint32_t id = dmers[pos];
+      if (id != kNoDmer && active[id]++ == 0)
+        score += frequencies[id];
+      if (pos >= begin + dmers_per_segment) {
+        const uint32_t old = dmers[pos - dmers_per_segment];
+        if (old != kNoDmer && --active[old] == 0)
+          score -= frequencies[old];
+      }
+      if (score > best_score) {
+        best_score = score;
+        best_begin = pos + 1 >= begin + dmers_per_segment ?
+            pos + 1 - dmers_per_segment : begin;
+      }
+    }
+    for (size_t pos = end > dmers_per_segment ? end - dmers_per_segment : 0;
+         pos < end; pos++) {
+      if (dmers[pos] != kNoDmer)
+        active[dmers[pos]] = 0;
+    }
+
+    if (best_score == 0) {
+      empty_epochs++;
+      continue;
+    }
+    empty_epochs = 0;
+
+    // Cut off the parts of the segment that do not contribute anything, and
+    // make sure that the d-mers in it do not count for later segments.
+    const size_t last = std::min(best_begin + dmers_per_segment, end);
+    size_t segment_begin = last;
+    size_t segment_end = best_begin;
+    for (size_t pos = best_begin; pos < last; pos++) {
+      const uint32_t id = dmers[pos];
+      if (id == kNoDmer || frequencies[id] == 0)
+        continue;
+      segment_begin = std::min(segment_begin, pos);
+      segment_end = pos + kDmerLength;
+      frequencies[id] = 0;
+    }
+
+    const size_t length = std::min(segment_end - segment_begin, tail);
+    tail -= length;
+    memcpy(dictionary.data() + tail, data.data() + segment_begin, length);
+  }
+
+  dictionary.erase(dictionary.begin(), dictionary.begin() + tail);
+  return dictionary;
+}
+
+}  // namespace node
@@ -0,0 +1,28 @@
+#ifndef SRC_DICTIONARY_TRAINER_H_
+#define SRC_DICTIONARY_TRAINER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <vector>
+
+namespace node {
+
+struct DictionarySample {
+  const unsigned char* data;
+  size_t length;
+};
+
+// Builds a compression dictionary of at most `size` bytes from pieces of
+// the samples that occur in many of them, following the COVER algorithm
+// that zstd uses for its dictionaries. The pieces that are expected to pay
+// off most come last, because references to the end of a dictionary are the
+// cheapest for deflate. The result is empty if the samples share nothing.
+std::vector<unsigned char> TrainDictionary(
+    const std::vector<DictionarySample>& samples, size_t size);
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_DICTIONARY_TRAINER_H_
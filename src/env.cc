@@ -8,6 +8,7 @@
 #include "node_buffer.h"
 #include "node_context_data.h"
 #include "node_errors.h"
+#include "node_file_uring.h"
 #include "node_internals.h"
 #include "node_options-inl.h"
 #include "node_process.h"
@@ -20,6 +21,10 @@
 #include "util-inl.h"
 #include "v8-profiler.h"
 
+#if HAVE_OPENSSL
+#include "crypto/crypto_bio.h"
+#endif  // HAVE_OPENSSL
+
 #include <algorithm>
 #include <atomic>
 #include <cinttypes>
@@ -538,6 +543,13 @@ Environment::~Environment() {
     }
   }
 
+#if HAVE_OPENSSL
+  // NodeBIOs that are freed later, e.g. by OpenSSL objects that are still
+  // referenced elsewhere, keep the pool alive without the Environment.
+  if (nodebio_pool_)
+    nodebio_pool_->Detach();
+#endif  // HAVE_OPENSSL
+
   CHECK_EQ(base_object_count_, 0);
 }
 
@@ -581,6 +593,9 @@ void Environment::InitializeLibuv() {
   // the one environment per process setup, but will be called in
   // FreeEnvironment.
   RegisterHandleCleanups();
+
+  if (options_->experimental_fs_io_uring)
+    fs::uring::Initialize(this);
 }
 
 void Environment::ExitEnv() {
@@ -1593,6 +1608,9 @@ void Environment::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("async_hooks", async_hooks_);
   tracker->TrackField("immediate_info", immediate_info_);
   tracker->TrackField("tick_info", tick_info_);
+#if HAVE_OPENSSL
+  tracker->TrackField("nodebio_pool", nodebio_pool_);
+#endif  // HAVE_OPENSSL
 
 #define V(PropertyName, TypeName)                                              \
   tracker->TrackField(#PropertyName, PropertyName());
@@ -1610,6 +1628,18 @@ void Environment::MemoryInfo(MemoryTracker* tracker) const {
   // node, we shift its sizeof() size out of the Environment node.
 }
 
+#if HAVE_OPENSSL
+const std::shared_ptr<crypto::NodeBIOPool>& Environment::nodebio_pool() {
+  if (!nodebio_pool_)
+    nodebio_pool_ = std::make_shared<crypto::NodeBIOPool>(this);
+  return nodebio_pool_;
+}
+
+crypto::NodeBIOPool* Environment::existing_nodebio_pool() const {
+  return nodebio_pool_.get();
+}
+#endif  // HAVE_OPENSSL
+
 void Environment::RunWeakRefCleanup() {
   isolate()->ClearKeptObjects();
 }
@@ -83,6 +83,12 @@ namespace worker {
 class Worker;
 }
 
+#if HAVE_OPENSSL
+namespace crypto {
+class NodeBIOPool;
+}
+#endif  // HAVE_OPENSSL
+
 namespace loader {
 class ModuleWrap;
 
@@ -330,10 +336,12 @@ constexpr size_t kFsStatsBufferLength =
   V(ondone_string, "ondone")                                                   \
   V(onerror_string, "onerror")                                                 \
   V(onexit_string, "onexit")                                                   \
+  V(onfiledone_string, "onfiledone")                                           \
   V(onhandshakedone_string, "onhandshakedone")                                 \
   V(onhandshakestart_string, "onhandshakestart")                               \
   V(onkeylog_string, "onkeylog")                                               \
   V(onmessage_string, "onmessage")                                             \
+  V(onmessages_string, "onmessages")                                           \
   V(onnewsession_string, "onnewsession")                                       \
   V(onocspresponse_string, "onocspresponse")                                   \
   V(onreadstart_string, "onreadstart")                                         \
@@ -453,6 +461,8 @@ constexpr size_t kFsStatsBufferLength =
   V(http2settings_constructor_template, v8::ObjectTemplate)                    \
   V(http2stream_constructor_template, v8::ObjectTemplate)                      \
   V(http2ping_constructor_template, v8::ObjectTemplate)                        \
+  V(http2filereadwrap_constructor_template, v8::ObjectTemplate)                \
+  V(http_header_block_template, v8::ObjectTemplate)                            \
   V(i18n_converter_template, v8::ObjectTemplate)                               \
   V(intervalhistogram_constructor_template, v8::FunctionTemplate)              \
   V(libuv_stream_wrap_ctor_template, v8::FunctionTemplate)                     \
@@ -571,6 +581,8 @@ class IsolateData : public MemoryRetainer {
 
   size_t max_young_gen_size = 1;
   std::unordered_map<const char*, v8::Eternal<v8::String>> static_str_map;
+  // Strings for the names in HTTP_KNOWN_HEADERS, see GetKnownHeaderName().
+  std::vector<v8::Eternal<v8::String>> http_header_names;
 
   inline v8::Isolate* isolate() const;
   IsolateData(const IsolateData&) = delete;
@@ -1371,6 +1383,13 @@ class Environment : public MemoryRetainer {
   inline std::unordered_map<char*, std::unique_ptr<v8::BackingStore>>*
       released_allocated_buffers();
 
+#if HAVE_OPENSSL
+  // Provides the memory chunks of the NodeBIOs used by TLS connections.
+  const std::shared_ptr<crypto::NodeBIOPool>& nodebio_pool();
+  // Like nodebio_pool(), but returns nullptr instead of creating the pool.
+  crypto::NodeBIOPool* existing_nodebio_pool() const;
+#endif  // HAVE_OPENSSL
+
   void AddUnmanagedFd(int fd);
   void RemoveUnmanagedFd(int fd);
 
@@ -1541,6 +1560,10 @@ class Environment : public MemoryRetainer {
   // a given pointer.
   std::unordered_map<char*, std::unique_ptr<v8::BackingStore>>
       released_allocated_buffers_;
+
+#if HAVE_OPENSSL
+  std::shared_ptr<crypto::NodeBIOPool> nodebio_pool_;
+#endif  // HAVE_OPENSSL
 };
 
 }  // namespace node
@@ -0,0 +1,236 @@
+#include "hex.h"
+#include "node_simd.h"
+
+#if defined(NODE_SIMD_X86)
+#include <immintrin.h>
+#elif defined(NODE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace node {
+
+namespace {
+
+#if defined(NODE_SIMD_X86)
+
+NODE_TARGET_SSE41
+inline __m128i HexDigitsSSE41() {
+  return _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+}
+
+NODE_TARGET_SSE41
+size_t EncodeSSE41(const uint8_t* src, size_t slen, char* dst) {
+  const __m128i digits = HexDigitsSSE41();
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  // Every iteration turns 16 bytes into 32 digits.
+  for (; i + 16 <= slen; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+    const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(in, nibble));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i),
+                     _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16),
+                     _mm_unpackhi_epi8(hi, lo));
+  }
+  return i;
+}
+
+NODE_TARGET_AVX2
+size_t EncodeAVX2(const uint8_t* src, size_t slen, char* dst) {
+  const __m256i digits = _mm256_broadcastsi128_si256(HexDigitsSSE41());
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  // Every iteration turns 32 bytes into 64 digits.
+  for (; i + 32 <= slen; i += 32) {
+    const __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i hi = _mm256_shuffle_epi8(
+        digits, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble));
+    const __m256i lo =
+        _mm256_shuffle_epi8(digits, _mm256_and_si256(in, nibble));
+    // Interleaving works within 128-bit lanes, which leaves the output for
+    // bytes 0-7 and 16-23 in `first`, and for 8-15 and 24-31 in `second`.
+    const __m256i first = _mm256_unpacklo_epi8(hi, lo);
+    const __m256i second = _mm256_unpackhi_epi8(hi, lo);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i),
+                        _mm256_permute2x128_si256(first, second, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i + 32),
+                        _mm256_permute2x128_si256(first, second, 0x31));
+  }
+  return i;
+}
+
+// Translates 16 hex digits into their values. Returns false if any of them
+// is not a hex digit.
+NODE_TARGET_SSE41
+inline bool TranslateSSE41(__m128i in, __m128i* values) {
+  const __m128i digit = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+  const __m128i is_digit =
+      _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+  // Setting 0x20 turns uppercase letters into lowercase ones.
+  const __m128i letter =
+      _mm_sub_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  const __m128i is_letter =
+      _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+  if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xffff)
+    return false;
+  *values = _mm_or_si128(
+      _mm_and_si128(is_digit, digit),
+      _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+  return true;
+}
+
+NODE_TARGET_SSE41
+size_t DecodeSSE41(char* dst, size_t dstlen,
+                   const uint8_t* src, size_t srclen) {
+  // Multiplies the high digit of every pair by 16 and adds the low one.
+  const __m128i weights = _mm_set1_epi16(0x0110);
+  size_t k = 0;
+  // Every iteration turns 32 digits into 16 bytes.
+  for (; 2 * k + 32 <= srclen && k + 16 <= dstlen; k += 16) {
+    __m128i a;
+    __m128i b;
+    if (!TranslateSSE41(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + 2 * k)), &a) ||
+        !TranslateSSE41(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + 2 * k + 16)), &b)) {
+      break;
+    }
+    const __m128i out = _mm_packus_epi16(_mm_maddubs_epi16(a, weights),
+                                         _mm_maddubs_epi16(b, weights));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k), out);
+  }
+  return k;
+}
+
+NODE_TARGET_AVX2
+inline bool TranslateAVX2(__m256i in, __m256i* values) {
+  const __m256i digit = _mm256_sub_epi8(in, _mm256_set1_epi8('0'));
+  const __m256i is_digit =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+  const __m256i letter = _mm256_sub_epi8(
+      _mm256_or_si256(in, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+  const __m256i is_letter =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+  if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)) != -1)
+    return false;
+  *values = _mm256_or_si256(
+      _mm256_and_si256(is_digit, digit),
+      _mm256_and_si256(is_letter,
+                       _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+  return true;
+}
+
+NODE_TARGET_AVX2
+size_t DecodeAVX2(char* dst, size_t dstlen,
+                  const uint8_t* src, size_t srclen) {
+  const __m256i weights = _mm256_set1_epi16(0x0110);
+  size_t k = 0;
+  // Every iteration turns 64 digits into 32 bytes.
+  for (; 2 * k + 64 <= srclen && k + 32 <= dstlen; k += 32) {
+    __m256i a;
+    __m256i b;
+    if (!TranslateAVX2(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src + 2 * k)), &a) ||
+        !TranslateAVX2(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src + 2 * k + 32)), &b)) {
+      break;
+    }
+    // Packing works within 128-bit lanes, so the 64-bit quarters of the
+    // result need to be put back in order.
+    const __m256i packed = _mm256_packus_epi16(
+        _mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k),
+                        _mm256_permute4x64_epi64(packed, 0xd8));
+  }
+  return k;
+}
+
+#elif defined(NODE_SIMD_NEON)
+
+size_t EncodeNEON(const uint8_t* src, size_t slen, char* dst) {
+  static const uint8_t kDigits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+  };
+  const uint8x16_t digits = vld1q_u8(kDigits);
+  size_t i = 0;
+  // Every iteration turns 16 bytes into 32 digits.
+  for (; i + 16 <= slen; i += 16) {
+    const uint8x16_t in = vld1q_u8(src + i);
+    uint8x16x2_t out;
+    out.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(in, 4));
+    out.val[1] = vqtbl1q_u8(digits, vandq_u8(in, vdupq_n_u8(0x0f)));
+    vst2q_u8(reinterpret_cast<uint8_t*>(dst + 2 * i), out);
+  }
+  return i;
+}
+
+inline bool TranslateNEON(uint8x16_t in, uint8x16_t* values) {
+  const uint8x16_t digit = vsubq_u8(in, vdupq_n_u8('0'));
+  const uint8x16_t is_digit = vcleq_u8(digit, vdupq_n_u8(9));
+  const uint8x16_t letter =
+      vsubq_u8(vorrq_u8(in, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+  const uint8x16_t is_letter = vcleq_u8(letter, vdupq_n_u8(5));
+  if (vminvq_u8(vorrq_u8(is_digit, is_letter)) == 0)
+    return false;
+  *values = vorrq_u8(vandq_u8(is_digit, digit),
+                     vandq_u8(is_letter, vaddq_u8(letter, vdupq_n_u8(10))));
+  return true;
+}
+
+size_t DecodeNEON(char* dst, size_t dstlen,
+                  const uint8_t* src, size_t srclen) {
+  size_t k = 0;
+  // Every iteration turns 32 digits into 16 bytes.
+  for (; 2 * k + 32 <= srclen && k + 16 <= dstlen; k += 16) {
+    const uint8x16x2_t in = vld2q_u8(src + 2 * k);
+    uint8x16_t hi;
+    uint8x16_t lo;
+    if (!TranslateNEON(in.val[0], &hi) || !TranslateNEON(in.val[1], &lo))
+      break;
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + k),
+             vorrq_u8(vshlq_n_u8(hi, 4), lo));
+  }
+  return k;
+}
+
+#endif  // defined(NODE_SIMD_NEON)
+
+}  // anonymous namespace
+
+size_t hex_encode_simd(const char* src, size_t slen, char* dst) {
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+  size_t i = 0;
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kAVX2))
+    i = EncodeAVX2(in, slen, dst);
+  if (simd::Supports(simd::kSSE41))
+    i += EncodeSSE41(in + i, slen - i, dst + 2 * i);
+#elif defined(NODE_SIMD_NEON)
+  i = EncodeNEON(in, slen, dst);
+#endif
+  return i;
+}
+
+size_t hex_decode_simd(char* dst,
+                       size_t dstlen,
+                       const uint8_t* src,
+                       size_t srclen) {
+  size_t k = 0;
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kAVX2))
+    k = DecodeAVX2(dst, dstlen, src, srclen);
+  if (simd::Supports(simd::kSSE41))
+    k += DecodeSSE41(dst + k, dstlen - k, src + 2 * k, srclen - 2 * k);
+#elif defined(NODE_SIMD_NEON)
+  k = DecodeNEON(dst, dstlen, src, srclen);
+#endif
+  return k;
+}
+
+}  // namespace node
@@ -0,0 +1,34 @@
+#ifndef SRC_HEX_H_
+#define SRC_HEX_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <cstdint>
+
+namespace node {
+
+// Vectorized hex conversion for the bulk of the data, implemented in hex.cc
+// for the instruction sets that the CPU supports. Both functions process a
+// prefix of their input and leave the rest to the scalar code in
+// string_bytes.cc, which defines the exact semantics.
+
+// Encodes a prefix of `src` into lowercase hex digits. Returns the number of
+// bytes of `src` that have been encoded; their digits fill `dst` up to twice
+// that length.
+size_t hex_encode_simd(const char* src, size_t slen, char* dst);
+
+// Decodes pairs of hex digits from `src`, stopping before the first block
+// that contains anything else, or when `dst` is full. Digits may be upper-
+// or lowercase. Returns the number of bytes written to `dst`, which is half
+// the number of characters consumed.
+size_t hex_decode_simd(char* dst,
+                       size_t dstlen,
+                       const uint8_t* src,
+                       size_t srclen);
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_HEX_H_
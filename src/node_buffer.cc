@@ -26,6 +26,7 @@
 #include "node_errors.h"
 #include "node_external_reference.h"
 #include "node_internals.h"
+#include "node_utf8.h"
 
 #include "env-inl.h"
 #include "string_bytes.h"
@@ -35,6 +36,7 @@
 
 #include <cstring>
 #include <climits>
+#include <vector>
 
 #define THROW_AND_RETURN_UNLESS_BUFFER(env, obj)                            \
   THROW_AND_RETURN_IF_NOT_BUFFER(env, obj, "argument")                      \
@@ -49,6 +51,7 @@
 namespace node {
 namespace Buffer {
 
+using v8::Array;
 using v8::ArrayBuffer;
 using v8::ArrayBufferView;
 using v8::BackingStore;
@@ -690,8 +693,10 @@ void ByteLengthUtf8(const FunctionCallbackInfo<Value> &args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK(args[0]->IsString());
 
-  // Fast case: avoid StringBytes on UTF8 string. Jump to v8.
-  args.GetReturnValue().Set(args[0].As<String>()->Utf8Length(env->isolate()));
+  // Fast case: avoid the encoding dispatch of StringBytes::Size().
+  const size_t length =
+      StringBytes::Utf8Length(env->isolate(), args[0].As<String>());
+  args.GetReturnValue().Set(static_cast<double>(length));
 }
 
 // Normalize val to be an integer in the range of [1, -1] since
@@ -1030,6 +1035,60 @@ void IndexOfNumber(const FunctionCallbackInfo<Value>& args) {
                                 : -1);
 }
 
+void IndexOfAny(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsNumber());
+
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  ArrayBufferViewContents<uint8_t> haystack(args[0]);
+  Local<Array> values = args[1].As<Array>();
+  int64_t offset_i64 = args[2].As<Integer>()->Value();
+
+  // Gather the needles into one allocation, which also takes care of
+  // Uint8Arrays whose contents live on the V8 heap.
+  const uint32_t count = values->Length();
+  std::vector<uint8_t> storage;
+  std::vector<size_t> lengths(count);
+  size_t min_length = SIZE_MAX;
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> value;
+    if (!values->Get(env->context(), i).ToLocal(&value)) return;
+    CHECK(value->IsUint8Array());
+    ArrayBufferViewContents<uint8_t> needle(value);
+    storage.insert(storage.end(), needle.data(),
+                   needle.data() + needle.length());
+    lengths[i] = needle.length();
+    min_length = std::min(min_length, lengths[i]);
+  }
+  if (count == 0)
+    return args.GetReturnValue().Set(-1);
+
+  int64_t opt_offset =
+      IndexOfOffset(haystack.length(), offset_i64, min_length, true);
+  if (min_length == 0) {
+    // Match indexOf() with an empty needle.
+    return args.GetReturnValue().Set(static_cast<double>(opt_offset));
+  }
+  if (opt_offset <= -1)
+    return args.GetReturnValue().Set(-1);
+
+  std::vector<const uint8_t*> needles(count);
+  size_t start = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    needles[i] = storage.data() + start;
+    start += lengths[i];
+  }
+
+  size_t result = stringsearch::SearchAny(haystack.data(),
+                                          haystack.length(),
+                                          needles.data(),
+                                          lengths.data(),
+                                          count,
+                                          static_cast<size_t>(opt_offset));
+  args.GetReturnValue().Set(result == haystack.length() ?
+      -1 : static_cast<double>(result));
+}
 
 void Swap16(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -1067,14 +1126,10 @@ static void EncodeUtf8String(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsString());
 
   Local<String> str = args[0].As<String>();
-  size_t length = str->Utf8Length(isolate);
+  size_t length = StringBytes::Utf8Length(isolate, str);
   AllocatedBuffer buf = AllocatedBuffer::AllocateManaged(env, length);
-  str->WriteUtf8(isolate,
-                 buf.data(),
-                 -1,  // We are certain that `data` is sufficiently large
-                 nullptr,
-                 String::NO_NULL_TERMINATION | String::REPLACE_INVALID_UTF8);
-  auto array = Uint8Array::New(buf.ToArrayBuffer(), 0, length);
+  size_t written = StringBytes::Write(isolate, buf.data(), length, str, UTF8);
+  auto array = Uint8Array::New(buf.ToArrayBuffer(), 0, written);
   args.GetReturnValue().Set(array);
 }
 
@@ -1102,17 +1157,27 @@ static void EncodeInto(const FunctionCallbackInfo<Value>& args) {
       result_arr->ByteOffset());
 
   int nchars;
-  int written = source->WriteUtf8(
-      isolate,
-      write_result,
-      dest_length,
-      &nchars,
-      String::NO_NULL_TERMINATION | String::REPLACE_INVALID_UTF8);
+  size_t written = StringBytes::Write(
+      isolate, write_result, dest_length, source, UTF8, &nchars);
   results[0] = nchars;
   results[1] = written;
 }
 
 
+static void IsUtf8(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<char> contents(args[0]);
+  args.GetReturnValue().Set(utf8::IsValid(contents.data(), contents.length()));
+}
+
+
+static void IsAscii(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<char> contents(args[0]);
+  args.GetReturnValue().Set(utf8::IsAscii(contents.data(), contents.length()));
+}
+
+
 void SetBufferPrototype(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -1166,6 +1231,7 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "fill", Fill);
   env->SetMethodNoSideEffect(target, "indexOfBuffer", IndexOfBuffer);
   env->SetMethodNoSideEffect(target, "indexOfNumber", IndexOfNumber);
+  env->SetMethodNoSideEffect(target, "indexOfAny", IndexOfAny);
   env->SetMethodNoSideEffect(target, "indexOfString", IndexOfString);
 
   env->SetMethod(target, "swap16", Swap16);
@@ -1174,6 +1240,8 @@ void Initialize(Local<Object> target,
 
   env->SetMethod(target, "encodeInto", EncodeInto);
   env->SetMethodNoSideEffect(target, "encodeUtf8String", EncodeUtf8String);
+  env->SetMethodNoSideEffect(target, "isUtf8", IsUtf8);
+  env->SetMethodNoSideEffect(target, "isAscii", IsAscii);
 
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "kMaxLength"),
@@ -1217,6 +1285,7 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(Fill);
   registry->Register(IndexOfBuffer);
   registry->Register(IndexOfNumber);
+  registry->Register(IndexOfAny);
   registry->Register(IndexOfString);
 
   registry->Register(Swap16);
@@ -1225,6 +1294,8 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
 
   registry->Register(EncodeInto);
   registry->Register(EncodeUtf8String);
+  registry->Register(IsUtf8);
+  registry->Register(IsAscii);
 
   registry->Register(StringSlice<ASCII>);
   registry->Register(StringSlice<BASE64>);
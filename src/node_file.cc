@@ -20,6 +20,7 @@
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "node_file.h"  // NOLINT(build/include_inline)
 #include "node_file-inl.h"
+#include "node_file_uring.h"
 #include "aliased_buffer.h"
 #include "memory_tracker-inl.h"
 #include "node_buffer.h"
@@ -32,6 +33,7 @@
 #include "req_wrap-inl.h"
 #include "stream_base-inl.h"
 #include "string_bytes.h"
+#include "threadpoolwork-inl.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
@@ -373,7 +375,7 @@ MaybeLocal<Promise> FileHandle::ClosePromise() {
         close->Resolve();
       }
     }};
-    int ret = req->Dispatch(uv_fs_close, fd_, AfterClose);
+    int ret = req->Dispatch(uring::Close, fd_, AfterClose);
     if (ret < 0) {
       req->Reject(UVException(isolate, ret, "close"));
       delete req;
@@ -473,7 +475,7 @@ int FileHandle::ReadStart() {
 
   current_read_ = std::move(read_wrap);
 
-  current_read_->Dispatch(uv_fs_read,
+  current_read_->Dispatch(uring::Read,
                           fd_,
                           &current_read_->buffer_,
                           1,
@@ -511,14 +513,7 @@ int FileHandle::ReadStart() {
       if (handle->read_length_ >= 0 && handle->read_length_ < result)
         result = handle->read_length_;
 
-      // If we read data and we have an expected length, decrease it by
-      // how much we have read.
-      if (handle->read_length_ >= 0)
-        handle->read_length_ -= result;
-
-      // If we have an offset, increase it by how much we have read.
-      if (handle->read_offset_ >= 0)
-        handle->read_offset_ += result;
+      handle->AdvanceRead(result);
     }
 
     // Reading 0 bytes from a file always means EOF, or that we reached
@@ -541,6 +536,17 @@ int FileHandle::ReadStop() {
   return 0;
 }
 
+void FileHandle::AdvanceRead(int64_t bytes) {
+  // If we read data and we have an expected length, decrease it by
+  // how much we have read.
+  if (read_length_ >= 0)
+    read_length_ -= bytes;
+
+  // If we have an offset, increase it by how much we have read.
+  if (read_offset_ >= 0)
+    read_offset_ += bytes;
+}
+
 typedef SimpleShutdownWrap<ReqWrap<uv_fs_t>> FileHandleCloseWrap;
 
 ShutdownWrap* FileHandle::CreateShutdownWrap(Local<Object> object) {
@@ -550,7 +556,7 @@ ShutdownWrap* FileHandle::CreateShutdownWrap(Local<Object> object) {
 int FileHandle::DoShutdown(ShutdownWrap* req_wrap) {
   FileHandleCloseWrap* wrap = static_cast<FileHandleCloseWrap*>(req_wrap);
   closing_ = true;
-  wrap->Dispatch(uv_fs_close, fd_, uv_fs_callback_t{[](uv_fs_t* req) {
+  wrap->Dispatch(uring::Close, fd_, uv_fs_callback_t{[](uv_fs_t* req) {
     FileHandleCloseWrap* wrap = static_cast<FileHandleCloseWrap*>(
         FileHandleCloseWrap::from_req(req));
     FileHandle* handle = static_cast<FileHandle*>(wrap->stream());
@@ -882,7 +888,7 @@ void Close(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 1);
   if (req_wrap_async != nullptr) {  // close(fd, req)
     AsyncCall(env, req_wrap_async, args, "close", UTF8, AfterNoArgs,
-              uv_fs_close, fd);
+              uring::Close, fd);
   } else {  // close(fd, undefined, ctx)
     CHECK_EQ(argc, 3);
     FSReqWrapSync req_wrap_sync;
@@ -1023,7 +1029,7 @@ static void Stat(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 2, use_bigint);
   if (req_wrap_async != nullptr) {  // stat(path, use_bigint, req)
     AsyncCall(env, req_wrap_async, args, "stat", UTF8, AfterStat,
-              uv_fs_stat, *path);
+              uring::Stat, *path);
   } else {  // stat(path, use_bigint, undefined, ctx)
     CHECK_EQ(argc, 4);
     FSReqWrapSync req_wrap_sync;
@@ -1054,7 +1060,7 @@ static void LStat(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 2, use_bigint);
   if (req_wrap_async != nullptr) {  // lstat(path, use_bigint, req)
     AsyncCall(env, req_wrap_async, args, "lstat", UTF8, AfterStat,
-              uv_fs_lstat, *path);
+              uring::LStat, *path);
   } else {  // lstat(path, use_bigint, undefined, ctx)
     CHECK_EQ(argc, 4);
     FSReqWrapSync req_wrap_sync;
@@ -1086,7 +1092,7 @@ static void FStat(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 2, use_bigint);
   if (req_wrap_async != nullptr) {  // fstat(fd, use_bigint, req)
     AsyncCall(env, req_wrap_async, args, "fstat", UTF8, AfterStat,
-              uv_fs_fstat, fd);
+              uring::FStat, fd);
   } else {  // fstat(fd, use_bigint, undefined, ctx)
     CHECK_EQ(argc, 4);
     FSReqWrapSync req_wrap_sync;
@@ -1103,6 +1109,140 @@ static void FStat(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+// Stats a whole list of paths on a single threadpool work item, so that
+// callers with many independent stat() calls pay for one JS<->C++ crossing,
+// one request object and one threadpool round trip in total.
+class StatManyWork final : public ThreadPoolWork {
+ public:
+  StatManyWork(Environment* env,
+               std::vector<std::string>&& paths,
+               bool follow_symlinks)
+      : ThreadPoolWork(env),
+        paths_(std::move(paths)),
+        stats_(paths_.size()),
+        errors_(paths_.size()),
+        follow_symlinks_(follow_symlinks) {}
+
+  void set_req_wrap(FSReqBase* req_wrap) { req_wrap_.reset(req_wrap); }
+
+  void StatAll() {
+    for (size_t i = 0; i < paths_.size(); i++) {
+      uv_fs_t req;
+      const char* path = paths_[i].c_str();
+      int err = follow_symlinks_ ? uv_fs_stat(nullptr, &req, path, nullptr)
+                                 : uv_fs_lstat(nullptr, &req, path, nullptr);
+      if (err == 0)
+        stats_[i] = req.statbuf;
+      errors_[i] = err;
+      uv_fs_req_cleanup(&req);
+    }
+  }
+
+  // Returns a [stats, errors] pair. `stats` holds kFsStatsFieldsNumber
+  // entries per path, laid out like the statValues array, and `errors` holds
+  // the libuv error code for each path, or 0 if its stats are valid.
+  Local<Value> ToJS(bool use_bigint) {
+    Isolate* isolate = env()->isolate();
+    EscapableHandleScope scope(isolate);
+    const size_t count = paths_.size();
+    constexpr size_t kFields =
+        static_cast<size_t>(FsStatsOffset::kFsStatsFieldsNumber);
+
+    Local<Value> stats;
+    if (use_bigint) {
+      AliasedBigUint64Array fields(isolate, count * kFields);
+      for (size_t i = 0; i < count; i++) {
+        if (errors_[i] == 0)
+          FillStatsArray(&fields, &stats_[i], i * kFields);
+      }
+      stats = Local<Value>::New(isolate, fields.GetJSArray());
+    } else {
+      AliasedFloat64Array fields(isolate, count * kFields);
+      for (size_t i = 0; i < count; i++) {
+        if (errors_[i] == 0)
+          FillStatsArray(&fields, &stats_[i], i * kFields);
+      }
+      stats = Local<Value>::New(isolate, fields.GetJSArray());
+    }
+
+    AliasedInt32Array errors(isolate, count);
+    for (size_t i = 0; i < count; i++)
+      errors.SetValue(i, errors_[i]);
+
+    Local<Value> result[] = {
+      stats,
+      Local<Value>::New(isolate, errors.GetJSArray())
+    };
+    return scope.Escape(Array::New(isolate, result, arraysize(result)));
+  }
+
+  void DoThreadPoolWork() override {
+    StatAll();
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<StatManyWork> self(this);
+    BaseObjectPtr<FSReqBase> req_wrap = std::move(req_wrap_);
+    HandleScope handle_scope(env()->isolate());
+    Context::Scope context_scope(env()->context());
+
+    req_wrap->Detach();
+    if (status != 0) {
+      req_wrap->Reject(UVException(env()->isolate(), status,
+                                   req_wrap->syscall()));
+    } else {
+      req_wrap->Resolve(ToJS(req_wrap->use_bigint()));
+    }
+  }
+
+ private:
+  BaseObjectPtr<FSReqBase> req_wrap_;
+  std::vector<std::string> paths_;
+  std::vector<uv_stat_t> stats_;
+  std::vector<int> errors_;
+  bool follow_symlinks_;
+};
+
+static void StatMany(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 3);
+
+  CHECK(args[0]->IsArray());
+  Local<Array> list = args[0].As<Array>();
+  std::vector<std::string> paths;
+  paths.reserve(list->Length());
+  for (uint32_t i = 0; i < list->Length(); i++) {
+    Local<Value> element;
+    if (!list->Get(env->context(), i).ToLocal(&element))
+      return;
+    BufferValue path(isolate, element);
+    CHECK_NOT_NULL(*path);
+    paths.emplace_back(*path, path.length());
+  }
+
+  bool use_bigint = args[1]->IsTrue();
+  bool follow_symlinks = args[2]->IsTrue();
+  std::unique_ptr<StatManyWork> work(
+      new StatManyWork(env, std::move(paths), follow_symlinks));
+
+  FSReqBase* req_wrap_async = GetReqWrap(args, 3, use_bigint);
+  if (req_wrap_async != nullptr) {  // statMany(paths, use_bigint, follow, req)
+    req_wrap_async->Init("statMany", nullptr, 0, UTF8);
+    work->set_req_wrap(req_wrap_async);
+    req_wrap_async->SetReturnValue(args);
+    work.release()->ScheduleWork();
+  } else {  // statMany(paths, use_bigint, follow)
+    env->PrintSyncTrace();
+    FS_SYNC_TRACE_BEGIN(statMany);
+    work->StatAll();
+    FS_SYNC_TRACE_END(statMany);
+    args.GetReturnValue().Set(work->ToJS(use_bigint));
+  }
+}
+
 static void Symlink(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   Isolate* isolate = env->isolate();
@@ -1267,7 +1407,7 @@ static void Fdatasync(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 1);
   if (req_wrap_async != nullptr) {
     AsyncCall(env, req_wrap_async, args, "fdatasync", UTF8, AfterNoArgs,
-              uv_fs_fdatasync, fd);
+              uring::Fdatasync, fd);
   } else {
     CHECK_EQ(argc, 3);
     FSReqWrapSync req_wrap_sync;
@@ -1289,7 +1429,7 @@ static void Fsync(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 1);
   if (req_wrap_async != nullptr) {
     AsyncCall(env, req_wrap_async, args, "fsync", UTF8, AfterNoArgs,
-              uv_fs_fsync, fd);
+              uring::Fsync, fd);
   } else {
     CHECK_EQ(argc, 3);
     FSReqWrapSync req_wrap_sync;
@@ -1724,7 +1864,7 @@ static void Open(const FunctionCallbackInfo<Value>& args) {
   if (req_wrap_async != nullptr) {  // open(path, flags, mode, req)
     req_wrap_async->set_is_plain_open(true);
     AsyncCall(env, req_wrap_async, args, "open", UTF8, AfterInteger,
-              uv_fs_open, *path, flags, mode);
+              uring::Open, *path, flags, mode);
   } else {  // open(path, flags, mode, undefined, ctx)
     CHECK_EQ(argc, 5);
     FSReqWrapSync req_wrap_sync;
@@ -1757,7 +1897,7 @@ static void OpenFileHandle(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 3);
   if (req_wrap_async != nullptr) {  // openFileHandle(path, flags, mode, req)
     AsyncCall(env, req_wrap_async, args, "open", UTF8, AfterOpenFileHandle,
-              uv_fs_open, *path, flags, mode);
+              uring::Open, *path, flags, mode);
   } else {  // openFileHandle(path, flags, mode, undefined, ctx)
     CHECK_EQ(argc, 5);
     FSReqWrapSync req_wrap_sync;
@@ -1849,7 +1989,7 @@ static void WriteBuffer(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 5);
   if (req_wrap_async != nullptr) {  // write(fd, buffer, off, len, pos, req)
     AsyncCall(env, req_wrap_async, args, "write", UTF8, AfterInteger,
-              uv_fs_write, fd, &uvbuf, 1, pos);
+              uring::Write, fd, &uvbuf, 1, pos);
   } else {  // write(fd, buffer, off, len, pos, undefined, ctx)
     CHECK_EQ(argc, 7);
     FSReqWrapSync req_wrap_sync;
@@ -1894,7 +2034,7 @@ static void WriteBuffers(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 3);
   if (req_wrap_async != nullptr) {  // writeBuffers(fd, chunks, pos, req)
     AsyncCall(env, req_wrap_async, args, "write", UTF8, AfterInteger,
-              uv_fs_write, fd, *iovs, iovs.length(), pos);
+              uring::Write, fd, *iovs, iovs.length(), pos);
   } else {  // writeBuffers(fd, chunks, pos, undefined, ctx)
     CHECK_EQ(argc, 5);
     FSReqWrapSync req_wrap_sync;
@@ -1966,7 +2106,7 @@ static void WriteString(const FunctionCallbackInfo<Value>& args) {
     len = StringBytes::Write(isolate, *stack_buffer, len, args[1], enc);
     stack_buffer.SetLengthAndZeroTerminate(len);
     uv_buf_t uvbuf = uv_buf_init(*stack_buffer, len);
-    int err = req_wrap_async->Dispatch(uv_fs_write,
+    int err = req_wrap_async->Dispatch(uring::Write,
                                        fd,
                                        &uvbuf,
                                        1,
@@ -2052,7 +2192,7 @@ static void Read(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 5);
   if (req_wrap_async != nullptr) {  // read(fd, buffer, offset, len, pos, req)
     AsyncCall(env, req_wrap_async, args, "read", UTF8, AfterInteger,
-              uv_fs_read, fd, &uvbuf, 1, pos);
+              uring::Read, fd, &uvbuf, 1, pos);
   } else {  // read(fd, buffer, offset, len, pos, undefined, ctx)
     CHECK_EQ(argc, 7);
     FSReqWrapSync req_wrap_sync;
@@ -2098,7 +2238,7 @@ static void ReadBuffers(const FunctionCallbackInfo<Value>& args) {
   FSReqBase* req_wrap_async = GetReqWrap(args, 3);
   if (req_wrap_async != nullptr) {  // readBuffers(fd, buffers, pos, req)
     AsyncCall(env, req_wrap_async, args, "read", UTF8, AfterInteger,
-              uv_fs_read, fd, *iovs, iovs.length(), pos);
+              uring::Read, fd, *iovs, iovs.length(), pos);
   } else {  // readBuffers(fd, buffers, undefined, ctx)
     CHECK_EQ(argc, 5);
     FSReqWrapSync req_wrap_sync;
@@ -2429,6 +2569,7 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "stat", Stat);
   env->SetMethod(target, "lstat", LStat);
   env->SetMethod(target, "fstat", FStat);
+  env->SetMethod(target, "statMany", StatMany);
   env->SetMethod(target, "link", Link);
   env->SetMethod(target, "symlink", Symlink);
   env->SetMethod(target, "readlink", ReadLink);
@@ -259,6 +259,13 @@ class FileHandle final : public AsyncWrap, public StreamBase {
   bool IsClosing() override { return closing_; }
   AsyncWrap* GetAsyncWrap() override { return this; }
 
+  // The range that is still to be read when used as a stream. An offset of
+  // -1 means the current file position, a length of -1 means up to EOF.
+  int64_t read_offset() const { return read_offset_; }
+  int64_t read_length() const { return read_length_; }
+  // Marks `bytes` bytes of that range as consumed.
+  void AdvanceRead(int64_t bytes);
+
   // In the case of file streams, shutting down corresponds to closing.
   ShutdownWrap* CreateShutdownWrap(v8::Local<v8::Object> object) override;
   int DoShutdown(ShutdownWrap* req_wrap) override;
@@ -0,0 +1,757 @@
+#include "node_file_uring.h"
+#include "env-inl.h"
+#include "util-inl.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+// IORING_FEAT_RW_CUR_POS was introduced together with the openat, close and
+// statx opcodes (Linux 5.6), so use it to detect whether the kernel headers
+// are recent enough to build the io_uring backend at all. Whether the running
+// kernel supports a given opcode is probed at runtime.
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup)
+#define NODE_HAVE_IO_URING 1
+#else
+#define NODE_HAVE_IO_URING 0
+#endif
+
+#if NODE_HAVE_IO_URING
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/sysmacros.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#endif
+
+namespace node {
+namespace fs {
+namespace uring {
+
+#if NODE_HAVE_IO_URING
+
+namespace {
+
+// Layout of the kernel's struct statx. Not every libc we build against
+// exposes it, so it is mirrored here the same way libuv does it.
+struct Statx {
+  uint32_t stx_mask;
+  uint32_t stx_blksize;
+  uint64_t stx_attributes;
+  uint32_t stx_nlink;
+  uint32_t stx_uid;
+  uint32_t stx_gid;
+  uint16_t stx_mode;
+  uint16_t unused0;
+  uint64_t stx_ino;
+  uint64_t stx_size;
+  uint64_t stx_blocks;
+  uint64_t stx_attributes_mask;
+  struct {
+    int64_t tv_sec;
+    uint32_t tv_nsec;
+    int32_t unused0;
+  } stx_atime, stx_btime, stx_ctime, stx_mtime;
+  uint32_t stx_rdev_major;
+  uint32_t stx_rdev_minor;
+  uint32_t stx_dev_major;
+  uint32_t stx_dev_minor;
+  uint64_t unused1[14];
+};
+
+// STATX_BASIC_STATS | STATX_BTIME
+constexpr uint32_t kStatxMask = 0xfff;
+constexpr int kAtEmptyPath = 0x1000;
+constexpr int kAtSymlinkNoFollow = 0x100;
+constexpr int kAtFdCwd = -100;
+
+static_assert(sizeof(Statx) == 256, "Statx must match struct statx");
+static_assert(sizeof(uv_buf_t) == sizeof(struct iovec) &&
+              offsetof(uv_buf_t, base) == offsetof(struct iovec, iov_base) &&
+              offsetof(uv_buf_t, len) == offsetof(struct iovec, iov_len),
+              "uv_buf_t must be usable as struct iovec");
+
+void StatxToUvStat(const Statx& s, uv_stat_t* buf) {
+  buf->st_dev = makedev(s.stx_dev_major, s.stx_dev_minor);
+  buf->st_mode = s.stx_mode;
+  buf->st_nlink = s.stx_nlink;
+  buf->st_uid = s.stx_uid;
+  buf->st_gid = s.stx_gid;
+  buf->st_rdev = makedev(s.stx_rdev_major, s.stx_rdev_minor);
+  buf->st_ino = s.stx_ino;
+  buf->st_size = s.stx_size;
+  buf->st_blksize = s.stx_blksize;
+  buf->st_blocks = s.stx_blocks;
+  buf->st_atim.tv_sec = s.stx_atime.tv_sec;
+  buf->st_atim.tv_nsec = s.stx_atime.tv_nsec;
+  buf->st_mtim.tv_sec = s.stx_mtime.tv_sec;
+  buf->st_mtim.tv_nsec = s.stx_mtime.tv_nsec;
+  buf->st_ctim.tv_sec = s.stx_ctime.tv_sec;
+  buf->st_ctim.tv_nsec = s.stx_ctime.tv_nsec;
+  buf->st_birthtim.tv_sec = s.stx_btime.tv_sec;
+  buf->st_birthtim.tv_nsec = s.stx_btime.tv_nsec;
+  buf->st_flags = 0;
+  buf->st_gen = 0;
+}
+
+// A single io_uring instance bound to an Environment's event loop.
+//
+// Submission queue entries are filled in as requests come in and handed to
+// the kernel in one io_uring_enter() call per event loop iteration, from a
+// prepare handle. The ring file descriptor is watched by a poll handle, and
+// completions are dispatched to the request callbacks on the loop thread,
+// without any threadpool involvement.
+//
+// The instance owns itself: it is deleted once both handles have been closed
+// during Environment cleanup, after all in-flight requests have completed.
+class IoUring final {
+ public:
+  // The kernel sizes the completion queue at twice this value, which is also
+  // the maximum number of requests we allow to be in flight, so that the
+  // completion queue can never overflow.
+  static constexpr unsigned kEntries = 256;
+
+  explicit IoUring(Environment* env) : env_(env) {}
+  ~IoUring();
+
+  bool Init();
+
+  uv_loop_t* loop() const { return env_->event_loop(); }
+  bool supports(uint8_t opcode) const { return supported_[opcode]; }
+  bool supports_current_position() const {
+    return (features_ & IORING_FEAT_RW_CUR_POS) != 0;
+  }
+
+  // Returns a zeroed submission queue entry for `req` and initializes `req`
+  // the way libuv would, or returns nullptr if the request has to take the
+  // threadpool path because the ring is saturated or shutting down.
+  io_uring_sqe* GetSqe(uv_fs_t* req, uv_fs_type fs_type, uv_fs_cb cb);
+  // Publishes the entry returned by the previous GetSqe() call.
+  void Commit(io_uring_sqe* sqe, uv_fs_t* req);
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+
+ private:
+  void ProbeOpcodes();
+  io_uring_sqe* NextSqe();
+  void Publish(io_uring_sqe* sqe, uv_fs_t* req);
+  void Flush();
+  void Reap();
+  void Complete(uv_fs_t* req, int32_t res);
+  bool ResubmitWrite(uv_fs_t* req, size_t written);
+  void StartClosing();
+  void Close();
+
+  static void OnPrepare(uv_prepare_t* handle);
+  static void OnPoll(uv_poll_t* handle, int status, int events);
+  static void CleanupHook(Environment* env, uv_handle_t* handle, void* arg);
+
+  Environment* env_;
+  int ring_fd_ = -1;
+  uint32_t features_ = 0;
+  bool supported_[256] = {};
+
+  void* sq_ring_ = MAP_FAILED;
+  void* cq_ring_ = MAP_FAILED;
+  size_t sq_ring_size_ = 0;
+  size_t cq_ring_size_ = 0;
+  io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sqes_size_ = 0;
+
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+  uint32_t sq_tail_local_ = 0;
+
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  io_uring_cqe* cqes_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  uint32_t cq_entries_ = 0;
+
+  uint32_t to_submit_ = 0;
+  uint32_t in_flight_ = 0;
+  bool closing_ = false;
+  bool closed_ = false;
+  int closed_handles_ = 0;
+
+  uv_prepare_t prepare_;
+  uv_poll_t poll_;
+};
+
+// Every event loop is driven by exactly one thread, so a thread-local pointer
+// is enough to find the ring for a given loop without any locking.
+thread_local IoUring* current_ring = nullptr;
+
+inline IoUring* RingFor(uv_loop_t* loop, uv_fs_cb cb) {
+  IoUring* ring = current_ring;
+  if (ring == nullptr || cb == nullptr || ring->loop() != loop)
+    return nullptr;
+  return ring;
+}
+
+IoUring::~IoUring() {
+  if (sqes_ != MAP_FAILED)
+    munmap(sqes_, sqes_size_);
+  if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+    munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_ != MAP_FAILED)
+    munmap(sq_ring_, sq_ring_size_);
+  if (ring_fd_ >= 0)
+    close(ring_fd_);
+}
+
+bool IoUring::Init() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ =
+      static_cast<int>(syscall(__NR_io_uring_setup, kEntries, &params));
+  if (ring_fd_ < 0)
+    return false;
+
+  features_ = params.features;
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = (features_ & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED)
+    return false;
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED)
+      return false;
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = static_cast<io_uring_sqe*>(
+      mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+  if (sqes_ == MAP_FAILED)
+    return false;
+
+  char* sq = static_cast<char*>(sq_ring_);
+  sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+  sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  sq_tail_local_ = *sq_tail_;
+
+  char* cq = static_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+  cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+  cq_entries_ = params.cq_entries;
+
+  ProbeOpcodes();
+
+  if (uv_poll_init(loop(), &poll_, ring_fd_) != 0)
+    return false;
+  CHECK_EQ(0, uv_prepare_init(loop(), &prepare_));
+  poll_.data = this;
+  prepare_.data = this;
+  CHECK_EQ(0, uv_poll_start(&poll_, UV_READABLE, OnPoll));
+  // The poll handle only keeps the loop alive while requests are in flight.
+  uv_unref(reinterpret_cast<uv_handle_t*>(&poll_));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&prepare_));
+
+  env_->RegisterHandleCleanup(reinterpret_cast<uv_handle_t*>(&poll_),
+                              CleanupHook,
+                              this);
+  return true;
+}
+
+void IoUring::ProbeOpcodes() {
+  // Available since io_uring was introduced in Linux 5.1.
+  supported_[IORING_OP_READV] = true;
+  supported_[IORING_OP_WRITEV] = true;
+  supported_[IORING_OP_FSYNC] = true;
+
+  // IORING_REGISTER_PROBE fails with EINVAL before Linux 5.6, in which case
+  // none of the newer opcodes are available either.
+  constexpr size_t kProbeOps = 256;
+  std::vector<char> storage(sizeof(io_uring_probe) +
+                            kProbeOps * sizeof(io_uring_probe_op));
+  io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+  if (syscall(__NR_io_uring_register,
+              ring_fd_,
+              IORING_REGISTER_PROBE,
+              probe,
+              kProbeOps) < 0) {
+    return;
+  }
+  for (size_t i = 0; i < probe->ops_len && i < kProbeOps; i++) {
+    if (probe->ops[i].flags & IO_URING_OP_SUPPORTED)
+      supported_[probe->ops[i].op] = true;
+  }
+}
+
+io_uring_sqe* IoUring::NextSqe() {
+  if (sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >=
+      sq_entries_) {
+    Flush();
+    if (sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >=
+        sq_entries_) {
+      return nullptr;
+    }
+  }
+
+  const uint32_t index = sq_tail_local_ & sq_mask_;
+  io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  return sqe;
+}
+
+void IoUring::Publish(io_uring_sqe* sqe, uv_fs_t* req) {
+  sqe->user_data = reinterpret_cast<uint64_t>(req);
+  __atomic_store_n(sq_tail_, ++sq_tail_local_, __ATOMIC_RELEASE);
+  if (to_submit_++ == 0)
+    uv_prepare_start(&prepare_, OnPrepare);
+}
+
+io_uring_sqe* IoUring::GetSqe(uv_fs_t* req, uv_fs_type fs_type, uv_fs_cb cb) {
+  if (closing_ || in_flight_ >= cq_entries_)
+    return nullptr;
+
+  io_uring_sqe* sqe = NextSqe();
+  if (sqe == nullptr)
+    return nullptr;
+
+  req->type = UV_FS;
+  req->fs_type = fs_type;
+  req->loop = loop();
+  req->cb = cb;
+  req->result = 0;
+  req->ptr = nullptr;
+  req->path = nullptr;
+  req->new_path = nullptr;
+  req->bufs = nullptr;
+  req->nbufs = 0;
+  // uv_cancel() inspects the threadpool work item of the request. Make it
+  // look like one that the threadpool has already picked up, so that
+  // cancellation is refused with UV_EBUSY instead of touching the queue.
+  req->work_req.loop = loop();
+  req->work_req.work = nullptr;
+  req->work_req.done = nullptr;
+  req->work_req.wq[0] = &req->work_req.wq;
+  req->work_req.wq[1] = &req->work_req.wq;
+  return sqe;
+}
+
+void IoUring::Commit(io_uring_sqe* sqe, uv_fs_t* req) {
+  Publish(sqe, req);
+  if (in_flight_++ == 0)
+    uv_ref(reinterpret_cast<uv_handle_t*>(&poll_));
+}
+
+void IoUring::Flush() {
+  while (to_submit_ > 0) {
+    int rc = static_cast<int>(syscall(__NR_io_uring_enter,
+                                      ring_fd_,
+                                      to_submit_,
+                                      0,
+                                      0,
+                                      nullptr,
+                                      0));
+    if (rc < 0 && errno == EINTR)
+      continue;
+    // On EAGAIN/EBUSY the kernel is temporarily out of resources; the
+    // prepare handle stays active and we retry on the next loop iteration.
+    if (rc <= 0)
+      return;
+    to_submit_ -= rc;
+  }
+  uv_prepare_stop(&prepare_);
+}
+
+void IoUring::Reap() {
+  uint32_t head = *cq_head_;
+  for (;;) {
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+      break;
+    const io_uring_cqe* cqe = &cqes_[head & cq_mask_];
+    uv_fs_t* req = reinterpret_cast<uv_fs_t*>(cqe->user_data);
+    const int32_t res = cqe->res;
+    __atomic_store_n(cq_head_, ++head, __ATOMIC_RELEASE);
+    Complete(req, res);
+  }
+
+  if (closing_ && in_flight_ == 0)
+    Close();
+}
+
+bool IoUring::ResubmitWrite(uv_fs_t* req, size_t written) {
+  if (req->off >= 0)
+    req->off += written;
+
+  // Drop the fully written buffers and trim the partially written one, so
+  // that the remaining data can be submitted again. This mirrors what
+  // libuv's uv__fs_write_all() does for short writes.
+  unsigned int done = 0;
+  while (done < req->nbufs && written >= req->bufs[done].len)
+    written -= req->bufs[done++].len;
+  if (done == req->nbufs)
+    return false;
+  memmove(req->bufs,
+          req->bufs + done,
+          (req->nbufs - done) * sizeof(*req->bufs));
+  req->nbufs -= done;
+  req->bufs[0].base += written;
+  req->bufs[0].len -= written;
+
+  io_uring_sqe* sqe = NextSqe();
+  if (sqe == nullptr)
+    return false;
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = req->file;
+  sqe->addr = reinterpret_cast<uint64_t>(req->bufs);
+  sqe->len = req->nbufs;
+  sqe->off = static_cast<uint64_t>(req->off);
+  Publish(sqe, req);
+  return true;
+}
+
+void IoUring::Complete(uv_fs_t* req, int32_t res) {
+  ssize_t result = res;
+  switch (req->fs_type) {
+    case UV_FS_WRITE:
+      // req->result accumulates the bytes written across short writes. An
+      // error after a short write reports what has been written so far.
+      if (res > 0) {
+        req->result += res;
+        if (ResubmitWrite(req, res))
+          return;
+      }
+      if (req->result > 0)
+        result = req->result;
+      break;
+    case UV_FS_STAT:
+    case UV_FS_LSTAT:
+    case UV_FS_FSTAT: {
+      Statx* statx = static_cast<Statx*>(req->ptr);
+      if (res == 0)
+        StatxToUvStat(*statx, &req->statbuf);
+      free(statx);
+      req->ptr = &req->statbuf;
+      break;
+    }
+    default:
+      break;
+  }
+
+  if (--in_flight_ == 0)
+    uv_unref(reinterpret_cast<uv_handle_t*>(&poll_));
+  req->result = result;
+  req->cb(req);
+}
+
+void IoUring::StartClosing() {
+  if (current_ring == this)
+    current_ring = nullptr;
+  closing_ = true;
+  Flush();
+  // Otherwise, Reap() closes the handles once the last request is done.
+  // Environment::CleanupHandles() keeps spinning the loop until then,
+  // because those requests are still counted as waiting requests.
+  if (in_flight_ == 0)
+    Close();
+}
+
+void IoUring::Close() {
+  if (closed_)
+    return;
+  closed_ = true;
+  auto on_close = [](auto* handle) {
+    IoUring* ring = static_cast<IoUring*>(handle->data);
+    if (++ring->closed_handles_ == 2)
+      delete ring;
+  };
+  env_->CloseHandle(&prepare_, on_close);
+  env_->CloseHandle(&poll_, on_close);
+}
+
+void IoUring::OnPrepare(uv_prepare_t* handle) {
+  static_cast<IoUring*>(handle->data)->Flush();
+}
+
+void IoUring::OnPoll(uv_poll_t* handle, int status, int events) {
+  static_cast<IoUring*>(handle->data)->Reap();
+}
+
+void IoUring::CleanupHook(Environment* env, uv_handle_t* handle, void* arg) {
+  static_cast<IoUring*>(arg)->StartClosing();
+}
+
+bool CopyBufs(uv_fs_t* req, const uv_buf_t bufs[], unsigned int nbufs) {
+  // Like libuv, keep small buffer lists inline in the request. Larger ones
+  // are released by uv_fs_req_cleanup().
+  req->bufs = req->bufsml;
+  if (nbufs > arraysize(req->bufsml)) {
+    req->bufs = static_cast<uv_buf_t*>(malloc(nbufs * sizeof(*bufs)));
+    if (req->bufs == nullptr)
+      return false;
+  }
+  memcpy(req->bufs, bufs, nbufs * sizeof(*bufs));
+  req->nbufs = nbufs;
+  return true;
+}
+
+int ReadWrite(IoUring* ring, uint8_t opcode, uv_fs_type fs_type,
+              uv_fs_t* req, uv_file file, const uv_buf_t bufs[],
+              unsigned int nbufs, int64_t offset, uv_fs_cb cb) {
+  io_uring_sqe* sqe = ring->GetSqe(req, fs_type, cb);
+  if (sqe == nullptr)
+    return UV_EAGAIN;
+  if (!CopyBufs(req, bufs, nbufs))
+    return UV_ENOMEM;
+  req->file = file;
+  req->off = offset;
+  sqe->opcode = opcode;
+  sqe->fd = file;
+  sqe->addr = reinterpret_cast<uint64_t>(req->bufs);
+  sqe->len = nbufs;
+  sqe->off = static_cast<uint64_t>(offset);
+  ring->Commit(sqe, req);
+  return 0;
+}
+
+bool CanReadWrite(IoUring* ring, uint8_t opcode,
+                  unsigned int nbufs, int64_t offset) {
+  return ring != nullptr &&
+         ring->supports(opcode) &&
+         nbufs > 0 &&
+         nbufs <= IOV_MAX &&
+         (offset >= 0 || ring->supports_current_position());
+}
+
+int DoStat(IoUring* ring, uv_fs_type fs_type, uv_fs_t* req, int dirfd,
+           const char* path, int flags, uv_fs_cb cb) {
+  // Both are released by uv_fs_req_cleanup() once the callback is done.
+  char* path_copy = fs_type == UV_FS_FSTAT ? nullptr : strdup(path);
+  Statx* statx = static_cast<Statx*>(malloc(sizeof(Statx)));
+  if ((fs_type != UV_FS_FSTAT && path_copy == nullptr) || statx == nullptr) {
+    free(path_copy);
+    free(statx);
+    return UV_ENOMEM;
+  }
+  io_uring_sqe* sqe = ring->GetSqe(req, fs_type, cb);
+  if (sqe == nullptr) {
+    free(path_copy);
+    free(statx);
+    return UV_EAGAIN;
+  }
+  req->path = path_copy;
+  req->ptr = statx;
+  sqe->opcode = IORING_OP_STATX;
+  sqe->fd = dirfd;
+  sqe->addr = reinterpret_cast<uint64_t>(path_copy != nullptr ? path_copy
+                                                              : "");
+  sqe->len = kStatxMask;
+  sqe->statx_flags = flags;
+  sqe->addr2 = reinterpret_cast<uint64_t>(statx);
+  ring->Commit(sqe, req);
+  return 0;
+}
+
+int DoFsync(IoUring* ring, uv_fs_type fs_type, uv_fs_t* req, uv_file file,
+            unsigned int flags, uv_fs_cb cb) {
+  io_uring_sqe* sqe = ring->GetSqe(req, fs_type, cb);
+  if (sqe == nullptr)
+    return UV_EAGAIN;
+  req->file = file;
+  sqe->opcode = IORING_OP_FSYNC;
+  sqe->fd = file;
+  sqe->fsync_flags = flags;
+  ring->Commit(sqe, req);
+  return 0;
+}
+
+}  // anonymous namespace
+
+#endif  // NODE_HAVE_IO_URING
+
+bool Initialize(Environment* env) {
+#if NODE_HAVE_IO_URING
+  if (current_ring != nullptr)
+    return current_ring->loop() == env->event_loop();
+  std::unique_ptr<IoUring> ring(new IoUring(env));
+  if (!ring->Init())
+    return false;
+  current_ring = ring.release();
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool IsActive(uv_loop_t* loop) {
+#if NODE_HAVE_IO_URING
+  return current_ring != nullptr && current_ring->loop() == loop;
+#else
+  return false;
+#endif
+}
+
+// In all of the functions below, a UV_EAGAIN from the ring means that it is
+// saturated, and the request is handed to the threadpool instead.
+
+int Open(uv_loop_t* loop, uv_fs_t* req, const char* path,
+         int flags, int mode, uv_fs_cb cb) {
+#if NODE_HAVE_IO_URING
+  IoUring* ring = RingFor(loop, cb);
+  if (ring != nullptr && ring->supports(IORING_OP_OPENAT)) {
+    char* path_copy = strdup(path);
+    if (path_copy == nullptr)
+      return UV_ENOMEM;
+    io_uring_sqe* sqe = ring->GetSqe(req, UV_FS_OPEN, cb);
+    if (sqe != nullptr) {
+      req->path = path_copy;
+      req->flags = flags;
+      req->mode = mode;
+      sqe->opcode = IORING_OP_OPENAT;
+      sqe->fd = kAtFdCwd;
+      sqe->addr = reinterpret_cast<uint64_t>(path_copy);
+      sqe->len = mode;
+      sqe->open_flags = flags | O_CLOEXEC;
+      ring->Commit(sqe, req);
+      return 0;
+    }
+    free(path_copy);
+  }
+#endif
+  return uv_fs_open(loop, req, path, flags, mode, cb);
+}
+
+int Close(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
+#if NODE_HAVE_IO_URING
+  IoUring* ring = RingFor(loop, cb);
+  if (ring != nullptr && ring->supports(IORING_OP_CLOSE)) {
+    io_uring_sqe* sqe = ring->GetSqe(req, UV_FS_CLOSE, cb);
+    if (sqe != nullptr) {
+      req->file = file;
+      sqe->opcode = IORING_OP_CLOSE;
+      sqe->fd = file;
+      ring->Commit(sqe, req);
+      return 0;
+    }
+  }
+#endif
+  return uv_fs_close(loop, req, file, cb);
+}
+
+int Read(uv_loop_t* loop, uv_fs_t* req, uv_file file,
+         const uv_buf_t bufs[], unsigned int nbufs, int64_t offset,
+         uv_fs_cb cb) {
+#if NODE_HAVE_IO_URING
+  IoUring* ring = RingFor(loop, cb);
+  if (CanReadWrite(ring, IORING_OP_READV, nbufs, offset)) {
+    int err = ReadWrite(ring, IORING_OP_READV, UV_FS_READ,
+                        req, file, bufs, nbufs, offset, cb);
+    if (err != UV_EAGAIN)
+      return err;
+  }
+#endif
+  return uv_fs_read(loop, req, file, bufs, nbufs, offset, cb);
+}
+
+int Write(uv_loop_t* loop, uv_fs_t* req, uv_file file,
+          const uv_buf_t bufs[], unsigned int nbufs, int64_t offset,
+          uv_fs_cb cb) {
+#if NODE_HAVE_IO_URING
+  IoUring* ring = RingFor(loop, cb);
+  if (CanReadWrite(ring, IORING_OP_WRITEV, nbufs, offset)) {
+    int err = ReadWrite(ring, IORING_OP_WRITEV, UV_FS_WRITE,
+                        req, file, bufs, nbufs, offset, cb);
+    if (err != UV_EAGAIN)
+      return err;
+  }
+#endif
+  return uv_fs_write(loop, req, file, bufs, nbufs, offset, cb);
+}
+
+int Stat(uv_loop_t* loop, uv_fs_t* req, const char* path, uv_fs_cb cb) {
+#if NODE_HAVE_IO_URING
+  IoUring* ring = RingFor(loop, cb);
+  if (ring != nullptr && ring->supports(IORING_OP_STATX)) {
+    int err = DoStat(ring, UV_FS_STAT, req, kAtFdCwd, path, 0, cb);
+    if (err != UV_EAGAIN)
+      return err;
+  }
+#endif
+  return uv_fs_stat(loop, req, path, cb);
+}
+
+int LStat(uv_loop_t* loop, uv_fs_t* req, const char* path, uv_fs_cb cb) {
+#if NODE_HAVE_IO_URING
+  IoUring* ring = RingFor(loop, cb);
+  if (ring != nullptr && ring->supports(IORING_OP_STATX)) {
+    int err = DoStat(ring, UV_FS_LSTAT, req, kAtFdCwd, path,
+                     kAtSymlinkNoFollow, cb);
+    if (err != UV_EAGAIN)
+      return err;
+  }
+#endif
+  return uv_fs_lstat(loop, req, path, cb);
+}
+
+int FStat(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
+#if NODE_HAVE_IO_URING
+  IoUring* ring = RingFor(loop, cb);
+  if (ring != nullptr && ring->supports(IORING_OP_STATX)) {
+    int err = DoStat(ring, UV_FS_FSTAT, req, file, nullptr, kAtEmptyPath, cb);
+    if (err != UV_EAGAIN)
+      return err;
+  }
+#endif
+  return uv_fs_fstat(loop, req, file, cb);
+}
+
+int Fsync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
+#if NODE_HAVE_IO_URING
+  IoUring* ring = RingFor(loop, cb);
+  if (ring != nullptr && ring->supports(IORING_OP_FSYNC)) {
+    int err = DoFsync(ring, UV_FS_FSYNC, req, file, 0, cb);
+    if (err != UV_EAGAIN)
+      return err;
+  }
+#endif
+  return uv_fs_fsync(loop, req, file, cb);
+}
+
+int Fdatasync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
+#if NODE_HAVE_IO_URING
+  IoUring* ring = RingFor(loop, cb);
+  if (ring != nullptr && ring->supports(IORING_OP_FSYNC)) {
+    int err = DoFsync(ring, UV_FS_FDATASYNC, req, file,
+                      IORING_FSYNC_DATASYNC, cb);
+    if (err != UV_EAGAIN)
+      return err;
+  }
+#endif
+  return uv_fs_fdatasync(loop, req, file, cb);
+}
+
+}  // namespace uring
+}  // namespace fs
+}  // namespace node
@@ -0,0 +1,53 @@
+#ifndef SRC_NODE_FILE_URING_H_
+#define SRC_NODE_FILE_URING_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "uv.h"
+
+namespace node {
+
+class Environment;
+
+namespace fs {
+namespace uring {
+
+// Sets up an io_uring instance for the event loop of `env`, so that the
+// functions below can submit file system requests directly to the kernel
+// instead of going through the libuv threadpool. Returns false if io_uring
+// is unavailable (non-Linux platforms, old kernels, seccomp filters, ...),
+// in which case every request keeps using the threadpool.
+bool Initialize(Environment* env);
+
+// Whether requests issued on `loop` from the current thread are submitted
+// through io_uring.
+bool IsActive(uv_loop_t* loop);
+
+// Drop-in replacements for the corresponding uv_fs_* functions. Requests are
+// submitted to the ring attached to `loop` if there is one and the kernel
+// supports the operation; otherwise, and for synchronous requests (`cb` is
+// nullptr), they are forwarded to libuv unchanged. Completion is reported
+// through `cb` with `req` filled in exactly as libuv would, so the result
+// can be consumed by the usual After* callbacks and uv_fs_req_cleanup().
+int Open(uv_loop_t* loop, uv_fs_t* req, const char* path,
+         int flags, int mode, uv_fs_cb cb);
+int Close(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb);
+int Read(uv_loop_t* loop, uv_fs_t* req, uv_file file,
+         const uv_buf_t bufs[], unsigned int nbufs, int64_t offset,
+         uv_fs_cb cb);
+int Write(uv_loop_t* loop, uv_fs_t* req, uv_file file,
+          const uv_buf_t bufs[], unsigned int nbufs, int64_t offset,
+          uv_fs_cb cb);
+int Stat(uv_loop_t* loop, uv_fs_t* req, const char* path, uv_fs_cb cb);
+int LStat(uv_loop_t* loop, uv_fs_t* req, const char* path, uv_fs_cb cb);
+int FStat(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb);
+int Fsync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb);
+int Fdatasync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb);
+
+}  // namespace uring
+}  // namespace fs
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_FILE_URING_H_
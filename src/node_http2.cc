@@ -11,10 +11,13 @@
 #include "node_mem-inl.h"
 #include "node_perf.h"
 #include "node_revert.h"
+#include "req_wrap-inl.h"
 #include "stream_base-inl.h"
 #include "util-inl.h"
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
 
 namespace node {
 
@@ -28,6 +31,7 @@ using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
+using v8::Int32;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
@@ -47,6 +51,12 @@ namespace {
 
 const char zero_bytes_256[256] = {};
 
+// The memory used by all sessions of the process, including those on Worker
+// threads, and the limit for it that is set through http2.setMemoryBudget().
+std::atomic<uint64_t> total_session_memory_usage { 0 };
+std::atomic<uint64_t> session_memory_budget {
+    std::numeric_limits<uint64_t>::max() };
+
 bool HasHttp2Observer(Environment* env) {
   AliasedUint32Array& observers = env->performance_state()->observers;
   return observers[performance::NODE_PERFORMANCE_ENTRY_TYPE_HTTP2] != 0;
@@ -201,6 +211,12 @@ Http2Options::Http2Options(Http2State* http2_state, SessionType type) {
         option,
         static_cast<size_t>(buffer[IDX_OPTIONS_MAX_SETTINGS]));
   }
+
+  // The initial window size settings are a poor fit for connections with a
+  // large bandwidth-delay product. With the adaptive window mode, the session
+  // measures it and grows its flow control windows accordingly.
+  if (flags & (1 << IDX_OPTIONS_ADAPTIVE_WINDOW))
+    set_adaptive_window(buffer[IDX_OPTIONS_ADAPTIVE_WINDOW] != 0);
 }
 
 #define GRABSETTING(entries, count, name)                                      \
@@ -452,10 +468,33 @@ void Http2Session::CheckAllocatedSize(size_t previous_size) const {
 
 void Http2Session::IncreaseAllocatedSize(size_t size) {
   current_nghttp2_memory_ += size;
+  total_session_memory_usage.fetch_add(size, std::memory_order_relaxed);
 }
 
 void Http2Session::DecreaseAllocatedSize(size_t size) {
   current_nghttp2_memory_ -= size;
+  total_session_memory_usage.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void Http2Session::IncrementCurrentSessionMemory(uint64_t amount) {
+  current_session_memory_ += amount;
+  total_session_memory_usage.fetch_add(amount, std::memory_order_relaxed);
+}
+
+void Http2Session::DecrementCurrentSessionMemory(uint64_t amount) {
+  DCHECK_LE(amount, current_session_memory_);
+  current_session_memory_ -= amount;
+  total_session_memory_usage.fetch_sub(amount, std::memory_order_relaxed);
+}
+
+bool Http2Session::has_available_session_memory(uint64_t amount) const {
+  return current_session_memory() + amount <= max_session_memory_ &&
+         total_session_memory() + amount <=
+             session_memory_budget.load(std::memory_order_relaxed);
+}
+
+uint64_t Http2Session::total_session_memory() {
+  return total_session_memory_usage.load(std::memory_order_relaxed);
 }
 
 Http2Session::Http2Session(Http2State* http2_state,
@@ -472,6 +511,7 @@ Http2Session::Http2Session(Http2State* http2_state,
   Http2Options opts(http2_state, type);
 
   max_session_memory_ = opts.max_session_memory();
+  adaptive_window_ = opts.adaptive_window();
 
   uint32_t maxHeaderPairs = opts.max_header_pairs();
   max_header_pairs_ =
@@ -522,6 +562,9 @@ Http2Session::~Http2Session() {
   // current_nghttp2_memory_ check passes.
   session_.reset();
   CHECK_EQ(current_nghttp2_memory_, 0);
+  // Not everything that is accounted for is released explicitly.
+  total_session_memory_usage.fetch_sub(current_session_memory_,
+                                       std::memory_order_relaxed);
 }
 
 void Http2Session::MemoryInfo(MemoryTracker* tracker) const {
@@ -1043,12 +1086,17 @@ int Http2Session::OnDataChunkReceived(nghttp2_session* handle,
   // so that it can send a WINDOW_UPDATE frame. This is a critical part of
   // the flow control process in http2
   CHECK_EQ(nghttp2_session_consume_connection(handle, len), 0);
+  if (session->adaptive_window_)
+    session->UpdateBdpSample(len);
   BaseObjectPtr<Http2Stream> stream = session->FindStream(id);
 
   // If the stream has been destroyed, ignore this chunk
   if (!stream || stream->is_destroyed())
     return 0;
 
+  if (session->adaptive_window_)
+    session->ApplyAdaptiveWindow(stream.get());
+
   stream->statistics_.received_bytes += len;
 
   // Repeatedly ask the stream's owner for memory, and copy the read data
@@ -1376,6 +1424,13 @@ void Http2Session::HandlePingFrame(const nghttp2_frame* frame) {
   Local<Value> arg;
   bool ack = frame->hd.flags & NGHTTP2_FLAG_ACK;
   if (ack) {
+    if (bdp_ping_pending_ &&
+        memcmp(frame->ping.opaque_data,
+               bdp_ping_payload_,
+               sizeof(bdp_ping_payload_)) == 0) {
+      return OnBdpPingAck();
+    }
+
     BaseObjectPtr<Http2Ping> ping = PopPing();
 
     if (!ping) {
@@ -1402,6 +1457,92 @@ void Http2Session::HandlePingFrame(const nghttp2_frame* frame) {
   MakeCallback(env()->http2session_on_ping_function(), 1, &arg);
 }
 
+void Http2Session::UpdateBdpSample(size_t length) {
+  if (adaptive_window_size_ >= kMaxAdaptiveWindowSize)
+    return;
+  if (!bdp_ping_pending_) {
+    // Start a new sample. All DATA that arrives until the PING has been
+    // acknowledged is an estimate of the bandwidth-delay product. A random
+    // payload keeps the acknowledgements of other PINGs from ending it.
+    if (uv_random(nullptr,
+                  nullptr,
+                  bdp_ping_payload_,
+                  sizeof(bdp_ping_payload_),
+                  0,
+                  nullptr) != 0 ||
+        nghttp2_submit_ping(session_.get(),
+                            NGHTTP2_FLAG_NONE,
+                            bdp_ping_payload_) != 0) {
+      return;
+    }
+    bdp_ping_pending_ = true;
+    bdp_ping_sent_at_ = uv_hrtime();
+    bdp_sample_ = 0;
+  }
+  bdp_sample_ += length;
+}
+
+// This follows the BDP estimator of gRPC.
+void Http2Session::OnBdpPingAck() {
+  bdp_ping_pending_ = false;
+
+  // Average the first few round trip times, then let older ones decay.
+  double rtt = (uv_hrtime() - bdp_ping_sent_at_) / 1e9;
+  if (bdp_rtt_sample_count_ < 10) {
+    bdp_rtt_sample_count_++;
+    bdp_rtt_ += (rtt - bdp_rtt_) / bdp_rtt_sample_count_;
+  } else {
+    bdp_rtt_ += (rtt - bdp_rtt_) * 0.1;
+  }
+  if (bdp_rtt_ <= 0)
+    return;
+
+  // The sample can contain up to 1.5 round trips worth of data.
+  double bandwidth = bdp_sample_ / (bdp_rtt_ * 1.5);
+  if (bandwidth > bdp_max_bandwidth_)
+    bdp_max_bandwidth_ = bandwidth;
+
+  // Only a sample that nearly filled the window indicates that the window,
+  // rather than the peer or the network, limits the throughput.
+  if (bdp_sample_ * 3 < static_cast<uint64_t>(adaptive_window_size_) * 2 ||
+      bandwidth < bdp_max_bandwidth_) {
+    return;
+  }
+
+  uint64_t window = std::min<uint64_t>(bdp_sample_ * 2,
+                                       kMaxAdaptiveWindowSize);
+  // Larger windows allow the peer to make the session buffer more data.
+  window = std::min(window, max_session_memory_ / 2);
+  if (window <= static_cast<uint64_t>(adaptive_window_size_) ||
+      !has_available_session_memory(window - adaptive_window_size_)) {
+    return;
+  }
+  adaptive_window_size_ = static_cast<int32_t>(window);
+  Debug(this, "adaptive window size is now %d", adaptive_window_size_);
+
+  if (adaptive_window_size_ >
+          nghttp2_session_get_local_window_size(session_.get())) {
+    nghttp2_session_set_local_window_size(
+        session_.get(), NGHTTP2_FLAG_NONE, 0, adaptive_window_size_);
+  }
+  for (const auto& stream : streams_)
+    ApplyAdaptiveWindow(stream.second.get());
+}
+
+void Http2Session::ApplyAdaptiveWindow(Http2Stream* stream) {
+  if (stream->adaptive_window_size_ >= adaptive_window_size_)
+    return;
+  stream->adaptive_window_size_ = adaptive_window_size_;
+
+  // The initial window size setting may be larger already.
+  uint32_t initial_window_size = nghttp2_session_get_local_settings(
+      session_.get(), NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE);
+  if (static_cast<uint32_t>(adaptive_window_size_) <= initial_window_size)
+    return;
+  nghttp2_session_set_local_window_size(
+      session_.get(), NGHTTP2_FLAG_NONE, stream->id(), adaptive_window_size_);
+}
+
 // Called by OnFrameReceived when a complete SETTINGS frame has been received.
 void Http2Session::HandleSettingsFrame(const nghttp2_frame* frame) {
   bool ack = frame->hd.flags & NGHTTP2_FLAG_ACK;
@@ -1566,6 +1707,19 @@ void Http2Session::CopyDataIntoOutgoing(const uint8_t* src, size_t src_length) {
   outgoing_storage_.resize(offset + src_length);
   memcpy(&outgoing_storage_[offset], src, src_length);
 
+  // Copies that directly follow each other are also adjacent in
+  // outgoing_storage_, so they can be written as a single buffer. This keeps
+  // the number of buffers that are passed to the underlying stream down to
+  // about one per DATA frame payload.
+  if (!outgoing_buffers_.empty()) {
+    NgHttp2StreamWrite& last = outgoing_buffers_.back();
+    if (last.buf.base == nullptr && !last.req_wrap) {
+      last.buf.len += src_length;
+      outgoing_length_ += src_length;
+      return;
+    }
+  }
+
   // Store with a base of `nullptr` initially, since future resizes
   // of the outgoing_buffers_ vector may invalidate the pointer.
   // The correct base pointers will be set later, before writing to the
@@ -1676,13 +1830,17 @@ int Http2Session::OnSendData(
   BaseObjectPtr<Http2Stream> stream = session->FindStream(frame->hd.stream_id);
   if (!stream) return 0;
 
-  // Send the frame header + a byte that indicates padding length.
-  session->CopyDataIntoOutgoing(framehd, 9);
+  // Send the frame header + a byte that indicates padding length. Only these
+  // few bytes are copied, the payload is taken from the stream's queue as-is.
+  uint8_t header[10];
+  size_t header_length = 9;
+  memcpy(header, framehd, header_length);
   if (frame->data.padlen > 0) {
     uint8_t padding_byte = frame->data.padlen - 1;
     CHECK_EQ(padding_byte, frame->data.padlen - 1);
-    session->CopyDataIntoOutgoing(&padding_byte, 1);
+    header[header_length++] = padding_byte;
   }
+  session->CopyDataIntoOutgoing(header, header_length);
 
   Debug(session, "nghttp2 has %d bytes to send directly", length);
   while (length > 0) {
@@ -1701,6 +1859,7 @@ int Http2Session::OnSendData(
 
     // Slice off `length` bytes of the first write in the queue.
     session->PushOutgoingBuffer(NgHttp2StreamWrite {
+      write.storage,
       uv_buf_init(write.buf.base, length)
     });
     write.buf.base += length;
@@ -2000,6 +2159,9 @@ void Http2Stream::Destroy() {
         queue_.pop();
       }
 
+      if (file_source_)
+        file_source_->OnStreamDestroyed();
+
       // We can destroy the stream now if there are no writes for it
       // already on the socket. Otherwise, we'll wait for the garbage collector
       // to take care of cleaning up.
@@ -2339,9 +2501,15 @@ ssize_t Http2Stream::Provider::Stream::OnRead(nghttp2_session* handle,
     }
   }
 
+  // Keep reading ahead while data is being sent.
+  if (stream->file_source_)
+    stream->file_source_->ScheduleRead();
+
   if (amount == 0 && stream->is_writable()) {
     CHECK(stream->queue_.empty());
     Debug(session, "deferring stream %d", id);
+    if (stream->file_source_)
+      return NGHTTP2_ERR_DEFERRED;
     stream->EmitWantsWrite(length);
     if (stream->available_outbound_length_ > 0 || !stream->is_writable()) {
       // EmitWantsWrite() did something interesting synchronously, restart:
@@ -2363,6 +2531,166 @@ ssize_t Http2Stream::Provider::Stream::OnRead(nghttp2_session* handle,
   return amount;
 }
 
+std::unique_ptr<Http2Stream::FileSource> Http2Stream::FileSource::Create(
+    Http2Stream* stream,
+    int fd,
+    int64_t position,
+    int64_t length) {
+  Environment* env = stream->env();
+  Local<Object> obj;
+  if (!env->http2filereadwrap_constructor_template()
+           ->NewInstance(env->context())
+           .ToLocal(&obj)) {
+    return nullptr;
+  }
+  BaseObjectPtr<ReadWrap> read_wrap;
+  {
+    AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(stream);
+    read_wrap = MakeDetachedBaseObject<ReadWrap>(env, obj);
+  }
+  return std::unique_ptr<FileSource>(
+      new FileSource(stream, std::move(read_wrap), fd, position, length));
+}
+
+Http2Stream::FileSource::FileSource(Http2Stream* stream,
+                                    BaseObjectPtr<ReadWrap> read_wrap,
+                                    int fd,
+                                    int64_t position,
+                                    int64_t length)
+    : stream_(stream),
+      read_wrap_(std::move(read_wrap)),
+      fd_(fd),
+      position_(position),
+      remaining_(length) {}
+
+Http2Stream::FileSource::ReadWrap::ReadWrap(Environment* env,
+                                            Local<Object> obj)
+    : ReqWrap(env, obj, AsyncWrap::PROVIDER_FSREQCALLBACK) {}
+
+void Http2Stream::FileSource::ReadWrap::MemoryInfo(
+    MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("chunk", chunk_ ? buf_.len : 0);
+}
+
+void Http2Stream::FileSource::MaybeRead() {
+  if (reading_ || finished_ || stream_->is_destroyed())
+    return;
+
+  if (remaining_ == 0) {
+    // The range to send is empty.
+    stream_->Shutdown();
+    return Finish(0);
+  }
+
+  Http2Session* session = stream_->session();
+  int32_t window = nghttp2_session_get_stream_remote_window_size(
+      session->session(), stream_->id());
+  size_t read_ahead = window > 0 ? static_cast<size_t>(window) : 0;
+  read_ahead = std::max(kMinReadAhead, std::min(read_ahead, kMaxReadAhead));
+  if (stream_->available_outbound_length_ >= read_ahead)
+    return;
+
+  size_t size = read_ahead - stream_->available_outbound_length_;
+  if (remaining_ > 0 && static_cast<uint64_t>(remaining_) < size)
+    size = static_cast<size_t>(remaining_);
+
+  // The chunk is handed over to the stream's queue once it has been read,
+  // so every read gets a new one.
+  read_wrap_->chunk_ = std::make_shared<MallocedBuffer<char>>(size);
+  read_wrap_->buf_ = uv_buf_init(read_wrap_->chunk_->data, size);
+  int err = read_wrap_->Dispatch(uv_fs_read,
+                                 fd_,
+                                 &read_wrap_->buf_,
+                                 1,
+                                 position_,
+                                 OnRead);
+  if (err < 0) {
+    read_wrap_->Reset();
+    read_wrap_->chunk_.reset();
+    return Finish(err);
+  }
+  read_wrap_->stream_.reset(stream_);
+  reading_ = true;
+}
+
+void Http2Stream::FileSource::ScheduleRead() {
+  if (reading_ || read_scheduled_ || finished_)
+    return;
+  read_scheduled_ = true;
+  BaseObjectPtr<Http2Stream> stream(stream_);
+  stream_->env()->SetImmediate([stream](Environment* env) {
+    FileSource* source = stream->file_source_.get();
+    source->read_scheduled_ = false;
+    source->MaybeRead();
+  });
+}
+
+void Http2Stream::FileSource::OnRead(uv_fs_t* req) {
+  ReadWrap* read_wrap = static_cast<ReadWrap*>(ReadWrap::from_req(req));
+  BaseObjectPtr<Http2Stream> stream = std::move(read_wrap->stream_);
+  FileSource* source = stream->file_source_.get();
+  CHECK_EQ(source->read_wrap_.get(), read_wrap);
+  CHECK(source->reading_);
+  source->reading_ = false;
+  read_wrap->Reset();
+  ssize_t result = req->result;
+  uv_fs_req_cleanup(req);
+  std::shared_ptr<MallocedBuffer<char>> chunk = std::move(read_wrap->chunk_);
+
+  // The read is cancelled when the Environment is torn down.
+  if (result == UV_ECANCELED || stream->is_destroyed() ||
+      !stream->env()->can_call_into_js()) {
+    return source->Finish(UV_ECANCELED);
+  }
+  if (result < 0)
+    return source->Finish(result);
+
+  Http2Scope h2scope(stream.get());
+  if (result > 0) {
+    if (source->position_ >= 0)
+      source->position_ += result;
+    if (source->remaining_ > 0)
+      source->remaining_ -= result;
+    uv_buf_t buf = uv_buf_init(chunk->data, result);
+    stream->queue_.emplace(NgHttp2StreamWrite { std::move(chunk), buf });
+    stream->IncrementAvailableOutboundLength(result);
+    CHECK_NE(nghttp2_session_resume_data(
+        stream->session()->session(),
+        stream->id()), NGHTTP2_ERR_NOMEM);
+  }
+
+  if (result == 0 || source->remaining_ == 0) {
+    // End of file, or of the requested range.
+    stream->Shutdown();
+    return source->Finish(0);
+  }
+  source->MaybeRead();
+}
+
+void Http2Stream::FileSource::OnStreamDestroyed() {
+  // A pending read reports back once it completes.
+  if (!reading_)
+    Finish(UV_ECANCELED);
+}
+
+void Http2Stream::FileSource::Finish(int status) {
+  if (finished_)
+    return;
+  finished_ = true;
+
+  // This may be called from within nghttp2 callbacks, so JS is notified
+  // asynchronously.
+  BaseObjectPtr<Http2Stream> stream(stream_);
+  stream_->env()->SetImmediate([stream, status](Environment* env) {
+    if (!env->can_call_into_js())
+      return;
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    Local<Value> arg = Integer::New(env->isolate(), status);
+    stream->MakeCallback(env->onfiledone_string(), 1, &arg);
+  });
+}
+
 void Http2Stream::IncrementAvailableOutboundLength(size_t amount) {
   available_outbound_length_ += amount;
   session_->IncrementCurrentSessionMemory(amount);
@@ -2478,6 +2806,12 @@ void Http2Session::RefreshState(const FunctionCallbackInfo<Value>& args) {
       static_cast<double>(nghttp2_session_get_hd_deflate_dynamic_table_size(s));
   buffer[IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE] =
       static_cast<double>(nghttp2_session_get_hd_inflate_dynamic_table_size(s));
+  buffer[IDX_SESSION_STATE_MEMORY_USAGE] =
+      static_cast<double>(session->current_session_memory());
+  buffer[IDX_SESSION_STATE_TOTAL_MEMORY_USAGE] =
+      static_cast<double>(total_session_memory());
+  buffer[IDX_SESSION_STATE_ADAPTIVE_WINDOW_SIZE] =
+      session->adaptive_window_ ? session->adaptive_window_size_ : 0;
 }
 
 
@@ -2662,6 +2996,30 @@ void Http2Stream::GetID(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(stream->id());
 }
 
+// Sends the payload of the stream from a file descriptor:
+// sendFD(fd, position, length). The handle's `onfiledone(status)` method is
+// called once the file descriptor is no longer used.
+void Http2Stream::SendFD(const FunctionCallbackInfo<Value>& args) {
+  Http2Stream* stream;
+  ASSIGN_OR_RETURN_UNWRAP(&stream, args.Holder());
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsNumber());
+  CHECK(args[2]->IsNumber());
+  CHECK(!stream->file_source_);
+
+  if (stream->is_destroyed() || !stream->is_writable())
+    return args.GetReturnValue().Set(UV_EPIPE);
+
+  int fd = args[0].As<Int32>()->Value();
+  int64_t position = static_cast<int64_t>(args[1].As<Number>()->Value());
+  int64_t length = static_cast<int64_t>(args[2].As<Number>()->Value());
+  stream->file_source_ = FileSource::Create(stream, fd, position, length);
+  if (!stream->file_source_)
+    return;
+  stream->file_source_->MaybeRead();
+  args.GetReturnValue().Set(0);
+}
+
 // Destroy the Http2Stream, rendering it no longer usable
 void Http2Stream::Destroy(const FunctionCallbackInfo<Value>& args) {
   Http2Stream* stream;
@@ -2974,6 +3332,18 @@ void NgHttp2StreamWrite::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("buf", buf);
 }
 
+// Sets the limit for the memory used by all sessions of the process, in bytes.
+void SetMemoryBudget(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsNumber());
+  double budget = args[0].As<Number>()->Value();
+  CHECK_GE(budget, 0);
+  constexpr uint64_t kNoLimit = std::numeric_limits<uint64_t>::max();
+  session_memory_budget.store(
+      budget >= static_cast<double>(kNoLimit) ?
+          kNoLimit : static_cast<uint64_t>(budget),
+      std::memory_order_relaxed);
+}
+
 void SetCallbackFunctions(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK_EQ(args.Length(), 11);
@@ -3054,6 +3424,7 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "refreshDefaultSettings", RefreshDefaultSettings);
   env->SetMethod(target, "packSettings", PackSettings);
   env->SetMethod(target, "setCallbackFunctions", SetCallbackFunctions);
+  env->SetMethod(target, "setMemoryBudget", SetMemoryBudget);
 
   Local<FunctionTemplate> ping = FunctionTemplate::New(env->isolate());
   ping->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "Http2Ping"));
@@ -3068,6 +3439,13 @@ void Initialize(Local<Object> target,
   settingt->SetInternalFieldCount(AsyncWrap::kInternalFieldCount);
   env->set_http2settings_constructor_template(settingt);
 
+  Local<FunctionTemplate> file_read = FunctionTemplate::New(env->isolate());
+  file_read->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  Local<ObjectTemplate> file_readt = file_read->InstanceTemplate();
+  file_readt->SetInternalFieldCount(
+      ReqWrap<uv_fs_t>::kInternalFieldCount);
+  env->set_http2filereadwrap_constructor_template(file_readt);
+
   Local<FunctionTemplate> stream = FunctionTemplate::New(env->isolate());
   env->SetProtoMethod(stream, "id", Http2Stream::GetID);
   env->SetProtoMethod(stream, "destroy", Http2Stream::Destroy);
@@ -3077,6 +3455,7 @@ void Initialize(Local<Object> target,
   env->SetProtoMethod(stream, "trailers", Http2Stream::Trailers);
   env->SetProtoMethod(stream, "respond", Http2Stream::Respond);
   env->SetProtoMethod(stream, "rstStream", Http2Stream::RstStream);
+  env->SetProtoMethod(stream, "sendFD", Http2Stream::SendFD);
   env->SetProtoMethod(stream, "refreshState", Http2Stream::RefreshState);
   stream->Inherit(AsyncWrap::GetConstructorTemplate(env));
   StreamBase::AddMethods(env, stream);
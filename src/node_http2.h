@@ -13,10 +13,12 @@
 #include "node_http_common.h"
 #include "node_mem.h"
 #include "node_perf.h"
+#include "req_wrap.h"
 #include "stream_base.h"
 #include "string_bytes.h"
 
 #include <algorithm>
+#include <memory>
 #include <queue>
 
 namespace node {
@@ -38,6 +40,9 @@ constexpr size_t kDefaultMaxSettings = 10;
 // Default maximum total memory cap for Http2Session.
 constexpr uint64_t kDefaultMaxSessionMemory = 10000000;
 
+// The largest flow control window that the adaptive window mode may grow to.
+constexpr int32_t kMaxAdaptiveWindowSize = 16 * 1024 * 1024;
+
 // These are the standard HTTP/2 defaults as specified by the RFC
 constexpr uint32_t DEFAULT_SETTINGS_HEADER_TABLE_SIZE = 4096;
 constexpr uint32_t DEFAULT_SETTINGS_ENABLE_PUSH = 1;
@@ -145,11 +150,16 @@ using Http2RcBufferPointer = NgRcBufPointer<Http2RcBufferPointerTraits>;
 
 struct NgHttp2StreamWrite : public MemoryRetainer {
   BaseObjectPtr<AsyncWrap> req_wrap;
+  // Keeps the memory behind `buf` alive when it was allocated natively,
+  // rather than being owned by the JS side of `req_wrap`.
+  std::shared_ptr<void> storage;
   uv_buf_t buf;
 
   inline explicit NgHttp2StreamWrite(uv_buf_t buf_) : buf(buf_) {}
   inline NgHttp2StreamWrite(BaseObjectPtr<AsyncWrap> req_wrap, uv_buf_t buf_) :
       req_wrap(std::move(req_wrap)), buf(buf_) {}
+  inline NgHttp2StreamWrite(std::shared_ptr<void> storage, uv_buf_t buf_) :
+      storage(std::move(storage)), buf(buf_) {}
 
   void MemoryInfo(MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(NgHttp2StreamWrite)
@@ -233,9 +243,18 @@ class Http2Options {
     return max_session_memory_;
   }
 
+  void set_adaptive_window(bool on) {
+    adaptive_window_ = on;
+  }
+
+  bool adaptive_window() const {
+    return adaptive_window_;
+  }
+
  private:
   Nghttp2OptionPointer options_;
   uint64_t max_session_memory_ = kDefaultMaxSessionMemory;
+  bool adaptive_window_ = false;
   uint32_t max_header_pairs_ = DEFAULT_MAX_HEADER_LIST_PAIRS;
   PaddingStrategy padding_strategy_ = PADDING_STRATEGY_NONE;
   size_t max_outstanding_pings_ = kDefaultMaxPings;
@@ -445,8 +464,10 @@ class Http2Stream : public AsyncWrap,
   static void Trailers(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Respond(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RstStream(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendFD(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   class Provider;
+  class FileSource;
 
   struct Statistics {
     uint64_t start_time;
@@ -495,6 +516,13 @@ class Http2Stream : public AsyncWrap,
   std::queue<NgHttp2StreamWrite> queue_;
   size_t available_outbound_length_ = 0;
 
+  // Set when the payload is read from a file descriptor natively.
+  std::unique_ptr<FileSource> file_source_;
+
+  // The local flow control window that was last set for this stream by the
+  // session's adaptive window mode.
+  int32_t adaptive_window_size_ = 0;
+
   Http2StreamListener stream_listener_;
 
   friend class Http2Session;
@@ -510,7 +538,6 @@ class Http2Stream::Provider {
     return !empty_ ? &provider_ : nullptr;
   }
 
-  class FD;
   class Stream;
  protected:
   nghttp2_data_provider provider_;
@@ -519,6 +546,85 @@ class Http2Stream::Provider {
   bool empty_ = false;
 };
 
+// Reads the payload of a stream from a file descriptor on the threadpool,
+// and queues it for the stream's data provider like DoWrite() would, but
+// without creating a WriteWrap or any other JS object for each chunk.
+// While the peer's flow control window allows more data to be sent, data is
+// read ahead, so that reading the file overlaps with sending it.
+class Http2Stream::FileSource final {
+ public:
+  // Bounds for the amount of data that is read ahead. Within these, it
+  // follows the size of the flow control window.
+  static constexpr size_t kMinReadAhead = 16 * 1024;
+  static constexpr size_t kMaxReadAhead = 256 * 1024;
+
+  // A `position` of -1 reads from the current file position, and a
+  // `length` of -1 reads until the end of the file. Returns nullptr if
+  // creating the JS object of the ReadWrap failed.
+  static std::unique_ptr<FileSource> Create(Http2Stream* stream,
+                                            int fd,
+                                            int64_t position,
+                                            int64_t length);
+  FileSource(const FileSource&) = delete;
+  FileSource& operator=(const FileSource&) = delete;
+
+  // Starts reading the next chunk, unless a read is already pending, the
+  // file has been read completely, or enough data is queued already.
+  void MaybeRead();
+  // Calls MaybeRead() from a SetImmediate() callback, for use from within
+  // nghttp2 callbacks.
+  void ScheduleRead();
+
+  // Called once the stream has been destroyed.
+  void OnStreamDestroyed();
+
+ private:
+  class ReadWrap;
+
+  FileSource(Http2Stream* stream,
+             BaseObjectPtr<ReadWrap> read_wrap,
+             int fd,
+             int64_t position,
+             int64_t length);
+
+  static void OnRead(uv_fs_t* req);
+  // Tells JS that the file descriptor is no longer used, with a libuv error
+  // code if the file could not be read.
+  void Finish(int status);
+
+  Http2Stream* stream_;
+  // Dispatched again for every read, so that no JS objects are created
+  // while the file is sent.
+  BaseObjectPtr<ReadWrap> read_wrap_;
+  int fd_;
+  int64_t position_;
+  int64_t remaining_;
+  bool reading_ = false;
+  bool read_scheduled_ = false;
+  bool finished_ = false;
+};
+
+// The reads of a FileSource. As a ReqWrap, a pending read is cancelled and
+// waited for when the Environment is torn down, e.g. when a Worker is
+// terminated.
+class Http2Stream::FileSource::ReadWrap final : public ReqWrap<uv_fs_t> {
+ public:
+  ReadWrap(Environment* env, v8::Local<v8::Object> obj);
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(Http2FileReadWrap)
+  SET_SELF_SIZE(ReadWrap)
+
+ private:
+  // Keeps the stream, and with it the FileSource, alive while a read is
+  // pending.
+  BaseObjectPtr<Http2Stream> stream_;
+  std::shared_ptr<MallocedBuffer<char>> chunk_;
+  uv_buf_t buf_;
+
+  friend class FileSource;
+};
+
 class Http2Stream::Provider::Stream : public Http2Stream::Provider {
  public:
   Stream(Http2Stream* stream, int options);
@@ -723,14 +829,8 @@ class Http2Session : public AsyncWrap,
   BaseObjectPtr<Http2Settings> PopSettings();
   bool AddSettings(v8::Local<v8::Function> callback);
 
-  void IncrementCurrentSessionMemory(uint64_t amount) {
-    current_session_memory_ += amount;
-  }
-
-  void DecrementCurrentSessionMemory(uint64_t amount) {
-    DCHECK_LE(amount, current_session_memory_);
-    current_session_memory_ -= amount;
-  }
+  void IncrementCurrentSessionMemory(uint64_t amount);
+  void DecrementCurrentSessionMemory(uint64_t amount);
 
   // Tell our custom memory allocator that this rcbuf is independent of
   // this session now, and may outlive it.
@@ -745,10 +845,13 @@ class Http2Session : public AsyncWrap,
     return total;
   }
 
-  // Return true if current_session_memory + amount is less than the max
-  bool has_available_session_memory(uint64_t amount) const {
-    return current_session_memory() + amount <= max_session_memory_;
-  }
+  // Return true if current_session_memory + amount is less than the max,
+  // and the memory budget shared by all sessions is not exceeded either.
+  bool has_available_session_memory(uint64_t amount) const;
+
+  // The memory used by all sessions of the process, as far as it is
+  // tracked through IncrementCurrentSessionMemory() and nghttp2's allocator.
+  static uint64_t total_session_memory();
 
   struct Statistics {
     uint64_t start_time;
@@ -784,6 +887,13 @@ class Http2Session : public AsyncWrap,
   void HandleAltSvcFrame(const nghttp2_frame* frame);
   void HandleOriginFrame(const nghttp2_frame* frame);
 
+  // Adaptive flow control: Estimates the bandwidth-delay product of the
+  // connection by counting the DATA received during the round trip of a
+  // PING, and grows the local flow control windows to match it.
+  void UpdateBdpSample(size_t length);
+  void OnBdpPingAck();
+  void ApplyAdaptiveWindow(Http2Stream* stream);
+
   // nghttp2 callbacks
   static int OnBeginHeadersCallback(
       nghttp2_session* session,
@@ -878,6 +988,17 @@ class Http2Session : public AsyncWrap,
   // The amount of memory allocated by nghttp2 internals
   uint64_t current_nghttp2_memory_ = 0;
 
+  // State of the adaptive window mode, see UpdateBdpSample().
+  bool adaptive_window_ = false;
+  bool bdp_ping_pending_ = false;
+  uint8_t bdp_ping_payload_[8];
+  uint64_t bdp_ping_sent_at_ = 0;
+  uint64_t bdp_sample_ = 0;
+  double bdp_rtt_ = 0;  // In seconds.
+  uint32_t bdp_rtt_sample_count_ = 0;
+  double bdp_max_bandwidth_ = 0;  // In bytes per second.
+  int32_t adaptive_window_size_ = DEFAULT_SETTINGS_INITIAL_WINDOW_SIZE;
+
   // The collection of active Http2Streams associated with this session
   std::unordered_map<int32_t, BaseObjectPtr<Http2Stream>> streams_;
 
@@ -31,6 +31,9 @@ namespace http2 {
     IDX_SESSION_STATE_OUTBOUND_QUEUE_SIZE,
     IDX_SESSION_STATE_HD_DEFLATE_DYNAMIC_TABLE_SIZE,
     IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE,
+    IDX_SESSION_STATE_MEMORY_USAGE,
+    IDX_SESSION_STATE_TOTAL_MEMORY_USAGE,
+    IDX_SESSION_STATE_ADAPTIVE_WINDOW_SIZE,
     IDX_SESSION_STATE_COUNT
   };
 
@@ -55,6 +58,7 @@ namespace http2 {
     IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS,
     IDX_OPTIONS_MAX_SESSION_MEMORY,
     IDX_OPTIONS_MAX_SETTINGS,
+    IDX_OPTIONS_ADAPTIVE_WINDOW,
     IDX_OPTIONS_FLAGS
   };
 
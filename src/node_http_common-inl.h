@@ -8,6 +8,7 @@
 #include "v8.h"
 
 #include <algorithm>
+#include <cstring>
 
 namespace node {
 
@@ -155,16 +156,13 @@ v8::MaybeLocal<v8::String> NgHeader<T>::GetName(
   const char* header_name = T::ToHttpHeaderName(token_);
 
   // If header_name is not nullptr, then it is a known header with
-  // a statically defined name. We can safely internalize it here.
+  // a statically defined name, for which a shared string exists.
   if (header_name != nullptr) {
-    auto& static_str_map = env_->isolate_data()->static_str_map;
-    v8::Eternal<v8::String> eternal = static_str_map[header_name];
-    if (eternal.IsEmpty()) {
-      v8::Local<v8::String> str = OneByteString(env_->isolate(), header_name);
-      eternal.Set(env_->isolate(), str);
+    v8::Local<v8::String> str =
+        GetKnownHeaderName(env_, header_name, strlen(header_name));
+    if (!str.IsEmpty())
       return str;
-    }
-    return eternal.Get(env_->isolate());
+    return OneByteString(env_->isolate(), header_name);
   }
   return rcbufferpointer_t::External::New(allocator, name_);
 }
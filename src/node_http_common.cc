@@ -0,0 +1,142 @@
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_http_common.h"
+#include "util-inl.h"
+
+#include <cstring>
+
+namespace node {
+
+using v8::Eternal;
+using v8::Isolate;
+using v8::Local;
+using v8::NewStringType;
+using v8::String;
+
+namespace {
+
+struct KnownHeaderName {
+  const char* name;
+  size_t length;
+};
+
+constexpr KnownHeaderName kKnownHeaderNames[] = {
+  { nullptr, 0 },  // HTTP_KNOWN_HEADER_MIN
+#define V(name, value) { value, sizeof(value) - 1 },
+  HTTP_KNOWN_HEADERS(V)
+#undef V
+};
+
+static_assert(arraysize(kKnownHeaderNames) == HTTP_KNOWN_HEADER_MAX,
+              "kKnownHeaderNames must have one entry per known header");
+
+// The table is indexed by the top kTableBits bits of the FNV-1a hash of the
+// lowercased name. The seed has been picked so that all known header names
+// end up in different slots, which is verified below; adding a header to
+// HTTP_KNOWN_HEADERS may require picking a new seed.
+constexpr uint32_t kHashSeed = 0x811ca09e;
+constexpr size_t kTableBits = 9;
+constexpr size_t kTableSize = 1 << kTableBits;
+
+// All characters in header names are tokens, for which setting this bit
+// turns uppercase letters into lowercase ones and leaves everything that
+// may appear in a known header name unchanged.
+constexpr uint32_t HashHeaderName(const char* name, size_t length) {
+  uint32_t hash = kHashSeed;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= static_cast<uint8_t>(name[i]) | 0x20;
+    hash *= 16777619u;
+  }
+  return hash >> (32 - kTableBits);
+}
+
+struct KnownHeaderTable {
+  // HTTP_HEADER_* values, or HTTP_KNOWN_HEADER_MIN for unused slots.
+  uint8_t slots[kTableSize];
+  bool perfect;
+};
+
+constexpr KnownHeaderTable BuildKnownHeaderTable() {
+  KnownHeaderTable table {};
+  table.perfect = true;
+  for (size_t i = HTTP_KNOWN_HEADER_MIN + 1; i < HTTP_KNOWN_HEADER_MAX; i++) {
+    const KnownHeaderName& header = kKnownHeaderNames[i];
+    uint8_t& slot = table.slots[HashHeaderName(header.name, header.length)];
+    if (slot != HTTP_KNOWN_HEADER_MIN)
+      table.perfect = false;
+    slot = static_cast<uint8_t>(i);
+  }
+  return table;
+}
+
+static_assert(HTTP_KNOWN_HEADER_MAX <= UINT8_MAX,
+              "Known header indices must fit into a table slot");
+
+constexpr KnownHeaderTable kKnownHeaderTable = BuildKnownHeaderTable();
+
+static_assert(kKnownHeaderTable.perfect,
+              "Known header names collide, pick a different kHashSeed");
+
+// Whether `name` is `lowercase` with the first letter and every letter that
+// follows a dash in uppercase, as in `Content-Type`.
+bool IsCapitalized(const char* name, const char* lowercase, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    char expected = lowercase[i];
+    if (i == 0 || lowercase[i - 1] == '-')
+      expected = ToUpper(expected);
+    if (name[i] != expected)
+      return false;
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
+http_known_headers LookupKnownHeader(const char* name, size_t length) {
+  uint8_t index = kKnownHeaderTable.slots[HashHeaderName(name, length)];
+  if (index == HTTP_KNOWN_HEADER_MIN)
+    return HTTP_KNOWN_HEADER_MAX;
+  const KnownHeaderName& header = kKnownHeaderNames[index];
+  if (header.length != length ||
+      !StringEqualNoCaseN(name, header.name, length)) {
+    return HTTP_KNOWN_HEADER_MAX;
+  }
+  return static_cast<http_known_headers>(index);
+}
+
+Local<String> GetKnownHeaderName(Environment* env,
+                                 const char* name,
+                                 size_t length) {
+  http_known_headers header = LookupKnownHeader(name, length);
+  if (header == HTTP_KNOWN_HEADER_MAX)
+    return Local<String>();
+
+  // There are two strings per header, one for the lowercase spelling that
+  // HTTP/2 requires and one for the capitalized one that most HTTP/1
+  // clients use. Other spellings need to be preserved as they are.
+  size_t index;
+  if (memcmp(name, kKnownHeaderNames[header].name, length) == 0)
+    index = header * 2;
+  else if (IsCapitalized(name, kKnownHeaderNames[header].name, length))
+    index = header * 2 + 1;
+  else
+    return Local<String>();
+
+  Isolate* isolate = env->isolate();
+  std::vector<Eternal<String>>& names = env->isolate_data()->http_header_names;
+  if (names.empty())
+    names.resize(HTTP_KNOWN_HEADER_MAX * 2);
+  Eternal<String>& eternal = names[index];
+  if (eternal.IsEmpty()) {
+    Local<String> str =
+        String::NewFromOneByte(isolate,
+                               reinterpret_cast<const uint8_t*>(name),
+                               NewStringType::kInternalized,
+                               length).ToLocalChecked();
+    eternal.Set(isolate, str);
+    return str;
+  }
+  return eternal.Get(isolate);
+}
+
+}  // namespace node
@@ -122,6 +122,20 @@ enum http_known_headers {
   HTTP_KNOWN_HEADER_MAX
 };
 
+// Returns the HTTP_HEADER_* value of the known header that `name` refers to,
+// ignoring case, or HTTP_KNOWN_HEADER_MAX if there is none. The lookup uses
+// a perfect hash table that is built at compile time.
+http_known_headers LookupKnownHeader(const char* name, size_t length);
+
+// Returns a cached, internalized string for the header name `name` if it is
+// a known header name, either in lowercase or capitalized like in
+// `Content-Type`, and an empty handle otherwise. This lets the HTTP/1 and
+// HTTP/2 implementations share a single string per header name and isolate,
+// rather than creating a new one for every received header.
+v8::Local<v8::String> GetKnownHeaderName(Environment* env,
+                                         const char* name,
+                                         size_t length);
+
 #define HTTP_STATUS_CODES(V)                                                  \
   V(CONTINUE, 100)                                                            \
   V(SWITCHING_PROTOCOLS, 101)                                                 \
@@ -408,6 +422,15 @@ class NgRcBufPointer : public MemoryRetainer {
         Allocator* allocator,
         NgRcBufPointer<T> ptr) {
       Environment* env = allocator->env();
+      if (ptr.IsInternalizable()) {
+        v8::Local<v8::String> name = GetKnownHeaderName(
+            env, reinterpret_cast<const char*>(ptr.data()), ptr.len());
+        if (!name.IsEmpty()) {
+          ptr.reset();
+          return name;
+        }
+      }
+
       if (ptr.IsStatic()) {
         auto& static_str_map = env->isolate_data()->static_str_map;
         const char* header_name = reinterpret_cast<const char*>(ptr.data());
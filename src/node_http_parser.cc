@@ -26,12 +26,16 @@
 #include "async_wrap-inl.h"
 #include "env-inl.h"
 #include "memory_tracker-inl.h"
+#include "node_http_common.h"
 #include "stream_base-inl.h"
 #include "v8.h"
 #include "llhttp.h"
 
+#include <algorithm>
 #include <cstdlib>  // free()
 #include <cstring>  // strdup(), strchr()
+#include <memory>
+#include <vector>
 
 
 // This is a binding to llhttp (https://github.com/nodejs/llhttp)
@@ -52,6 +56,8 @@ namespace {  // NOLINT(build/namespaces)
 using v8::Array;
 using v8::Boolean;
 using v8::Context;
+using v8::DontDelete;
+using v8::DontEnum;
 using v8::EscapableHandleScope;
 using v8::Exception;
 using v8::Function;
@@ -64,6 +70,9 @@ using v8::Local;
 using v8::MaybeLocal;
 using v8::Number;
 using v8::Object;
+using v8::PropertyAttribute;
+using v8::ReadOnly;
+using v8::Signature;
 using v8::String;
 using v8::Uint32;
 using v8::Undefined;
@@ -76,7 +85,7 @@ const uint32_t kOnBody = 3;
 const uint32_t kOnMessageComplete = 4;
 const uint32_t kOnExecute = 5;
 const uint32_t kOnTimeout = 6;
-// Any more fields than this will be flushed into JS
+// Number of header fields that there is room for without allocating
 const size_t kMaxHeaderFieldsCount = 32;
 
 inline bool IsOWS(char c) {
@@ -103,59 +112,106 @@ class BindingData : public BaseObject {
 // TODO(addaleax): Remove once we're on C++17.
 constexpr FastStringKey BindingData::type_name;
 
-// helper class for the Parser
-struct StringPtr {
-  StringPtr() {
-    on_heap_ = false;
-    Reset();
+// Backing storage for the header strings of a Parser that could not be
+// parsed from a single buffer. Memory is handed out from a small number of
+// blocks and reclaimed all at once when the next message begins, rather
+// than allocating a heap string for every header that straddles two calls
+// to execute().
+class HeaderArena {
+ public:
+  char* Allocate(size_t size) {
+    if (blocks_.empty() || blocks_.back().size - used_ < size) {
+      // Grow geometrically, so that a header that arrives one byte at a
+      // time needs only a logarithmic number of copies.
+      size_t block_size = std::max(kMinBlockSize, size * 2);
+      blocks_.push_back({ std::make_unique<char[]>(block_size), block_size });
+      used_ = 0;
+      total_size_ += block_size;
+    }
+    char* ret = blocks_.back().data.get() + used_;
+    used_ += size;
+    return ret;
   }
 
+  // Grows the most recent allocation `str` of `size` bytes by `extra`
+  // bytes if there is room for that, and returns whether it succeeded.
+  bool Extend(const char* str, size_t size, size_t extra) {
+    if (blocks_.empty())
+      return false;
+    const Block& block = blocks_.back();
+    if (str + size != block.data.get() + used_ ||
+        block.size - used_ < extra) {
+      return false;
+    }
+    used_ += extra;
+    return true;
+  }
 
-  ~StringPtr() {
+  // Invalidates all allocations. Only the first block is kept for re-use,
+  // so that a single large message does not pin memory forever.
+  void Reset() {
+    if (blocks_.size() > 1) {
+      blocks_.resize(1);
+      total_size_ = blocks_[0].size;
+    }
+    used_ = 0;
+  }
+
+  size_t size() const { return total_size_; }
+
+ private:
+  static constexpr size_t kMinBlockSize = 4096;
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  std::vector<Block> blocks_;
+  size_t used_ = 0;
+  size_t total_size_ = 0;
+};
+
+// helper class for the Parser
+struct StringPtr {
+  StringPtr() {
     Reset();
   }
 
 
-  // If str_ does not point to a heap string yet, this function makes it do
+  // If str_ does not point into the arena yet, this function makes it do
   // so. This is called at the end of each http_parser_execute() so as not
   // to leak references. See issue #2438 and test-http-parser-bad-ref.js.
-  void Save() {
-    if (!on_heap_ && size_ > 0) {
-      char* s = new char[size_];
+  void Save(HeaderArena* arena) {
+    if (!in_arena_ && size_ > 0) {
+      char* s = arena->Allocate(size_);
       memcpy(s, str_, size_);
       str_ = s;
-      on_heap_ = true;
+      in_arena_ = true;
     }
   }
 
 
   void Reset() {
-    if (on_heap_) {
-      delete[] str_;
-      on_heap_ = false;
-    }
-
     str_ = nullptr;
+    in_arena_ = false;
     size_ = 0;
   }
 
 
-  void Update(const char* str, size_t size) {
+  void Update(const char* str, size_t size, HeaderArena* arena) {
     if (str_ == nullptr) {
       str_ = str;
-    } else if (on_heap_ || str_ + size_ != str) {
-      // Non-consecutive input, make a copy on the heap.
-      // TODO(bnoordhuis) Use slab allocation, O(n) allocs is bad.
-      char* s = new char[size_ + size];
+    } else if (in_arena_ && arena->Extend(str_, size_, size)) {
+      // Appended in place.
+      memcpy(const_cast<char*>(str_) + size_, str, size);
+    } else if (in_arena_ || str_ + size_ != str) {
+      // Non-consecutive input, make a contiguous copy in the arena.
+      char* s = arena->Allocate(size_ + size);
       memcpy(s, str_, size_);
       memcpy(s + size_, str, size);
-
-      if (on_heap_)
-        delete[] str_;
-      else
-        on_heap_ = true;
-
       str_ = s;
+      in_arena_ = true;
     }
     size_ += size;
   }
@@ -169,20 +225,174 @@ struct StringPtr {
   }
 
 
+  // Known header names are shared with other messages and with HTTP/2.
+  Local<String> ToHeaderName(Environment* env) const {
+    Local<String> name = GetKnownHeaderName(env, str_, size_);
+    return name.IsEmpty() ? ToString(env) : name;
+  }
+
+
   // Strip trailing OWS (SPC or HTAB) from string.
-  Local<String> ToTrimmedString(Environment* env) {
+  void Trim() {
     while (size_ > 0 && IsOWS(str_[size_ - 1])) {
       size_--;
     }
+  }
+
+
+  Local<String> ToTrimmedString(Environment* env) {
+    Trim();
     return ToString(env);
   }
 
 
   const char* str_;
-  bool on_heap_;
+  bool in_arena_;
   size_t size_;
 };
 
+// The headers of a message, handed to JS in place of an array of strings
+// when the parser was initialized with `lazyHeaders`. Names and values are
+// copied into a single buffer, and JS strings are only created for the
+// entries that are actually accessed. Indices are the same as for the
+// corresponding `rawHeaders` array, i.e. names are at even and values at
+// odd indices.
+class HeaderBlock : public BaseObject {
+ public:
+  static MaybeLocal<Object> New(Environment* env,
+                                const StringPtr* fields,
+                                StringPtr* values,
+                                size_t count);
+
+  HeaderBlock(Environment* env, Local<Object> object)
+      : BaseObject(env, object) {
+    MakeWeak();
+  }
+
+  static void GetLength(const FunctionCallbackInfo<Value>& args);
+  static void Get(const FunctionCallbackInfo<Value>& args);
+  static void Find(const FunctionCallbackInfo<Value>& args);
+  static void ToArray(const FunctionCallbackInfo<Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("data", data_);
+    tracker->TrackField("offsets", offsets_);
+  }
+
+  SET_MEMORY_INFO_NAME(HeaderBlock)
+  SET_SELF_SIZE(HeaderBlock)
+
+ private:
+  size_t length() const { return offsets_.size() - 1; }
+
+  Local<String> EntryToString(size_t index) const {
+    const char* start = data_.data() + offsets_[index];
+    size_t size = offsets_[index + 1] - offsets_[index];
+    if (index % 2 == 0) {
+      Local<String> name = GetKnownHeaderName(env(), start, size);
+      if (!name.IsEmpty())
+        return name;
+    }
+    if (size == 0)
+      return String::Empty(env()->isolate());
+    return OneByteString(env()->isolate(), start, size);
+  }
+
+  std::vector<char> data_;
+  // Entry `i` is stored at [offsets_[i], offsets_[i + 1]) in `data_`.
+  std::vector<size_t> offsets_;
+};
+
+
+MaybeLocal<Object> HeaderBlock::New(Environment* env,
+                                    const StringPtr* fields,
+                                    StringPtr* values,
+                                    size_t count) {
+  Local<Object> obj;
+  if (!env->http_header_block_template()
+           ->NewInstance(env->context())
+           .ToLocal(&obj)) {
+    return MaybeLocal<Object>();
+  }
+  HeaderBlock* block = new HeaderBlock(env, obj);
+
+  size_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    values[i].Trim();
+    total += fields[i].size_ + values[i].size_;
+  }
+
+  block->data_.resize(total);
+  block->offsets_.resize(count * 2 + 1);
+  size_t pos = 0;
+  auto append = [&](size_t index, const StringPtr& str) {
+    block->offsets_[index] = pos;
+    if (str.size_ > 0)
+      memcpy(block->data_.data() + pos, str.str_, str.size_);
+    pos += str.size_;
+  };
+  for (size_t i = 0; i < count; i++) {
+    append(i * 2, fields[i]);
+    append(i * 2 + 1, values[i]);
+  }
+  block->offsets_[count * 2] = pos;
+
+  return obj;
+}
+
+
+void HeaderBlock::GetLength(const FunctionCallbackInfo<Value>& args) {
+  HeaderBlock* block;
+  ASSIGN_OR_RETURN_UNWRAP(&block, args.This());
+  args.GetReturnValue().Set(static_cast<double>(block->length()));
+}
+
+
+void HeaderBlock::Get(const FunctionCallbackInfo<Value>& args) {
+  HeaderBlock* block;
+  ASSIGN_OR_RETURN_UNWRAP(&block, args.This());
+  CHECK(args[0]->IsUint32());
+  uint32_t index = args[0].As<Uint32>()->Value();
+  if (index < block->length())
+    args.GetReturnValue().Set(block->EntryToString(index));
+}
+
+
+// find(name, start) returns the index of the first header at or after the
+// index `start` whose name matches `name` case-insensitively, or -1.
+void HeaderBlock::Find(const FunctionCallbackInfo<Value>& args) {
+  HeaderBlock* block;
+  ASSIGN_OR_RETURN_UNWRAP(&block, args.This());
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsUint32());
+  Utf8Value name(args.GetIsolate(), args[0]);
+  size_t start = RoundUp<size_t>(args[1].As<Uint32>()->Value(), 2);
+
+  for (size_t i = start; i < block->length(); i += 2) {
+    size_t offset = block->offsets_[i];
+    if (block->offsets_[i + 1] - offset == name.length() &&
+        StringEqualNoCaseN(block->data_.data() + offset,
+                           *name,
+                           name.length())) {
+      return args.GetReturnValue().Set(static_cast<double>(i));
+    }
+  }
+  args.GetReturnValue().Set(-1);
+}
+
+
+void HeaderBlock::ToArray(const FunctionCallbackInfo<Value>& args) {
+  HeaderBlock* block;
+  ASSIGN_OR_RETURN_UNWRAP(&block, args.This());
+  MaybeStackBuffer<Local<Value>, kMaxHeaderFieldsCount * 2> entries(
+      block->length());
+  for (size_t i = 0; i < block->length(); i++)
+    entries[i] = block->EntryToString(i);
+  args.GetReturnValue().Set(
+      Array::New(args.GetIsolate(), entries.out(), block->length()));
+}
+
+
 class Parser : public AsyncWrap, public StreamListener {
  public:
   Parser(BindingData* binding_data, Local<Object> wrap)
@@ -195,6 +405,7 @@ class Parser : public AsyncWrap, public StreamListener {
 
   void MemoryInfo(MemoryTracker* tracker) const override {
     tracker->TrackField("current_buffer", current_buffer_);
+    tracker->TrackFieldWithSize("header_arena", header_arena_.size());
   }
 
   SET_MEMORY_INFO_NAME(Parser)
@@ -204,6 +415,8 @@ class Parser : public AsyncWrap, public StreamListener {
     num_fields_ = num_values_ = 0;
     url_.Reset();
     status_message_.Reset();
+    header_arena_.Reset();
+    have_flushed_ = false;
     header_parsing_start_time_ = uv_hrtime();
 
     Local<Value> cb = object()->Get(env()->context(), kOnMessageBegin)
@@ -228,7 +441,7 @@ class Parser : public AsyncWrap, public StreamListener {
       return rv;
     }
 
-    url_.Update(at, length);
+    url_.Update(at, length, &header_arena_);
     return 0;
   }
 
@@ -239,7 +452,7 @@ class Parser : public AsyncWrap, public StreamListener {
       return rv;
     }
 
-    status_message_.Update(at, length);
+    status_message_.Update(at, length, &header_arena_);
     return 0;
   }
 
@@ -253,19 +466,19 @@ class Parser : public AsyncWrap, public StreamListener {
     if (num_fields_ == num_values_) {
       // start of new field name
       num_fields_++;
-      if (num_fields_ == kMaxHeaderFieldsCount) {
-        // ran out of space - flush to javascript land
-        Flush();
-        num_fields_ = 1;
-        num_values_ = 0;
+      if (num_fields_ > fields_.size()) {
+        // All headers are passed to JS at once, so there is no limit here
+        // other than the one imposed by max_http_header_size_.
+        fields_.resize(num_fields_);
+        values_.resize(num_fields_);
       }
       fields_[num_fields_ - 1].Reset();
     }
 
-    CHECK_LT(num_fields_, kMaxHeaderFieldsCount);
+    CHECK_LE(num_fields_, fields_.size());
     CHECK_EQ(num_fields_, num_values_ + 1);
 
-    fields_[num_fields_ - 1].Update(at, length);
+    fields_[num_fields_ - 1].Update(at, length, &header_arena_);
 
     return 0;
   }
@@ -283,10 +496,10 @@ class Parser : public AsyncWrap, public StreamListener {
       values_[num_values_ - 1].Reset();
     }
 
-    CHECK_LT(num_values_, arraysize(values_));
+    CHECK_LE(num_values_, values_.size());
     CHECK_EQ(num_values_, num_fields_);
 
-    values_[num_values_ - 1].Update(at, length);
+    values_[num_values_ - 1].Update(at, length, &header_arena_);
 
     return 0;
   }
@@ -329,7 +542,14 @@ class Parser : public AsyncWrap, public StreamListener {
       Flush();
     } else {
       // Fast case, pass headers and URL to JS land.
-      argv[A_HEADERS] = CreateHeaders();
+      Local<Object> header_block;
+      if (lazy_headers_ &&
+          HeaderBlock::New(env(), fields_.data(), values_.data(), num_values_)
+              .ToLocal(&header_block)) {
+        argv[A_HEADERS] = header_block;
+      } else {
+        argv[A_HEADERS] = CreateHeaders();
+      }
       if (parser_.type == HTTP_REQUEST)
         argv[A_URL] = url_.ToString(env());
     }
@@ -490,15 +710,15 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   void Save() {
-    url_.Save();
-    status_message_.Save();
+    url_.Save(&header_arena_);
+    status_message_.Save(&header_arena_);
 
+    // Save in parsing order, so that the string that is still incomplete
+    // ends up last in the arena and can be extended in place.
     for (size_t i = 0; i < num_fields_; i++) {
-      fields_[i].Save();
-    }
-
-    for (size_t i = 0; i < num_values_; i++) {
-      values_[i].Save();
+      fields_[i].Save(&header_arena_);
+      if (i < num_values_)
+        values_[i].Save(&header_arena_);
     }
   }
 
@@ -540,6 +760,7 @@ class Parser : public AsyncWrap, public StreamListener {
   static void Initialize(const FunctionCallbackInfo<Value>& args) {
     Environment* env = Environment::GetCurrent(args);
     bool lenient = args[3]->IsTrue();
+    bool lazy_headers = args[5]->IsTrue();
 
     uint64_t max_http_header_size = 0;
     uint64_t headers_timeout = 0;
@@ -577,7 +798,8 @@ class Parser : public AsyncWrap, public StreamListener {
 
     parser->set_provider_type(provider);
     parser->AsyncReset(args[1].As<Object>());
-    parser->Init(type, max_http_header_size, lenient, headers_timeout);
+    parser->Init(type, max_http_header_size, lenient, headers_timeout,
+                 lazy_headers);
   }
 
   template <bool should_pause>
@@ -804,15 +1026,15 @@ class Parser : public AsyncWrap, public StreamListener {
   }
 
   Local<Array> CreateHeaders() {
-    // There could be extra entries but the max size should be fixed
-    Local<Value> headers_v[kMaxHeaderFieldsCount * 2];
+    MaybeStackBuffer<Local<Value>, kMaxHeaderFieldsCount * 2> headers_v(
+        num_values_ * 2);
 
     for (size_t i = 0; i < num_values_; ++i) {
-      headers_v[i * 2] = fields_[i].ToString(env());
+      headers_v[i * 2] = fields_[i].ToHeaderName(env());
       headers_v[i * 2 + 1] = values_[i].ToTrimmedString(env());
     }
 
-    return Array::New(env()->isolate(), headers_v, num_values_ * 2);
+    return Array::New(env()->isolate(), headers_v.out(), num_values_ * 2);
   }
 
 
@@ -844,12 +1066,13 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   void Init(llhttp_type_t type, uint64_t max_http_header_size,
-            bool lenient, uint64_t headers_timeout) {
+            bool lenient, uint64_t headers_timeout, bool lazy_headers) {
     llhttp_init(&parser_, type, &settings);
     llhttp_set_lenient(&parser_, lenient);
     header_nread_ = 0;
     url_.Reset();
     status_message_.Reset();
+    header_arena_.Reset();
     num_fields_ = 0;
     num_values_ = 0;
     have_flushed_ = false;
@@ -857,6 +1080,7 @@ class Parser : public AsyncWrap, public StreamListener {
     max_http_header_size_ = max_http_header_size;
     header_parsing_start_time_ = 0;
     headers_timeout_ = headers_timeout;
+    lazy_headers_ = lazy_headers;
   }
 
 
@@ -892,8 +1116,11 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   llhttp_t parser_;
-  StringPtr fields_[kMaxHeaderFieldsCount];  // header fields
-  StringPtr values_[kMaxHeaderFieldsCount];  // header values
+  HeaderArena header_arena_;
+  std::vector<StringPtr> fields_ =
+      std::vector<StringPtr>(kMaxHeaderFieldsCount);  // header fields
+  std::vector<StringPtr> values_ =
+      std::vector<StringPtr>(kMaxHeaderFieldsCount);  // header values
   StringPtr url_;
   StringPtr status_message_;
   size_t num_fields_;
@@ -909,6 +1136,7 @@ class Parser : public AsyncWrap, public StreamListener {
   uint64_t max_http_header_size_;
   uint64_t headers_timeout_;
   uint64_t header_parsing_start_time_ = 0;
+  bool lazy_headers_ = false;
 
   BaseObjectPtr<BindingData> binding_data_;
 
@@ -1001,6 +1229,24 @@ void InitializeHttpParser(Local<Object> target,
   env->SetProtoMethod(t, "getCurrentBuffer", Parser::GetCurrentBuffer);
 
   env->SetConstructorFunction(target, "HTTPParser", t);
+
+  Local<FunctionTemplate> header_block = FunctionTemplate::New(env->isolate());
+  header_block->InstanceTemplate()->SetInternalFieldCount(
+      HeaderBlock::kInternalFieldCount);
+  header_block->Inherit(BaseObject::GetConstructorTemplate(env));
+  header_block->PrototypeTemplate()->SetAccessorProperty(
+      env->length_string(),
+      FunctionTemplate::New(env->isolate(),
+                            HeaderBlock::GetLength,
+                            Local<Value>(),
+                            Signature::New(env->isolate(), header_block)),
+      Local<FunctionTemplate>(),
+      static_cast<PropertyAttribute>(ReadOnly | DontDelete | DontEnum));
+  env->SetProtoMethodNoSideEffect(header_block, "get", HeaderBlock::Get);
+  env->SetProtoMethodNoSideEffect(header_block, "find", HeaderBlock::Find);
+  env->SetProtoMethodNoSideEffect(header_block, "toArray",
+                                  HeaderBlock::ToArray);
+  env->set_http_header_block_template(header_block->InstanceTemplate());
 }
 
 }  // anonymous namespace
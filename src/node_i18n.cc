@@ -50,6 +50,7 @@
 #include "node_buffer.h"
 #include "node_errors.h"
 #include "node_internals.h"
+#include "node_utf8.h"
 #include "util-inl.h"
 #include "v8.h"
 
@@ -449,14 +450,25 @@ void ConverterObject::Decode(const FunctionCallbackInfo<Value>& args) {
   size_t source_length = input.length();
 
   UChar* target = *result;
-  ucnv_toUnicode(converter->conv(),
-                 &target,
-                 target + (limit * sizeof(UChar)),
-                 &source,
-                 source + source_length,
-                 nullptr,
-                 flush,
-                 &status);
+  UErrorCode pending_status = U_ZERO_ERROR;
+  if (converter->utf8() &&
+      ucnv_toUCountPending(converter->conv(), &pending_status) == 0 &&
+      utf8::IsValid(source, source_length)) {
+    // Complete and valid UTF-8 input needs none of the converter's state
+    // handling or error reporting, and is much faster to decode directly.
+    // It never takes more UTF-16 code units than bytes, i.e. `limit`.
+    target += utf8::ToUtf16(
+        source, source_length, reinterpret_cast<uint16_t*>(target));
+  } else {
+    ucnv_toUnicode(converter->conv(),
+                   &target,
+                   target + (limit * sizeof(UChar)),
+                   &source,
+                   source + source_length,
+                   nullptr,
+                   flush,
+                   &status);
+  }
 
   if (U_SUCCESS(status)) {
     bool omit_initial_bom = false;
@@ -505,6 +517,8 @@ ConverterObject::ConverterObject(
 
   switch (ucnv_getType(converter)) {
     case UCNV_UTF8:
+      flags_ |= CONVERTER_FLAGS_UNICODE | CONVERTER_FLAGS_UTF8;
+      break;
     case UCNV_UTF16_BigEndian:
     case UCNV_UTF16_LittleEndian:
       flags_ |= CONVERTER_FLAGS_UNICODE;
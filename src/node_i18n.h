@@ -93,6 +93,7 @@ class ConverterObject : public BaseObject, Converter {
     CONVERTER_FLAGS_IGNORE_BOM = 0x4,
     CONVERTER_FLAGS_UNICODE    = 0x8,
     CONVERTER_FLAGS_BOM_SEEN   = 0x10,
+    CONVERTER_FLAGS_UTF8       = 0x20,
   };
 
   static void Create(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -129,6 +130,10 @@ class ConverterObject : public BaseObject, Converter {
     return (flags_ & CONVERTER_FLAGS_IGNORE_BOM) == CONVERTER_FLAGS_IGNORE_BOM;
   }
 
+  bool utf8() const {
+    return (flags_ & CONVERTER_FLAGS_UTF8) == CONVERTER_FLAGS_UTF8;
+  }
+
  private:
   int flags_ = 0;
 };
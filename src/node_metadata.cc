@@ -8,6 +8,7 @@
 #include "uv.h"
 #include "v8.h"
 #include "zlib.h"
+#include "zstd.h"
 
 #if HAVE_OPENSSL
 #include <openssl/opensslv.h>
@@ -87,6 +88,8 @@ Metadata::Versions::Versions() {
     "." +
     std::to_string(BrotliEncoderVersion() & 0xFFF);
 
+  zstd = ZSTD_versionString();
+
 #if HAVE_OPENSSL
   openssl = GetOpenSSLVersion();
 #endif
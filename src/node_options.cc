@@ -320,6 +320,11 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "experimental ES Module support for webassembly modules",
             &EnvironmentOptions::experimental_wasm_modules,
             kAllowedInEnvironment);
+  AddOption("--experimental-fs-io-uring",
+            "submit asynchronous file system requests through io_uring "
+            "instead of the libuv threadpool where supported",
+            &EnvironmentOptions::experimental_fs_io_uring,
+            kAllowedInEnvironment);
   AddOption("--experimental-import-meta-resolve",
             "experimental ES Module import.meta.resolve() support",
             &EnvironmentOptions::experimental_import_meta_resolve,
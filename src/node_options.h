@@ -107,6 +107,7 @@ class EnvironmentOptions : public Options {
   std::string experimental_specifier_resolution;
   bool experimental_wasm_modules = false;
   bool experimental_import_meta_resolve = false;
+  bool experimental_fs_io_uring = false;
   std::string module_type;
   std::string experimental_policy;
   std::string experimental_policy_integrity;
@@ -9,6 +9,11 @@
 #include "node_worker.h"
 #include "util.h"
 
+#if HAVE_OPENSSL
+#include "crypto/crypto_bio.h"
+#include "memory_tracker-inl.h"
+#endif  // HAVE_OPENSSL
+
 #ifdef _WIN32
 #include <Windows.h>
 #else  // !_WIN32
@@ -70,6 +75,7 @@ static void PrintJavaScriptErrorProperties(JSONWriter* writer,
                                            Local<Object> error);
 static void PrintNativeStack(JSONWriter* writer);
 static void PrintResourceUsage(JSONWriter* writer);
+static void PrintTLSBufferPool(JSONWriter* writer, Environment* env);
 static void PrintGCStatistics(JSONWriter* writer, Isolate* isolate);
 static void PrintSystemInformation(JSONWriter* writer);
 static void PrintLoadedLibraries(JSONWriter* writer);
@@ -284,6 +290,9 @@ static void WriteNodeReport(Isolate* isolate,
   // Report OS and current thread resource usage
   PrintResourceUsage(&writer);
 
+  // Report memory held by the buffers of TLS connections
+  PrintTLSBufferPool(&writer, env);
+
   writer.json_arraystart("libuv");
   if (env != nullptr) {
     uv_walk(env->event_loop(), WalkHandle, static_cast<void*>(&writer));
@@ -658,6 +667,26 @@ static void PrintResourceUsage(JSONWriter* writer) {
 #endif
 }
 
+// Report the memory used for the encrypted data of TLS connections.
+static void PrintTLSBufferPool(JSONWriter* writer, Environment* env) {
+  size_t in_use_bytes = 0;
+  size_t pooled_bytes = 0;
+#if HAVE_OPENSSL
+  // Writing a report should not create the pool if no TLS connection has.
+  node::crypto::NodeBIOPool* pool =
+      env != nullptr ? env->existing_nodebio_pool() : nullptr;
+  if (pool != nullptr) {
+    in_use_bytes = pool->in_use_bytes();
+    pooled_bytes = pool->pooled_bytes();
+  }
+#endif  // HAVE_OPENSSL
+
+  writer->json_objectstart("tlsBufferPool");
+  writer->json_keyvalue("inUseBytes", in_use_bytes);
+  writer->json_keyvalue("pooledBytes", pooled_bytes);
+  writer->json_objectend();
+}
+
 // Report operating system information.
 static void PrintSystemInformation(JSONWriter* writer) {
   uv_env_item_t* envitems;
@@ -0,0 +1,60 @@
+#include "node_simd.h"
+
+#include <atomic>
+
+#if defined(NODE_SIMD_X86) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace node {
+namespace simd {
+
+namespace {
+
+uint32_t DetectFeatures() {
+  uint32_t features = 0;
+#if defined(NODE_SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  const int max_leaf = info[0];
+  __cpuid(info, 1);
+  if (info[2] & (1 << 19))
+    features |= kSSE41;
+  // AVX2 also requires the OS to save the upper halves of the registers.
+  const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 &&
+                            (_xgetbv(0) & 6) == 6;
+  if (os_saves_ymm && max_leaf >= 7) {
+    __cpuidex(info, 7, 0);
+    if (info[1] & (1 << 5))
+      features |= kAVX2;
+  }
+#else
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.1"))
+    features |= kSSE41;
+  if (__builtin_cpu_supports("avx2"))
+    features |= kAVX2;
+#endif
+#elif defined(NODE_SIMD_NEON)
+  features |= kNEON;
+#endif
+  return features;
+}
+
+std::atomic<uint32_t> feature_mask { ~0u };
+
+}  // anonymous namespace
+
+uint32_t GetFeatures() {
+  static const uint32_t features = DetectFeatures();
+  return features & feature_mask.load(std::memory_order_relaxed);
+}
+
+uint32_t SetFeatureMaskForTesting(uint32_t mask) {
+  return feature_mask.exchange(mask);
+}
+
+}  // namespace simd
+}  // namespace node
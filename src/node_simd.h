@@ -0,0 +1,57 @@
+#ifndef SRC_NODE_SIMD_H_
+#define SRC_NODE_SIMD_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstdint>
+
+// Support for code that uses SIMD instructions beyond the baseline of the
+// target architecture. Such code lives in functions that are marked with the
+// matching NODE_TARGET_* attribute, and these functions may only be called
+// after node::simd::Supports() has confirmed that the CPU has the feature.
+// This way, a single binary can use AVX2 where it is available without
+// requiring it everywhere.
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    defined(__i386__) || defined(_M_IX86)
+#define NODE_SIMD_X86 1
+#if defined(__GNUC__) || defined(__clang__)
+#define NODE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define NODE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+// MSVC allows using the intrinsics of any instruction set everywhere.
+#define NODE_TARGET_SSE41
+#define NODE_TARGET_AVX2
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+// NEON is part of the baseline on arm64, no runtime check is required.
+#define NODE_SIMD_NEON 1
+#endif
+
+namespace node {
+namespace simd {
+
+enum Feature : uint32_t {
+  kSSE41 = 1 << 0,
+  kAVX2 = 1 << 1,
+  kNEON = 1 << 2,
+};
+
+// Returns the features of the CPU that the process runs on, as a bit mask of
+// Feature values.
+uint32_t GetFeatures();
+
+inline bool Supports(Feature feature) {
+  return (GetFeatures() & feature) != 0;
+}
+
+// Hides features from GetFeatures(), so that tests can exercise every code
+// path on the same machine. Returns the previous mask.
+uint32_t SetFeatureMaskForTesting(uint32_t mask);
+
+}  // namespace simd
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_SIMD_H_
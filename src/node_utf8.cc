@@ -0,0 +1,994 @@
+#include "node_utf8.h"
+#include "node_simd.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(NODE_SIMD_X86)
+#include <immintrin.h>
+#elif defined(NODE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+// The vectorized validation follows J. Keiser and D. Lemire, "Validating
+// UTF-8 In Less Than One Instruction Per Byte" (Software: Practice and
+// Experience, 2021). Transcoding only vectorizes runs of ASCII characters,
+// which dominate most real-world text, and handles all other characters
+// with scalar code.
+
+namespace node {
+namespace utf8 {
+
+namespace {
+
+// How many bytes the scalar code processes before it tries to find another
+// run of ASCII characters for the vector code.
+constexpr size_t kScalarRun = 16;
+
+inline bool IsContinuation(uint8_t c) {
+  return (c & 0xc0) == 0x80;
+}
+
+inline size_t CountBits(uint32_t x) {
+  x = x - ((x >> 1) & 0x55555555);
+  x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+  return (((x + (x >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+}
+
+// Scalar versions of the primitives below. They handle one machine word at a
+// time, which keeps platforms without vector support reasonably fast.
+
+size_t AsciiPrefixScalar(const uint8_t* src, size_t length) {
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word;
+    memcpy(&word, src + i, sizeof(word));
+    if (word & 0x8080808080808080ull)
+      break;
+  }
+  return i;
+}
+
+size_t CopyAsciiPrefixScalar(const uint8_t* src, size_t length, char* dst) {
+  const size_t n = AsciiPrefixScalar(src, length);
+  memcpy(dst, src, n);
+  return n;
+}
+
+#if defined(NODE_SIMD_X86)
+
+// Lookup tables for the validation, indexed by the high nibble of the first
+// byte of a pair, its low nibble, and the high nibble of the second byte.
+// Every bit stands for one kind of error, and a pair of bytes is invalid if a
+// bit is set in all three results. See the paper for details.
+#define UTF8_BYTE_1_HIGH                                                      \
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,                             \
+  0x80, 0x80, 0x80, 0x80, 0x21, 0x01, 0x15, 0x49
+#define UTF8_BYTE_1_LOW                                                       \
+  0xe7, 0xa3, 0x83, 0x83, 0x8b, 0xcb, 0xcb, 0xcb,                             \
+  0xcb, 0xcb, 0xcb, 0xcb, 0xcb, 0xdb, 0xcb, 0xcb
+#define UTF8_BYTE_2_HIGH                                                      \
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,                             \
+  0xe6, 0xae, 0xba, 0xba, 0x01, 0x01, 0x01, 0x01
+// Bytes greater than these at the end of a block start a character that
+// continues in the next block.
+#define UTF8_INCOMPLETE_MAX                                                   \
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,                             \
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf
+#define UTF8_ALL_FF                                                           \
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,                             \
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+
+#define V(x) static_cast<char>(x)
+
+NODE_TARGET_SSE41
+inline __m128i Table128(uint8_t a0, uint8_t a1, uint8_t a2, uint8_t a3,
+                        uint8_t a4, uint8_t a5, uint8_t a6, uint8_t a7,
+                        uint8_t a8, uint8_t a9, uint8_t a10, uint8_t a11,
+                        uint8_t a12, uint8_t a13, uint8_t a14, uint8_t a15) {
+  return _mm_setr_epi8(V(a0), V(a1), V(a2), V(a3), V(a4), V(a5), V(a6),
+                       V(a7), V(a8), V(a9), V(a10), V(a11), V(a12), V(a13),
+                       V(a14), V(a15));
+}
+
+#undef V
+
+struct ValidationStateSSE41 {
+  __m128i prev_input;
+  __m128i prev_incomplete;
+  __m128i error;
+};
+
+NODE_TARGET_SSE41
+inline void CheckBlockSSE41(__m128i input, ValidationStateSSE41* state) {
+  if (_mm_movemask_epi8(input) == 0) {
+    // An ASCII block is fine unless the previous one ended mid-character.
+    state->error = _mm_or_si128(state->error, state->prev_incomplete);
+    state->prev_input = input;
+    return;
+  }
+
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  const __m128i prev1 = _mm_alignr_epi8(input, state->prev_input, 15);
+  const __m128i byte_1_high = _mm_shuffle_epi8(
+      Table128(UTF8_BYTE_1_HIGH),
+      _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+  const __m128i byte_1_low = _mm_shuffle_epi8(
+      Table128(UTF8_BYTE_1_LOW), _mm_and_si128(prev1, nibble));
+  const __m128i byte_2_high = _mm_shuffle_epi8(
+      Table128(UTF8_BYTE_2_HIGH),
+      _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+  const __m128i special_cases =
+      _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+  // The second and third continuation bytes of three- and four-byte
+  // characters are not covered by the tables.
+  const __m128i prev2 = _mm_alignr_epi8(input, state->prev_input, 14);
+  const __m128i prev3 = _mm_alignr_epi8(input, state->prev_input, 13);
+  const __m128i is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(0x60));
+  const __m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(0x70));
+  const __m128i must_be_continuation =
+      _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte),
+                    _mm_set1_epi8(static_cast<char>(0x80)));
+
+  state->error = _mm_or_si128(
+      state->error, _mm_xor_si128(must_be_continuation, special_cases));
+  state->prev_incomplete =
+      _mm_subs_epu8(input, Table128(UTF8_INCOMPLETE_MAX));
+  state->prev_input = input;
+}
+
+NODE_TARGET_SSE41
+bool IsValidSSE41(const uint8_t* src, size_t length) {
+  ValidationStateSSE41 state = {
+    _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()
+  };
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+    const __m128i c =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32));
+    const __m128i d =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48));
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b),
+                                       _mm_or_si128(c, d))) == 0) {
+      state.error = _mm_or_si128(state.error, state.prev_incomplete);
+      state.prev_input = d;
+    } else {
+      CheckBlockSSE41(a, &state);
+      CheckBlockSSE41(b, &state);
+      CheckBlockSSE41(c, &state);
+      CheckBlockSSE41(d, &state);
+    }
+    if (!_mm_testz_si128(state.error, state.error))
+      return false;
+  }
+  for (; i + 16 <= length; i += 16) {
+    CheckBlockSSE41(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), &state);
+  }
+  if (i < length) {
+    // Zeros are ASCII, so padding the rest of the input with them detects
+    // a character that is cut off at the end.
+    uint8_t last[16] = {};
+    memcpy(last, src + i, length - i);
+    CheckBlockSSE41(_mm_loadu_si128(reinterpret_cast<const __m128i*>(last)),
+                    &state);
+  }
+  state.error = _mm_or_si128(state.error, state.prev_incomplete);
+  return _mm_testz_si128(state.error, state.error);
+}
+
+struct ValidationStateAVX2 {
+  __m256i prev_input;
+  __m256i prev_incomplete;
+  __m256i error;
+};
+
+NODE_TARGET_AVX2
+inline __m256i Table256(__m128i table) {
+  return _mm256_broadcastsi128_si256(table);
+}
+
+NODE_TARGET_AVX2
+inline void CheckBlockAVX2(__m256i input,
+                           const __m256i* tables,
+                           ValidationStateAVX2* state) {
+  if (_mm256_movemask_epi8(input) == 0) {
+    state->error = _mm256_or_si256(state->error, state->prev_incomplete);
+    state->prev_input = input;
+    return;
+  }
+
+  // The bytes that precede the lower lane of `input` are in the upper lane
+  // of the previous block.
+  const __m256i shifted =
+      _mm256_permute2x128_si256(state->prev_input, input, 0x21);
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  const __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+  const __m256i byte_1_high = _mm256_shuffle_epi8(
+      tables[0], _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+  const __m256i byte_1_low =
+      _mm256_shuffle_epi8(tables[1], _mm256_and_si256(prev1, nibble));
+  const __m256i byte_2_high = _mm256_shuffle_epi8(
+      tables[2], _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+  const __m256i special_cases = _mm256_and_si256(
+      _mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+  const __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+  const __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+  const __m256i is_third_byte =
+      _mm256_subs_epu8(prev2, _mm256_set1_epi8(0x60));
+  const __m256i is_fourth_byte =
+      _mm256_subs_epu8(prev3, _mm256_set1_epi8(0x70));
+  const __m256i must_be_continuation =
+      _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte),
+                       _mm256_set1_epi8(static_cast<char>(0x80)));
+
+  state->error = _mm256_or_si256(
+      state->error, _mm256_xor_si256(must_be_continuation, special_cases));
+  state->prev_incomplete = _mm256_subs_epu8(input, tables[3]);
+  state->prev_input = input;
+}
+
+NODE_TARGET_AVX2
+bool IsValidAVX2(const uint8_t* src, size_t length) {
+  const __m256i tables[] = {
+    Table256(Table128(UTF8_BYTE_1_HIGH)),
+    Table256(Table128(UTF8_BYTE_1_LOW)),
+    Table256(Table128(UTF8_BYTE_2_HIGH)),
+    _mm256_inserti128_si256(
+        _mm256_castsi128_si256(Table128(UTF8_ALL_FF)),
+        Table128(UTF8_INCOMPLETE_MAX), 1),
+  };
+  ValidationStateAVX2 state = {
+    _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()
+  };
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+    if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) == 0) {
+      state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+      state.prev_input = b;
+    } else {
+      CheckBlockAVX2(a, tables, &state);
+      CheckBlockAVX2(b, tables, &state);
+    }
+    if (!_mm256_testz_si256(state.error, state.error))
+      return false;
+  }
+  if (i < length) {
+    uint8_t last[64] = {};
+    memcpy(last, src + i, length - i);
+    CheckBlockAVX2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(last)),
+        tables, &state);
+    CheckBlockAVX2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(last + 32)),
+        tables, &state);
+  }
+  state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+  return _mm256_testz_si256(state.error, state.error);
+}
+
+NODE_TARGET_SSE41
+size_t AsciiPrefixSSE41(const uint8_t* src, size_t length) {
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    const __m128i* p = reinterpret_cast<const __m128i*>(src + i);
+    const __m128i all = _mm_or_si128(
+        _mm_or_si128(_mm_loadu_si128(p), _mm_loadu_si128(p + 1)),
+        _mm_or_si128(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3)));
+    if (_mm_movemask_epi8(all) != 0)
+      break;
+  }
+  for (; i + 16 <= length; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(in) != 0)
+      break;
+  }
+  return i;
+}
+
+NODE_TARGET_SSE41
+size_t CopyAsciiPrefixSSE41(const uint8_t* src, size_t length, char* dst) {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(in) != 0)
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), in);
+  }
+  return i;
+}
+
+NODE_TARGET_SSE41
+size_t WidenAsciiPrefixSSE41(const uint8_t* src,
+                             size_t length,
+                             uint16_t* dst) {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(in) != 0)
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_cvtepu8_epi16(in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8),
+                     _mm_cvtepu8_epi16(_mm_srli_si128(in, 8)));
+  }
+  return i;
+}
+
+NODE_TARGET_SSE41
+size_t AsciiPrefixUtf16SSE41(const uint16_t* src, size_t length) {
+  const __m128i non_ascii = _mm_set1_epi16(static_cast<int16_t>(0xff80));
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    if (!_mm_testz_si128(_mm_or_si128(lo, hi), non_ascii))
+      break;
+  }
+  return i;
+}
+
+NODE_TARGET_SSE41
+size_t NarrowAsciiPrefixSSE41(const uint16_t* src,
+                              size_t length,
+                              char* dst) {
+  const __m128i non_ascii = _mm_set1_epi16(static_cast<int16_t>(0xff80));
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    if (!_mm_testz_si128(_mm_or_si128(lo, hi), non_ascii))
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(lo, hi));
+  }
+  return i;
+}
+
+NODE_TARGET_SSE41
+void StripHighBitsSSE41(const uint8_t* src, char* dst, size_t length) {
+  const __m128i mask = _mm_set1_epi8(0x7f);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_and_si128(in, mask));
+  }
+  for (; i < length; i++)
+    dst[i] = src[i] & 0x7f;
+}
+
+// Counts the bytes that start a character, plus those that start a
+// four-byte character, which takes two UTF-16 code units.
+NODE_TARGET_SSE41
+size_t Utf16LengthSSE41(const uint8_t* src, size_t length, size_t* counted) {
+  // Compared as signed bytes, 0x80-0xbf are -128 to -65 and 0xf0-0xff are
+  // -16 to -1, which excludes ASCII once the sign bit is checked as well.
+  const __m128i last_continuation = _mm_set1_epi8(-65);
+  const __m128i before_four_byte_lead = _mm_set1_epi8(-17);
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const uint32_t leads = _mm_movemask_epi8(
+        _mm_cmpgt_epi8(in, last_continuation));
+    const uint32_t four_byte_leads = _mm_movemask_epi8(
+        _mm_cmpgt_epi8(in, before_four_byte_lead)) & _mm_movemask_epi8(in);
+    result += CountBits(leads) + CountBits(four_byte_leads);
+  }
+  *counted = i;
+  return result;
+}
+
+NODE_TARGET_SSE41
+size_t CountHighBytesSSE41(const uint8_t* src, size_t length, size_t* counted) {
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    result += CountBits(_mm_movemask_epi8(in));
+  }
+  *counted = i;
+  return result;
+}
+
+#undef UTF8_BYTE_1_HIGH
+#undef UTF8_BYTE_1_LOW
+#undef UTF8_BYTE_2_HIGH
+#undef UTF8_INCOMPLETE_MAX
+#undef UTF8_ALL_FF
+
+#elif defined(NODE_SIMD_NEON)
+
+constexpr uint8_t kByte1High[16] = {
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x80, 0x80, 0x80, 0x80, 0x21, 0x01, 0x15, 0x49
+};
+constexpr uint8_t kByte1Low[16] = {
+  0xe7, 0xa3, 0x83, 0x83, 0x8b, 0xcb, 0xcb, 0xcb,
+  0xcb, 0xcb, 0xcb, 0xcb, 0xcb, 0xdb, 0xcb, 0xcb
+};
+constexpr uint8_t kByte2High[16] = {
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0xe6, 0xae, 0xba, 0xba, 0x01, 0x01, 0x01, 0x01
+};
+constexpr uint8_t kIncompleteMax[16] = {
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf
+};
+
+struct ValidationStateNEON {
+  uint8x16_t prev_input;
+  uint8x16_t prev_incomplete;
+  uint8x16_t error;
+};
+
+inline void CheckBlockNEON(uint8x16_t input, ValidationStateNEON* state) {
+  if (vmaxvq_u8(input) < 0x80) {
+    state->error = vorrq_u8(state->error, state->prev_incomplete);
+    state->prev_input = input;
+    return;
+  }
+
+  const uint8x16_t prev1 = vextq_u8(state->prev_input, input, 15);
+  const uint8x16_t byte_1_high =
+      vqtbl1q_u8(vld1q_u8(kByte1High), vshrq_n_u8(prev1, 4));
+  const uint8x16_t byte_1_low =
+      vqtbl1q_u8(vld1q_u8(kByte1Low), vandq_u8(prev1, vdupq_n_u8(0x0f)));
+  const uint8x16_t byte_2_high =
+      vqtbl1q_u8(vld1q_u8(kByte2High), vshrq_n_u8(input, 4));
+  const uint8x16_t special_cases =
+      vandq_u8(vandq_u8(byte_1_high, byte_1_low), byte_2_high);
+
+  const uint8x16_t prev2 = vextq_u8(state->prev_input, input, 14);
+  const uint8x16_t prev3 = vextq_u8(state->prev_input, input, 13);
+  const uint8x16_t is_third_byte = vqsubq_u8(prev2, vdupq_n_u8(0x60));
+  const uint8x16_t is_fourth_byte = vqsubq_u8(prev3, vdupq_n_u8(0x70));
+  const uint8x16_t must_be_continuation =
+      vandq_u8(vorrq_u8(is_third_byte, is_fourth_byte), vdupq_n_u8(0x80));
+
+  state->error = vorrq_u8(state->error,
+                          veorq_u8(must_be_continuation, special_cases));
+  state->prev_incomplete = vqsubq_u8(input, vld1q_u8(kIncompleteMax));
+  state->prev_input = input;
+}
+
+bool IsValidNEON(const uint8_t* src, size_t length) {
+  ValidationStateNEON state = {
+    vdupq_n_u8(0), vdupq_n_u8(0), vdupq_n_u8(0)
+  };
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    const uint8x16_t in[] = {
+      vld1q_u8(src + i), vld1q_u8(src + i + 16),
+      vld1q_u8(src + i + 32), vld1q_u8(src + i + 48)
+    };
+    const uint8x16_t all = vorrq_u8(vorrq_u8(in[0], in[1]),
+                                    vorrq_u8(in[2], in[3]));
+    if (vmaxvq_u8(all) < 0x80) {
+      state.error = vorrq_u8(state.error, state.prev_incomplete);
+      state.prev_input = in[3];
+    } else {
+      for (int j = 0; j < 4; j++)
+        CheckBlockNEON(in[j], &state);
+    }
+    if (vmaxvq_u8(state.error) != 0)
+      return false;
+  }
+  for (; i + 16 <= length; i += 16)
+    CheckBlockNEON(vld1q_u8(src + i), &state);
+  if (i < length) {
+    uint8_t last[16] = {};
+    memcpy(last, src + i, length - i);
+    CheckBlockNEON(vld1q_u8(last), &state);
+  }
+  state.error = vorrq_u8(state.error, state.prev_incomplete);
+  return vmaxvq_u8(state.error) == 0;
+}
+
+size_t AsciiPrefixNEON(const uint8_t* src, size_t length) {
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    const uint8x16_t all =
+        vorrq_u8(vorrq_u8(vld1q_u8(src + i), vld1q_u8(src + i + 16)),
+                 vorrq_u8(vld1q_u8(src + i + 32), vld1q_u8(src + i + 48)));
+    if (vmaxvq_u8(all) >= 0x80)
+      break;
+  }
+  for (; i + 16 <= length; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(src + i)) >= 0x80)
+      break;
+  }
+  return i;
+}
+
+size_t CopyAsciiPrefixNEON(const uint8_t* src, size_t length, char* dst) {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t in = vld1q_u8(src + i);
+    if (vmaxvq_u8(in) >= 0x80)
+      break;
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), in);
+  }
+  return i;
+}
+
+size_t WidenAsciiPrefixNEON(const uint8_t* src,
+                            size_t length,
+                            uint16_t* dst) {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t in = vld1q_u8(src + i);
+    if (vmaxvq_u8(in) >= 0x80)
+      break;
+    vst1q_u16(dst + i, vmovl_u8(vget_low_u8(in)));
+    vst1q_u16(dst + i + 8, vmovl_high_u8(in));
+  }
+  return i;
+}
+
+size_t AsciiPrefixUtf16NEON(const uint16_t* src, size_t length) {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    if (vmaxvq_u16(vorrq_u16(vld1q_u16(src + i), vld1q_u16(src + i + 8))) >=
+        0x80) {
+      break;
+    }
+  }
+  return i;
+}
+
+size_t NarrowAsciiPrefixNEON(const uint16_t* src,
+                             size_t length,
+                             char* dst) {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint16x8_t lo = vld1q_u16(src + i);
+    const uint16x8_t hi = vld1q_u16(src + i + 8);
+    if (vmaxvq_u16(vorrq_u16(lo, hi)) >= 0x80)
+      break;
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i),
+             vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+  }
+  return i;
+}
+
+void StripHighBitsNEON(const uint8_t* src, char* dst, size_t length) {
+  const uint8x16_t mask = vdupq_n_u8(0x7f);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i),
+             vandq_u8(vld1q_u8(src + i), mask));
+  }
+  for (; i < length; i++)
+    dst[i] = src[i] & 0x7f;
+}
+
+size_t Utf16LengthNEON(const uint8_t* src, size_t length, size_t* counted) {
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t in = vld1q_u8(src + i);
+    // Every byte that starts a character is either ASCII or at least 0xc0.
+    const uint8x16_t leads = vorrq_u8(vcltq_u8(in, vdupq_n_u8(0x80)),
+                                      vcgeq_u8(in, vdupq_n_u8(0xc0)));
+    const uint8x16_t four_byte_leads = vcgeq_u8(in, vdupq_n_u8(0xf0));
+    result += vaddlvq_u8(vshrq_n_u8(leads, 7)) +
+              vaddlvq_u8(vshrq_n_u8(four_byte_leads, 7));
+  }
+  *counted = i;
+  return result;
+}
+
+size_t CountHighBytesNEON(const uint8_t* src, size_t length, size_t* counted) {
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16)
+    result += vaddlvq_u8(vshrq_n_u8(vld1q_u8(src + i), 7));
+  *counted = i;
+  return result;
+}
+
+#endif  // defined(NODE_SIMD_NEON)
+
+// Dispatch to the best available implementation of each primitive. All of
+// them process a prefix of the input, and the callers handle the rest.
+
+inline size_t AsciiPrefix(const uint8_t* src, size_t length) {
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kSSE41))
+    return AsciiPrefixSSE41(src, length);
+#elif defined(NODE_SIMD_NEON)
+  if (simd::Supports(simd::kNEON))
+    return AsciiPrefixNEON(src, length);
+#endif
+  return AsciiPrefixScalar(src, length);
+}
+
+inline size_t CopyAsciiPrefix(const uint8_t* src, size_t length, char* dst) {
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kSSE41))
+    return CopyAsciiPrefixSSE41(src, length, dst);
+#elif defined(NODE_SIMD_NEON)
+  if (simd::Supports(simd::kNEON))
+    return CopyAsciiPrefixNEON(src, length, dst);
+#endif
+  return CopyAsciiPrefixScalar(src, length, dst);
+}
+
+inline size_t WidenAsciiPrefix(const uint8_t* src,
+                               size_t length,
+                               uint16_t* dst) {
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kSSE41))
+    return WidenAsciiPrefixSSE41(src, length, dst);
+#elif defined(NODE_SIMD_NEON)
+  if (simd::Supports(simd::kNEON))
+    return WidenAsciiPrefixNEON(src, length, dst);
+#endif
+  return 0;
+}
+
+inline size_t AsciiPrefixUtf16(const uint16_t* src, size_t length) {
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kSSE41))
+    return AsciiPrefixUtf16SSE41(src, length);
+#elif defined(NODE_SIMD_NEON)
+  if (simd::Supports(simd::kNEON))
+    return AsciiPrefixUtf16NEON(src, length);
+#endif
+  return 0;
+}
+
+inline size_t NarrowAsciiPrefix(const uint16_t* src,
+                                size_t length,
+                                char* dst) {
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kSSE41))
+    return NarrowAsciiPrefixSSE41(src, length, dst);
+#elif defined(NODE_SIMD_NEON)
+  if (simd::Supports(simd::kNEON))
+    return NarrowAsciiPrefixNEON(src, length, dst);
+#endif
+  return 0;
+}
+
+bool IsValidScalar(const uint8_t* src, size_t length) {
+  size_t i = 0;
+  while (i < length) {
+    i += AsciiPrefixScalar(src + i, length - i);
+    const size_t end = std::min(length, i + kScalarRun);
+    while (i < end) {
+      const uint8_t c = src[i];
+      if (c < 0x80) {
+        i++;
+        continue;
+      }
+
+      size_t n;
+      uint32_t code_point;
+      uint32_t min;
+      if ((c & 0xe0) == 0xc0) {
+        n = 2;
+        code_point = c & 0x1f;
+        min = 0x80;
+      } else if ((c & 0xf0) == 0xe0) {
+        n = 3;
+        code_point = c & 0x0f;
+        min = 0x800;
+      } else if ((c & 0xf8) == 0xf0) {
+        n = 4;
+        code_point = c & 0x07;
+        min = 0x10000;
+      } else {
+        return false;
+      }
+      if (length - i < n)
+        return false;
+      for (size_t j = 1; j < n; j++) {
+        if (!IsContinuation(src[i + j]))
+          return false;
+        code_point = (code_point << 6) | (src[i + j] & 0x3f);
+      }
+      if (code_point < min || code_point > 0x10ffff ||
+          (code_point >= 0xd800 && code_point <= 0xdfff)) {
+        return false;
+      }
+      i += n;
+    }
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
+bool IsAscii(const char* data, size_t length) {
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+  for (size_t i = AsciiPrefix(src, length); i < length; i++) {
+    if (src[i] & 0x80)
+      return false;
+  }
+  return true;
+}
+
+bool IsValid(const char* data, size_t length) {
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kAVX2))
+    return IsValidAVX2(src, length);
+  if (simd::Supports(simd::kSSE41))
+    return IsValidSSE41(src, length);
+#elif defined(NODE_SIMD_NEON)
+  if (simd::Supports(simd::kNEON))
+    return IsValidNEON(src, length);
+#endif
+  return IsValidScalar(src, length);
+}
+
+void StripHighBits(const char* data, char* dst, size_t length) {
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kSSE41))
+    return StripHighBitsSSE41(src, dst, length);
+#elif defined(NODE_SIMD_NEON)
+  if (simd::Supports(simd::kNEON))
+    return StripHighBitsNEON(src, dst, length);
+#endif
+  for (size_t i = 0; i < length; i++)
+    dst[i] = src[i] & 0x7f;
+}
+
+size_t Utf16Length(const char* data, size_t length) {
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+  size_t i = 0;
+  size_t result = 0;
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kSSE41))
+    result = Utf16LengthSSE41(src, length, &i);
+#elif defined(NODE_SIMD_NEON)
+  if (simd::Supports(simd::kNEON))
+    result = Utf16LengthNEON(src, length, &i);
+#endif
+  for (; i < length; i++)
+    result += !IsContinuation(src[i]) + (src[i] >= 0xf0);
+  return result;
+}
+
+size_t ToUtf16(const char* data, size_t length, uint16_t* dst) {
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+  size_t i = 0;
+  size_t k = 0;
+  while (i < length) {
+    const size_t ascii = WidenAsciiPrefix(src + i, length - i, dst + k);
+    i += ascii;
+    k += ascii;
+    const size_t end = std::min(length, i + kScalarRun);
+    while (i < end) {
+      const uint8_t c = src[i];
+      if (c < 0x80) {
+        dst[k++] = c;
+        i++;
+        continue;
+      }
+
+      size_t n = (c >= 0xf0) ? 4 : (c >= 0xe0) ? 3 : 2;
+      if (length - i < n)
+        n = length - i;
+      uint32_t code_point = c & (0x7f >> n);
+      for (size_t j = 1; j < n; j++)
+        code_point = (code_point << 6) | (src[i + j] & 0x3f);
+      if (code_point >= 0x10000) {
+        code_point -= 0x10000;
+        dst[k++] = 0xd800 | ((code_point >> 10) & 0x3ff);
+        dst[k++] = 0xdc00 | (code_point & 0x3ff);
+      } else {
+        dst[k++] = code_point;
+      }
+      i += n;
+    }
+  }
+  return k;
+}
+
+bool IsLatin1(const char* data, size_t length) {
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+  // In valid UTF-8, code points above U+00FF are exactly those whose first
+  // byte is at least 0xc4. The inner loop has no early exit, so that the
+  // compiler can vectorize it.
+  for (size_t i = AsciiPrefix(src, length); i < length; i += kScalarRun) {
+    const size_t end = std::min(length, i + kScalarRun);
+    bool wide = false;
+    for (size_t j = i; j < end; j++)
+      wide |= src[j] >= 0xc4;
+    if (wide)
+      return false;
+  }
+  return true;
+}
+
+size_t ToLatin1(const char* data, size_t length, char* dst) {
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+  size_t i = 0;
+  size_t k = 0;
+  while (i < length) {
+    const size_t ascii = CopyAsciiPrefix(src + i, length - i, dst + k);
+    i += ascii;
+    k += ascii;
+    const size_t end = std::min(length, i + kScalarRun);
+    while (i < end) {
+      const uint8_t c = src[i];
+      if (c < 0x80) {
+        dst[k++] = c;
+        i++;
+      } else {
+        dst[k++] = ((c & 0x03) << 6) | (src[i + 1] & 0x3f);
+        i += 2;
+      }
+    }
+  }
+  return k;
+}
+
+size_t LengthFromLatin1(const uint8_t* src, size_t length) {
+  size_t i = 0;
+  size_t result = length;
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kSSE41))
+    result += CountHighBytesSSE41(src, length, &i);
+#elif defined(NODE_SIMD_NEON)
+  if (simd::Supports(simd::kNEON))
+    result += CountHighBytesNEON(src, length, &i);
+#endif
+  for (; i < length; i++)
+    result += src[i] >> 7;
+  return result;
+}
+
+size_t FromLatin1(const uint8_t* src,
+                  size_t length,
+                  char* dst,
+                  size_t dst_length,
+                  size_t* read) {
+  size_t i = 0;
+  size_t k = 0;
+  while (i < length) {
+    const size_t ascii = CopyAsciiPrefix(
+        src + i, std::min(length - i, dst_length - k), dst + k);
+    i += ascii;
+    k += ascii;
+    const size_t end = std::min(length, i + kScalarRun);
+    for (; i < end; i++) {
+      const uint8_t c = src[i];
+      if (c < 0x80) {
+        if (k == dst_length)
+          break;
+        dst[k++] = c;
+      } else {
+        if (dst_length - k < 2)
+          break;
+        dst[k++] = 0xc0 | (c >> 6);
+        dst[k++] = 0x80 | (c & 0x3f);
+      }
+    }
+    if (i < end)
+      break;
+  }
+  *read = i;
+  return k;
+}
+
+size_t LengthFromUtf16(const uint16_t* src, size_t length) {
+  size_t result = 0;
+  size_t i = 0;
+  while (i < length) {
+    const size_t ascii = AsciiPrefixUtf16(src + i, length - i);
+    i += ascii;
+    result += ascii;
+    const size_t end = std::min(length, i + kScalarRun);
+    for (; i < end; i++) {
+      const uint16_t c = src[i];
+      if (c < 0x80) {
+        result += 1;
+      } else if (c < 0x800) {
+        result += 2;
+      } else if (c >= 0xd800 && c <= 0xdbff && i + 1 < length &&
+                 src[i + 1] >= 0xdc00 && src[i + 1] <= 0xdfff) {
+        result += 4;
+        i++;
+      } else {
+        result += 3;
+      }
+    }
+  }
+  return result;
+}
+
+size_t FromUtf16(const uint16_t* src,
+                 size_t length,
+                 char* dst,
+                 size_t dst_length,
+                 size_t* read) {
+  size_t i = 0;
+  size_t k = 0;
+  while (i < length) {
+    const size_t ascii = NarrowAsciiPrefix(
+        src + i, std::min(length - i, dst_length - k), dst + k);
+    i += ascii;
+    k += ascii;
+    const size_t end = std::min(length, i + kScalarRun);
+    bool full = false;
+    while (i < end) {
+      uint32_t c = src[i];
+      size_t n = 1;
+      if (c >= 0xd800 && c <= 0xdfff) {
+        if (c <= 0xdbff && i + 1 < length &&
+            src[i + 1] >= 0xdc00 && src[i + 1] <= 0xdfff) {
+          c = 0x10000 + ((c - 0xd800) << 10) + (src[i + 1] - 0xdc00);
+          n = 2;
+        } else {
+          c = 0xfffd;
+        }
+      }
+
+      if (c < 0x80) {
+        if (k == dst_length) {
+          full = true;
+          break;
+        }
+        dst[k++] = c;
+      } else if (c < 0x800) {
+        if (dst_length - k < 2) {
+          full = true;
+          break;
+        }
+        dst[k++] = 0xc0 | (c >> 6);
+        dst[k++] = 0x80 | (c & 0x3f);
+      } else if (c < 0x10000) {
+        if (dst_length - k < 3) {
+          full = true;
+          break;
+        }
+        dst[k++] = 0xe0 | (c >> 12);
+        dst[k++] = 0x80 | ((c >> 6) & 0x3f);
+        dst[k++] = 0x80 | (c & 0x3f);
+      } else {
+        if (dst_length - k < 4) {
+          full = true;
+          break;
+        }
+        dst[k++] = 0xf0 | (c >> 18);
+        dst[k++] = 0x80 | ((c >> 12) & 0x3f);
+        dst[k++] = 0x80 | ((c >> 6) & 0x3f);
+        dst[k++] = 0x80 | (c & 0x3f);
+      }
+      i += n;
+    }
+    if (full)
+      break;
+  }
+  *read = i;
+  return k;
+}
+
+}  // namespace utf8
+}  // namespace node
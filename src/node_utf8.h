@@ -0,0 +1,78 @@
+#ifndef SRC_NODE_UTF8_H_
+#define SRC_NODE_UTF8_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <cstdint>
+
+// UTF-8 validation and transcoding for data that does not live in V8 strings,
+// or that lives in external strings whose contents are directly accessible.
+// ASCII runs and validation are processed with vector instructions where the
+// CPU supports them (see node_simd.h); everything else falls back to scalar
+// code with identical results.
+
+namespace node {
+namespace utf8 {
+
+// Returns true if all bytes are below 0x80.
+bool IsAscii(const char* data, size_t length);
+
+// Returns true if `data` is well-formed UTF-8, i.e. it contains neither
+// overlong encodings nor surrogates nor code points above U+10FFFF, and
+// does not end in the middle of a character.
+bool IsValid(const char* data, size_t length);
+
+// Copies `src` to `dst` with the high bit of every byte cleared, which is
+// how Node.js' 'ascii' encoding treats non-ASCII bytes.
+void StripHighBits(const char* src, char* dst, size_t length);
+
+// Returns the number of UTF-16 code units that the valid UTF-8 `data`
+// decodes to.
+size_t Utf16Length(const char* data, size_t length);
+
+// Decodes `data`, which must be valid UTF-8 (see IsValid()), into `dst`,
+// which must have room for Utf16Length(data, length) code units. Returns the
+// number of code units written.
+size_t ToUtf16(const char* data, size_t length, uint16_t* dst);
+
+// Returns true if the valid UTF-8 `data` only contains code points up to
+// U+00FF, i.e. it can be represented as Latin-1.
+bool IsLatin1(const char* data, size_t length);
+
+// Decodes `data`, which must be valid UTF-8 for which IsLatin1() returns
+// true, into `dst`, which must have room for Utf16Length(data, length)
+// characters. Returns the number of characters written.
+size_t ToLatin1(const char* data, size_t length, char* dst);
+
+// Returns the number of bytes that the Latin-1 `data` encodes to in UTF-8.
+size_t LengthFromLatin1(const uint8_t* data, size_t length);
+
+// Encodes Latin-1 characters as UTF-8 until either `src` or `dst` runs out,
+// without splitting characters. Returns the number of bytes written and
+// stores the number of characters read in `*read`.
+size_t FromLatin1(const uint8_t* src,
+                  size_t length,
+                  char* dst,
+                  size_t dst_length,
+                  size_t* read);
+
+// Returns the number of bytes that the UTF-16 `data` encodes to in UTF-8,
+// counting unpaired surrogates as U+FFFD.
+size_t LengthFromUtf16(const uint16_t* data, size_t length);
+
+// Like FromLatin1(), for UTF-16 input. Unpaired surrogates are replaced with
+// U+FFFD, and surrogate pairs are never split, which matches what
+// v8::String::WriteUtf8() does with String::REPLACE_INVALID_UTF8.
+size_t FromUtf16(const uint16_t* src,
+                 size_t length,
+                 char* dst,
+                 size_t dst_length,
+                 size_t* read);
+
+}  // namespace utf8
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_UTF8_H_
@@ -24,6 +24,7 @@
 #include "node_buffer.h"
 
 #include "async_wrap-inl.h"
+#include "dictionary_trainer.h"
 #include "env-inl.h"
 #include "threadpoolwork-inl.h"
 #include "util-inl.h"
@@ -33,6 +34,8 @@
 #include "brotli/encode.h"
 #include "brotli/decode.h"
 #include "zlib.h"
+#define ZSTD_STATIC_LINKING_ONLY  // For ZSTD_customMem.
+#include "zstd.h"
 
 #include <sys/types.h>
 
@@ -40,9 +43,14 @@
 #include <cstdlib>
 #include <cstring>
 #include <atomic>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
 
 namespace node {
 
+using v8::Array;
 using v8::ArrayBuffer;
 using v8::Context;
 using v8::Function;
@@ -51,9 +59,12 @@ using v8::FunctionTemplate;
 using v8::Global;
 using v8::HandleScope;
 using v8::Int32;
+using v8::Int32Array;
 using v8::Integer;
+using v8::Isolate;
 using v8::Local;
 using v8::Object;
+using v8::Uint32;
 using v8::Uint32Array;
 using v8::Value;
 
@@ -100,7 +111,9 @@ enum node_zlib_mode {
   INFLATERAW,
   UNZIP,
   BROTLI_DECODE,
-  BROTLI_ENCODE
+  BROTLI_ENCODE,
+  ZSTD_COMPRESS,
+  ZSTD_DECOMPRESS
 };
 
 #define GZIP_HEADER_ID1 0x1f
@@ -123,6 +136,147 @@ struct CompressionError {
   inline bool IsError() const { return code != nullptr; }
 };
 
+// The state of a zlib stream. zlib keeps a pointer back to the z_stream in
+// its internal state, so this is allocated separately from the ZlibContext
+// and never moves, which also allows handing it from one ZlibContext to
+// another.
+struct ZlibStreamState {
+  ZlibStreamState() {
+    strm.zalloc = Alloc;
+    strm.zfree = Free;
+    strm.opaque = this;
+  }
+
+  // Releases the memory held by zlib.
+  int End(node_zlib_mode mode);
+
+  z_stream strm {};
+  // Whether deflateInit2() or inflateInit2() has succeeded on `strm`.
+  bool initialized = false;
+  // Size of the memory that zlib currently holds for `strm`.
+  std::atomic<size_t> memory {0};
+  // Allocations are added to this counter of the CompressionStream that uses
+  // the state, which reports them to V8 from the main thread later on. This
+  // is nullptr while the state is kept in a ZlibContextPool.
+  std::atomic<ssize_t>* unreported_allocations = nullptr;
+
+ private:
+  static void* Alloc(void* data, uInt items, uInt size);
+  static void Free(void* data, void* pointer);
+};
+
+// The parameters that a zlib stream is initialized with. States that agree
+// on all of them can be reused for each other after a reset.
+struct ZlibContextKey {
+  node_zlib_mode mode;
+  int level;
+  int window_bits;
+  int mem_level;
+  int strategy;
+
+  bool operator<(const ZlibContextKey& other) const {
+    return std::tie(mode, level, window_bits, mem_level, strategy) <
+           std::tie(other.mode, other.level, other.window_bits,
+                    other.mem_level, other.strategy);
+  }
+};
+
+// Keeps the states of closed zlib streams, so that streams which are created
+// later on with the same parameters do not have to allocate and initialize
+// their own. For small inputs, such as typical HTTP responses, that takes
+// longer than the actual compression. States are only kept up to a limit on
+// their total size, and are freed along with the Environment.
+class ZlibContextPool : public BaseObject {
+ public:
+  ZlibContextPool(Environment* env, Local<Object> wrap)
+      : BaseObject(env, wrap) {}
+  ~ZlibContextPool() override;
+
+  static constexpr FastStringKey type_name { "zlib" };
+
+  // Returns a state for `key` that can be used right away, or nullptr if
+  // there is none. Its memory is added to `unreported_allocations`.
+  std::unique_ptr<ZlibStreamState> Take(
+      const ZlibContextKey& key,
+      std::atomic<ssize_t>* unreported_allocations);
+
+  // Keeps `state`, which must have been reset, or frees it if the pool is
+  // full.
+  void Put(const ZlibContextKey& key, std::unique_ptr<ZlibStreamState> state);
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("idle_states", idle_memory_);
+  }
+
+  SET_MEMORY_INFO_NAME(ZlibContextPool)
+  SET_SELF_SIZE(ZlibContextPool)
+
+ private:
+  // A default deflate state takes about 256 KB, an inflate state about 40 KB.
+  static constexpr size_t kMaxIdleMemory = 16 * 1024 * 1024;
+  static constexpr size_t kMaxIdleStatesPerKey = 32;
+
+  std::map<ZlibContextKey, std::vector<std::unique_ptr<ZlibStreamState>>>
+      idle_states_;
+  size_t idle_memory_ = 0;
+};
+
+// TODO(addaleax): Remove once we're on C++17.
+constexpr FastStringKey ZlibContextPool::type_name;
+
+// Dictionaries are not modified once they have been passed to a stream, so
+// that any number of streams can share one.
+using ZlibDictionaryData = std::shared_ptr<const std::vector<unsigned char>>;
+
+// A dictionary that is loaded once and then used by many streams without
+// copying it, as opposed to the Buffers that are copied into each stream.
+class ZlibDictionary : public BaseObject {
+ public:
+  ZlibDictionary(Environment* env, Local<Object> wrap, ZlibDictionaryData data)
+      : BaseObject(env, wrap), data_(std::move(data)) {
+    MakeWeak();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    CHECK(Buffer::HasInstance(args[0]));
+    const unsigned char* data =
+        reinterpret_cast<const unsigned char*>(Buffer::Data(args[0]));
+    new ZlibDictionary(env, args.This(),
+                       std::make_shared<std::vector<unsigned char>>(
+                           data, data + Buffer::Length(args[0])));
+  }
+
+  // Returns the contents of a dictionary passed in from JS, which is either
+  // a Buffer, or a ZlibDictionary, or undefined.
+  static ZlibDictionaryData FromValue(Local<Value> value) {
+    if (Buffer::HasInstance(value)) {
+      const unsigned char* data =
+          reinterpret_cast<const unsigned char*>(Buffer::Data(value));
+      return std::make_shared<std::vector<unsigned char>>(
+          data, data + Buffer::Length(value));
+    }
+    if (!value->IsObject())
+      return nullptr;
+    ZlibDictionary* dictionary = Unwrap<ZlibDictionary>(value.As<Object>());
+    CHECK_NOT_NULL(dictionary);
+    return dictionary->data();
+  }
+
+  const ZlibDictionaryData& data() const { return data_; }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("data", *data_);
+  }
+
+  SET_MEMORY_INFO_NAME(ZlibDictionary)
+  SET_SELF_SIZE(ZlibDictionary)
+
+ private:
+  ZlibDictionaryData data_;
+};
+
 class ZlibContext : public MemoryRetainer {
  public:
   ZlibContext() = default;
@@ -139,15 +293,18 @@ class ZlibContext : public MemoryRetainer {
 
   // Zlib-specific:
   void Init(int level, int window_bits, int mem_level, int strategy,
-            std::vector<unsigned char>&& dictionary);
-  void SetAllocationFunctions(alloc_func alloc, free_func free, void* opaque);
+            ZlibDictionaryData dictionary);
+  void SetPool(ZlibContextPool* pool,
+               std::atomic<ssize_t>* unreported_allocations);
   CompressionError SetParams(int level, int strategy);
 
   SET_MEMORY_INFO_NAME(ZlibContext)
   SET_SELF_SIZE(ZlibContext)
 
   void MemoryInfo(MemoryTracker* tracker) const override {
-    tracker->TrackField("dictionary", dictionary_);
+    // Shared dictionaries are accounted for by their ZlibDictionary.
+    if (dictionary_ && dictionary_.use_count() == 1)
+      tracker->TrackField("dictionary", *dictionary_);
   }
 
   ZlibContext(const ZlibContext&) = delete;
@@ -168,9 +325,15 @@ class ZlibContext : public MemoryRetainer {
   int strategy_ = 0;
   int window_bits_ = 0;
   unsigned int gzip_id_bytes_read_ = 0;
-  std::vector<unsigned char> dictionary_;
-
-  z_stream strm_;
+  ZlibDictionaryData dictionary_;
+
+  BaseObjectPtr<ZlibContextPool> pool_;
+  std::atomic<ssize_t>* unreported_allocations_ = nullptr;
+  ZlibContextKey key_ {};
+  // States whose parameters were changed after initialization are not
+  // returned to the pool.
+  bool reusable_ = true;
+  std::unique_ptr<ZlibStreamState> state_;
 };
 
 // Brotli has different data types for compression and decompression streams,
@@ -244,6 +407,73 @@ class BrotliDecoderContext final : public BrotliContext {
   DeleteFnPtr<BrotliDecoderState, BrotliDecoderDestroyInstance> state_;
 };
 
+inline void FreeZstdCCtx(ZSTD_CCtx* cctx) { ZSTD_freeCCtx(cctx); }
+inline void FreeZstdDCtx(ZSTD_DCtx* dctx) { ZSTD_freeDCtx(dctx); }
+
+// Like Brotli, zstd has different data types for compression and
+// decompression streams.
+class ZstdContext : public MemoryRetainer {
+ public:
+  ZstdContext() = default;
+
+  void SetBuffers(char* in, uint32_t in_len, char* out, uint32_t out_len);
+  void SetFlush(int flush);
+  void GetAfterWriteOffsets(uint32_t* avail_in, uint32_t* avail_out) const;
+  inline void SetMode(node_zlib_mode mode) { mode_ = mode; }
+
+  ZstdContext(const ZstdContext&) = delete;
+  ZstdContext& operator=(const ZstdContext&) = delete;
+
+ protected:
+  node_zlib_mode mode_ = NONE;
+  ZSTD_inBuffer input_ = { nullptr, 0, 0 };
+  ZSTD_outBuffer output_ = { nullptr, 0, 0 };
+  ZSTD_EndDirective flush_ = ZSTD_e_continue;
+  // The return value of the last call into zstd, which is either an error
+  // code or a hint for how much more data zstd is waiting for.
+  size_t last_result_ = 0;
+};
+
+class ZstdCompressContext final : public ZstdContext {
+ public:
+  void Close();
+  void DoThreadPoolWork();
+  CompressionError Init(ZSTD_allocFunction alloc,
+                        ZSTD_freeFunction free,
+                        void* opaque);
+  CompressionError ResetStream();
+  CompressionError SetParams(int key, int value);
+  CompressionError GetErrorInfo() const;
+
+  SET_MEMORY_INFO_NAME(ZstdCompressContext)
+  SET_SELF_SIZE(ZstdCompressContext)
+  SET_NO_MEMORY_INFO()  // cctx_ is covered through allocation tracking.
+
+ private:
+  DeleteFnPtr<ZSTD_CCtx, FreeZstdCCtx> cctx_;
+};
+
+class ZstdDecompressContext final : public ZstdContext {
+ public:
+  void Close();
+  void DoThreadPoolWork();
+  CompressionError Init(ZSTD_allocFunction alloc,
+                        ZSTD_freeFunction free,
+                        void* opaque);
+  CompressionError ResetStream();
+  CompressionError SetParams(int key, int value);
+  CompressionError GetErrorInfo() const;
+
+  SET_MEMORY_INFO_NAME(ZstdDecompressContext)
+  SET_SELF_SIZE(ZstdDecompressContext)
+  SET_NO_MEMORY_INFO()  // dctx_ is covered through allocation tracking.
+
+ private:
+  // Whether the last frame was decompressed completely.
+  bool frame_done_ = false;
+  DeleteFnPtr<ZSTD_DCtx, FreeZstdDCtx> dctx_;
+};
+
 template <typename CompressionContext>
 class CompressionStream : public AsyncWrap, public ThreadPoolWork {
  public:
@@ -465,20 +695,18 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
     init_done_ = true;
   }
 
-  // Allocation functions provided to zlib itself. We store the real size of
-  // the allocated memory chunk just before the "payload" memory we return
-  // to zlib.
-  // Because we use zlib off the thread pool, we can not report memory directly
-  // to V8; rather, we first store it as "unreported" memory in a separate
-  // field and later report it back from the main thread.
-  static void* AllocForZlib(void* data, uInt items, uInt size) {
-    size_t real_size =
-        MultiplyWithOverflowCheck(static_cast<size_t>(items),
-                                  static_cast<size_t>(size));
-    return AllocForBrotli(data, real_size);
+  std::atomic<ssize_t>* unreported_allocations() {
+    return &unreported_allocations_;
   }
 
-  static void* AllocForBrotli(void* data, size_t size) {
+  // Allocation functions provided to Brotli and zstd. We store the real size
+  // of the allocated memory chunk just before the "payload" memory we return
+  // to them.
+  // Because we use them off the thread pool, we can not report memory
+  // directly to V8; rather, we first store it as "unreported" memory in a
+  // separate field and later report it back from the main thread.
+  // zlib streams use ZlibStreamState::Alloc() instead.
+  static void* AllocWithSize(void* data, size_t size) {
     size += sizeof(size_t);
     CompressionStream* ctx = static_cast<CompressionStream*>(data);
     char* memory = UncheckedMalloc(size);
@@ -489,7 +717,7 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
     return memory + sizeof(size_t);
   }
 
-  static void FreeForZlib(void* data, void* pointer) {
+  static void FreeWithSize(void* data, void* pointer) {
     if (UNLIKELY(pointer == nullptr)) return;
     CompressionStream* ctx = static_cast<CompressionStream*>(data);
     char* real_pointer = static_cast<char*>(pointer) - sizeof(size_t);
@@ -603,20 +831,14 @@ class ZlibStream : public CompressionStream<ZlibContext> {
     CHECK(args[5]->IsFunction());
     Local<Function> write_js_callback = args[5].As<Function>();
 
-    std::vector<unsigned char> dictionary;
-    if (Buffer::HasInstance(args[6])) {
-      unsigned char* data =
-          reinterpret_cast<unsigned char*>(Buffer::Data(args[6]));
-      dictionary = std::vector<unsigned char>(
-          data,
-          data + Buffer::Length(args[6]));
-    }
+    ZlibDictionaryData dictionary = ZlibDictionary::FromValue(args[6]);
 
     wrap->InitStream(write_result, write_js_callback);
 
     AllocScope alloc_scope(wrap);
-    wrap->context()->SetAllocationFunctions(
-        AllocForZlib, FreeForZlib, static_cast<CompressionStream*>(wrap));
+    wrap->context()->SetPool(
+        Environment::GetBindingData<ZlibContextPool>(args),
+        wrap->unreported_allocations());
     wrap->context()->Init(level, window_bits, mem_level, strategy,
                           std::move(dictionary));
   }
@@ -679,8 +901,8 @@ class BrotliCompressionStream : public CompressionStream<CompressionContext> {
     AllocScope alloc_scope(wrap);
     CompressionError err =
         wrap->context()->Init(
-          CompressionStream<CompressionContext>::AllocForBrotli,
-          CompressionStream<CompressionContext>::FreeForZlib,
+          CompressionStream<CompressionContext>::AllocWithSize,
+          CompressionStream<CompressionContext>::FreeWithSize,
           static_cast<CompressionStream<CompressionContext>*>(wrap));
     if (err.IsError()) {
       wrap->EmitError(err);
@@ -720,11 +942,564 @@ class BrotliCompressionStream : public CompressionStream<CompressionContext> {
 using BrotliEncoderStream = BrotliCompressionStream<BrotliEncoderContext>;
 using BrotliDecoderStream = BrotliCompressionStream<BrotliDecoderContext>;
 
+template <typename CompressionContext>
+class ZstdCompressionStream : public CompressionStream<CompressionContext> {
+ public:
+  ZstdCompressionStream(Environment* env,
+                        Local<Object> wrap,
+                        node_zlib_mode mode)
+    : CompressionStream<CompressionContext>(env, wrap) {
+    context()->SetMode(mode);
+  }
+
+  inline CompressionContext* context() {
+    return this->CompressionStream<CompressionContext>::context();
+  }
+  typedef typename CompressionStream<CompressionContext>::AllocScope AllocScope;
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args[0]->IsInt32());
+    node_zlib_mode mode =
+        static_cast<node_zlib_mode>(args[0].As<Int32>()->Value());
+    new ZstdCompressionStream(env, args.This(), mode);
+  }
+
+  static void Init(const FunctionCallbackInfo<Value>& args) {
+    ZstdCompressionStream* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+    CHECK(args.Length() == 3 && "init(params, writeResult, writeCallback)");
+
+    CHECK(args[1]->IsUint32Array());
+    uint32_t* write_result = reinterpret_cast<uint32_t*>(Buffer::Data(args[1]));
+
+    CHECK(args[2]->IsFunction());
+    Local<Function> write_js_callback = args[2].As<Function>();
+    wrap->InitStream(write_result, write_js_callback);
+
+    AllocScope alloc_scope(wrap);
+    CompressionError err =
+        wrap->context()->Init(
+          CompressionStream<CompressionContext>::AllocWithSize,
+          CompressionStream<CompressionContext>::FreeWithSize,
+          static_cast<CompressionStream<CompressionContext>*>(wrap));
+    if (err.IsError()) {
+      wrap->EmitError(err);
+      args.GetReturnValue().Set(false);
+      return;
+    }
+
+    // Unlike Brotli's, zstd's parameter keys are sparse and its values may be
+    // negative, so they are passed as a list of (key, value) pairs.
+    CHECK(args[0]->IsInt32Array());
+    const int32_t* data = reinterpret_cast<int32_t*>(Buffer::Data(args[0]));
+    size_t len = args[0].As<Int32Array>()->Length();
+    CHECK_EQ(len % 2, 0);
+
+    for (size_t i = 0; i < len; i += 2) {
+      err = wrap->context()->SetParams(data[i], data[i + 1]);
+      if (err.IsError()) {
+        wrap->EmitError(err);
+        args.GetReturnValue().Set(false);
+        return;
+      }
+    }
+
+    args.GetReturnValue().Set(true);
+  }
+
+  static void Params(const FunctionCallbackInfo<Value>& args) {
+    // Currently a no-op, and not accessed from JS land.
+  }
+
+  SET_MEMORY_INFO_NAME(ZstdCompressionStream)
+  SET_SELF_SIZE(ZstdCompressionStream)
+};
+
+using ZstdCompressStream = ZstdCompressionStream<ZstdCompressContext>;
+using ZstdDecompressStream = ZstdCompressionStream<ZstdDecompressContext>;
+
+// Compresses one block of a larger input on the thread pool, so that the
+// blocks of one input can be compressed concurrently. Every block but the
+// last one ends in a sync flush, and every block but the first one is raw
+// deflate data, so that their outputs concatenate into a single stream.
+// Blocks are primed with the end of the input that precedes them, which
+// keeps the loss in compression at the block boundaries small. The caller
+// combines the checksums computed for every block into the stream trailer.
+class DeflateBlockJob final : public AsyncWrap, public ThreadPoolWork {
+ public:
+  DeflateBlockJob(Environment* env, Local<Object> wrap)
+      : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
+        ThreadPoolWork(env) {
+    MakeWeak();
+  }
+
+  ~DeflateBlockJob() override {
+    free(output_);
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    new DeflateBlockJob(env, args.This());
+  }
+
+  // run(mode, first, last, level, windowBits, memLevel, strategy, input,
+  //     dictionary)
+  static void Run(const FunctionCallbackInfo<Value>& args) {
+    CHECK_EQ(args.Length(), 9);
+    DeflateBlockJob* job;
+    ASSIGN_OR_RETURN_UNWRAP(&job, args.Holder());
+    CHECK(!job->running_ && job->input_object_.IsEmpty());
+
+    CHECK(args[0]->IsInt32());
+    job->mode_ = static_cast<node_zlib_mode>(args[0].As<Int32>()->Value());
+    CHECK(job->mode_ == DEFLATE || job->mode_ == GZIP ||
+          job->mode_ == DEFLATERAW);
+    job->first_ = args[1]->IsTrue();
+    job->last_ = args[2]->IsTrue();
+    CHECK(args[3]->IsInt32());
+    job->level_ = args[3].As<Int32>()->Value();
+    CHECK(args[4]->IsInt32());
+    job->window_bits_ = args[4].As<Int32>()->Value();
+    CHECK(args[5]->IsInt32());
+    job->mem_level_ = args[5].As<Int32>()->Value();
+    CHECK(args[6]->IsInt32());
+    job->strategy_ = args[6].As<Int32>()->Value();
+
+    Isolate* isolate = args.GetIsolate();
+    CHECK(Buffer::HasInstance(args[7]));
+    job->input_object_.Reset(isolate, args[7].As<Object>());
+    job->input_ = reinterpret_cast<Bytef*>(Buffer::Data(args[7]));
+    job->input_length_ = Buffer::Length(args[7]);
+    CHECK_LE(job->input_length_, std::numeric_limits<uInt>::max());
+
+    if (Buffer::HasInstance(args[8])) {
+      job->dictionary_object_.Reset(isolate, args[8].As<Object>());
+      job->dictionary_ = reinterpret_cast<Bytef*>(Buffer::Data(args[8]));
+      job->dictionary_length_ = Buffer::Length(args[8]);
+      CHECK_LE(job->dictionary_length_, std::numeric_limits<uInt>::max());
+    } else if (args[8]->IsObject()) {
+      // Holding on to the ZlibDictionary keeps its data alive.
+      ZlibDictionary* dictionary = Unwrap<ZlibDictionary>(args[8].As<Object>());
+      CHECK_NOT_NULL(dictionary);
+      job->dictionary_object_.Reset(isolate, args[8].As<Object>());
+      job->dictionary_ = const_cast<Bytef*>(dictionary->data()->data());
+      job->dictionary_length_ = dictionary->data()->size();
+      CHECK_LE(job->dictionary_length_, std::numeric_limits<uInt>::max());
+    } else {
+      job->dictionary_ = nullptr;
+      job->dictionary_length_ = 0;
+    }
+
+    job->running_ = true;
+    job->ClearWeak();
+    job->ScheduleWork();
+  }
+
+  void DoThreadPoolWork() override {
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+
+    // Only the first block carries the zlib or gzip header. That lets zlib
+    // write it, and makes the output of a single block a complete stream.
+    int window_bits = window_bits_;
+    if (!first_ || mode_ == DEFLATERAW)
+      window_bits = -window_bits;
+    else if (mode_ == GZIP)
+      window_bits += 16;
+
+    err_ = deflateInit2(&strm, level_, Z_DEFLATED, window_bits, mem_level_,
+                        strategy_);
+    if (err_ != Z_OK) {
+      message_ = "Init error";
+      return;
+    }
+    auto cleanup = OnScopeLeave([&]() { deflateEnd(&strm); });
+
+    // Like ZlibStream, ignore dictionaries for gzip, where zlib rejects them.
+    if (dictionary_length_ > 0 && (!first_ || mode_ != GZIP)) {
+      err_ = deflateSetDictionary(&strm, dictionary_, dictionary_length_);
+      if (err_ != Z_OK) {
+        message_ = "Failed to set dictionary";
+        return;
+      }
+    }
+
+    const int flush = last_ ? Z_FINISH : Z_SYNC_FLUSH;
+    // deflateBound() covers Z_FINISH; leave room for a sync flush marker.
+    size_t capacity = deflateBound(&strm, input_length_) + 16;
+    // The output of a failed block is not handed to JS, so drop it here.
+    free(output_);
+    output_ = UncheckedMalloc(capacity);
+    output_length_ = 0;
+    strm.next_in = input_;
+    strm.avail_in = input_length_;
+    while (output_ != nullptr) {
+      strm.next_out = reinterpret_cast<Bytef*>(output_ + output_length_);
+      strm.avail_out = capacity - output_length_;
+      err_ = deflate(&strm, flush);
+      output_length_ = capacity - strm.avail_out;
+      if (err_ == Z_STREAM_ERROR) {
+        message_ = "Compression failed";
+        return;
+      }
+      if (flush == Z_FINISH ? err_ == Z_STREAM_END : strm.avail_out != 0)
+        break;
+      capacity *= 2;
+      char* output = UncheckedRealloc(output_, capacity);
+      if (output == nullptr)
+        free(output_);
+      output_ = output;
+    }
+    if (output_ == nullptr) {
+      err_ = Z_MEM_ERROR;
+      message_ = "Out of memory";
+      return;
+    }
+    err_ = Z_OK;
+    // Shrinking may fail too, in which case the larger block is kept.
+    char* output = UncheckedRealloc(output_, output_length_);
+    if (output != nullptr || output_length_ == 0)
+      output_ = output;
+
+    if (mode_ == GZIP)
+      checksum_ = crc32(0, input_, input_length_);
+    else if (mode_ == DEFLATE)
+      checksum_ = adler32(1, input_, input_length_);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    auto on_scope_leave = OnScopeLeave([&]() {
+      input_object_.Reset();
+      dictionary_object_.Reset();
+      running_ = false;
+      MakeWeak();
+    });
+
+    if (status == UV_ECANCELED)
+      return;
+    CHECK_EQ(status, 0);
+
+    Environment* env = AsyncWrap::env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    if (err_ != Z_OK) {
+      Local<Value> args[3] = {
+        OneByteString(env->isolate(), message_),
+        Integer::New(env->isolate(), err_),
+        OneByteString(env->isolate(), ZlibStrerror(err_))
+      };
+      MakeCallback(env->onerror_string(), arraysize(args), args);
+      return;
+    }
+
+    Local<Object> buffer;
+    if (!Buffer::New(env, output_, output_length_).ToLocal(&buffer))
+      return;
+    output_ = nullptr;
+    Local<Value> args[2] = {
+      buffer,
+      Integer::NewFromUnsigned(env->isolate(), checksum_)
+    };
+    MakeCallback(env->oncomplete_string(), arraysize(args), args);
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    // The output is only safe to look at while no compression is running.
+    if (!running_ && output_ != nullptr)
+      tracker->TrackFieldWithSize("output", output_length_);
+  }
+
+  SET_MEMORY_INFO_NAME(DeflateBlockJob)
+  SET_SELF_SIZE(DeflateBlockJob)
+
+ private:
+  node_zlib_mode mode_ = NONE;
+  bool first_ = false;
+  bool last_ = false;
+  bool running_ = false;
+  int level_ = 0;
+  int window_bits_ = 0;
+  int mem_level_ = 0;
+  int strategy_ = 0;
+  Global<Object> input_object_;
+  Bytef* input_ = nullptr;
+  size_t input_length_ = 0;
+  Global<Object> dictionary_object_;
+  Bytef* dictionary_ = nullptr;
+  size_t dictionary_length_ = 0;
+  char* output_ = nullptr;
+  size_t output_length_ = 0;
+  uLong checksum_ = 0;
+  int err_ = Z_OK;
+  const char* message_ = nullptr;
+};
+
+// crc32Combine(crc1, crc2, length2) and adler32Combine(adler1, adler2,
+// length2) return the checksum of two concatenated blocks of data.
+void Crc32Combine(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsUint32());
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsUint32());
+  const uLong crc = crc32_combine(args[0].As<Uint32>()->Value(),
+                                  args[1].As<Uint32>()->Value(),
+                                  args[2].As<Uint32>()->Value());
+  args.GetReturnValue().Set(static_cast<uint32_t>(crc));
+}
+
+void Adler32Combine(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsUint32());
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsUint32());
+  const uLong adler = adler32_combine(args[0].As<Uint32>()->Value(),
+                                      args[1].As<Uint32>()->Value(),
+                                      args[2].As<Uint32>()->Value());
+  args.GetReturnValue().Set(static_cast<uint32_t>(adler));
+}
+
+void* ZlibStreamState::Alloc(void* data, uInt items, uInt size) {
+  // We store the real size of the allocated memory chunk just before the
+  // "payload" memory we return to zlib.
+  ZlibStreamState* state = static_cast<ZlibStreamState*>(data);
+  size_t real_size =
+      MultiplyWithOverflowCheck(static_cast<size_t>(items),
+                                static_cast<size_t>(size)) + sizeof(size_t);
+  char* memory = UncheckedMalloc(real_size);
+  if (UNLIKELY(memory == nullptr)) return nullptr;
+  *reinterpret_cast<size_t*>(memory) = real_size;
+  state->memory.fetch_add(real_size, std::memory_order_relaxed);
+  if (state->unreported_allocations != nullptr) {
+    state->unreported_allocations->fetch_add(real_size,
+                                             std::memory_order_relaxed);
+  }
+  return memory + sizeof(size_t);
+}
+
+
+void ZlibStreamState::Free(void* data, void* pointer) {
+  if (UNLIKELY(pointer == nullptr)) return;
+  ZlibStreamState* state = static_cast<ZlibStreamState*>(data);
+  char* real_pointer = static_cast<char*>(pointer) - sizeof(size_t);
+  size_t real_size = *reinterpret_cast<size_t*>(real_pointer);
+  state->memory.fetch_sub(real_size, std::memory_order_relaxed);
+  if (state->unreported_allocations != nullptr) {
+    state->unreported_allocations->fetch_sub(real_size,
+                                             std::memory_order_relaxed);
+  }
+  free(real_pointer);
+}
+
+
+int ZlibStreamState::End(node_zlib_mode mode) {
+  CHECK(initialized);
+  CHECK_LE(mode, UNZIP);
+  initialized = false;
+  if (mode == DEFLATE || mode == GZIP || mode == DEFLATERAW)
+    return deflateEnd(&strm);
+  return inflateEnd(&strm);
+}
+
+
+ZlibContextPool::~ZlibContextPool() {
+  for (auto& entry : idle_states_) {
+    for (auto& state : entry.second)
+      state->End(entry.first.mode);
+  }
+  if (idle_memory_ > 0) {
+    env()->isolate()->AdjustAmountOfExternalAllocatedMemory(
+        -static_cast<int64_t>(idle_memory_));
+  }
+}
+
+
+std::unique_ptr<ZlibStreamState> ZlibContextPool::Take(
+    const ZlibContextKey& key,
+    std::atomic<ssize_t>* unreported_allocations) {
+  auto it = idle_states_.find(key);
+  if (it == idle_states_.end())
+    return nullptr;
+
+  std::unique_ptr<ZlibStreamState> state = std::move(it->second.back());
+  it->second.pop_back();
+  if (it->second.empty())
+    idle_states_.erase(it);
+
+  // The memory is reported to V8 by the stream from now on.
+  const size_t memory = state->memory.load(std::memory_order_relaxed);
+  CHECK_GE(idle_memory_, memory);
+  idle_memory_ -= memory;
+  env()->isolate()->AdjustAmountOfExternalAllocatedMemory(
+      -static_cast<int64_t>(memory));
+  unreported_allocations->fetch_add(memory, std::memory_order_relaxed);
+  state->unreported_allocations = unreported_allocations;
+  return state;
+}
+
+
+void ZlibContextPool::Put(const ZlibContextKey& key,
+                          std::unique_ptr<ZlibStreamState> state) {
+  const size_t memory = state->memory.load(std::memory_order_relaxed);
+  std::vector<std::unique_ptr<ZlibStreamState>>& states = idle_states_[key];
+  if (idle_memory_ + memory > kMaxIdleMemory ||
+      states.size() >= kMaxIdleStatesPerKey) {
+    if (states.empty())
+      idle_states_.erase(key);
+    const int status = state->End(key.mode);
+    CHECK(status == Z_OK || status == Z_DATA_ERROR);
+    return;
+  }
+
+  state->unreported_allocations->fetch_sub(memory, std::memory_order_relaxed);
+  state->unreported_allocations = nullptr;
+  idle_memory_ += memory;
+  env()->isolate()->AdjustAmountOfExternalAllocatedMemory(memory);
+  states.emplace_back(std::move(state));
+}
+
+
+// trainDictionary(samples, size)
+void TrainZlibDictionary(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsArray());
+  CHECK(args[1]->IsUint32());
+  Local<Array> array = args[0].As<Array>();
+
+  std::vector<DictionarySample> samples;
+  samples.reserve(array->Length());
+  for (uint32_t i = 0; i < array->Length(); i++) {
+    Local<Value> sample;
+    if (!array->Get(env->context(), i).ToLocal(&sample)) return;
+    CHECK(Buffer::HasInstance(sample));
+    samples.push_back({
+        reinterpret_cast<const unsigned char*>(Buffer::Data(sample)),
+        Buffer::Length(sample)});
+  }
+
+  const std::vector<unsigned char> dictionary =
+      TrainDictionary(samples, args[1].As<Uint32>()->Value());
+  Local<Object> buffer;
+  if (Buffer::Copy(env,
+                   reinterpret_cast<const char*>(dictionary.data()),
+                   dictionary.size()).ToLocal(&buffer)) {
+    args.GetReturnValue().Set(buffer);
+  }
+}
+
+// Trains a dictionary on the threadpool. Training on a realistic set of
+// samples takes long enough that it should not block the event loop.
+class TrainDictionaryJob final : public AsyncWrap, public ThreadPoolWork {
+ public:
+  TrainDictionaryJob(Environment* env, Local<Object> wrap)
+      : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
+        ThreadPoolWork(env) {
+    MakeWeak();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    new TrainDictionaryJob(env, args.This());
+  }
+
+  // run(samples, size)
+  static void Run(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    TrainDictionaryJob* job;
+    ASSIGN_OR_RETURN_UNWRAP(&job, args.Holder());
+    CHECK(!job->running_);
+    CHECK(args[0]->IsArray());
+    CHECK(args[1]->IsUint32());
+    Local<Array> array = args[0].As<Array>();
+
+    // The samples are copied, so that JS may modify them in the meantime.
+    std::vector<Local<Value>> samples;
+    samples.reserve(array->Length());
+    size_t total = 0;
+    for (uint32_t i = 0; i < array->Length(); i++) {
+      Local<Value> sample;
+      if (!array->Get(env->context(), i).ToLocal(&sample)) return;
+      CHECK(Buffer::HasInstance(sample));
+      samples.push_back(sample);
+      total += Buffer::Length(sample);
+    }
+    job->data_.resize(total);
+    job->lengths_.clear();
+    job->lengths_.reserve(samples.size());
+    size_t offset = 0;
+    for (Local<Value> sample : samples) {
+      size_t length = Buffer::Length(sample);
+      if (length > 0)
+        memcpy(job->data_.data() + offset, Buffer::Data(sample), length);
+      job->lengths_.push_back(length);
+      offset += length;
+    }
+    job->size_ = args[1].As<Uint32>()->Value();
+
+    job->running_ = true;
+    job->ClearWeak();
+    job->ScheduleWork();
+  }
+
+  void DoThreadPoolWork() override {
+    std::vector<DictionarySample> samples;
+    samples.reserve(lengths_.size());
+    const unsigned char* data = data_.data();
+    for (size_t length : lengths_) {
+      samples.push_back({ data, length });
+      data += length;
+    }
+    dictionary_ = TrainDictionary(samples, size_);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    auto on_scope_leave = OnScopeLeave([&]() {
+      data_ = {};
+      lengths_ = {};
+      dictionary_ = {};
+      running_ = false;
+      MakeWeak();
+    });
+
+    if (status == UV_ECANCELED)
+      return;
+    CHECK_EQ(status, 0);
+
+    Environment* env = AsyncWrap::env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    Local<Value> buffer;
+    if (!Buffer::Copy(env,
+                      reinterpret_cast<const char*>(dictionary_.data()),
+                      dictionary_.size()).ToLocal(&buffer)) {
+      return;
+    }
+    MakeCallback(env->oncomplete_string(), 1, &buffer);
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    // The buffers are only safe to look at while no training is running.
+    if (!running_)
+      tracker->TrackFieldWithSize("samples", data_.size());
+  }
+
+  SET_MEMORY_INFO_NAME(TrainDictionaryJob)
+  SET_SELF_SIZE(TrainDictionaryJob)
+
+ private:
+  bool running_ = false;
+  std::vector<unsigned char> data_;
+  std::vector<size_t> lengths_;
+  size_t size_ = 0;
+  std::vector<unsigned char> dictionary_;
+};
+
 void ZlibContext::Close() {
   {
     Mutex::ScopedLock lock(mutex_);
-    if (!zlib_init_done_) {
-      dictionary_.clear();
+    if (!state_ || !state_->initialized) {
+      state_.reset();
+      dictionary_.reset();
       mode_ = NONE;
       return;
     }
@@ -732,18 +1507,28 @@ void ZlibContext::Close() {
 
   CHECK_LE(mode_, UNZIP);
 
-  int status = Z_OK;
-  if (mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW) {
-    status = deflateEnd(&strm_);
-  } else if (mode_ == INFLATE || mode_ == GUNZIP || mode_ == INFLATERAW ||
-             mode_ == UNZIP) {
-    status = inflateEnd(&strm_);
+  // A state that can be reset is as good as a new one. Note that mode_ may
+  // have changed from UNZIP to INFLATE or GUNZIP, but key_ has not.
+  int status;
+  if (pool_ && reusable_) {
+    if (mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW)
+      status = deflateReset(&state_->strm);
+    else
+      status = inflateReset(&state_->strm);
+    if (status == Z_OK) {
+      pool_->Put(key_, std::move(state_));
+      mode_ = NONE;
+      dictionary_.reset();
+      return;
+    }
   }
 
+  status = state_->End(mode_);
   CHECK(status == Z_OK || status == Z_DATA_ERROR);
+  state_.reset();
   mode_ = NONE;
 
-  dictionary_.clear();
+  dictionary_.reset();
 }
 
 
@@ -762,11 +1547,11 @@ void ZlibContext::DoThreadPoolWork() {
     case DEFLATE:
     case GZIP:
     case DEFLATERAW:
-      err_ = deflate(&strm_, flush_);
+      err_ = deflate(&state_->strm, flush_);
       break;
     case UNZIP:
-      if (strm_.avail_in > 0) {
-        next_expected_header_byte = strm_.next_in;
+      if (state_->strm.avail_in > 0) {
+        next_expected_header_byte = state_->strm.next_in;
       }
 
       switch (gzip_id_bytes_read_) {
@@ -779,7 +1564,7 @@ void ZlibContext::DoThreadPoolWork() {
             gzip_id_bytes_read_ = 1;
             next_expected_header_byte++;
 
-            if (strm_.avail_in == 1) {
+            if (state_->strm.avail_in == 1) {
               // The only available byte was already read.
               break;
             }
@@ -812,20 +1597,20 @@ void ZlibContext::DoThreadPoolWork() {
     case INFLATE:
     case GUNZIP:
     case INFLATERAW:
-      err_ = inflate(&strm_, flush_);
+      err_ = inflate(&state_->strm, flush_);
 
       // If data was encoded with dictionary (INFLATERAW will have it set in
       // SetDictionary, don't repeat that here)
       if (mode_ != INFLATERAW &&
           err_ == Z_NEED_DICT &&
-          !dictionary_.empty()) {
+          dictionary_ && !dictionary_->empty()) {
         // Load it
-        err_ = inflateSetDictionary(&strm_,
-                                    dictionary_.data(),
-                                    dictionary_.size());
+        err_ = inflateSetDictionary(&state_->strm,
+                                    dictionary_->data(),
+                                    dictionary_->size());
         if (err_ == Z_OK) {
           // And try to decode again
-          err_ = inflate(&strm_, flush_);
+          err_ = inflate(&state_->strm, flush_);
         } else if (err_ == Z_DATA_ERROR) {
           // Both inflateSetDictionary() and inflate() return Z_DATA_ERROR.
           // Make it possible for After() to tell a bad dictionary from bad
@@ -834,17 +1619,17 @@ void ZlibContext::DoThreadPoolWork() {
         }
       }
 
-      while (strm_.avail_in > 0 &&
+      while (state_->strm.avail_in > 0 &&
              mode_ == GUNZIP &&
              err_ == Z_STREAM_END &&
-             strm_.next_in[0] != 0x00) {
+             state_->strm.next_in[0] != 0x00) {
         // Bytes remain in input buffer. Perhaps this is another compressed
         // member in the same archive, or just trailing garbage.
         // Trailing zero bytes are okay, though, since they are frequently
         // used for padding.
 
         ResetStream();
-        err_ = inflate(&strm_, flush_);
+        err_ = inflate(&state_->strm, flush_);
       }
       break;
     default:
@@ -855,10 +1640,10 @@ void ZlibContext::DoThreadPoolWork() {
 
 void ZlibContext::SetBuffers(char* in, uint32_t in_len,
                              char* out, uint32_t out_len) {
-  strm_.avail_in = in_len;
-  strm_.next_in = reinterpret_cast<Bytef*>(in);
-  strm_.avail_out = out_len;
-  strm_.next_out = reinterpret_cast<Bytef*>(out);
+  state_->strm.avail_in = in_len;
+  state_->strm.next_in = reinterpret_cast<Bytef*>(in);
+  state_->strm.avail_out = out_len;
+  state_->strm.next_out = reinterpret_cast<Bytef*>(out);
 }
 
 
@@ -869,14 +1654,14 @@ void ZlibContext::SetFlush(int flush) {
 
 void ZlibContext::GetAfterWriteOffsets(uint32_t* avail_in,
                                        uint32_t* avail_out) const {
-  *avail_in = strm_.avail_in;
-  *avail_out = strm_.avail_out;
+  *avail_in = state_->strm.avail_in;
+  *avail_out = state_->strm.avail_out;
 }
 
 
 CompressionError ZlibContext::ErrorForMessage(const char* message) const {
-  if (strm_.msg != nullptr)
-    message = strm_.msg;
+  if (state_->strm.msg != nullptr)
+    message = state_->strm.msg;
 
   return CompressionError { message, ZlibStrerror(err_), err_ };
 }
@@ -887,14 +1672,14 @@ CompressionError ZlibContext::GetErrorInfo() const {
   switch (err_) {
   case Z_OK:
   case Z_BUF_ERROR:
-    if (strm_.avail_out != 0 && flush_ == Z_FINISH) {
+    if (state_->strm.avail_out != 0 && flush_ == Z_FINISH) {
       return ErrorForMessage("unexpected end of file");
     }
   case Z_STREAM_END:
     // normal statuses, not fatal
     break;
   case Z_NEED_DICT:
-    if (dictionary_.empty())
+    if (!dictionary_ || dictionary_->empty())
       return ErrorForMessage("Missing dictionary");
     else
       return ErrorForMessage("Bad dictionary");
@@ -919,12 +1704,12 @@ CompressionError ZlibContext::ResetStream() {
     case DEFLATE:
     case DEFLATERAW:
     case GZIP:
-      err_ = deflateReset(&strm_);
+      err_ = deflateReset(&state_->strm);
       break;
     case INFLATE:
     case INFLATERAW:
     case GUNZIP:
-      err_ = inflateReset(&strm_);
+      err_ = inflateReset(&state_->strm);
       break;
     default:
       break;
@@ -937,18 +1722,16 @@ CompressionError ZlibContext::ResetStream() {
 }
 
 
-void ZlibContext::SetAllocationFunctions(alloc_func alloc,
-                                         free_func free,
-                                         void* opaque) {
-  strm_.zalloc = alloc;
-  strm_.zfree = free;
-  strm_.opaque = opaque;
+void ZlibContext::SetPool(ZlibContextPool* pool,
+                          std::atomic<ssize_t>* unreported_allocations) {
+  pool_.reset(pool);
+  unreported_allocations_ = unreported_allocations;
 }
 
 
 void ZlibContext::Init(
     int level, int window_bits, int mem_level, int strategy,
-    std::vector<unsigned char>&& dictionary) {
+    ZlibDictionaryData dictionary) {
   if (!((window_bits == 0) &&
         (mode_ == INFLATE ||
          mode_ == GUNZIP ||
@@ -991,6 +1774,14 @@ void ZlibContext::Init(
   }
 
   dictionary_ = std::move(dictionary);
+
+  key_ = ZlibContextKey { mode_, level_, window_bits_, mem_level_, strategy_ };
+  if (pool_)
+    state_ = pool_->Take(key_, unreported_allocations_);
+  if (!state_) {
+    state_ = std::make_unique<ZlibStreamState>();
+    state_->unreported_allocations = unreported_allocations_;
+  }
 }
 
 bool ZlibContext::InitZlib() {
@@ -999,31 +1790,36 @@ bool ZlibContext::InitZlib() {
     return false;
   }
 
-  switch (mode_) {
-    case DEFLATE:
-    case GZIP:
-    case DEFLATERAW:
-      err_ = deflateInit2(&strm_,
-                          level_,
-                          Z_DEFLATED,
-                          window_bits_,
-                          mem_level_,
-                          strategy_);
-      break;
-    case INFLATE:
-    case GUNZIP:
-    case INFLATERAW:
-    case UNZIP:
-      err_ = inflateInit2(&strm_, window_bits_);
-      break;
-    default:
-      UNREACHABLE();
-  }
+  // States from the pool have been initialized already.
+  if (!state_->initialized) {
+    switch (mode_) {
+      case DEFLATE:
+      case GZIP:
+      case DEFLATERAW:
+        err_ = deflateInit2(&state_->strm,
+                            level_,
+                            Z_DEFLATED,
+                            window_bits_,
+                            mem_level_,
+                            strategy_);
+        break;
+      case INFLATE:
+      case GUNZIP:
+      case INFLATERAW:
+      case UNZIP:
+        err_ = inflateInit2(&state_->strm, window_bits_);
+        break;
+      default:
+        UNREACHABLE();
+    }
 
-  if (err_ != Z_OK) {
-    dictionary_.clear();
-    mode_ = NONE;
-    return true;
+    if (err_ != Z_OK) {
+      dictionary_.reset();
+      mode_ = NONE;
+      return true;
+    }
+
+    state_->initialized = true;
   }
 
   SetDictionary();
@@ -1033,7 +1829,7 @@ bool ZlibContext::InitZlib() {
 
 
 CompressionError ZlibContext::SetDictionary() {
-  if (dictionary_.empty())
+  if (!dictionary_ || dictionary_->empty())
     return CompressionError {};
 
   err_ = Z_OK;
@@ -1041,16 +1837,16 @@ CompressionError ZlibContext::SetDictionary() {
   switch (mode_) {
     case DEFLATE:
     case DEFLATERAW:
-      err_ = deflateSetDictionary(&strm_,
-                                  dictionary_.data(),
-                                  dictionary_.size());
+      err_ = deflateSetDictionary(&state_->strm,
+                                  dictionary_->data(),
+                                  dictionary_->size());
       break;
     case INFLATERAW:
       // The other inflate cases will have the dictionary set when inflate()
       // returns Z_NEED_DICT in Process()
-      err_ = inflateSetDictionary(&strm_,
-                                  dictionary_.data(),
-                                  dictionary_.size());
+      err_ = inflateSetDictionary(&state_->strm,
+                                  dictionary_->data(),
+                                  dictionary_->size());
       break;
     default:
       break;
@@ -1075,7 +1871,8 @@ CompressionError ZlibContext::SetParams(int level, int strategy) {
   switch (mode_) {
     case DEFLATE:
     case DEFLATERAW:
-      err_ = deflateParams(&strm_, level, strategy);
+      err_ = deflateParams(&state_->strm, level, strategy);
+      reusable_ = false;
       break;
     default:
       break;
@@ -1244,6 +2041,180 @@ CompressionError BrotliDecoderContext::GetErrorInfo() const {
 }
 
 
+void ZstdContext::SetBuffers(char* in, uint32_t in_len,
+                             char* out, uint32_t out_len) {
+  input_ = { in, in_len, 0 };
+  output_ = { out, out_len, 0 };
+}
+
+
+void ZstdContext::SetFlush(int flush) {
+  flush_ = static_cast<ZSTD_EndDirective>(flush);
+}
+
+
+void ZstdContext::GetAfterWriteOffsets(uint32_t* avail_in,
+                                       uint32_t* avail_out) const {
+  *avail_in = input_.size - input_.pos;
+  *avail_out = output_.size - output_.pos;
+}
+
+
+void ZstdCompressContext::DoThreadPoolWork() {
+  CHECK_EQ(mode_, ZSTD_COMPRESS);
+  CHECK(cctx_);
+  // With worker threads, zstd may return before it has taken all of the
+  // input or finished the flush, while the workers are busy. The stream
+  // expects either the output buffer to be full or the call to be complete.
+  do {
+    last_result_ =
+        ZSTD_compressStream2(cctx_.get(), &output_, &input_, flush_);
+  } while (!ZSTD_isError(last_result_) &&
+           output_.pos < output_.size &&
+           (input_.pos < input_.size ||
+            (flush_ != ZSTD_e_continue && last_result_ != 0)));
+}
+
+
+void ZstdCompressContext::Close() {
+  cctx_.reset();
+  mode_ = NONE;
+}
+
+CompressionError ZstdCompressContext::Init(ZSTD_allocFunction alloc,
+                                           ZSTD_freeFunction free,
+                                           void* opaque) {
+  cctx_.reset(ZSTD_createCCtx_advanced({ alloc, free, opaque }));
+  if (!cctx_) {
+    return CompressionError("Could not initialize zstd instance",
+                            "ERR_ZLIB_INITIALIZATION_FAILED",
+                            -1);
+  } else {
+    return CompressionError {};
+  }
+}
+
+CompressionError ZstdCompressContext::ResetStream() {
+  // Unlike with Brotli, the parameters survive this.
+  last_result_ = ZSTD_CCtx_reset(cctx_.get(), ZSTD_reset_session_only);
+  return GetErrorInfo();
+}
+
+CompressionError ZstdCompressContext::SetParams(int key, int value) {
+  if (ZSTD_isError(ZSTD_CCtx_setParameter(cctx_.get(),
+                                          static_cast<ZSTD_cParameter>(key),
+                                          value))) {
+    return CompressionError("Setting parameter failed",
+                            "ERR_ZSTD_PARAM_SET_FAILED",
+                            -1);
+  } else {
+    return CompressionError {};
+  }
+}
+
+CompressionError ZstdCompressContext::GetErrorInfo() const {
+  if (ZSTD_isError(last_result_)) {
+    return CompressionError(ZSTD_getErrorName(last_result_),
+                            "ERR_ZSTD_COMPRESSION_FAILED",
+                            -static_cast<int>(ZSTD_getErrorCode(last_result_)));
+  } else {
+    return CompressionError {};
+  }
+}
+
+
+void ZstdDecompressContext::Close() {
+  dctx_.reset();
+  mode_ = NONE;
+}
+
+// Whether `data` is, or could be the beginning of, the magic number of a
+// regular or a skippable zstd frame.
+inline bool IsZstdFrameStart(const uint8_t* data, size_t length) {
+  bool regular = true;
+  bool skippable = true;
+  for (size_t i = 0; i < std::min<size_t>(length, 4); i++) {
+    const unsigned int shift = 8 * i;
+    regular = regular && data[i] == ((ZSTD_MAGICNUMBER >> shift) & 0xff);
+    skippable = skippable &&
+        (data[i] & ((ZSTD_MAGIC_SKIPPABLE_MASK >> shift) & 0xff)) ==
+            ((ZSTD_MAGIC_SKIPPABLE_START >> shift) & 0xff);
+  }
+  return regular || skippable;
+}
+
+void ZstdDecompressContext::DoThreadPoolWork() {
+  CHECK_EQ(mode_, ZSTD_DECOMPRESS);
+  CHECK(dctx_);
+  // zstd stops at the end of every frame. Carry on if another frame follows,
+  // so that concatenated frames decompress like a single one. Anything else
+  // is trailing data, which is left alone like zlib does.
+  for (;;) {
+    if (frame_done_ &&
+        (input_.pos == input_.size ||
+         !IsZstdFrameStart(static_cast<const uint8_t*>(input_.src) +
+                               input_.pos,
+                           input_.size - input_.pos))) {
+      return;
+    }
+    last_result_ = ZSTD_decompressStream(dctx_.get(), &output_, &input_);
+    if (ZSTD_isError(last_result_))
+      return;
+    frame_done_ = last_result_ == 0;
+    if (!frame_done_ || output_.pos == output_.size)
+      return;
+  }
+}
+
+CompressionError ZstdDecompressContext::Init(ZSTD_allocFunction alloc,
+                                             ZSTD_freeFunction free,
+                                             void* opaque) {
+  frame_done_ = false;
+  dctx_.reset(ZSTD_createDCtx_advanced({ alloc, free, opaque }));
+  if (!dctx_) {
+    return CompressionError("Could not initialize zstd instance",
+                            "ERR_ZLIB_INITIALIZATION_FAILED",
+                            -1);
+  } else {
+    return CompressionError {};
+  }
+}
+
+CompressionError ZstdDecompressContext::ResetStream() {
+  frame_done_ = false;
+  last_result_ = ZSTD_DCtx_reset(dctx_.get(), ZSTD_reset_session_only);
+  return GetErrorInfo();
+}
+
+CompressionError ZstdDecompressContext::SetParams(int key, int value) {
+  if (ZSTD_isError(ZSTD_DCtx_setParameter(dctx_.get(),
+                                          static_cast<ZSTD_dParameter>(key),
+                                          value))) {
+    return CompressionError("Setting parameter failed",
+                            "ERR_ZSTD_PARAM_SET_FAILED",
+                            -1);
+  } else {
+    return CompressionError {};
+  }
+}
+
+CompressionError ZstdDecompressContext::GetErrorInfo() const {
+  if (ZSTD_isError(last_result_)) {
+    return CompressionError(ZSTD_getErrorName(last_result_),
+                            "ERR_ZSTD_DECOMPRESSION_FAILED",
+                            -static_cast<int>(ZSTD_getErrorCode(last_result_)));
+  } else if (flush_ == ZSTD_e_end && !frame_done_ &&
+             input_.pos == input_.size && output_.pos < output_.size) {
+    // Match zlib's behaviour, as zstd doesn't have its own code for this.
+    return CompressionError("unexpected end of file",
+                            "Z_BUF_ERROR",
+                            Z_BUF_ERROR);
+  } else {
+    return CompressionError {};
+  }
+}
+
+
 template <typename Stream>
 struct MakeClass {
   static void Make(Environment* env, Local<Object> target, const char* name) {
@@ -1270,10 +2241,41 @@ void Initialize(Local<Object> target,
                 Local<Context> context,
                 void* priv) {
   Environment* env = Environment::GetCurrent(context);
+  if (env->AddBindingData<ZlibContextPool>(context, target) == nullptr)
+    return;
 
   MakeClass<ZlibStream>::Make(env, target, "Zlib");
   MakeClass<BrotliEncoderStream>::Make(env, target, "BrotliEncoder");
   MakeClass<BrotliDecoderStream>::Make(env, target, "BrotliDecoder");
+  MakeClass<ZstdCompressStream>::Make(env, target, "ZstdCompress");
+  MakeClass<ZstdDecompressStream>::Make(env, target, "ZstdDecompress");
+
+  Local<FunctionTemplate> deflate_block =
+      env->NewFunctionTemplate(DeflateBlockJob::New);
+  deflate_block->InstanceTemplate()->SetInternalFieldCount(
+      DeflateBlockJob::kInternalFieldCount);
+  deflate_block->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  env->SetProtoMethod(deflate_block, "run", DeflateBlockJob::Run);
+  env->SetConstructorFunction(target, "DeflateBlock", deflate_block);
+
+  Local<FunctionTemplate> dictionary =
+      env->NewFunctionTemplate(ZlibDictionary::New);
+  dictionary->InstanceTemplate()->SetInternalFieldCount(
+      ZlibDictionary::kInternalFieldCount);
+  env->SetConstructorFunction(target, "ZlibDictionary", dictionary);
+  env->SetMethodNoSideEffect(target, "trainDictionary", TrainZlibDictionary);
+
+  Local<FunctionTemplate> train_dictionary =
+      env->NewFunctionTemplate(TrainDictionaryJob::New);
+  train_dictionary->InstanceTemplate()->SetInternalFieldCount(
+      TrainDictionaryJob::kInternalFieldCount);
+  train_dictionary->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  env->SetProtoMethod(train_dictionary, "run", TrainDictionaryJob::Run);
+  env->SetConstructorFunction(
+      target, "TrainDictionaryJob", train_dictionary);
+
+  env->SetMethodNoSideEffect(target, "crc32Combine", Crc32Combine);
+  env->SetMethodNoSideEffect(target, "adler32Combine", Adler32Combine);
 
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "ZLIB_VERSION"),
@@ -1321,6 +2323,8 @@ void DefineZlibConstants(Local<Object> target) {
   NODE_DEFINE_CONSTANT(target, UNZIP);
   NODE_DEFINE_CONSTANT(target, BROTLI_DECODE);
   NODE_DEFINE_CONSTANT(target, BROTLI_ENCODE);
+  NODE_DEFINE_CONSTANT(target, ZSTD_COMPRESS);
+  NODE_DEFINE_CONSTANT(target, ZSTD_DECOMPRESS);
 
   NODE_DEFINE_CONSTANT(target, Z_MIN_WINDOWBITS);
   NODE_DEFINE_CONSTANT(target, Z_MAX_WINDOWBITS);
@@ -1400,6 +2404,46 @@ void DefineZlibConstants(Local<Object> target) {
   NODE_DEFINE_CONSTANT(target, BROTLI_DECODER_ERROR_ALLOC_RING_BUFFER_2);
   NODE_DEFINE_CONSTANT(target, BROTLI_DECODER_ERROR_ALLOC_BLOCK_TYPE_TREES);
   NODE_DEFINE_CONSTANT(target, BROTLI_DECODER_ERROR_UNREACHABLE);
+
+  // zstd constants
+  NODE_DEFINE_CONSTANT(target, ZSTD_e_continue);
+  NODE_DEFINE_CONSTANT(target, ZSTD_e_flush);
+  NODE_DEFINE_CONSTANT(target, ZSTD_e_end);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_compressionLevel);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_windowLog);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_hashLog);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_chainLog);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_searchLog);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_minMatch);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_targetLength);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_strategy);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_enableLongDistanceMatching);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_ldmHashLog);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_ldmMinMatch);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_ldmBucketSizeLog);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_ldmHashRateLog);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_contentSizeFlag);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_checksumFlag);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_dictIDFlag);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_nbWorkers);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_jobSize);
+  NODE_DEFINE_CONSTANT(target, ZSTD_c_overlapLog);
+  NODE_DEFINE_CONSTANT(target, ZSTD_d_windowLogMax);
+  NODE_DEFINE_CONSTANT(target, ZSTD_fast);
+  NODE_DEFINE_CONSTANT(target, ZSTD_dfast);
+  NODE_DEFINE_CONSTANT(target, ZSTD_greedy);
+  NODE_DEFINE_CONSTANT(target, ZSTD_lazy);
+  NODE_DEFINE_CONSTANT(target, ZSTD_lazy2);
+  NODE_DEFINE_CONSTANT(target, ZSTD_btlazy2);
+  NODE_DEFINE_CONSTANT(target, ZSTD_btopt);
+  NODE_DEFINE_CONSTANT(target, ZSTD_btultra);
+  NODE_DEFINE_CONSTANT(target, ZSTD_btultra2);
+  NODE_DEFINE_CONSTANT(target, ZSTD_CLEVEL_DEFAULT);
+  NODE_DEFINE_CONSTANT(target, ZSTD_WINDOWLOG_LIMIT_DEFAULT);
+  const int ZSTD_MIN_LEVEL = ZSTD_minCLevel();
+  const int ZSTD_MAX_LEVEL = ZSTD_maxCLevel();
+  NODE_DEFINE_CONSTANT(target, ZSTD_MIN_LEVEL);
+  NODE_DEFINE_CONSTANT(target, ZSTD_MAX_LEVEL);
 }
 
 }  // namespace node
@@ -25,6 +25,7 @@
 #include "connection_wrap.h"
 #include "env-inl.h"
 #include "handle_wrap.h"
+#include "memory_tracker-inl.h"
 #include "node.h"
 #include "node_buffer.h"
 #include "connect_wrap.h"
@@ -150,6 +151,11 @@ PipeWrap::PipeWrap(Environment* env,
 }
 
 
+void PipeWrap::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackField("read_slab_allocator", read_slab_allocator_);
+}
+
+
 void PipeWrap::Bind(const FunctionCallbackInfo<Value>& args) {
   PipeWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
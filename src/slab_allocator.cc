@@ -0,0 +1,144 @@
+#include "slab_allocator.h"
+#include "allocated_buffer-inl.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "util-inl.h"
+
+#include <algorithm>
+
+namespace node {
+
+using v8::ArrayBuffer;
+using v8::BackingStore;
+using v8::Local;
+using v8::True;
+
+namespace {
+
+// Keep reservations aligned so that JS code may create any kind of typed
+// array on top of a received Buffer, like for the Buffer.allocUnsafe() pool.
+constexpr size_t kAlignment = 8;
+
+}  // anonymous namespace
+
+SlabAllocator::SlabAllocator(Environment* env, size_t slab_size)
+    : env_(env), slab_size_(slab_size) {}
+
+SlabAllocator::~SlabAllocator() = default;
+
+uv_buf_t SlabAllocator::Allocate(size_t size) {
+  if (!current_ || current_->size() - current_->used < size) {
+    if (current_ && current_->reservations > 0)
+      retired_.emplace_back(std::move(current_));
+
+    NoArrayBufferZeroFillScope no_zero_fill_scope(env_->isolate_data());
+    std::unique_ptr<BackingStore> store =
+        ArrayBuffer::NewBackingStore(env_->isolate(),
+                                     std::max(size, slab_size_));
+    current_ = std::make_unique<Slab>();
+    current_->store = std::move(store);
+  }
+
+  char* base = current_->data() + current_->used;
+  current_->used = std::min(current_->used + RoundUp(size, kAlignment),
+                            current_->size());
+  current_->reservations++;
+  return uv_buf_init(base, static_cast<unsigned int>(size));
+}
+
+Local<ArrayBuffer> SlabAllocator::Commit(const uv_buf_t& buf,
+                                         size_t nread,
+                                         size_t* offset) {
+  Slab* slab = Find(buf.base);
+  CHECK_NOT_NULL(slab);
+  CHECK_LE(nread, buf.len);
+
+  if (nread <= kMaxCopySize) {
+    std::unique_ptr<BackingStore> store;
+    {
+      NoArrayBufferZeroFillScope no_zero_fill_scope(env_->isolate_data());
+      store = ArrayBuffer::NewBackingStore(env_->isolate(), nread);
+    }
+    if (nread > 0)
+      memcpy(store->Data(), buf.base, nread);
+    *offset = 0;
+    EndReservation(slab, buf, 0);
+    return ArrayBuffer::New(env_->isolate(), std::move(store));
+  }
+
+  Local<ArrayBuffer> ab;
+  if (slab->array_buffer.IsEmpty()) {
+    ab = ArrayBuffer::New(env_->isolate(), slab->store);
+    // The slab is shared by many reads, and later ones still write into it,
+    // so it must not be detached by transferring it to another thread.
+    ab->SetPrivate(
+        env_->context(),
+        env_->untransferable_object_private_symbol(),
+        True(env_->isolate())).Check();
+    slab->array_buffer.Reset(env_->isolate(), ab);
+  } else {
+    ab = PersistentToLocal::Strong(slab->array_buffer);
+  }
+  *offset = buf.base - slab->data();
+
+  EndReservation(slab, buf, nread);
+  return ab;
+}
+
+void SlabAllocator::Release(const uv_buf_t& buf) {
+  Slab* slab = Find(buf.base);
+  CHECK_NOT_NULL(slab);
+  EndReservation(slab, buf, 0);
+}
+
+void SlabAllocator::Reclaim() {
+  if (current_ && current_->reservations > 0)
+    retired_.emplace_back(std::move(current_));
+  current_.reset();
+}
+
+SlabAllocator::Slab* SlabAllocator::Find(const char* ptr) const {
+  if (current_ && current_->Contains(ptr))
+    return current_.get();
+  for (const std::unique_ptr<Slab>& slab : retired_) {
+    if (slab->Contains(ptr))
+      return slab.get();
+  }
+  return nullptr;
+}
+
+void SlabAllocator::EndReservation(Slab* slab,
+                                   const uv_buf_t& buf,
+                                   size_t nread) {
+  CHECK_GT(slab->reservations, 0);
+  slab->reservations--;
+
+  if (slab == current_.get()) {
+    // If this is the most recent reservation, the part of it that was not
+    // filled can be handed out again.
+    size_t start = buf.base - slab->data();
+    size_t end = std::min(start + RoundUp<size_t>(buf.len, kAlignment),
+                          slab->size());
+    if (end == slab->used)
+      slab->used = std::min(start + RoundUp(nread, kAlignment), slab->size());
+    return;
+  }
+
+  if (slab->reservations == 0) {
+    auto it = std::find_if(retired_.begin(), retired_.end(),
+                           [&](const std::unique_ptr<Slab>& entry) {
+                             return entry.get() == slab;
+                           });
+    CHECK_NE(it, retired_.end());
+    retired_.erase(it);
+  }
+}
+
+void SlabAllocator::MemoryInfo(MemoryTracker* tracker) const {
+  size_t size = current_ ? current_->size() : 0;
+  for (const std::unique_ptr<Slab>& slab : retired_)
+    size += slab->size();
+  tracker->TrackFieldWithSize("slabs", size);
+}
+
+}  // namespace node
@@ -0,0 +1,97 @@
+#ifndef SRC_SLAB_ALLOCATOR_H_
+#define SRC_SLAB_ALLOCATOR_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "memory_tracker.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <memory>
+#include <vector>
+
+namespace node {
+
+class Environment;
+
+// Hands out memory for incoming network data as slices of large
+// ArrayBuffers, rather than allocating (and then shrinking) a separate
+// ArrayBuffer for every single read.
+//
+// Each handle that reads data owns its own SlabAllocator, so that a Buffer
+// that JS receives can only ever share memory with data from the same
+// connection.
+//
+// A read first reserves as much memory as it might need through Allocate().
+// Once the amount of data is known, Commit() makes it available to JS. Small
+// reads are copied into an ArrayBuffer of their own and give the whole
+// reservation back, so that a Buffer that is kept around does not keep the
+// slab alive. Larger reads become a range of the slab's ArrayBuffer and give
+// the unused part of the reservation back, so that slabs are densely filled
+// with actual data. A slab that is full is replaced by a new one; its memory
+// is freed once JS no longer references any Buffer that was created from it.
+class SlabAllocator : public MemoryRetainer {
+ public:
+  static constexpr size_t kDefaultSlabSize = 256 * 1024;
+  // Reads of up to this many bytes are copied out of the slab.
+  static constexpr size_t kMaxCopySize = 4096;
+
+  explicit SlabAllocator(Environment* env,
+                         size_t slab_size = kDefaultSlabSize);
+  ~SlabAllocator() override;
+
+  // Reserves `size` bytes for a single read.
+  uv_buf_t Allocate(size_t size);
+
+  // Ends the reservation `buf`. The first `nread` bytes of it are the
+  // contents of the returned ArrayBuffer starting at `*offset`.
+  v8::Local<v8::ArrayBuffer> Commit(const uv_buf_t& buf,
+                                    size_t nread,
+                                    size_t* offset);
+
+  // Ends the reservation `buf` without using any of it.
+  void Release(const uv_buf_t& buf);
+
+  // Gives up the current slab, e.g. because the handle stopped reading.
+  // Its memory is freed once no reservation is pending on it and JS no
+  // longer references any Buffer that was created from it.
+  void Reclaim();
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(SlabAllocator)
+  SET_SELF_SIZE(SlabAllocator)
+
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+ private:
+  struct Slab {
+    std::shared_ptr<v8::BackingStore> store;
+    v8::Global<v8::ArrayBuffer> array_buffer;
+    size_t used = 0;
+    size_t reservations = 0;
+
+    char* data() const { return static_cast<char*>(store->Data()); }
+    size_t size() const { return store->ByteLength(); }
+    bool Contains(const char* ptr) const {
+      return ptr >= data() && ptr < data() + size();
+    }
+  };
+
+  Slab* Find(const char* ptr) const;
+  void EndReservation(Slab* slab, const uv_buf_t& buf, size_t nread);
+
+  Environment* env_;
+  size_t slab_size_;
+  // The slab that new reservations are taken from.
+  std::unique_ptr<Slab> current_;
+  // Earlier slabs that still have reservations pending. This is almost
+  // always empty, because reads are usually committed right away.
+  std::vector<std::unique_ptr<Slab>> retired_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_SLAB_ALLOCATOR_H_
@@ -8,6 +8,7 @@
 #include "node_errors.h"
 #include "env-inl.h"
 #include "js_stream.h"
+#include "slab_allocator.h"
 #include "string_bytes.h"
 #include "util-inl.h"
 #include "v8.h"
@@ -54,7 +55,17 @@ int StreamBase::ReadStartJS(const FunctionCallbackInfo<Value>& args) {
 
 
 int StreamBase::ReadStopJS(const FunctionCallbackInfo<Value>& args) {
-  return ReadStop();
+  int err = ReadStop();
+  // A paused stream should not hold on to memory for data it does not read.
+  if (read_slab_allocator_)
+    read_slab_allocator_->Reclaim();
+  return err;
+}
+
+SlabAllocator* StreamBase::read_slab_allocator() {
+  if (!read_slab_allocator_)
+    read_slab_allocator_ = std::make_unique<SlabAllocator>(env_);
+  return read_slab_allocator_.get();
 }
 
 int StreamBase::UseUserBuffer(const FunctionCallbackInfo<Value>& args) {
@@ -486,28 +497,32 @@ void StreamResource::ClearError() {
 
 uv_buf_t EmitToJSStreamListener::OnStreamAlloc(size_t suggested_size) {
   CHECK_NOT_NULL(stream_);
-  Environment* env = static_cast<StreamBase*>(stream_)->stream_env();
-  return AllocatedBuffer::AllocateManaged(env, suggested_size).release();
+  StreamBase* stream = static_cast<StreamBase*>(stream_);
+  return stream->read_slab_allocator()->Allocate(suggested_size);
 }
 
-void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
+void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf) {
   CHECK_NOT_NULL(stream_);
   StreamBase* stream = static_cast<StreamBase*>(stream_);
   Environment* env = stream->stream_env();
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
-  AllocatedBuffer buf(env, buf_);
+  SlabAllocator* allocator = stream->read_slab_allocator();
 
   if (nread <= 0)  {
-    if (nread < 0)
+    if (buf.base != nullptr)
+      allocator->Release(buf);
+    if (nread < 0) {
+      // No more data is going to arrive after EOF or an error.
+      allocator->Reclaim();
       stream->CallJSOnreadMethod(nread, Local<ArrayBuffer>());
+    }
     return;
   }
 
-  CHECK_LE(static_cast<size_t>(nread), buf.size());
-  buf.Resize(nread);
-
-  stream->CallJSOnreadMethod(nread, buf.ToArrayBuffer());
+  size_t offset;
+  Local<ArrayBuffer> ab = allocator->Commit(buf, nread, &offset);
+  stream->CallJSOnreadMethod(nread, ab, offset);
 }
 
 
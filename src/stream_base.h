@@ -7,6 +7,7 @@
 #include "allocated_buffer.h"
 #include "async_wrap.h"
 #include "node.h"
+#include "slab_allocator.h"
 #include "util.h"
 
 #include "v8.h"
@@ -326,6 +327,10 @@ class StreamBase : public StreamResource {
   // subclasses are also `BaseObject`s.
   Environment* stream_env() const { return env_; }
 
+  // The memory that data for JS is read into. It belongs to this stream
+  // alone, and is created when it is first needed.
+  SlabAllocator* read_slab_allocator();
+
   // Shut down the current stream. This request can use an existing
   // ShutdownWrap object (that was created in JS), or a new one will be created.
   // Returns 1 in case of a synchronous completion, 0 in case of asynchronous
@@ -390,6 +395,8 @@ class StreamBase : public StreamResource {
     kNumStreamBaseStateFields
   };
 
+  std::unique_ptr<SlabAllocator> read_slab_allocator_;
+
  private:
   Environment* env_;
   EmitToJSStreamListener default_listener_;
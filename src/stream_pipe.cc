@@ -1,9 +1,17 @@
 #include "stream_pipe.h"
 #include "allocated_buffer-inl.h"
 #include "stream_base-inl.h"
+#include "stream_wrap.h"
 #include "node_buffer.h"
+#include "node_file.h"
+#include "threadpoolwork-inl.h"
 #include "util-inl.h"
 
+#ifdef __linux__
+#include <sys/sendfile.h>
+#include <unistd.h>
+#endif
+
 namespace node {
 
 using v8::Context;
@@ -18,7 +26,8 @@ using v8::Value;
 StreamPipe::StreamPipe(StreamBase* source,
                        StreamBase* sink,
                        Local<Object> obj)
-    : AsyncWrap(source->stream_env(), obj, AsyncWrap::PROVIDER_STREAMPIPE) {
+    : AsyncWrap(source->stream_env(), obj, AsyncWrap::PROVIDER_STREAMPIPE),
+      sendfile_work_(source->stream_env()) {
   MakeWeak();
 
   CHECK_NOT_NULL(sink);
@@ -45,6 +54,7 @@ StreamPipe::StreamPipe(StreamBase* source,
 
 StreamPipe::~StreamPipe() {
   Unpipe(true);
+  CloseSendFileFds();
 }
 
 StreamBase* StreamPipe::source() {
@@ -70,6 +80,8 @@ void StreamPipe::Unpipe(bool is_in_deletion) {
   source()->RemoveStreamListener(&readable_listener_);
   if (pending_writes_ == 0)
     sink()->RemoveStreamListener(&writable_listener_);
+  if (!sendfile_ref_)
+    CloseSendFileFds();
 
   if (is_in_deletion) return;
 
@@ -138,7 +150,8 @@ void StreamPipe::ReadableListener::OnStreamRead(ssize_t nread,
     // If we’re not writing, close now. Otherwise, we’ll do that in
     // `OnStreamAfterWrite()`.
     if (pipe->pending_writes_ == 0) {
-      sink->Shutdown();
+      if (pipe->shutdown_on_eof_)
+        sink->Shutdown();
       pipe->Unpipe();
     }
     return;
@@ -149,9 +162,17 @@ void StreamPipe::ReadableListener::OnStreamRead(ssize_t nread,
 
 void StreamPipe::ProcessData(size_t nread, AllocatedBuffer&& buf) {
   CHECK(uses_wants_write_ || pending_writes_ == 0);
+  if (use_sendfile_) {
+    // Only copy a single chunk, then go back to sendfile() once it has been
+    // written.
+    copy_next_chunk_ = false;
+    is_reading_ = false;
+    source()->ReadStop();
+  }
   uv_buf_t buffer = uv_buf_init(buf.data(), nread);
   StreamWriteResult res = sink()->Write(&buffer, 1);
   pending_writes_++;
+  bytes_piped_ += nread;
   if (!res.async) {
     writable_listener_.OnStreamAfterWrite(nullptr, res.err);
   } else {
@@ -162,6 +183,133 @@ void StreamPipe::ProcessData(size_t nread, AllocatedBuffer&& buf) {
   }
 }
 
+void StreamPipe::MaybeUseSendFile() {
+#ifdef __linux__
+  if (use_sendfile_)
+    return;
+  if (source()->GetAsyncWrap()->provider_type() !=
+          AsyncWrap::PROVIDER_FILEHANDLE) {
+    return;
+  }
+  AsyncWrap::ProviderType sink_type = sink()->GetAsyncWrap()->provider_type();
+  if (sink_type != AsyncWrap::PROVIDER_TCPWRAP &&
+      sink_type != AsyncWrap::PROVIDER_PIPEWRAP) {
+    return;
+  }
+
+  int in_fd = source()->GetFD();
+  int out_fd = sink()->GetFD();
+  if (in_fd < 0 || out_fd < 0)
+    return;
+
+  // The threadpool works on duplicates of the file descriptors, so that it
+  // never writes to a descriptor that has been closed (and possibly reused)
+  // while a sendfile() call was pending.
+  sendfile_work_.in_fd = dup(in_fd);
+  sendfile_work_.out_fd = dup(out_fd);
+  if (sendfile_work_.in_fd < 0 || sendfile_work_.out_fd < 0) {
+    CloseSendFileFds();
+    return;
+  }
+  use_sendfile_ = true;
+#endif
+}
+
+bool StreamPipe::TrySendFile() {
+  if (!use_sendfile_ || copy_next_chunk_)
+    return false;
+
+  // Data that has been written to the sink by other means needs to go out
+  // first, and only libuv knows when that has happened.
+  uv_stream_t* stream = static_cast<LibuvStreamWrap*>(sink())->stream();
+  if (uv_stream_get_write_queue_size(stream) > 0)
+    return false;
+
+  fs::FileHandle* file = static_cast<fs::FileHandle*>(source());
+  int64_t length = file->read_length();
+  if (length == 0) {
+    readable_listener_.OnStreamRead(UV_EOF, uv_buf_init(nullptr, 0));
+    return true;
+  }
+
+  sendfile_work_.offset = file->read_offset();
+  sendfile_work_.length = kSendFileChunkSize;
+  if (length > 0 && static_cast<uint64_t>(length) < kSendFileChunkSize)
+    sendfile_work_.length = static_cast<size_t>(length);
+  pending_writes_++;
+  sendfile_ref_.reset(this);
+  sendfile_work_.ScheduleWork();
+  return true;
+}
+
+void StreamPipe::OnSendFileDone(ssize_t result) {
+  BaseObjectPtr<StreamPipe> strong_ref = std::move(sendfile_ref_);
+  HandleScope handle_scope(env()->isolate());
+  InternalCallbackScope callback_scope(this);
+
+  if (is_closed_) {
+    CloseSendFileFds();
+    if (!sink_destroyed_)
+      writable_listener_.OnStreamAfterWrite(nullptr, 0);
+    return;
+  }
+
+  if (!is_eof_) {
+    if (result == 0) {
+      // The file ended before the expected length was reached.
+      pending_writes_--;
+      readable_listener_.OnStreamRead(UV_EOF, uv_buf_init(nullptr, 0));
+      return;
+    }
+
+    if (result > 0) {
+      static_cast<fs::FileHandle*>(source())->AdvanceRead(result);
+      bytes_piped_ += result;
+    } else if (result == UV_EAGAIN) {
+      // The socket buffer is full. Let libuv queue a regular write, which
+      // will wait for the socket to become writable again.
+      copy_next_chunk_ = true;
+    } else {
+      // Not supported for this combination of file and socket, or the
+      // socket is broken. The regular path either works or reports the
+      // error properly.
+      use_sendfile_ = false;
+      CloseSendFileFds();
+    }
+  }
+
+  writable_listener_.OnStreamAfterWrite(nullptr, 0);
+}
+
+void StreamPipe::CloseSendFileFds() {
+#ifdef __linux__
+  if (sendfile_work_.in_fd >= 0)
+    close(sendfile_work_.in_fd);
+  if (sendfile_work_.out_fd >= 0)
+    close(sendfile_work_.out_fd);
+#endif
+  sendfile_work_.in_fd = -1;
+  sendfile_work_.out_fd = -1;
+}
+
+void StreamPipe::SendFileWork::DoThreadPoolWork() {
+#ifdef __linux__
+  off_t off = offset;
+  ssize_t r;
+  do {
+    r = sendfile(out_fd, in_fd, offset >= 0 ? &off : nullptr, length);
+  } while (r == -1 && errno == EINTR);
+  result = r >= 0 ? r : uv_translate_sys_error(errno);
+#else
+  result = UV_ENOSYS;
+#endif
+}
+
+void StreamPipe::SendFileWork::AfterThreadPoolWork(int status) {
+  StreamPipe* pipe = ContainerOf(&StreamPipe::sendfile_work_, this);
+  pipe->OnSendFileDone(status == 0 ? result : status);
+}
+
 void StreamPipe::WritableListener::OnStreamAfterWrite(WriteWrap* w,
                                                       int status) {
   StreamPipe* pipe = ContainerOf(&StreamPipe::writable_listener_, this);
@@ -181,7 +329,8 @@ void StreamPipe::WritableListener::OnStreamAfterWrite(WriteWrap* w,
     HandleScope handle_scope(pipe->env()->isolate());
     InternalCallbackScope callback_scope(pipe,
         InternalCallbackScope::kSkipTaskQueues);
-    pipe->sink()->Shutdown();
+    if (pipe->shutdown_on_eof_)
+      pipe->sink()->Shutdown();
     pipe->Unpipe();
     return;
   }
@@ -227,11 +376,13 @@ void StreamPipe::WritableListener::OnStreamDestroy() {
 void StreamPipe::WritableListener::OnStreamWantsWrite(size_t suggested_size) {
   StreamPipe* pipe = ContainerOf(&StreamPipe::writable_listener_, this);
   pipe->wanted_data_ = suggested_size;
-  if (pipe->is_reading_ || pipe->is_closed_)
+  if (pipe->is_reading_ || pipe->is_closed_ || pipe->sendfile_ref_)
     return;
   HandleScope handle_scope(pipe->env()->isolate());
   InternalCallbackScope callback_scope(pipe,
       InternalCallbackScope::kSkipTaskQueues);
+  if (pipe->TrySendFile())
+    return;
   pipe->is_reading_ = true;
   pipe->source()->ReadStart();
 }
@@ -257,10 +408,13 @@ void StreamPipe::New(const FunctionCallbackInfo<Value>& args) {
   new StreamPipe(source, sink, args.This());
 }
 
+// start([shutdownOnEnd]): `shutdownOnEnd` defaults to true.
 void StreamPipe::Start(const FunctionCallbackInfo<Value>& args) {
   StreamPipe* pipe;
   ASSIGN_OR_RETURN_UNWRAP(&pipe, args.Holder());
   pipe->is_closed_ = false;
+  pipe->shutdown_on_eof_ = !args[0]->IsFalse();
+  pipe->MaybeUseSendFile();
   pipe->writable_listener_.OnStreamWantsWrite(65536);
 }
 
@@ -282,6 +436,12 @@ void StreamPipe::PendingWrites(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(pipe->pending_writes_);
 }
 
+void StreamPipe::BytesPiped(const FunctionCallbackInfo<Value>& args) {
+  StreamPipe* pipe;
+  ASSIGN_OR_RETURN_UNWRAP(&pipe, args.Holder());
+  args.GetReturnValue().Set(static_cast<double>(pipe->bytes_piped_));
+}
+
 namespace {
 
 void InitializeStreamPipe(Local<Object> target,
@@ -296,6 +456,7 @@ void InitializeStreamPipe(Local<Object> target,
   env->SetProtoMethod(pipe, "start", StreamPipe::Start);
   env->SetProtoMethod(pipe, "isClosed", StreamPipe::IsClosed);
   env->SetProtoMethod(pipe, "pendingWrites", StreamPipe::PendingWrites);
+  env->SetProtoMethod(pipe, "bytesPiped", StreamPipe::BytesPiped);
   pipe->Inherit(AsyncWrap::GetConstructorTemplate(env));
   pipe->InstanceTemplate()->SetInternalFieldCount(
       StreamPipe::kInternalFieldCount);
@@ -5,6 +5,7 @@
 
 #include "stream_base.h"
 #include "allocated_buffer.h"
+#include "node_internals.h"
 
 namespace node {
 
@@ -13,6 +14,9 @@ class StreamPipe : public AsyncWrap {
   StreamPipe(StreamBase* source, StreamBase* sink, v8::Local<v8::Object> obj);
   ~StreamPipe() override;
 
+  // Largest amount of data passed to a single sendfile() call.
+  static constexpr size_t kSendFileChunkSize = 1024 * 1024;
+
   void Unpipe(bool is_in_deletion = false);
 
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -20,6 +24,7 @@ class StreamPipe : public AsyncWrap {
   static void Unpipe(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void IsClosed(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void PendingWrites(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void BytesPiped(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   SET_NO_MEMORY_INFO()
   SET_MEMORY_INFO_NAME(StreamPipe)
@@ -36,6 +41,11 @@ class StreamPipe : public AsyncWrap {
   bool sink_destroyed_ = false;
   bool source_destroyed_ = false;
   bool uses_wants_write_ = false;
+  // Whether the sink is shut down once the source has ended. Otherwise,
+  // that is left to the owner of the sink, e.g. a net.Socket in JS.
+  bool shutdown_on_eof_ = true;
+  // The amount of data that has been written to the sink.
+  uint64_t bytes_piped_ = 0;
 
   // Set a default value so that when we’re coming from Start(), we know
   // that we don’t want to read just yet.
@@ -45,6 +55,34 @@ class StreamPipe : public AsyncWrap {
 
   void ProcessData(size_t nread, AllocatedBuffer&& buf);
 
+  // When piping a FileHandle into a TCP or pipe handle, the file contents
+  // are transferred with sendfile() on the threadpool, without copying them
+  // through memory that the process can see. The regular read/write path is
+  // still used for a chunk whenever sendfile() would block or the sink has
+  // writes queued, and for the rest of the transfer after other errors.
+  bool use_sendfile_ = false;
+  bool copy_next_chunk_ = false;
+  BaseObjectPtr<StreamPipe> sendfile_ref_;
+
+  void MaybeUseSendFile();
+  bool TrySendFile();
+  void OnSendFileDone(ssize_t result);
+  void CloseSendFileFds();
+
+  class SendFileWork final : public ThreadPoolWork {
+   public:
+    explicit SendFileWork(Environment* env) : ThreadPoolWork(env) {}
+
+    void DoThreadPoolWork() override;
+    void AfterThreadPoolWork(int status) override;
+
+    int in_fd = -1;
+    int out_fd = -1;
+    int64_t offset = -1;
+    size_t length = 0;
+    ssize_t result = 0;
+  };
+
   class ReadableListener : public StreamListener {
    public:
     uv_buf_t OnStreamAlloc(size_t suggested_size) override;
@@ -64,6 +102,7 @@ class StreamPipe : public AsyncWrap {
 
   ReadableListener readable_listener_;
   WritableListener writable_listener_;
+  SendFileWork sendfile_work_;
 };
 
 }  // namespace node
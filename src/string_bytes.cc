@@ -23,8 +23,10 @@
 
 #include "base64-inl.h"
 #include "env-inl.h"
+#include "hex.h"
 #include "node_buffer.h"
 #include "node_errors.h"
+#include "node_utf8.h"
 #include "util.h"
 
 #include <climits>
@@ -243,13 +245,41 @@ static inline unsigned unhex(uint8_t x) {
   return unhex_table[x];
 }
 
+// Decodes as much of `src` as the vector code can handle. Two-byte input is
+// left entirely to the scalar loop in hex_decode().
+template <typename TypeName>
+static inline size_t hex_decode_prefix(char* buf,
+                                       size_t len,
+                                       const TypeName* src,
+                                       const size_t srcLen) {
+  return 0;
+}
+
+static inline size_t hex_decode_prefix(char* buf,
+                                       size_t len,
+                                       const uint8_t* src,
+                                       const size_t srcLen) {
+  return hex_decode_simd(buf, len, src, srcLen);
+}
+
+static inline size_t hex_decode_prefix(char* buf,
+                                       size_t len,
+                                       const char* src,
+                                       const size_t srcLen) {
+  return hex_decode_simd(
+      buf, len, reinterpret_cast<const uint8_t*>(src), srcLen);
+}
+
 template <typename TypeName>
 static size_t hex_decode(char* buf,
                          size_t len,
                          const TypeName* src,
                          const size_t srcLen) {
-  size_t i;
-  for (i = 0; i < len && i * 2 + 1 < srcLen; ++i) {
+  // The vector code stops in front of the block that contains the first
+  // invalid character, so that the loop below finds it and returns the
+  // same count that it would have returned on its own.
+  size_t i = hex_decode_prefix(buf, len, src, srcLen);
+  for (; i < len && i * 2 + 1 < srcLen; ++i) {
     unsigned a = unhex(src[i * 2 + 0]);
     unsigned b = unhex(src[i * 2 + 1]);
     if (!~a || !~b)
@@ -339,7 +369,28 @@ size_t StringBytes::Write(Isolate* isolate,
 
     case BUFFER:
     case UTF8:
-      nbytes = str->WriteUtf8(isolate, buf, buflen, chars_written, flags);
+      // The contents of external strings are accessible without copying
+      // them, which allows transcoding them directly.
+      if (str->IsExternalOneByte()) {
+        auto ext = str->GetExternalOneByteStringResource();
+        size_t nchars;
+        nbytes = utf8::FromLatin1(reinterpret_cast<const uint8_t*>(ext->data()),
+                                  ext->length(),
+                                  buf,
+                                  buflen,
+                                  &nchars);
+        *chars_written = static_cast<int>(nchars);
+      } else if (auto ext = str->GetExternalStringResource()) {
+        size_t nchars;
+        nbytes = utf8::FromUtf16(ext->data(),
+                                 ext->length(),
+                                 buf,
+                                 buflen,
+                                 &nchars);
+        *chars_written = static_cast<int>(nchars);
+      } else {
+        nbytes = str->WriteUtf8(isolate, buf, buflen, chars_written, flags);
+      }
       break;
 
     case UCS2: {
@@ -364,6 +415,16 @@ size_t StringBytes::Write(Isolate* isolate,
       if (str->IsExternalOneByte()) {
         auto ext = str->GetExternalOneByteStringResource();
         nbytes = base64_decode(buf, buflen, ext->data(), ext->length());
+      } else if (str->IsOneByte()) {
+        // Flattening into one byte per character is cheaper than the two
+        // bytes of String::Value, and lets base64_decode use SIMD.
+        MaybeStackBuffer<uint8_t> value(str->Length());
+        str->WriteOneByte(isolate,
+                          *value,
+                          0,
+                          -1,
+                          String::NO_NULL_TERMINATION);
+        nbytes = base64_decode(buf, buflen, *value, value.length());
       } else {
         String::Value value(isolate, str);
         nbytes = base64_decode(buf, buflen, *value, value.length());
@@ -375,6 +436,14 @@ size_t StringBytes::Write(Isolate* isolate,
       if (str->IsExternalOneByte()) {
         auto ext = str->GetExternalOneByteStringResource();
         nbytes = hex_decode(buf, buflen, ext->data(), ext->length());
+      } else if (str->IsOneByte()) {
+        MaybeStackBuffer<uint8_t> value(str->Length());
+        str->WriteOneByte(isolate,
+                          *value,
+                          0,
+                          -1,
+                          String::NO_NULL_TERMINATION);
+        nbytes = hex_decode(buf, buflen, *value, value.length());
       } else {
         String::Value value(isolate, str);
         nbytes = hex_decode(buf, buflen, *value, value.length());
@@ -465,7 +534,7 @@ Maybe<size_t> StringBytes::Size(Isolate* isolate,
 
     case BUFFER:
     case UTF8:
-      return Just<size_t>(str->Utf8Length(isolate));
+      return Just(Utf8Length(isolate, str));
 
     case UCS2:
       return Just(str->Length() * sizeof(uint16_t));
@@ -487,106 +556,15 @@ Maybe<size_t> StringBytes::Size(Isolate* isolate,
 
 
 
-static bool contains_non_ascii_slow(const char* buf, size_t len) {
-  for (size_t i = 0; i < len; ++i) {
-    if (buf[i] & 0x80)
-      return true;
-  }
-  return false;
-}
-
-
-static bool contains_non_ascii(const char* src, size_t len) {
-  if (len < 16) {
-    return contains_non_ascii_slow(src, len);
-  }
-
-  const unsigned bytes_per_word = sizeof(uintptr_t);
-  const unsigned align_mask = bytes_per_word - 1;
-  const unsigned unaligned = reinterpret_cast<uintptr_t>(src) & align_mask;
-
-  if (unaligned > 0) {
-    const unsigned n = bytes_per_word - unaligned;
-    if (contains_non_ascii_slow(src, n))
-      return true;
-    src += n;
-    len -= n;
-  }
-
-
-#if defined(_WIN64) || defined(_LP64)
-  const uintptr_t mask = 0x8080808080808080ll;
-#else
-  const uintptr_t mask = 0x80808080l;
-#endif
-
-  const uintptr_t* srcw = reinterpret_cast<const uintptr_t*>(src);
-
-  for (size_t i = 0, n = len / bytes_per_word; i < n; ++i) {
-    if (srcw[i] & mask)
-      return true;
-  }
-
-  const unsigned remainder = len & align_mask;
-  if (remainder > 0) {
-    const size_t offset = len - remainder;
-    if (contains_non_ascii_slow(src + offset, remainder))
-      return true;
-  }
-
-  return false;
-}
-
-
-static void force_ascii_slow(const char* src, char* dst, size_t len) {
-  for (size_t i = 0; i < len; ++i) {
-    dst[i] = src[i] & 0x7f;
-  }
-}
-
-
-static void force_ascii(const char* src, char* dst, size_t len) {
-  if (len < 16) {
-    force_ascii_slow(src, dst, len);
-    return;
-  }
-
-  const unsigned bytes_per_word = sizeof(uintptr_t);
-  const unsigned align_mask = bytes_per_word - 1;
-  const unsigned src_unalign = reinterpret_cast<uintptr_t>(src) & align_mask;
-  const unsigned dst_unalign = reinterpret_cast<uintptr_t>(dst) & align_mask;
-
-  if (src_unalign > 0) {
-    if (src_unalign == dst_unalign) {
-      const unsigned unalign = bytes_per_word - src_unalign;
-      force_ascii_slow(src, dst, unalign);
-      src += unalign;
-      dst += unalign;
-      len -= src_unalign;
-    } else {
-      force_ascii_slow(src, dst, len);
-      return;
-    }
-  }
-
-#if defined(_WIN64) || defined(_LP64)
-  const uintptr_t mask = ~0x8080808080808080ll;
-#else
-  const uintptr_t mask = ~0x80808080l;
-#endif
-
-  const uintptr_t* srcw = reinterpret_cast<const uintptr_t*>(src);
-  uintptr_t* dstw = reinterpret_cast<uintptr_t*>(dst);
-
-  for (size_t i = 0, n = len / bytes_per_word; i < n; ++i) {
-    dstw[i] = srcw[i] & mask;
-  }
-
-  const unsigned remainder = len & align_mask;
-  if (remainder > 0) {
-    const size_t offset = len - remainder;
-    force_ascii_slow(src + offset, dst + offset, remainder);
+size_t StringBytes::Utf8Length(Isolate* isolate, Local<String> str) {
+  if (str->IsExternalOneByte()) {
+    auto ext = str->GetExternalOneByteStringResource();
+    return utf8::LengthFromLatin1(
+        reinterpret_cast<const uint8_t*>(ext->data()), ext->length());
   }
+  if (auto ext = str->GetExternalStringResource())
+    return utf8::LengthFromUtf16(ext->data(), ext->length());
+  return str->Utf8Length(isolate);
 }
 
 
@@ -600,7 +578,8 @@ size_t StringBytes::hex_encode(
       "not enough space provided for hex encode");
 
   dlen = slen * 2;
-  for (uint32_t i = 0, k = 0; k < dlen; i += 1, k += 2) {
+  size_t i = hex_encode_simd(src, slen, dst);
+  for (size_t k = i * 2; k < dlen; i += 1, k += 2) {
     static const char hex[] = "0123456789abcdef";
     uint8_t val = static_cast<uint8_t>(src[i]);
     dst[k + 0] = hex[val >> 4];
@@ -655,13 +634,13 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
       }
 
     case ASCII:
-      if (contains_non_ascii(buf, buflen)) {
+      if (!utf8::IsAscii(buf, buflen)) {
         char* out = node::UncheckedMalloc(buflen);
         if (out == nullptr) {
           *error = node::ERR_MEMORY_ALLOCATION_FAILED(isolate);
           return MaybeLocal<Value>();
         }
-        force_ascii(buf, out, buflen);
+        utf8::StripHighBits(buf, out, buflen);
         return ExternOneByteString::New(isolate, out, buflen, error);
       } else {
         return ExternOneByteString::NewFromCopy(isolate, buf, buflen, error);
@@ -669,6 +648,32 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
 
     case UTF8:
       {
+        // ASCII is its own Latin-1 representation. Large valid input is
+        // transcoded into an external string, which the garbage collector
+        // does not need to move around, with one byte per character when
+        // possible. V8 handles everything else, including the replacement
+        // of invalid sequences.
+        if (utf8::IsAscii(buf, buflen))
+          return ExternOneByteString::NewFromCopy(isolate, buf, buflen, error);
+        if (buflen >= EXTERN_APEX && utf8::IsValid(buf, buflen)) {
+          const size_t length = utf8::Utf16Length(buf, buflen);
+          if (utf8::IsLatin1(buf, buflen)) {
+            char* dst = node::UncheckedMalloc(length);
+            if (dst == nullptr) {
+              *error = node::ERR_MEMORY_ALLOCATION_FAILED(isolate);
+              return MaybeLocal<Value>();
+            }
+            utf8::ToLatin1(buf, buflen, dst);
+            return ExternOneByteString::New(isolate, dst, length, error);
+          }
+          uint16_t* dst = node::UncheckedMalloc<uint16_t>(length);
+          if (dst == nullptr) {
+            *error = node::ERR_MEMORY_ALLOCATION_FAILED(isolate);
+            return MaybeLocal<Value>();
+          }
+          utf8::ToUtf16(buf, buflen, dst);
+          return ExternTwoByteString::New(isolate, dst, length, error);
+        }
         val = String::NewFromUtf8(isolate,
                                   buf,
                                   v8::NewStringType::kNormal,
@@ -67,6 +67,10 @@ class StringBytes {
                                 v8::Local<v8::Value> val,
                                 enum encoding enc);
 
+  // Precise UTF-8 byte count of a string. External strings are measured
+  // without going through V8.
+  static size_t Utf8Length(v8::Isolate* isolate, v8::Local<v8::String> str);
+
   // Write the bytes from the string or buffer into the char*
   // returns the number of bytes written, which will always be
   // <= buflen.  Use StorageSize/Size first to know how much
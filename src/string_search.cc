@@ -0,0 +1,356 @@
+#include "string_search.h"
+#include "node_simd.h"
+
+#include <cstring>
+
+#if defined(NODE_SIMD_X86)
+#include <immintrin.h>
+#elif defined(NODE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace node {
+namespace stringsearch {
+
+namespace {
+
+inline unsigned CountTrailingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(value);
+#else
+  unsigned count = 0;
+  while ((value & 1) == 0) {
+    value >>= 1;
+    count++;
+  }
+  return count;
+#endif
+}
+
+// Short needles are located by comparing the first and the last byte of the
+// needle with a whole block of candidate positions at once, and then
+// comparing the bytes in between only where both of them match. Every kernel
+// advances `*pos` past the candidates that it has ruled out, and returns the
+// position of the first match, or `haystack_length` if it did not find one.
+
+inline size_t ShortNeedleScalar(const uint8_t* haystack,
+                                size_t haystack_length,
+                                const uint8_t* needle,
+                                size_t needle_length,
+                                size_t pos) {
+  const size_t last = needle_length - 1;
+  for (; pos + needle_length <= haystack_length; pos++) {
+    if (haystack[pos] == needle[0] &&
+        haystack[pos + last] == needle[last] &&
+        memcmp(haystack + pos + 1, needle + 1, needle_length - 2) == 0) {
+      return pos;
+    }
+  }
+  return haystack_length;
+}
+
+#if defined(NODE_SIMD_X86)
+
+NODE_TARGET_SSE41
+size_t ShortNeedleSSE41(const uint8_t* haystack,
+                        size_t haystack_length,
+                        const uint8_t* needle,
+                        size_t needle_length,
+                        size_t* pos) {
+  const size_t last = needle_length - 1;
+  const __m128i first_byte = _mm_set1_epi8(needle[0]);
+  const __m128i last_byte = _mm_set1_epi8(needle[last]);
+  size_t i = *pos;
+  for (; i + last + 16 <= haystack_length; i += 16) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + last));
+    uint32_t mask = _mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(a, first_byte),
+                      _mm_cmpeq_epi8(b, last_byte)));
+    while (mask != 0) {
+      const size_t candidate = i + CountTrailingZeros(mask);
+      if (memcmp(haystack + candidate + 1, needle + 1, needle_length - 2) == 0)
+        return candidate;
+      mask &= mask - 1;
+    }
+  }
+  *pos = i;
+  return haystack_length;
+}
+
+NODE_TARGET_AVX2
+size_t ShortNeedleAVX2(const uint8_t* haystack,
+                       size_t haystack_length,
+                       const uint8_t* needle,
+                       size_t needle_length,
+                       size_t* pos) {
+  const size_t last = needle_length - 1;
+  const __m256i first_byte = _mm256_set1_epi8(needle[0]);
+  const __m256i last_byte = _mm256_set1_epi8(needle[last]);
+  size_t i = *pos;
+  for (; i + last + 32 <= haystack_length; i += 32) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i));
+    const __m256i b = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(haystack + i + last));
+    uint32_t mask = _mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(a, first_byte),
+                         _mm256_cmpeq_epi8(b, last_byte)));
+    while (mask != 0) {
+      const size_t candidate = i + CountTrailingZeros(mask);
+      if (memcmp(haystack + candidate + 1, needle + 1, needle_length - 2) == 0)
+        return candidate;
+      mask &= mask - 1;
+    }
+  }
+  *pos = i;
+  return haystack_length;
+}
+
+#elif defined(NODE_SIMD_NEON)
+
+// Narrows a comparison result to four bits per byte, which is the cheapest
+// way to get a scalar mask out of a NEON register.
+inline uint64_t NibbleMask(uint8x16_t matches) {
+  return vget_lane_u64(vreinterpret_u64_u8(
+      vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+}
+
+size_t ShortNeedleNEON(const uint8_t* haystack,
+                       size_t haystack_length,
+                       const uint8_t* needle,
+                       size_t needle_length,
+                       size_t* pos) {
+  const size_t last = needle_length - 1;
+  const uint8x16_t first_byte = vdupq_n_u8(needle[0]);
+  const uint8x16_t last_byte = vdupq_n_u8(needle[last]);
+  size_t i = *pos;
+  for (; i + last + 16 <= haystack_length; i += 16) {
+    const uint8x16_t a = vld1q_u8(haystack + i);
+    const uint8x16_t b = vld1q_u8(haystack + i + last);
+    uint64_t mask = NibbleMask(
+        vandq_u8(vceqq_u8(a, first_byte), vceqq_u8(b, last_byte)));
+    while (mask != 0) {
+      const size_t candidate = i + CountTrailingZeros(mask) / 4;
+      if (memcmp(haystack + candidate + 1, needle + 1, needle_length - 2) == 0)
+        return candidate;
+      mask &= ~(uint64_t{0xf} << (CountTrailingZeros(mask) & ~3u));
+    }
+  }
+  *pos = i;
+  return haystack_length;
+}
+
+#endif  // defined(NODE_SIMD_NEON)
+
+// Searching for several needles at once starts by classifying every byte of
+// the haystack as a possible first byte of a needle or not, which takes two
+// table lookups per block: each distinct first byte gets one of eight bits,
+// which is set in the entry for its low nibble in one table and in the entry
+// for its high nibble in the other. A byte is a candidate if the entries
+// for its two nibbles have a bit in common. With more than eight distinct
+// first bytes, bits are shared and some candidates are false positives; all
+// of them are verified against the needles anyway.
+class MultiNeedle {
+ public:
+  MultiNeedle(const uint8_t* const* needles,
+              const size_t* needle_lengths,
+              size_t count)
+      : needles_(needles), needle_lengths_(needle_lengths), count_(count) {
+    size_t distinct = 0;
+    for (size_t i = 0; i < count; i++) {
+      const uint8_t byte = needles[i][0];
+      if (first_bytes_[byte])
+        continue;
+      first_bytes_[byte] = true;
+      const uint8_t bit = 1 << (distinct++ % 8);
+      low_nibbles_[byte & 0xf] |= bit;
+      high_nibbles_[byte >> 4] |= bit;
+    }
+  }
+
+  bool MatchesAt(const uint8_t* haystack,
+                 size_t haystack_length,
+                 size_t pos) const {
+    if (!first_bytes_[haystack[pos]])
+      return false;
+    for (size_t i = 0; i < count_; i++) {
+      const size_t length = needle_lengths_[i];
+      if (length <= haystack_length - pos &&
+          memcmp(haystack + pos, needles_[i], length) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t SearchScalar(const uint8_t* haystack,
+                      size_t haystack_length,
+                      size_t pos) const {
+    for (; pos < haystack_length; pos++) {
+      if (MatchesAt(haystack, haystack_length, pos))
+        return pos;
+    }
+    return haystack_length;
+  }
+
+#if defined(NODE_SIMD_X86)
+  NODE_TARGET_SSE41
+  size_t SearchSSE41(const uint8_t* haystack,
+                     size_t haystack_length,
+                     size_t* pos) const {
+    const __m128i low_table =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(low_nibbles_));
+    const __m128i high_table =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(high_nibbles_));
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t i = *pos;
+    for (; i + 16 <= haystack_length; i += 16) {
+      const __m128i in =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+      const __m128i low =
+          _mm_shuffle_epi8(low_table, _mm_and_si128(in, nibble));
+      const __m128i high = _mm_shuffle_epi8(
+          high_table, _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+      uint32_t mask = 0xffff & ~_mm_movemask_epi8(
+          _mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128()));
+      while (mask != 0) {
+        const size_t candidate = i + CountTrailingZeros(mask);
+        if (MatchesAt(haystack, haystack_length, candidate))
+          return candidate;
+        mask &= mask - 1;
+      }
+    }
+    *pos = i;
+    return haystack_length;
+  }
+
+  NODE_TARGET_AVX2
+  size_t SearchAVX2(const uint8_t* haystack,
+                    size_t haystack_length,
+                    size_t* pos) const {
+    const __m256i low_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(low_nibbles_)));
+    const __m256i high_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(high_nibbles_)));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    size_t i = *pos;
+    for (; i + 32 <= haystack_length; i += 32) {
+      const __m256i in =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i));
+      const __m256i low =
+          _mm256_shuffle_epi8(low_table, _mm256_and_si256(in, nibble));
+      const __m256i high = _mm256_shuffle_epi8(
+          high_table, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble));
+      uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(
+          _mm256_cmpeq_epi8(_mm256_and_si256(low, high),
+                            _mm256_setzero_si256())));
+      while (mask != 0) {
+        const size_t candidate = i + CountTrailingZeros(mask);
+        if (MatchesAt(haystack, haystack_length, candidate))
+          return candidate;
+        mask &= mask - 1;
+      }
+    }
+    *pos = i;
+    return haystack_length;
+  }
+#elif defined(NODE_SIMD_NEON)
+  size_t SearchNEON(const uint8_t* haystack,
+                    size_t haystack_length,
+                    size_t* pos) const {
+    const uint8x16_t low_table = vld1q_u8(low_nibbles_);
+    const uint8x16_t high_table = vld1q_u8(high_nibbles_);
+    size_t i = *pos;
+    for (; i + 16 <= haystack_length; i += 16) {
+      const uint8x16_t in = vld1q_u8(haystack + i);
+      const uint8x16_t low =
+          vqtbl1q_u8(low_table, vandq_u8(in, vdupq_n_u8(0x0f)));
+      const uint8x16_t high = vqtbl1q_u8(high_table, vshrq_n_u8(in, 4));
+      uint64_t mask = NibbleMask(vtstq_u8(low, high));
+      while (mask != 0) {
+        const size_t candidate = i + CountTrailingZeros(mask) / 4;
+        if (MatchesAt(haystack, haystack_length, candidate))
+          return candidate;
+        mask &= ~(uint64_t{0xf} << (CountTrailingZeros(mask) & ~3u));
+      }
+    }
+    *pos = i;
+    return haystack_length;
+  }
+#endif  // defined(NODE_SIMD_NEON)
+
+ private:
+  const uint8_t* const* needles_;
+  const size_t* needle_lengths_;
+  const size_t count_;
+  bool first_bytes_[256] = {};
+  uint8_t low_nibbles_[16] = {};
+  uint8_t high_nibbles_[16] = {};
+};
+
+}  // anonymous namespace
+
+bool SearchShortNeedle(const uint8_t* haystack,
+                       size_t haystack_length,
+                       const uint8_t* needle,
+                       size_t needle_length,
+                       size_t start_index,
+                       size_t* result) {
+  CHECK_GE(needle_length, 2);
+  CHECK_LE(needle_length, kMaxShortNeedleLength);
+  size_t pos = start_index;
+  size_t found = haystack_length;
+#if defined(NODE_SIMD_X86)
+  if (!simd::Supports(simd::kSSE41))
+    return false;
+  if (simd::Supports(simd::kAVX2)) {
+    found = ShortNeedleAVX2(
+        haystack, haystack_length, needle, needle_length, &pos);
+  }
+  if (found == haystack_length) {
+    found = ShortNeedleSSE41(
+        haystack, haystack_length, needle, needle_length, &pos);
+  }
+#elif defined(NODE_SIMD_NEON)
+  found = ShortNeedleNEON(
+      haystack, haystack_length, needle, needle_length, &pos);
+#else
+  return false;
+#endif
+  if (found == haystack_length) {
+    found = ShortNeedleScalar(
+        haystack, haystack_length, needle, needle_length, pos);
+  }
+  *result = found;
+  return true;
+}
+
+size_t SearchAny(const uint8_t* haystack,
+                 size_t haystack_length,
+                 const uint8_t* const* needles,
+                 const size_t* needle_lengths,
+                 size_t count,
+                 size_t start_index) {
+  for (size_t i = 0; i < count; i++)
+    CHECK_GT(needle_lengths[i], 0);
+  const MultiNeedle search(needles, needle_lengths, count);
+  size_t pos = start_index;
+  size_t found = haystack_length;
+#if defined(NODE_SIMD_X86)
+  if (simd::Supports(simd::kAVX2))
+    found = search.SearchAVX2(haystack, haystack_length, &pos);
+  if (found == haystack_length && simd::Supports(simd::kSSE41))
+    found = search.SearchSSE41(haystack, haystack_length, &pos);
+#elif defined(NODE_SIMD_NEON)
+  found = search.SearchNEON(haystack, haystack_length, &pos);
+#endif
+  if (found == haystack_length)
+    found = search.SearchScalar(haystack, haystack_length, pos);
+  return found;
+}
+
+}  // namespace stringsearch
+}  // namespace node
@@ -574,6 +574,31 @@ size_t StringSearch<Char>::InitialSearch(
   return subject.length();
 }
 
+// Needles of up to this length are searched for with vector instructions,
+// where setting up the Boyer-Moore tables costs more than it saves.
+constexpr size_t kMaxShortNeedleLength = 16;
+
+// Forward search for a needle of 2 to kMaxShortNeedleLength bytes, defined in
+// string_search.cc. Returns false if the CPU lacks the instructions for it.
+// Otherwise stores the position of the first match at or after start_index
+// in *result, or haystack_length if there is none.
+bool SearchShortNeedle(const uint8_t* haystack,
+                       size_t haystack_length,
+                       const uint8_t* needle,
+                       size_t needle_length,
+                       size_t start_index,
+                       size_t* result);
+
+// Returns the first position at or after start_index at which any of the
+// `count` needles occurs, or haystack_length if none of them does. None of
+// the needles may be empty.
+size_t SearchAny(const uint8_t* haystack,
+                 size_t haystack_length,
+                 const uint8_t* const* needles,
+                 const size_t* needle_lengths,
+                 size_t count,
+                 size_t start_index);
+
 // Perform a single stand-alone search.
 // If searching multiple times for the same pattern, a search
 // object should be constructed once and the Search function then called
@@ -598,6 +623,19 @@ size_t SearchString(const Char* haystack,
                     size_t start_index,
                     bool is_forward) {
   if (haystack_length < needle_length) return haystack_length;
+  if (sizeof(Char) == 1 && is_forward && needle_length >= 2 &&
+      needle_length <= stringsearch::kMaxShortNeedleLength) {
+    size_t pos;
+    if (stringsearch::SearchShortNeedle(
+            reinterpret_cast<const uint8_t*>(haystack),
+            haystack_length,
+            reinterpret_cast<const uint8_t*>(needle),
+            needle_length,
+            start_index,
+            &pos)) {
+      return pos;
+    }
+  }
   // To do a reverse search (lastIndexOf instead of indexOf) without redundant
   // code, create two vectors that are reversed views into the input strings.
   // For example, v_needle[0] would return the *last* character of the needle.
@@ -24,6 +24,7 @@
 #include "connection_wrap.h"
 #include "env-inl.h"
 #include "handle_wrap.h"
+#include "memory_tracker-inl.h"
 #include "node_buffer.h"
 #include "node_internals.h"
 #include "connect_wrap.h"
@@ -156,6 +157,11 @@ TCPWrap::TCPWrap(Environment* env, Local<Object> object, ProviderType provider)
 }
 
 
+void TCPWrap::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackField("read_slab_allocator", read_slab_allocator_);
+}
+
+
 void TCPWrap::SetNoDelay(const FunctionCallbackInfo<Value>& args) {
   TCPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap,
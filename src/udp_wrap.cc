@@ -25,12 +25,31 @@
 #include "node_buffer.h"
 #include "node_sockaddr-inl.h"
 #include "handle_wrap.h"
+#include "memory_tracker-inl.h"
 #include "req_wrap-inl.h"
+#include "slab_allocator.h"
 #include "util-inl.h"
 
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <netinet/udp.h>
+#include <unistd.h>
+
+// Older C libraries do not define these yet.
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif  // __linux__
+
 namespace node {
 
 using v8::Array;
+using v8::ArrayBuffer;
 using v8::Context;
 using v8::DontDelete;
 using v8::FunctionCallbackInfo;
@@ -47,6 +66,19 @@ using v8::Uint32;
 using v8::Undefined;
 using v8::Value;
 
+// The number of datagrams that a single recvmmsg() call may read. libuv
+// reserves 64 KiB of the receive buffer for each of them, so this should be
+// kept small enough for the buffer to fit into a slab a couple of times.
+static constexpr size_t kMaxRecvmmsgMessages = 8;
+
+// The number of datagrams that are passed to a single sendmmsg() call.
+static constexpr size_t kMaxSendmmsgMessages = 64;
+
+// The largest UDP payload, and the number of segments that every kernel with
+// UDP GSO supports in a single call.
+static constexpr size_t kMaxUDPPayload = 65507;
+static constexpr size_t kMaxGSOSegments = 64;
+
 class SendWrap : public ReqWrap<uv_udp_send_t> {
  public:
   SendWrap(Environment* env, Local<Object> req_wrap_obj, bool have_callback);
@@ -113,12 +145,16 @@ UDPWrap::UDPWrap(Environment* env, Local<Object> object)
     : HandleWrap(env,
                  object,
                  reinterpret_cast<uv_handle_t*>(&handle_),
-                 AsyncWrap::PROVIDER_UDPWRAP) {
+                 AsyncWrap::PROVIDER_UDPWRAP),
+      read_slab_allocator_(env) {
   object->SetAlignedPointerInInternalField(
       UDPWrapBase::kUDPWrapBaseField, static_cast<UDPWrapBase*>(this));
 
-  int r = uv_udp_init(env->event_loop(), &handle_);
-  CHECK_EQ(r, 0);  // can't fail anyway
+  // recvmmsg() is only used where it is available, so this can't fail either.
+  int r = uv_udp_init_ex(env->event_loop(),
+                         &handle_,
+                         AF_UNSPEC | UV_UDP_RECVMMSG);
+  CHECK_EQ(r, 0);
 
   set_listener(this);
 }
@@ -158,6 +194,14 @@ void UDPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "bind6", Bind6);
   env->SetProtoMethod(t, "connect6", Connect6);
   env->SetProtoMethod(t, "send6", Send6);
+  env->SetProtoMethod(t, "sendMany", SendMany);
+  env->SetProtoMethod(t, "sendMany6", SendMany6);
+  env->SetProtoMethod(t, "sendSegments", SendSegments);
+  env->SetProtoMethod(t, "sendSegments6", SendSegments6);
+  env->SetProtoMethod(t, "setGRO", SetGRO);
+  // These shadow the HandleWrap methods, to apply to the GRO watcher too.
+  env->SetProtoMethod(t, "ref", Ref);
+  env->SetProtoMethod(t, "unref", Unref);
   env->SetProtoMethod(t, "disconnect", Disconnect);
   env->SetProtoMethod(t, "getpeername",
                       GetSockOrPeerName<UDPWrap, uv_udp_getpeername>);
@@ -598,6 +642,231 @@ ssize_t UDPWrap::Send(uv_buf_t* bufs_ptr,
 }
 
 
+void UDPWrap::DoSendMany(const FunctionCallbackInfo<Value>& args,
+                         int family) {
+  Environment* env = Environment::GetCurrent(args);
+
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+
+  CHECK(args.Length() == 2 || args.Length() == 4);
+  CHECK(args[0]->IsArray());
+  CHECK(args[1]->IsUint32());
+
+  bool sendto = args.Length() == 4;
+  if (sendto) {
+    // sendMany(list, list.length, port, address)
+    CHECK(args[2]->IsUint32());
+    CHECK(args[3]->IsString());
+  }
+
+  Local<Array> messages = args[0].As<Array>();
+  size_t count = args[1].As<Uint32>()->Value();
+
+  MaybeStackBuffer<uv_buf_t, 16> bufs(count);
+  for (size_t i = 0; i < count; i++) {
+    Local<Value> message;
+    if (!messages->Get(env->context(), i).ToLocal(&message)) return;
+    bufs[i] = uv_buf_init(Buffer::Data(message), Buffer::Length(message));
+  }
+
+  int err = 0;
+  struct sockaddr_storage addr_storage;
+  sockaddr* addr = nullptr;
+  if (sendto) {
+    const unsigned short port = args[2].As<Uint32>()->Value();
+    node::Utf8Value address(env->isolate(), args[3]);
+    err = sockaddr_for_family(family, address.out(), port, &addr_storage);
+    if (err == 0)
+      addr = reinterpret_cast<sockaddr*>(&addr_storage);
+  }
+
+  if (err != 0)
+    return args.GetReturnValue().Set(err);
+  args.GetReturnValue().Set(
+      static_cast<double>(wrap->SendMany(*bufs, count, addr)));
+}
+
+ssize_t UDPWrap::SendMany(uv_buf_t* msgs,
+                          size_t count,
+                          const sockaddr* addr) {
+  if (IsHandleClosing()) return UV_EBADF;
+  if (UNLIKELY(env()->options()->test_udp_no_try_send) ||
+      handle_.send_queue_count > 0) {
+    return 0;
+  }
+
+  size_t sent = 0;
+#ifdef __linux__
+  // uv_udp_try_send() takes one system call per datagram, sendmmsg() takes
+  // one for many of them. On Unix, uv_buf_t is layout-compatible with iovec.
+  uv_os_fd_t fd;
+  if (uv_fileno(reinterpret_cast<uv_handle_t*>(&handle_), &fd) == 0) {
+    socklen_t addrlen = 0;
+    if (addr != nullptr) {
+      addrlen = addr->sa_family == AF_INET6 ? sizeof(sockaddr_in6)
+                                            : sizeof(sockaddr_in);
+    }
+    mmsghdr hdrs[kMaxSendmmsgMessages];
+    while (sent < count) {
+      const size_t batch = std::min(count - sent, kMaxSendmmsgMessages);
+      memset(hdrs, 0, sizeof(hdrs[0]) * batch);
+      for (size_t i = 0; i < batch; i++) {
+        hdrs[i].msg_hdr.msg_name = const_cast<sockaddr*>(addr);
+        hdrs[i].msg_hdr.msg_namelen = addrlen;
+        hdrs[i].msg_hdr.msg_iov = reinterpret_cast<iovec*>(&msgs[sent + i]);
+        hdrs[i].msg_hdr.msg_iovlen = 1;
+      }
+      int r;
+      do {
+        r = sendmmsg(fd, hdrs, batch, 0);
+      } while (r == -1 && errno == EINTR);
+      if (r == -1) {
+        if (errno == ENOSYS)
+          break;  // Fall back to uv_udp_try_send().
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+          return sent;
+        return sent > 0 ? sent : uv_translate_sys_error(errno);
+      }
+      sent += r;
+      if (static_cast<size_t>(r) < batch)
+        return sent;
+    }
+  }
+#endif  // __linux__
+
+  for (; sent < count; sent++) {
+    int err = uv_udp_try_send(&handle_, &msgs[sent], 1, addr);
+    if (err == UV_ENOSYS || err == UV_EAGAIN)
+      break;
+    if (err < 0)
+      return sent > 0 ? sent : err;
+  }
+  return sent;
+}
+
+
+void UDPWrap::DoSendSegments(const FunctionCallbackInfo<Value>& args,
+                             int family) {
+  Environment* env = Environment::GetCurrent(args);
+
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+
+  CHECK(args.Length() == 2 || args.Length() == 4);
+  CHECK(Buffer::HasInstance(args[0]));
+  CHECK(args[1]->IsUint32());
+
+  bool sendto = args.Length() == 4;
+  if (sendto) {
+    // sendSegments(buffer, segmentSize, port, address)
+    CHECK(args[2]->IsUint32());
+    CHECK(args[3]->IsString());
+  }
+
+  const uv_buf_t buf =
+      uv_buf_init(Buffer::Data(args[0]), Buffer::Length(args[0]));
+  const size_t segment_size = args[1].As<Uint32>()->Value();
+  CHECK_GT(segment_size, 0);
+
+  int err = 0;
+  struct sockaddr_storage addr_storage;
+  sockaddr* addr = nullptr;
+  if (sendto) {
+    const unsigned short port = args[2].As<Uint32>()->Value();
+    node::Utf8Value address(env->isolate(), args[3]);
+    err = sockaddr_for_family(family, address.out(), port, &addr_storage);
+    if (err == 0)
+      addr = reinterpret_cast<sockaddr*>(&addr_storage);
+  }
+
+  if (err != 0)
+    return args.GetReturnValue().Set(err);
+  args.GetReturnValue().Set(
+      static_cast<double>(wrap->SendSegments(buf, segment_size, addr)));
+}
+
+ssize_t UDPWrap::SendSegments(const uv_buf_t& buf,
+                              size_t segment_size,
+                              const sockaddr* addr) {
+  if (IsHandleClosing()) return UV_EBADF;
+  if (UNLIKELY(env()->options()->test_udp_no_try_send) ||
+      handle_.send_queue_count > 0 ||
+      gso_support_ == GSOSupport::kUnsupported) {
+    return 0;
+  }
+
+  size_t sent = 0;
+#ifdef __linux__
+  uv_os_fd_t fd;
+  if (uv_fileno(reinterpret_cast<uv_handle_t*>(&handle_), &fd) != 0)
+    return 0;
+
+  // Kernels without UDP GSO ignore the control message, and would send all
+  // of the data as one datagram. Make sure that the option is known first.
+  if (gso_support_ == GSOSupport::kUnknown) {
+    int value;
+    socklen_t length = sizeof(value);
+    gso_support_ = getsockopt(fd, SOL_UDP, UDP_SEGMENT, &value, &length) == 0 ?
+        GSOSupport::kSupported : GSOSupport::kUnsupported;
+    if (gso_support_ == GSOSupport::kUnsupported)
+      return 0;
+  }
+
+  const size_t max_length =
+      std::min(kMaxGSOSegments, kMaxUDPPayload / segment_size) * segment_size;
+  if (max_length == 0)
+    return 0;
+
+  socklen_t addrlen = 0;
+  if (addr != nullptr) {
+    addrlen = addr->sa_family == AF_INET6 ? sizeof(sockaddr_in6)
+                                          : sizeof(sockaddr_in);
+  }
+  const uint16_t gso_size = static_cast<uint16_t>(segment_size);
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(gso_size))];
+  while (sent < buf.len) {
+    iovec iov;
+    iov.iov_base = buf.base + sent;
+    iov.iov_len = std::min(buf.len - sent, max_length);
+
+    msghdr h;
+    memset(&h, 0, sizeof(h));
+    memset(control, 0, sizeof(control));
+    h.msg_name = const_cast<sockaddr*>(addr);
+    h.msg_namelen = addrlen;
+    h.msg_iov = &iov;
+    h.msg_iovlen = 1;
+    h.msg_control = control;
+    h.msg_controllen = sizeof(control);
+    cmsghdr* cm = CMSG_FIRSTHDR(&h);
+    cm->cmsg_level = SOL_UDP;
+    cm->cmsg_type = UDP_SEGMENT;
+    cm->cmsg_len = CMSG_LEN(sizeof(gso_size));
+    memcpy(CMSG_DATA(cm), &gso_size, sizeof(gso_size));
+
+    ssize_t r;
+    do {
+      r = sendmsg(fd, &h, 0);
+    } while (r == -1 && errno == EINTR);
+    if (r == -1) {
+      // EIO means that the device can not do segmentation. Anything else is
+      // left for the regular send path to report.
+      if (errno == EIO)
+        gso_support_ = GSOSupport::kUnsupported;
+      break;
+    }
+    sent += iov.iov_len;
+  }
+#endif  // __linux__
+  return sent;
+}
+
+
 ReqWrap<uv_udp_send_t>* UDPWrap::CreateSendWrap(size_t msg_size) {
   SendWrap* req_wrap = new SendWrap(env(),
                                     current_send_req_wrap_,
@@ -617,10 +886,97 @@ void UDPWrap::Send6(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void UDPWrap::SendMany(const FunctionCallbackInfo<Value>& args) {
+  DoSendMany(args, AF_INET);
+}
+
+
+void UDPWrap::SendMany6(const FunctionCallbackInfo<Value>& args) {
+  DoSendMany(args, AF_INET6);
+}
+
+
+void UDPWrap::SendSegments(const FunctionCallbackInfo<Value>& args) {
+  DoSendSegments(args, AF_INET);
+}
+
+
+void UDPWrap::SendSegments6(const FunctionCallbackInfo<Value>& args) {
+  DoSendSegments(args, AF_INET6);
+}
+
+
+void UDPWrap::SetGRO(const FunctionCallbackInfo<Value>& args) {
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsBoolean());
+  args.GetReturnValue().Set(wrap->SetGRO(args[0]->IsTrue()));
+}
+
+
+int UDPWrap::SetGRO(bool enable) {
+  if (IsHandleClosing()) return UV_EBADF;
+#ifdef __linux__
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&handle_), &fd);
+  if (err != 0) return err;
+  int value = enable ? 1 : 0;
+  if (setsockopt(fd, SOL_UDP, UDP_GRO, &value, sizeof(value)) != 0)
+    return uv_translate_sys_error(errno);
+  if (enable == gro_enabled_)
+    return 0;
+
+  // Switch over to the other way of receiving.
+  const bool receiving = receiving_;
+  if (receiving)
+    RecvStop();
+  gro_enabled_ = enable;
+  return receiving ? RecvStart() : 0;
+#else
+  return UV_ENOTSUP;
+#endif  // __linux__
+}
+
+
+void UDPWrap::Ref(const FunctionCallbackInfo<Value>& args) {
+  HandleWrap::Ref(args);
+#ifdef __linux__
+  UDPWrap* wrap = Unwrap<UDPWrap>(args.Holder());
+  if (wrap != nullptr && wrap->gro_poll_ != nullptr)
+    uv_ref(reinterpret_cast<uv_handle_t*>(wrap->gro_poll_));
+#endif  // __linux__
+}
+
+
+void UDPWrap::Unref(const FunctionCallbackInfo<Value>& args) {
+  HandleWrap::Unref(args);
+#ifdef __linux__
+  UDPWrap* wrap = Unwrap<UDPWrap>(args.Holder());
+  if (wrap != nullptr && wrap->gro_poll_ != nullptr)
+    uv_unref(reinterpret_cast<uv_handle_t*>(wrap->gro_poll_));
+#endif  // __linux__
+}
+
+
+void UDPWrap::Close(Local<Value> close_callback) {
+#ifdef __linux__
+  StopGROReceive();
+#endif  // __linux__
+  HandleWrap::Close(close_callback);
+}
+
+
 AsyncWrap* UDPWrap::GetAsyncWrap() {
   return this;
 }
 
+void UDPWrap::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackField("read_slab_allocator", &read_slab_allocator_);
+  tracker->TrackFieldWithSize("recvmmsg_buffer", recvmmsg_buffer_.size);
+}
+
 SocketAddress UDPWrap::GetPeerName() {
   return SocketAddress::FromPeerName(handle_);
 }
@@ -636,10 +992,18 @@ void UDPWrapBase::RecvStart(const FunctionCallbackInfo<Value>& args) {
 
 int UDPWrap::RecvStart() {
   if (IsHandleClosing()) return UV_EBADF;
-  int err = uv_udp_recv_start(&handle_, OnAlloc, OnRecv);
+  int err;
+#ifdef __linux__
+  if (gro_enabled_)
+    err = StartGROReceive();
+  else
+#endif  // __linux__
+    err = uv_udp_recv_start(&handle_, OnAlloc, OnRecv);
   // UV_EALREADY means that the socket is already bound but that's okay
   if (err == UV_EALREADY)
     err = 0;
+  if (err == 0)
+    receiving_ = true;
   return err;
 }
 
@@ -651,9 +1015,135 @@ void UDPWrapBase::RecvStop(const FunctionCallbackInfo<Value>& args) {
 
 int UDPWrap::RecvStop() {
   if (IsHandleClosing()) return UV_EBADF;
-  return uv_udp_recv_stop(&handle_);
+  receiving_ = false;
+#ifdef __linux__
+  if (gro_enabled_) {
+    StopGROReceive();
+    read_slab_allocator_.Reclaim();
+    return 0;
+  }
+#endif  // __linux__
+  int err = uv_udp_recv_stop(&handle_);
+  read_slab_allocator_.Reclaim();
+  recvmmsg_buffer_ = MallocedBuffer<char>();
+  return err;
+}
+
+#ifdef __linux__
+int UDPWrap::StartGROReceive() {
+  if (gro_poll_ != nullptr)
+    return 0;
+
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&handle_), &fd);
+  if (err != 0)
+    return err;
+  gro_fd_ = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  if (gro_fd_ == -1)
+    return uv_translate_sys_error(errno);
+
+  gro_poll_ = new uv_poll_t;
+  err = uv_poll_init(env()->event_loop(), gro_poll_, gro_fd_);
+  if (err != 0) {
+    delete gro_poll_;
+    gro_poll_ = nullptr;
+    close(gro_fd_);
+    gro_fd_ = -1;
+    return err;
+  }
+  gro_poll_->data = this;
+  if (!uv_has_ref(GetHandle()))
+    uv_unref(reinterpret_cast<uv_handle_t*>(gro_poll_));
+  CHECK_EQ(uv_poll_start(gro_poll_, UV_READABLE, OnGROReadable), 0);
+  return 0;
+}
+
+void UDPWrap::StopGROReceive() {
+  if (gro_poll_ == nullptr)
+    return;
+  // Closing the poll handle stops watching the descriptor right away.
+  env()->CloseHandle(gro_poll_, [](uv_poll_t* handle) { delete handle; });
+  gro_poll_ = nullptr;
+  close(gro_fd_);
+  gro_fd_ = -1;
 }
 
+void UDPWrap::OnGROReadable(uv_poll_t* handle, int status, int events) {
+  UDPWrap* wrap = static_cast<UDPWrap*>(handle->data);
+  if (status < 0) {
+    wrap->listener()->OnRecv(status, uv_buf_init(nullptr, 0), nullptr, 0);
+    return;
+  }
+  wrap->ReadGRO();
+}
+
+void UDPWrap::ReadGRO() {
+  Environment* env = this->env();
+  SlabAllocator* allocator = &read_slab_allocator_;
+
+  // Like libuv, only read so many times in a row, to not starve the loop.
+  for (int count = 0; count < 32; count++) {
+    // JS may have stopped receiving or closed the socket.
+    if (gro_poll_ == nullptr)
+      return;
+
+    uv_buf_t buf = allocator->Allocate(kMaxUDPPayload);
+    sockaddr_storage peer;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    iovec iov;
+    iov.iov_base = buf.base;
+    iov.iov_len = buf.len;
+    msghdr h;
+    memset(&h, 0, sizeof(h));
+    memset(&peer, 0, sizeof(peer));
+    h.msg_name = &peer;
+    h.msg_namelen = sizeof(peer);
+    h.msg_iov = &iov;
+    h.msg_iovlen = 1;
+    h.msg_control = control;
+    h.msg_controllen = sizeof(control);
+
+    ssize_t nread;
+    do {
+      nread = recvmsg(gro_fd_, &h, 0);
+    } while (nread == -1 && errno == EINTR);
+    if (nread == -1) {
+      allocator->Release(buf);
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        listener()->OnRecv(uv_translate_sys_error(errno),
+                           uv_buf_init(nullptr, 0), nullptr, 0);
+      }
+      return;
+    }
+
+    int segment_size = 0;
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&h); cm != nullptr;
+         cm = CMSG_NXTHDR(&h, cm)) {
+      if (cm->cmsg_level == SOL_UDP && cm->cmsg_type == UDP_GRO)
+        memcpy(&segment_size, CMSG_DATA(cm), sizeof(segment_size));
+    }
+    const sockaddr* addr = reinterpret_cast<const sockaddr*>(&peer);
+    if (segment_size <= 0 || nread <= segment_size) {
+      listener()->OnRecv(nread, buf, addr, 0);
+      continue;
+    }
+
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    size_t offset;
+    Local<ArrayBuffer> ab = allocator->Commit(buf, nread, &offset);
+    Local<Value> argv[] = {
+      Integer::New(env->isolate(), nread),
+      object(),
+      Buffer::New(env, ab, offset, nread).ToLocalChecked(),
+      AddressToJS(env, addr),
+      Integer::New(env->isolate(), segment_size)
+    };
+    MakeCallback(env->onmessage_string(), arraysize(argv), argv);
+  }
+}
+#endif  // __linux__
+
 
 void UDPWrap::OnSendDone(ReqWrap<uv_udp_send_t>* req, int status) {
   std::unique_ptr<SendWrap> req_wrap{static_cast<SendWrap*>(req)};
@@ -679,7 +1169,20 @@ void UDPWrap::OnAlloc(uv_handle_t* handle,
 }
 
 uv_buf_t UDPWrap::OnAlloc(size_t suggested_size) {
-  return AllocatedBuffer::AllocateManaged(env(), suggested_size).release();
+  if (!uv_udp_using_recvmmsg(&handle_))
+    return read_slab_allocator_.Allocate(suggested_size);
+
+  // libuv reads one datagram into each `suggested_size` bytes of the buffer.
+  // The datagrams are copied out before libuv releases it again, so a single
+  // buffer serves all batches.
+  const size_t size = suggested_size * kMaxRecvmmsgMessages;
+  if (recvmmsg_buffer_.size < size) {
+    char* data = UncheckedMalloc(size);
+    if (data == nullptr)
+      return uv_buf_init(nullptr, 0);
+    recvmmsg_buffer_ = MallocedBuffer<char>(data, size);
+  }
+  return uv_buf_init(recvmmsg_buffer_.data, size);
 }
 
 void UDPWrap::OnRecv(uv_udp_t* handle,
@@ -695,8 +1198,28 @@ void UDPWrap::OnRecv(ssize_t nread,
                      const uv_buf_t& buf_,
                      const sockaddr* addr,
                      unsigned int flags) {
+  if (flags & UV_UDP_MMSG_CHUNK) {
+    CHECK_GE(nread, 0);
+    CHECK_NOT_NULL(addr);
+    ReceivedMessage message;
+    message.data = buf_.base;
+    message.length = nread;
+    memcpy(&message.address,
+           addr,
+           addr->sa_family == AF_INET6 ? sizeof(sockaddr_in6)
+                                       : sizeof(sockaddr_in));
+    received_.push_back(message);
+    return;
+  }
+  if (flags & UV_UDP_MMSG_FREE)
+    return EmitReceivedMessages();
+
   Environment* env = this->env();
-  AllocatedBuffer buf(env, buf_);
+  SlabAllocator* allocator = &read_slab_allocator_;
+  if (nread <= 0 && buf_.base != nullptr &&
+      buf_.base != recvmmsg_buffer_.data) {
+    allocator->Release(buf_);
+  }
   if (nread == 0 && addr == nullptr) {
     return;
   }
@@ -716,12 +1239,50 @@ void UDPWrap::OnRecv(ssize_t nread,
     return;
   }
 
-  buf.Resize(nread);
-  argv[2] = buf.ToBuffer().ToLocalChecked();
+  size_t offset = 0;
+  Local<ArrayBuffer> ab;
+  if (nread > 0)
+    ab = allocator->Commit(buf_, nread, &offset);
+  else
+    ab = ArrayBuffer::New(env->isolate(), 0);
+  argv[2] = Buffer::New(env, ab, offset, nread).ToLocalChecked();
   argv[3] = AddressToJS(env, addr);
   MakeCallback(env->onmessage_string(), arraysize(argv), argv);
 }
 
+void UDPWrap::EmitReceivedMessages() {
+  if (received_.empty())
+    return;
+
+  Environment* env = this->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  const size_t count = received_.size();
+  MaybeStackBuffer<Local<Value>, kMaxRecvmmsgMessages> buffers(count);
+  MaybeStackBuffer<Local<Value>, kMaxRecvmmsgMessages> addresses(count);
+  for (size_t i = 0; i < count; i++) {
+    const ReceivedMessage& message = received_[i];
+    Local<Object> buffer;
+    if (!Buffer::Copy(env, message.data, message.length).ToLocal(&buffer)) {
+      received_.clear();
+      return;
+    }
+    buffers[i] = buffer;
+    addresses[i] = AddressToJS(
+        env, reinterpret_cast<const sockaddr*>(&message.address));
+  }
+
+  received_.clear();
+
+  Local<Value> argv[] = {
+    object(),
+    Array::New(env->isolate(), buffers.out(), count),
+    Array::New(env->isolate(), addresses.out(), count)
+  };
+  MakeCallback(env->onmessages_string(), arraysize(argv), argv);
+}
+
 MaybeLocal<Object> UDPWrap::Instantiate(Environment* env,
                                         AsyncWrap* parent,
                                         UDPWrap::SocketType type) {
@@ -27,9 +27,12 @@
 #include "handle_wrap.h"
 #include "req_wrap.h"
 #include "node_sockaddr.h"
+#include "slab_allocator.h"
 #include "uv.h"
 #include "v8.h"
 
+#include <vector>
+
 namespace node {
 
 class UDPWrapBase;
@@ -135,6 +138,13 @@ class UDPWrap final : public HandleWrap,
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Send6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendMany(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendMany6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendSegments(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendSegments6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetGRO(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Ref(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Unref(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Disconnect(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void AddMembership(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DropMembership(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -167,6 +177,30 @@ class UDPWrap final : public HandleWrap,
                size_t nbufs,
                const sockaddr* addr) override;
 
+  // Sends each of `msgs` as a separate datagram, for as long as that is
+  // possible without blocking. Returns the number of datagrams that were
+  // sent, or a libuv error code if not even the first one could be sent.
+  // Datagrams are only sent if libuv has none of its own queued, to keep
+  // them in order.
+  ssize_t SendMany(uv_buf_t* msgs, size_t count, const sockaddr* addr);
+
+  // Sends `buf` as datagrams of `segment_size` bytes each (the last one may
+  // be shorter), letting the kernel split it up (UDP GSO). Returns the number
+  // of bytes that were sent, which is always a multiple of `segment_size`
+  // unless all of `buf` was sent, or a libuv error code. Only sends anything
+  // if the kernel supports segmentation and libuv has no datagrams queued.
+  ssize_t SendSegments(const uv_buf_t& buf,
+                       size_t segment_size,
+                       const sockaddr* addr);
+
+  // Makes the kernel coalesce incoming datagrams from the same flow into a
+  // single buffer (UDP GRO). Such buffers are passed to JS along with the
+  // size of the datagrams that make them up.
+  int SetGRO(bool enable);
+
+  void Close(
+      v8::Local<v8::Value> close_callback = v8::Local<v8::Value>()) override;
+
   SocketAddress GetPeerName() override;
   SocketAddress GetSockName() override;
 
@@ -175,7 +209,7 @@ class UDPWrap final : public HandleWrap,
   static v8::MaybeLocal<v8::Object> Instantiate(Environment* env,
                                                 AsyncWrap* parent,
                                                 SocketType type);
-  SET_NO_MEMORY_INFO()
+  void MemoryInfo(MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(UDPWrap)
   SET_SELF_SIZE(UDPWrap)
 
@@ -194,6 +228,10 @@ class UDPWrap final : public HandleWrap,
                      int family);
   static void DoSend(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
+  static void DoSendMany(const v8::FunctionCallbackInfo<v8::Value>& args,
+                         int family);
+  static void DoSendSegments(const v8::FunctionCallbackInfo<v8::Value>& args,
+                             int family);
   static void SetMembership(const v8::FunctionCallbackInfo<v8::Value>& args,
                             uv_membership membership);
   static void SetSourceMembership(
@@ -209,8 +247,48 @@ class UDPWrap final : public HandleWrap,
                      const struct sockaddr* addr,
                      unsigned int flags);
 
+  // Passes the datagrams that were collected from a recvmmsg() call to JS.
+  void EmitReceivedMessages();
+
+#ifdef __linux__
+  // libuv does not pass ancillary data on to its users, so with GRO the
+  // socket is read by UDPWrap itself. libuv remains in charge of the socket
+  // for sending, and keeps watching it for that. A duplicate of the file
+  // descriptor is watched for reading instead, since libuv supports only
+  // one watcher per descriptor.
+  int StartGROReceive();
+  void StopGROReceive();
+  void ReadGRO();
+  static void OnGROReadable(uv_poll_t* handle, int status, int events);
+
+  uv_poll_t* gro_poll_ = nullptr;
+  int gro_fd_ = -1;
+#endif  // __linux__
+  bool gro_enabled_ = false;
+  bool receiving_ = false;
+  enum class GSOSupport { kUnknown, kSupported, kUnsupported };
+  GSOSupport gso_support_ = GSOSupport::kUnknown;
+
   uv_udp_t handle_;
 
+  // The memory that datagrams are read into. It is not shared with any other
+  // handle, so that a Buffer that JS receives can only refer to data that
+  // was sent to this socket.
+  SlabAllocator read_slab_allocator_;
+
+  // With recvmmsg(), libuv reads the datagrams into 64 KiB slots of a single
+  // buffer and reports them one by one. That buffer belongs to this handle
+  // and is reused for every batch. Each datagram is copied into memory of its
+  // own, and all of them are passed to JS with a single call once libuv
+  // releases the buffer.
+  struct ReceivedMessage {
+    const char* data;
+    size_t length;
+    sockaddr_storage address;
+  };
+  std::vector<ReceivedMessage> received_;
+  MallocedBuffer<char> recvmmsg_buffer_;
+
   bool current_send_has_callback_;
   v8::Local<v8::Object> current_send_req_wrap_;
 };
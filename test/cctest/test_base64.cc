@@ -1,7 +1,10 @@
 #include "base64-inl.h"
+#include "node_simd.h"
 
 #include <cstddef>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -140,3 +143,119 @@ TEST(Base64Test, Decode) {
        "dCBjdXBpZGF0YXQgbm9uIHByb2lkZW50LCBzdW50IGluIGN1bHBhIHF1aSBvZmZpY2lh\n"
        "IGRlc2VydW50IG1vbGxpdCBhbmltIGlkIGVzdCBsYWJvcnVtLg", text);
 }
+
+// The vectorized code paths have to produce exactly the same results as the
+// scalar ones, which are used as the reference here. Decoding from uint16_t
+// never uses SIMD, and masking all features disables it for encoding.
+class Base64SIMDTest : public ::testing::TestWithParam<uint32_t> {
+ protected:
+  void SetUp() override {
+    previous_mask_ = node::simd::SetFeatureMaskForTesting(GetParam());
+  }
+
+  void TearDown() override {
+    node::simd::SetFeatureMaskForTesting(previous_mask_);
+  }
+
+  static std::string Encode(const std::string& input, node::Base64Mode mode) {
+    const size_t len = node::base64_encoded_size(input.size(), mode);
+    std::string result(len, '\0');
+    base64_encode(input.data(), input.size(), &result[0], len, mode);
+    return result;
+  }
+
+  static std::string Decode(const std::string& input, size_t dstlen) {
+    std::string result(dstlen, '\0');
+    result.resize(base64_decode(&result[0], dstlen, input.data(),
+                                input.size()));
+    return result;
+  }
+
+  static std::string DecodeReference(const std::string& input,
+                                     size_t dstlen) {
+    std::vector<uint16_t> wide(input.size());
+    for (size_t i = 0; i < input.size(); i++)
+      wide[i] = static_cast<uint8_t>(input[i]);
+    std::string result(dstlen, '\0');
+    result.resize(base64_decode(&result[0], dstlen, wide.data(),
+                                wide.size()));
+    return result;
+  }
+
+ private:
+  uint32_t previous_mask_;
+};
+
+static std::string MakeInput(size_t size, uint32_t seed) {
+  std::string result(size, '\0');
+  for (size_t i = 0; i < size; i++) {
+    seed = seed * 1103515245 + 12345;
+    result[i] = static_cast<char>(seed >> 16);
+  }
+  return result;
+}
+
+TEST_P(Base64SIMDTest, Encode) {
+  std::vector<size_t> sizes;
+  for (size_t size = 0; size <= 200; size++)
+    sizes.push_back(size);
+  sizes.push_back(4095);
+  sizes.push_back(65536);
+
+  for (size_t size : sizes) {
+    const std::string input = MakeInput(size, size);
+    for (node::Base64Mode mode :
+         { node::Base64Mode::NORMAL, node::Base64Mode::URL }) {
+      const std::string actual = Encode(input, mode);
+      const uint32_t mask = node::simd::SetFeatureMaskForTesting(0);
+      const std::string expected = Encode(input, mode);
+      node::simd::SetFeatureMaskForTesting(mask);
+      EXPECT_EQ(expected, actual) << "size " << size;
+    }
+  }
+}
+
+TEST_P(Base64SIMDTest, Decode) {
+  for (size_t size = 0; size <= 300; size++) {
+    const std::string input = MakeInput(size, size + 1);
+    const std::string normal = Encode(input, node::Base64Mode::NORMAL);
+    const std::string url = Encode(input, node::Base64Mode::URL);
+
+    std::vector<std::string> cases = { normal, url };
+    // Both alphabets in the same string.
+    cases.push_back(normal.substr(0, normal.size() / 2) +
+                    url.substr(url.size() / 2));
+    if (normal.size() > 60) {
+      // Whitespace, padding and invalid characters in the middle of input
+      // that would otherwise be decoded with vector instructions.
+      std::string with_whitespace = normal;
+      with_whitespace.insert(40, "\r\n");
+      cases.push_back(with_whitespace);
+      std::string with_padding = normal;
+      with_padding[37] = '=';
+      cases.push_back(with_padding);
+      std::string with_invalid = normal;
+      with_invalid[50] = '\xc3';
+      cases.push_back(with_invalid);
+      std::string with_mixed_block = normal;
+      with_mixed_block[1] = '-';
+      with_mixed_block[2] = '/';
+      cases.push_back(with_mixed_block);
+    }
+
+    for (const std::string& encoded : cases) {
+      const size_t full = node::base64_decoded_size(encoded.data(),
+                                                    encoded.size());
+      // Too small destinations must not be overrun, either.
+      for (size_t dstlen : { full, full / 2, full > 0 ? full - 1 : 0 }) {
+        EXPECT_EQ(DecodeReference(encoded, dstlen), Decode(encoded, dstlen))
+            << "size " << size << ", dstlen " << dstlen;
+      }
+    }
+    EXPECT_EQ(input, Decode(normal, input.size()));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Features,
+                         Base64SIMDTest,
+                         ::testing::Values(~0u, node::simd::kSSE41, 0u));
@@ -0,0 +1,73 @@
+#include "dictionary_trainer.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::DictionarySample;
+using node::TrainDictionary;
+
+// JSON documents that share their structure, but not their values.
+static std::vector<std::string> MakeSamples(size_t count) {
+  std::vector<std::string> samples;
+  uint32_t seed = 1;
+  for (size_t i = 0; i < count; i++) {
+    std::string sample = "{\"items\":[";
+    for (int j = 0; j < 5; j++) {
+      seed = seed * 1103515245 + 12345;
+      sample += "{\"identifier\":" + std::to_string(seed % 100000) +
+                ",\"description\":\"value " + std::to_string(seed % 977) +
+                "\",\"created_at\":\"2021-0" + std::to_string(seed % 9 + 1) +
+                "\",\"enabled\":true},";
+    }
+    sample += "null]}";
+    samples.push_back(sample);
+  }
+  return samples;
+}
+
+static std::vector<DictionarySample> ToSamples(
+    const std::vector<std::string>& strings) {
+  std::vector<DictionarySample> samples;
+  for (const std::string& string : strings) {
+    samples.push_back({
+        reinterpret_cast<const unsigned char*>(string.data()), string.size()});
+  }
+  return samples;
+}
+
+TEST(DictionaryTrainerTest, CommonSubstrings) {
+  const std::vector<std::string> strings = MakeSamples(200);
+  const std::vector<unsigned char> dictionary =
+      TrainDictionary(ToSamples(strings), 4096);
+  ASSERT_GE(dictionary.size(), 256u);
+  EXPECT_LE(dictionary.size(), 4096u);
+
+  // The most valuable segment goes last.
+  const std::string text(dictionary.end() - 256, dictionary.end());
+  for (const char* common : { "\"identifier\":", "\"description\":\"value ",
+                              "\",\"created_at\":\"2021-0",
+                              "\",\"enabled\":true}," }) {
+    EXPECT_NE(text.find(common), std::string::npos) << common;
+  }
+
+  EXPECT_EQ(TrainDictionary(ToSamples(strings), 4096), dictionary);
+}
+
+TEST(DictionaryTrainerTest, Size) {
+  const std::vector<std::string> strings = MakeSamples(500);
+  for (size_t size : { 0, 1, 100, 256, 1000, 32768 }) {
+    EXPECT_LE(TrainDictionary(ToSamples(strings), size).size(), size);
+  }
+}
+
+TEST(DictionaryTrainerTest, NothingInCommon) {
+  EXPECT_TRUE(TrainDictionary({}, 1024).empty());
+
+  std::vector<std::string> strings;
+  for (int i = 0; i < 100; i++)
+    strings.push_back(std::string(300, static_cast<char>(i)));
+  // Every sample only repeats itself.
+  EXPECT_TRUE(TrainDictionary(ToSamples(strings), 1024).empty());
+}
@@ -0,0 +1,121 @@
+#include "hex.h"
+#include "node_simd.h"
+
+#include <cstddef>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using node::hex_decode_simd;
+using node::hex_encode_simd;
+
+// Every test runs once with each set of CPU features. Without any, the
+// functions are expected to leave all of the work to the scalar code.
+class HexTest : public ::testing::TestWithParam<uint32_t> {
+ protected:
+  void SetUp() override {
+    previous_mask_ = node::simd::SetFeatureMaskForTesting(GetParam());
+  }
+
+  void TearDown() override {
+    node::simd::SetFeatureMaskForTesting(previous_mask_);
+  }
+
+ private:
+  uint32_t previous_mask_;
+};
+
+static std::string ToHex(const std::string& data) {
+  static const char digits[] = "0123456789abcdef";
+  std::string result;
+  for (unsigned char c : data) {
+    result += digits[c >> 4];
+    result += digits[c & 15];
+  }
+  return result;
+}
+
+static std::string Bytes(size_t size) {
+  std::string result;
+  for (size_t i = 0; i < size; i++)
+    result += static_cast<char>(i * 37 + 11);
+  return result;
+}
+
+TEST_P(HexTest, Encode) {
+  for (size_t size = 0; size < 200; size++) {
+    const std::string input = Bytes(size);
+    const std::string expected = ToHex(input);
+    std::string output(2 * size, '\0');
+    const size_t encoded = hex_encode_simd(input.data(), size, &output[0]);
+    ASSERT_LE(encoded, size);
+    if (GetParam() == 0) {
+      EXPECT_EQ(0u, encoded);
+    } else {
+      EXPECT_LT(size - encoded, 16u);
+    }
+    EXPECT_EQ(expected.substr(0, 2 * encoded), output.substr(0, 2 * encoded));
+  }
+}
+
+TEST_P(HexTest, Decode) {
+  for (size_t size = 0; size < 150; size++) {
+    const std::string expected = Bytes(size);
+    std::string input = ToHex(expected);
+    // Mix upper- and lowercase digits.
+    for (size_t i = 0; i < input.size(); i += 3)
+      input[i] = toupper(input[i]);
+    std::string output(size, '\0');
+    size_t decoded = hex_decode_simd(
+        &output[0], size,
+        reinterpret_cast<const uint8_t*>(input.data()), input.size());
+    ASSERT_LE(decoded, size);
+    if (GetParam() != 0) {
+      EXPECT_LT(size - decoded, 16u);
+    }
+    EXPECT_EQ(expected.substr(0, decoded), output.substr(0, decoded));
+
+    // A smaller output buffer is never overrun.
+    const size_t half = size / 2;
+    std::string small(half + 1, '\x55');
+    decoded = hex_decode_simd(
+        &small[0], half,
+        reinterpret_cast<const uint8_t*>(input.data()), input.size());
+    ASSERT_LE(decoded, half);
+    EXPECT_EQ('\x55', small[half]);
+    EXPECT_EQ(expected.substr(0, decoded), small.substr(0, decoded));
+  }
+}
+
+TEST_P(HexTest, DecodeStopsBeforeInvalidCharacters) {
+  const std::string expected = Bytes(100);
+  const std::string valid = ToHex(expected);
+  for (const char bad : { 'g', 'G', '/', ':', '@', '`', ' ', '\0', '\x80',
+                          '\xb0', '\xc1' }) {
+    for (size_t pos = 0; pos < valid.size(); pos++) {
+      std::string input = valid;
+      input[pos] = bad;
+      std::string output(expected.size(), '\0');
+      const size_t decoded = hex_decode_simd(
+          &output[0], output.size(),
+          reinterpret_cast<const uint8_t*>(input.data()), input.size());
+      EXPECT_LE(2 * decoded, pos) << "position " << pos;
+      EXPECT_EQ(expected.substr(0, decoded), output.substr(0, decoded));
+    }
+  }
+}
+
+TEST_P(HexTest, DecodeOddLength) {
+  const std::string expected = Bytes(64);
+  const std::string input = ToHex(expected) + "a";
+  std::string output(expected.size() + 1, '\0');
+  const size_t decoded = hex_decode_simd(
+      &output[0], output.size(),
+      reinterpret_cast<const uint8_t*>(input.data()), input.size());
+  EXPECT_LE(decoded, expected.size());
+  EXPECT_EQ(expected.substr(0, decoded), output.substr(0, decoded));
+}
+
+INSTANTIATE_TEST_SUITE_P(Features,
+                         HexTest,
+                         ::testing::Values(~0u, node::simd::kSSE41, 0u));
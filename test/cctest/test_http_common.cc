@@ -0,0 +1,57 @@
+#include "env-inl.h"
+#include "node_http_common.h"
+#include "node_test_fixture.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+
+using node::GetKnownHeaderName;
+using node::LookupKnownHeader;
+using v8::Local;
+using v8::String;
+
+static node::http_known_headers Lookup(const std::string& name) {
+  return LookupKnownHeader(name.data(), name.size());
+}
+
+TEST(HttpCommonTest, LookupKnownHeader) {
+#define V(name, value)                                                        \
+  EXPECT_EQ(Lookup(value), node::HTTP_HEADER_##name);
+  HTTP_KNOWN_HEADERS(V)
+#undef V
+
+  EXPECT_EQ(Lookup("Content-Type"), node::HTTP_HEADER_CONTENT_TYPE);
+  EXPECT_EQ(Lookup("USER-AGENT"), node::HTTP_HEADER_USER_AGENT);
+  EXPECT_EQ(Lookup(""), node::HTTP_KNOWN_HEADER_MAX);
+  EXPECT_EQ(Lookup("content-typ"), node::HTTP_KNOWN_HEADER_MAX);
+  EXPECT_EQ(Lookup("content-types"), node::HTTP_KNOWN_HEADER_MAX);
+  EXPECT_EQ(Lookup("x-custom-header"), node::HTTP_KNOWN_HEADER_MAX);
+}
+
+class HttpCommonEnvTest : public EnvironmentTestFixture {};
+
+TEST_F(HttpCommonEnvTest, GetKnownHeaderName) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+
+  auto get = [&](const char* name) {
+    return GetKnownHeaderName(*env, name, strlen(name));
+  };
+
+  Local<String> lowercase = get("content-type");
+  ASSERT_FALSE(lowercase.IsEmpty());
+  EXPECT_EQ(lowercase, get("content-type"));
+
+  Local<String> capitalized = get("Content-Type");
+  ASSERT_FALSE(capitalized.IsEmpty());
+  EXPECT_NE(lowercase, capitalized);
+  EXPECT_EQ(capitalized, get("Content-Type"));
+  EXPECT_EQ(std::string(*String::Utf8Value(isolate_, capitalized)),
+            "Content-Type");
+
+  // Other spellings keep their case, so no shared string is returned.
+  EXPECT_TRUE(get("CONTENT-TYPE").IsEmpty());
+  EXPECT_TRUE(get("x-custom-header").IsEmpty());
+}
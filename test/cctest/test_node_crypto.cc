@@ -2,8 +2,12 @@
 // and settting it to a file that does not exist.
 #define NODE_OPENSSL_SYSTEM_CERT_PATH "/missing/ca.pem"
 
+#include "crypto/crypto_bio.h"
 #include "crypto/crypto_context.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
 #include "node_options.h"
+#include "node_test_fixture.h"
 #include "openssl/err.h"
 #include "gtest/gtest.h"
 
@@ -21,3 +25,25 @@ TEST(NodeCrypto, NewRootCertStore) {
                                       "any errors on the OpenSSL error stack\n";
   X509_STORE_free(store);
 }
+
+class NodeBIOPoolTest : public EnvironmentTestFixture {};
+
+// A NodeBIO that is freed after its Environment gives its chunks back to the
+// detached pool instead of using the destroyed Environment.
+TEST_F(NodeBIOPoolTest, NodeBIOOutlivesEnvironment) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Argv argv;
+  node::crypto::BIOPointer bio;
+  std::shared_ptr<node::crypto::NodeBIOPool> pool;
+  {
+    Env env{handle_scope, argv};
+    bio = node::crypto::NodeBIO::New(*env);
+    ASSERT_EQ(BIO_write(bio.get(), "hello", 5), 5);
+    pool = (*env)->nodebio_pool();
+    EXPECT_NE(pool->in_use_bytes(), 0u);
+  }
+  EXPECT_EQ(pool->pooled_bytes(), 0u);
+  bio.reset();
+  EXPECT_EQ(pool->in_use_bytes(), 0u);
+  EXPECT_EQ(pool->pooled_bytes(), 0u);
+}
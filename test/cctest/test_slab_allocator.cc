@@ -0,0 +1,138 @@
+#include "slab_allocator.h"
+#include "env-inl.h"
+#include "node_test_fixture.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+using node::SlabAllocator;
+using v8::ArrayBuffer;
+using v8::Local;
+
+class SlabAllocatorTest : public EnvironmentTestFixture {};
+
+TEST_F(SlabAllocatorTest, PacksConsecutiveReads) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+  SlabAllocator allocator(*env, 1024 * 1024);
+
+  uv_buf_t first = allocator.Allocate(65536);
+  EXPECT_EQ(first.len, 65536u);
+  size_t first_offset;
+  Local<ArrayBuffer> first_ab = allocator.Commit(first, 5001, &first_offset);
+  EXPECT_EQ(first_offset, 0u);
+
+  // The unused part of the first reservation is handed out again, aligned
+  // to 8 bytes.
+  uv_buf_t second = allocator.Allocate(65536);
+  EXPECT_EQ(second.base, first.base + 5008);
+  size_t second_offset;
+  Local<ArrayBuffer> second_ab = allocator.Commit(second, 5000, &second_offset);
+  EXPECT_EQ(second_offset, 5008u);
+  EXPECT_EQ(first_ab, second_ab);
+
+  // Released reservations are reused entirely.
+  uv_buf_t third = allocator.Allocate(65536);
+  allocator.Release(third);
+  uv_buf_t fourth = allocator.Allocate(65536);
+  EXPECT_EQ(third.base, fourth.base);
+  allocator.Release(fourth);
+}
+
+TEST_F(SlabAllocatorTest, CopiesSmallReads) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+  SlabAllocator allocator(*env, 1024 * 1024);
+
+  uv_buf_t first = allocator.Allocate(65536);
+  memcpy(first.base, "hello", 5);
+  size_t offset;
+  Local<ArrayBuffer> ab = allocator.Commit(first, 5, &offset);
+  EXPECT_EQ(offset, 0u);
+  EXPECT_EQ(ab->ByteLength(), 5u);
+  EXPECT_NE(ab->GetBackingStore()->Data(), first.base);
+  EXPECT_EQ(memcmp(ab->GetBackingStore()->Data(), "hello", 5), 0);
+
+  // The whole reservation is given back.
+  uv_buf_t second = allocator.Allocate(65536);
+  EXPECT_EQ(second.base, first.base);
+  Local<ArrayBuffer> large_ab =
+      allocator.Commit(second, SlabAllocator::kMaxCopySize + 1, &offset);
+  EXPECT_EQ(offset, 0u);
+  EXPECT_EQ(large_ab->ByteLength(), 1024u * 1024u);
+}
+
+TEST_F(SlabAllocatorTest, InterleavedReservations) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+  SlabAllocator allocator(*env, 1024 * 1024);
+
+  uv_buf_t a = allocator.Allocate(10000);
+  uv_buf_t b = allocator.Allocate(10000);
+  EXPECT_EQ(b.base, a.base + 10000);
+
+  // `a` is not the most recent reservation, so its tail stays in use.
+  size_t offset;
+  allocator.Commit(a, 5000, &offset);
+  EXPECT_EQ(offset, 0u);
+  allocator.Commit(b, 5000, &offset);
+  EXPECT_EQ(offset, 10000u);
+
+  uv_buf_t c = allocator.Allocate(10000);
+  EXPECT_EQ(c.base, b.base + 5000);
+  allocator.Release(c);
+}
+
+TEST_F(SlabAllocatorTest, StartsNewSlabs) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+  SlabAllocator allocator(*env, 16384);
+
+  // `pending` is still reserved when its slab is replaced.
+  uv_buf_t pending = allocator.Allocate(12000);
+  uv_buf_t next = allocator.Allocate(12000);
+  EXPECT_NE(next.base, pending.base + 12000);
+
+  size_t offset;
+  Local<ArrayBuffer> next_ab = allocator.Commit(next, 12000, &offset);
+  EXPECT_EQ(offset, 0u);
+  EXPECT_EQ(next_ab->ByteLength(), 16384u);
+  Local<ArrayBuffer> pending_ab = allocator.Commit(pending, 5000, &offset);
+  EXPECT_EQ(offset, 0u);
+  EXPECT_NE(pending_ab, next_ab);
+  EXPECT_EQ(pending_ab->GetBackingStore()->Data(), pending.base);
+
+  // Reservations larger than a slab get a slab of their own.
+  uv_buf_t large = allocator.Allocate(40000);
+  EXPECT_EQ(large.len, 40000u);
+  Local<ArrayBuffer> large_ab = allocator.Commit(large, 40000, &offset);
+  EXPECT_EQ(offset, 0u);
+  EXPECT_EQ(large_ab->ByteLength(), 40000u);
+}
+
+TEST_F(SlabAllocatorTest, Reclaim) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+  SlabAllocator allocator(*env, 1024 * 1024);
+
+  uv_buf_t first = allocator.Allocate(65536);
+  size_t offset;
+  Local<ArrayBuffer> first_ab = allocator.Commit(first, 5000, &offset);
+
+  // Reads after a reclaim go into a new slab.
+  allocator.Reclaim();
+  uv_buf_t second = allocator.Allocate(65536);
+  EXPECT_NE(second.base, first.base + 5000);
+
+  // A reservation that is pending during a reclaim can still be committed.
+  allocator.Reclaim();
+  Local<ArrayBuffer> second_ab = allocator.Commit(second, 5000, &offset);
+  EXPECT_EQ(offset, 0u);
+  EXPECT_NE(first_ab, second_ab);
+  EXPECT_EQ(second_ab->GetBackingStore()->Data(), second.base);
+}
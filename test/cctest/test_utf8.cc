@@ -0,0 +1,272 @@
+#include "node_simd.h"
+#include "node_utf8.h"
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::utf8::FromLatin1;
+using node::utf8::FromUtf16;
+using node::utf8::IsAscii;
+using node::utf8::IsLatin1;
+using node::utf8::IsValid;
+using node::utf8::LengthFromLatin1;
+using node::utf8::LengthFromUtf16;
+using node::utf8::StripHighBits;
+using node::utf8::ToLatin1;
+using node::utf8::ToUtf16;
+using node::utf8::Utf16Length;
+
+// Every test runs once with each set of CPU features, so that the vector and
+// the scalar code paths are held to the same expectations.
+class Utf8Test : public ::testing::TestWithParam<uint32_t> {
+ protected:
+  void SetUp() override {
+    previous_mask_ = node::simd::SetFeatureMaskForTesting(GetParam());
+  }
+
+  void TearDown() override {
+    node::simd::SetFeatureMaskForTesting(previous_mask_);
+  }
+
+ private:
+  uint32_t previous_mask_;
+};
+
+static std::string Repeat(const std::string& str, size_t count) {
+  std::string result;
+  for (size_t i = 0; i < count; i++)
+    result += str;
+  return result;
+}
+
+TEST_P(Utf8Test, IsAscii) {
+  for (size_t size = 0; size < 200; size++) {
+    std::string str(size, 'a');
+    EXPECT_TRUE(IsAscii(str.data(), str.size()));
+    for (size_t i = 0; i < size; i++) {
+      str[i] = '\x80';
+      EXPECT_FALSE(IsAscii(str.data(), str.size()));
+      str[i] = 'a';
+    }
+  }
+}
+
+TEST_P(Utf8Test, IsValid) {
+  const char* valid[] = {
+    "", "a", "\x7f", "\xc2\x80", "\xdf\xbf", "\xe0\xa0\x80", "\xed\x9f\xbf",
+    "\xee\x80\x80", "\xef\xbf\xbf", "\xf0\x90\x80\x80", "\xf4\x8f\xbf\xbf",
+    "\xe2\x82\xac \xf0\x9f\x98\x80 \xc3\xa9",
+  };
+  const char* invalid[] = {
+    "\x80", "\xbf", "\xc0\x80", "\xc1\xbf", "\xc2", "\xc2\x41", "\xe0\x80\x80",
+    "\xe0\x9f\xbf", "\xed\xa0\x80", "\xed\xbf\xbf", "\xe2\x82", "\xe2\x82\x41",
+    "\xf0\x80\x80\x80", "\xf0\x8f\xbf\xbf", "\xf4\x90\x80\x80",
+    "\xf5\x80\x80\x80", "\xf8\x88\x80\x80\x80", "\xff", "\xfe",
+    "\xf0\x9f\x98", "\xc2\x80\x80",
+  };
+
+  // Put every sequence at every offset of blocks of different sizes, so
+  // that it is checked both within a vector and across two of them.
+  for (size_t prefix = 0; prefix < 70; prefix++) {
+    for (size_t suffix : { 0, 1, 30, 64 }) {
+      const std::string before(prefix, 'x');
+      const std::string after(suffix, 'y');
+      for (const char* seq : valid) {
+        const std::string str = before + seq + after;
+        EXPECT_TRUE(IsValid(str.data(), str.size()))
+            << "prefix " << prefix << ", suffix " << suffix;
+      }
+      for (const char* seq : invalid) {
+        const std::string str = before + seq + after;
+        EXPECT_FALSE(IsValid(str.data(), str.size()))
+            << "prefix " << prefix << ", suffix " << suffix;
+      }
+    }
+  }
+
+  const std::string long_valid =
+      Repeat("\xe2\x82\xac\xf0\x9f\x98\x80" "ab", 100);
+  EXPECT_TRUE(IsValid(long_valid.data(), long_valid.size()));
+  for (size_t cut = 1; cut < 9; cut++) {
+    EXPECT_EQ(cut == 3 || cut == 7 || cut == 8,
+              IsValid(long_valid.data(), long_valid.size() - 9 + cut));
+  }
+}
+
+TEST_P(Utf8Test, IsValidMatchesScalar) {
+  // Random byte sequences, most of them invalid somewhere.
+  uint32_t seed = 1;
+  for (size_t size = 1; size < 300; size++) {
+    std::string str(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+      seed = seed * 1103515245 + 12345;
+      // Mostly ASCII with a few high bytes, to get some valid strings too.
+      const uint8_t byte = seed >> 16;
+      str[i] = (seed >> 28) == 0 ? byte : (byte & 0x7f);
+    }
+    const bool actual = IsValid(str.data(), str.size());
+    const uint32_t mask = node::simd::SetFeatureMaskForTesting(0);
+    const bool expected = IsValid(str.data(), str.size());
+    node::simd::SetFeatureMaskForTesting(mask);
+    EXPECT_EQ(expected, actual) << "size " << size;
+  }
+}
+
+TEST_P(Utf8Test, StripHighBits) {
+  std::string input;
+  for (int i = 0; i < 300; i++)
+    input += static_cast<char>(i);
+  std::string output(input.size(), '\0');
+  StripHighBits(input.data(), &output[0], input.size());
+  for (size_t i = 0; i < input.size(); i++)
+    EXPECT_EQ(input[i] & 0x7f, output[i]);
+}
+
+TEST_P(Utf8Test, ToUtf16) {
+  const std::string pieces[] = {
+    "hello world, ", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+  };
+  const std::vector<uint16_t> expected_pieces[] = {
+    { 'h', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd', ',', ' ' },
+    { 0xe9 }, { 0x20ac }, { 0xd83d, 0xde00 },
+  };
+
+  std::string input;
+  std::vector<uint16_t> expected;
+  for (size_t i = 0; i < 500; i++) {
+    const size_t piece = (i * 7) % 4;
+    input += pieces[piece];
+    expected.insert(expected.end(),
+                    expected_pieces[piece].begin(),
+                    expected_pieces[piece].end());
+
+    ASSERT_EQ(expected.size(), Utf16Length(input.data(), input.size()));
+    std::vector<uint16_t> output(expected.size());
+    EXPECT_EQ(expected.size(),
+              ToUtf16(input.data(), input.size(), output.data()));
+    EXPECT_EQ(expected, output);
+  }
+}
+
+TEST_P(Utf8Test, ToLatin1) {
+  std::string input;
+  std::string expected;
+  for (size_t i = 0; i < 700; i++) {
+    const unsigned char c = (i * 37) % 256;
+    if (c < 0x80) {
+      input += static_cast<char>(c);
+    } else {
+      input += static_cast<char>(0xc0 | (c >> 6));
+      input += static_cast<char>(0x80 | (c & 0x3f));
+    }
+    expected += static_cast<char>(c);
+
+    ASSERT_TRUE(IsLatin1(input.data(), input.size()));
+    ASSERT_EQ(expected.size(), Utf16Length(input.data(), input.size()));
+    std::string output(expected.size(), '\0');
+    EXPECT_EQ(expected.size(),
+              ToLatin1(input.data(), input.size(), &output[0]));
+    EXPECT_EQ(expected, output);
+  }
+
+  // Any character above U+00FF, at any offset, rules out Latin-1.
+  for (const char* seq : { "\xc4\x80", "\xe2\x82\xac", "\xf0\x9f\x98\x80" }) {
+    for (size_t prefix = 0; prefix < 70; prefix++) {
+      const std::string str =
+          Repeat("\xc3\xa9", prefix / 2) + std::string(prefix % 2, 'x') +
+          seq + "y";
+      EXPECT_FALSE(IsLatin1(str.data(), str.size())) << "prefix " << prefix;
+    }
+  }
+}
+
+TEST_P(Utf8Test, FromLatin1) {
+  std::vector<uint8_t> input;
+  for (int i = 0; i < 700; i++)
+    input.push_back(i % 3 == 0 ? 0xe9 : 'a' + i % 26);
+  input.insert(input.end(), 100, 'z');
+
+  std::string expected;
+  for (uint8_t c : input) {
+    if (c < 0x80) {
+      expected += static_cast<char>(c);
+    } else {
+      expected += static_cast<char>(0xc0 | (c >> 6));
+      expected += static_cast<char>(0x80 | (c & 0x3f));
+    }
+  }
+  EXPECT_EQ(expected.size(), LengthFromLatin1(input.data(), input.size()));
+
+  // Output buffers of every size, so that each character is the one that
+  // does not fit at some point.
+  for (size_t dst_length = 0; dst_length <= expected.size(); dst_length++) {
+    std::string output(dst_length, '\0');
+    size_t read;
+    const size_t written =
+        FromLatin1(input.data(), input.size(), &output[0], dst_length, &read);
+    EXPECT_TRUE(written == dst_length || written + 1 == dst_length);
+    EXPECT_EQ(expected.substr(0, written), output.substr(0, written));
+    EXPECT_EQ(written, LengthFromLatin1(input.data(), read));
+  }
+}
+
+TEST_P(Utf8Test, FromUtf16) {
+  std::vector<uint16_t> input;
+  for (int i = 0; i < 200; i++) {
+    input.insert(input.end(), 20, 'a' + i % 26);
+    switch (i % 6) {
+      case 0: input.push_back(0xe9); break;
+      case 1: input.push_back(0x20ac); break;
+      case 2: input.push_back(0xd83d); input.push_back(0xde00); break;
+      case 3: input.push_back(0xd83d); break;  // Unpaired lead surrogate.
+      case 4: input.push_back(0xde00); break;  // Unpaired trail surrogate.
+      default: break;
+    }
+  }
+  input.push_back(0xd83d);  // Unpaired lead surrogate at the end.
+
+  std::string expected;
+  for (size_t i = 0; i < input.size(); i++) {
+    uint32_t c = input[i];
+    if (c >= 0xd800 && c <= 0xdbff && i + 1 < input.size() &&
+        input[i + 1] >= 0xdc00 && input[i + 1] <= 0xdfff) {
+      c = 0x10000 + ((c - 0xd800) << 10) + (input[++i] - 0xdc00);
+    } else if (c >= 0xd800 && c <= 0xdfff) {
+      c = 0xfffd;
+    }
+    if (c < 0x80) {
+      expected += static_cast<char>(c);
+    } else if (c < 0x800) {
+      expected += static_cast<char>(0xc0 | (c >> 6));
+      expected += static_cast<char>(0x80 | (c & 0x3f));
+    } else if (c < 0x10000) {
+      expected += static_cast<char>(0xe0 | (c >> 12));
+      expected += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      expected += static_cast<char>(0x80 | (c & 0x3f));
+    } else {
+      expected += static_cast<char>(0xf0 | (c >> 18));
+      expected += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+      expected += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      expected += static_cast<char>(0x80 | (c & 0x3f));
+    }
+  }
+  EXPECT_EQ(expected.size(), LengthFromUtf16(input.data(), input.size()));
+
+  for (size_t dst_length = 0; dst_length <= expected.size(); dst_length++) {
+    std::string output(dst_length, '\0');
+    size_t read;
+    const size_t written =
+        FromUtf16(input.data(), input.size(), &output[0], dst_length, &read);
+    EXPECT_LE(dst_length - written, 3u);
+    EXPECT_EQ(expected.substr(0, written), output.substr(0, written));
+    EXPECT_EQ(written, LengthFromUtf16(input.data(), read));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Features,
+                         Utf8Test,
+                         ::testing::Values(~0u, node::simd::kSSE41, 0u));
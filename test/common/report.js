@@ -58,7 +58,8 @@ function _validateContent(report, fields = []) {
   // Verify that all sections are present as own properties of the report.
   const sections = ['header', 'javascriptStack', 'nativeStack',
                     'javascriptHeap', 'libuv', 'environmentVariables',
-                    'sharedObjects', 'resourceUsage', 'workers'];
+                    'sharedObjects', 'resourceUsage', 'tlsBufferPool',
+                    'workers'];
   if (!isWindows)
     sections.push('userLimits');
 
@@ -241,6 +242,12 @@ function _validateContent(report, fields = []) {
     assert(Number.isSafeInteger(usage.fsActivity.writes));
   }
 
+  // Verify the format of the tlsBufferPool section.
+  const tlsBufferPool = report.tlsBufferPool;
+  checkForUnknownFields(tlsBufferPool, ['inUseBytes', 'pooledBytes']);
+  assert(Number.isSafeInteger(tlsBufferPool.inUseBytes));
+  assert(Number.isSafeInteger(tlsBufferPool.pooledBytes));
+
   // Verify the format of the libuv section.
   assert(Array.isArray(report.libuv));
   report.libuv.forEach((resource) => {
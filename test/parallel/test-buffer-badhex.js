@@ -46,3 +46,36 @@ const assert = require('assert');
   const badHex = `${hex.slice(0, 256)}xx${hex.slice(256, 510)}`;
   assert.deepStrictEqual(Buffer.from(badHex, 'hex'), buf.slice(0, 128));
 }
+
+// Inputs long enough to be handled by vector code, with the first invalid
+// character at every offset of a few blocks.
+{
+  const buf = Buffer.alloc(300);
+  for (let i = 0; i < buf.length; i++)
+    buf[i] = (i * 37 + 11) & 0xff;
+
+  const hex = buf.toString('hex');
+  assert.strictEqual(hex, Array.from(buf, (byte) => {
+    return byte.toString(16).padStart(2, '0');
+  }).join(''));
+  assert.deepStrictEqual(Buffer.from(hex.toUpperCase(), 'hex'), buf);
+
+  for (const bad of ['g', 'G', '/', ':', '@', '`', ' ', '\u0080', '€']) {
+    for (let pos = 0; pos < 200; pos++) {
+      const badHex = `${hex.slice(0, pos)}${bad}${hex.slice(pos + 1)}`;
+      const expected = buf.slice(0, pos >>> 1);
+      assert.deepStrictEqual(Buffer.from(badHex, 'hex'), expected);
+
+      const target = Buffer.alloc(buf.length);
+      assert.strictEqual(target.write(badHex, 'hex'), expected.length);
+      assert.deepStrictEqual(target.slice(0, expected.length), expected);
+    }
+  }
+
+  // A trailing odd digit is ignored.
+  assert.deepStrictEqual(Buffer.from(`${hex}a`, 'hex'), buf);
+  // Writing stops when the target is full.
+  const target = Buffer.alloc(100);
+  assert.strictEqual(target.write(hex, 'hex'), 100);
+  assert.deepStrictEqual(target, buf.slice(0, 100));
+}
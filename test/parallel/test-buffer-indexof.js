@@ -621,3 +621,26 @@ assert.strictEqual(reallyLong.lastIndexOf(pattern), 0);
              'Received an instance of lastIndexOf'
   });
 }
+
+// Short needles at every position around the block boundaries of the vector
+// search, including near misses that only match the first and last byte.
+{
+  const haystack = Buffer.alloc(100, 'x');
+  for (let length = 2; length <= 17; length++) {
+    const needle = Buffer.alloc(length, 'a');
+    needle[length - 1] = 0x62;
+    const nearMiss = Buffer.from(needle);
+    nearMiss[length >> 1] = 0x78;
+    for (let pos = 0; pos + length <= haystack.length; pos++) {
+      const buf = Buffer.from(haystack);
+      if (length > 2 && pos >= length)
+        nearMiss.copy(buf, pos - length);
+      needle.copy(buf, pos);
+      assert.strictEqual(buf.indexOf(needle), pos);
+      assert.strictEqual(buf.indexOf(needle.toString()), pos);
+      assert.strictEqual(buf.indexOf(needle, pos), pos);
+      assert.strictEqual(buf.indexOf(needle, pos + 1), -1);
+      assert.strictEqual(buf.subarray(0, pos + length - 1).indexOf(needle), -1);
+    }
+  }
+}
@@ -0,0 +1,77 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+
+const buf = Buffer.from('GET /index.html HTTP/1.1\r\nHost: a\r\n\r\nbody');
+
+assert.strictEqual(buf.indexOfAny(['\r\n', ' ']), 3);
+assert.strictEqual(buf.indexOfAny(['\r\n', ' '], 4), 15);
+assert.strictEqual(buf.indexOfAny(['\r\n', ' '], 16), 24);
+assert.strictEqual(buf.indexOfAny(['\r\n\r\n', ':']), 30);
+assert.strictEqual(buf.indexOfAny(['\r\n\r\n'], 31), 33);
+assert.strictEqual(buf.indexOfAny(['\r\n\r\n', 'body']), 33);
+assert.strictEqual(buf.indexOfAny(['nope', 'never']), -1);
+assert.strictEqual(buf.indexOfAny([]), -1);
+assert.strictEqual(buf.indexOfAny(['body'], -4), buf.length - 4);
+assert.strictEqual(buf.indexOfAny(['body'], -3), -1);
+assert.strictEqual(buf.indexOfAny(['body'], 1000), -1);
+assert.strictEqual(buf.indexOfAny(['body'], {}), buf.length - 4);
+
+// Numbers, Buffers and Uint8Arrays can be mixed with strings.
+assert.strictEqual(buf.indexOfAny([0x2f, 'HTTP']), 4);
+assert.strictEqual(buf.indexOfAny([0x2f + 256, 'HTTP']), 4);
+assert.strictEqual(buf.indexOfAny([Buffer.from('Host'), 0x0a]), 25);
+assert.strictEqual(buf.indexOfAny([new Uint8Array([0x31, 0x2e])]), 21);
+
+// Strings are encoded with the given encoding.
+assert.strictEqual(buf.indexOfAny(['486f7374'], 'hex'), 26);
+assert.strictEqual(buf.indexOfAny(['486f7374'], 0, 'hex'), 26);
+assert.strictEqual(buf.indexOfAny(['SG9zdA=='], 0, 'base64'), 26);
+assert.strictEqual(
+  Buffer.from('aé€', 'utf16le').indexOfAny(['€', 'é'], 'utf16le'), 2);
+
+// An empty value matches at the offset, like with indexOf().
+assert.strictEqual(buf.indexOfAny(['nope', '']), 0);
+assert.strictEqual(buf.indexOfAny(['nope', ''], 7), 7);
+assert.strictEqual(buf.indexOfAny([Buffer.alloc(0)], 1000), buf.length);
+
+// Many values with the same first bytes, and more distinct first bytes than
+// the vector search can tell apart, at every position of a longer buffer.
+{
+  const values = [];
+  for (let i = 0; i < 20; i++)
+    values.push(`${String.fromCharCode(0x41 + i)}${i}${i % 3 ? '!' : '?'}`);
+  values.push('@@', '@a', 'x');
+  const haystack = Buffer.alloc(150, '-');
+  for (const value of values) {
+    for (let pos = 0; pos + value.length <= haystack.length; pos++) {
+      const copy = Buffer.from(haystack);
+      copy.write(value, pos, 'latin1');
+      assert.strictEqual(copy.indexOfAny(values), pos);
+      assert.strictEqual(copy.indexOfAny(values, pos + 1), -1);
+      // A value cut short by the end of the buffer does not match.
+      if (value.length > 1) {
+        assert.strictEqual(
+          copy.subarray(0, pos + value.length - 1).indexOfAny(values), -1);
+      }
+    }
+  }
+}
+
+for (const values of [undefined, 'abc', { 0: 'a', length: 1 }]) {
+  assert.throws(() => buf.indexOfAny(values), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    name: 'TypeError'
+  });
+}
+
+assert.throws(() => buf.indexOfAny(['a', {}]), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError',
+  message: /^The "values\[1\]" argument must be/
+});
+
+assert.throws(() => buf.indexOfAny(['a'], 0, 'nope'), {
+  code: 'ERR_UNKNOWN_ENCODING',
+  name: 'TypeError'
+});
@@ -0,0 +1,85 @@
+'use strict';
+require('../common');
+
+// Tests buffer.isUtf8() and buffer.isAscii().
+
+const assert = require('assert');
+const { isAscii, isUtf8 } = require('buffer');
+
+const valid = [
+  '',
+  'hello',
+  'é',
+  '€',
+  '\u{1f600}',
+  'a'.repeat(100) + '\u{10ffff}',
+  '€'.repeat(1000),
+];
+
+const invalid = [
+  [0x80],
+  [0xc0, 0x80],
+  [0xc2],
+  [0xe0, 0x80, 0x80],
+  [0xed, 0xa0, 0x80],
+  [0xe2, 0x82],
+  [0xf0, 0x80, 0x80, 0x80],
+  [0xf4, 0x90, 0x80, 0x80],
+  [0xf8, 0x88, 0x80, 0x80, 0x80],
+  [0xff],
+];
+
+for (const str of valid) {
+  const buf = Buffer.from(str);
+  assert.strictEqual(isUtf8(buf), true);
+  assert.strictEqual(isUtf8(new Uint8Array(buf)), true);
+  assert.strictEqual(isUtf8(new Uint8Array(buf).buffer), true);
+  assert.strictEqual(isAscii(buf), /^[\x00-\x7f]*$/.test(str));
+}
+
+for (const bytes of invalid) {
+  // Also at different offsets within longer input.
+  for (const prefix of [0, 15, 31, 63]) {
+    const buf = Buffer.concat([Buffer.alloc(prefix, 'a'),
+                               Buffer.from(bytes),
+                               Buffer.alloc(10, 'b')]);
+    assert.strictEqual(isUtf8(buf), false);
+    assert.strictEqual(isAscii(buf), false);
+  }
+}
+
+// Views only cover their own range of the underlying memory.
+const buf = Buffer.from([0x61, 0xe2, 0x82, 0xac, 0x80]);
+assert.strictEqual(isUtf8(buf.subarray(0, 4)), true);
+assert.strictEqual(isUtf8(buf.subarray(0, 3)), false);
+assert.strictEqual(isUtf8(buf), false);
+assert.strictEqual(isAscii(buf.subarray(0, 1)), true);
+assert.strictEqual(
+  isUtf8(new Uint16Array(new Uint8Array([0x61, 0xe2, 0x82, 0xac]).buffer)),
+  true);
+
+for (const input of ['hello', 1, null, undefined, {}, [0x61]]) {
+  assert.throws(() => isUtf8(input), { code: 'ERR_INVALID_ARG_TYPE' });
+  assert.throws(() => isAscii(input), { code: 'ERR_INVALID_ARG_TYPE' });
+}
+
+// Detached buffers throw instead of being treated as empty.
+{
+  const { port1 } = new MessageChannel();
+  const ab = new ArrayBuffer(8);
+  const views = [new Uint8Array(ab), new Uint16Array(ab), new DataView(ab)];
+  port1.postMessage(ab, [ab]);
+  port1.close();
+  for (const input of [ab, ...views]) {
+    assert.throws(() => isUtf8(input), { code: 'ERR_INVALID_STATE' });
+    assert.throws(() => isAscii(input), { code: 'ERR_INVALID_STATE' });
+  }
+}
+
+for (const input of [new Uint8Array(0),
+                     new ArrayBuffer(0),
+                     new DataView(new ArrayBuffer(0)),
+                     new SharedArrayBuffer(0)]) {
+  assert.strictEqual(isUtf8(input), true);
+  assert.strictEqual(isAscii(input), true);
+}
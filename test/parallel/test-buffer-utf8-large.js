@@ -0,0 +1,78 @@
+'use strict';
+const common = require('../common');
+
+// Large inputs take the fast paths for UTF-8 decoding and encoding, which
+// turn them into external strings and transcode those directly. Checks that
+// the results match those for small inputs, which V8 handles.
+
+const assert = require('assert');
+
+const size = 2 * 1024 * 1024;
+
+function check(str) {
+  const buf = Buffer.from(str);
+  assert.strictEqual(buf.length, Buffer.byteLength(str));
+
+  // Decoding, both into a new string and through TextDecoder.
+  const decoded = buf.toString();
+  assert.strictEqual(decoded, str);
+  assert.strictEqual(new TextDecoder().decode(buf), str);
+
+  // Encoding the decoded string, which may be external now.
+  assert.strictEqual(Buffer.byteLength(decoded), buf.length);
+  assert.deepStrictEqual(Buffer.from(decoded), buf);
+  assert.deepStrictEqual(Buffer.from(new TextEncoder().encode(decoded)), buf);
+
+  // Writing into a buffer that is too small must not split characters.
+  const small = Buffer.alloc(buf.length - 1);
+  const written = small.write(decoded);
+  assert(written >= buf.length - 4);
+  assert.deepStrictEqual(small.subarray(0, written), buf.subarray(0, written));
+  const { read, written: written2 } =
+    new TextEncoder().encodeInto(decoded, new Uint8Array(buf.length - 1));
+  assert.strictEqual(written2, written);
+  assert.strictEqual(Buffer.from(decoded.slice(0, read)).length, written);
+}
+
+check('x'.repeat(size));
+check('é'.repeat(size));
+// Latin-1 only, which becomes a one-byte string, and just beyond it.
+check('caf\xe9 \xff\x80 '.repeat(size / 8));
+check('\xff\u0100'.repeat(size / 2));
+check('hello € world \u{1f600} '.repeat(size / 20));
+// Mostly ASCII with a single multi-byte character at the end.
+check('a'.repeat(size) + '\u{10ffff}');
+
+// Invalid input is still decoded with replacement characters.
+{
+  const buf = Buffer.alloc(size, 'a');
+  buf[size / 2] = 0xff;
+  buf[size - 1] = 0xe2;
+  const expected =
+    'a'.repeat(size / 2) + '\ufffd' + 'a'.repeat(size / 2 - 2) + '\ufffd';
+  assert.strictEqual(buf.toString(), expected);
+  assert.strictEqual(new TextDecoder().decode(buf), expected);
+  assert.throws(() => new TextDecoder('utf-8', { fatal: true }).decode(buf), {
+    code: 'ERR_ENCODING_INVALID_ENCODED_DATA'
+  });
+}
+
+// Streaming decodes keep characters that are split across chunks intact,
+// as well as a byte order mark at the very beginning.
+if (common.hasIntl) {
+  const str = '\ufeff' + 'abc € \u{1f600} '.repeat(10000);
+  const buf = Buffer.from(str);
+  for (const chunkSize of [1, 7, 4096, 65536]) {
+    const decoder = new TextDecoder();
+    let result = '';
+    for (let i = 0; i < buf.length; i += chunkSize) {
+      const chunk = buf.subarray(i, i + chunkSize);
+      result += decoder.decode(chunk, { stream: true });
+    }
+    result += decoder.decode();
+    assert.strictEqual(result, str.slice(1));
+  }
+
+  const keepBOM = new TextDecoder('utf-8', { ignoreBOM: true });
+  assert.strictEqual(keepBOM.decode(buf), str);
+}
@@ -0,0 +1,87 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+const data = [
+  'hello world',
+  '',
+  Buffer.from('a buffer'),
+  new Uint16Array([1, 2, 3, 4]),
+  new DataView(new ArrayBuffer(7)),
+  new ArrayBuffer(3),
+  'ünïcödé',
+  Buffer.alloc(100000, 'x'),
+];
+
+function expected(algorithm, encoding, options) {
+  return data.map((input) => {
+    const hash = crypto.createHash(algorithm, options);
+    if (input instanceof ArrayBuffer)
+      hash.update(new Uint8Array(input));
+    else
+      hash.update(input);
+    return hash.digest(encoding);
+  });
+}
+
+for (const algorithm of ['sha256', 'SHA512', 'md5', 'sha1']) {
+  crypto.hashBatch(algorithm, data, common.mustSucceed((digests) => {
+    assert.deepStrictEqual(digests, expected(algorithm));
+  }));
+  crypto.hashBatch(algorithm, data, { encoding: 'hex' },
+                   common.mustSucceed((digests) => {
+                     assert.deepStrictEqual(digests,
+                                            expected(algorithm, 'hex'));
+                   }));
+}
+
+{
+  // Extendable-output functions take an output length.
+  const options = { outputLength: 64 };
+  crypto.hashBatch('shake256', data, options, common.mustSucceed((digests) => {
+    assert.deepStrictEqual(digests, expected('shake256', undefined, options));
+    assert.strictEqual(digests[0].length, 64);
+  }));
+  crypto.hashBatch('shake128', data, { outputLength: 0 },
+                   common.mustSucceed((digests) => {
+                     assert.strictEqual(digests.length, data.length);
+                     for (const digest of digests)
+                       assert.strictEqual(digest.length, 0);
+                   }));
+}
+
+crypto.hashBatch('sha256', [], common.mustSucceed((digests) => {
+  assert.deepStrictEqual(digests, []);
+}));
+
+{
+  // The inputs are copied before the call returns.
+  const input = Buffer.from('original');
+  const digest = crypto.createHash('sha256').update(input).digest();
+  crypto.hashBatch('sha256', [input], common.mustSucceed((digests) => {
+    assert.deepStrictEqual(digests, [digest]);
+  }));
+  input.fill(0);
+}
+
+assert.throws(() => crypto.hashBatch('not a hash', data, common.mustNotCall()),
+              { code: 'ERR_CRYPTO_INVALID_DIGEST' });
+assert.throws(() => crypto.hashBatch('sha256', data, { outputLength: 10 },
+                                     common.mustNotCall()),
+              { code: 'ERR_CRYPTO_INVALID_DIGEST' });
+assert.throws(() => crypto.hashBatch('sha256', data, { encoding: 'nope' },
+                                     common.mustNotCall()),
+              { code: 'ERR_UNKNOWN_ENCODING' });
+assert.throws(() => crypto.hashBatch('sha256', data, { outputLength: -1 },
+                                     common.mustNotCall()),
+              { code: 'ERR_OUT_OF_RANGE' });
+assert.throws(() => crypto.hashBatch('sha256', 'data', common.mustNotCall()),
+              { code: 'ERR_INVALID_ARG_TYPE' });
+assert.throws(() => crypto.hashBatch('sha256', ['a', 1], common.mustNotCall()),
+              { code: 'ERR_INVALID_ARG_TYPE', message: /"data\[1\]"/ });
+assert.throws(() => crypto.hashBatch('sha256', data),
+              { code: 'ERR_INVALID_CALLBACK' });
@@ -0,0 +1,29 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+// Datagrams that were read with a single recvmmsg() call must not share
+// memory with each other, or with data that is read later on.
+
+const kCount = 32;
+const socket = dgram.createSocket('udp4');
+const arrayBuffers = new Set();
+let received = 0;
+
+socket.on('message', common.mustCall((msg) => {
+  assert.strictEqual(msg.length, 100);
+  assert(msg.every((byte) => byte === msg[0]));
+  assert.strictEqual(msg.buffer.byteLength, msg.length);
+  assert(!arrayBuffers.has(msg.buffer));
+  arrayBuffers.add(msg.buffer);
+  if (++received === kCount)
+    socket.close();
+}, kCount));
+
+socket.bind(0, '127.0.0.1', common.mustCall(() => {
+  const messages = [];
+  for (let i = 0; i < kCount; i++)
+    messages.push(Buffer.alloc(100, i));
+  socket.sendMany(messages, socket.address().port, '127.0.0.1');
+}));
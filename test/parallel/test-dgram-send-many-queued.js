@@ -0,0 +1,28 @@
+// Flags: --test-udp-no-try-send
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+// All datagrams go through the per-datagram fallback of sendMany().
+
+const server = dgram.createSocket('udp4');
+const client = dgram.createSocket('udp4');
+const messages = ['first', 'second', 'third', ''];
+const received = [];
+
+server.on('message', common.mustCall((buf) => {
+  received.push(buf.toString());
+  if (received.length === messages.length) {
+    assert.deepStrictEqual(received, messages);
+    server.close();
+    client.close();
+  }
+}, messages.length));
+
+server.bind(0, common.mustCall(() => {
+  client.sendMany(messages, server.address().port,
+                  common.mustSucceed((bytes) => {
+                    assert.strictEqual(bytes, 16);
+                  }));
+}));
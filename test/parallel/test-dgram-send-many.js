@@ -0,0 +1,107 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+const messages = [];
+for (let i = 0; i < 100; i++)
+  messages.push(`message ${i}`);
+messages.push('');
+messages.push(Buffer.from('a buffer'));
+messages.push(new Uint8Array([1, 2, 3]));
+messages.push(new DataView(new ArrayBuffer(4)));
+messages.push(Buffer.alloc(60000, 'x'));
+
+const expected = messages.map((message) => {
+  if (typeof message === 'string')
+    return Buffer.from(message);
+  return Buffer.from(message.buffer, message.byteOffset, message.byteLength);
+});
+const expectedBytes = expected.reduce((bytes, buf) => bytes + buf.length, 0);
+
+{
+  const server = dgram.createSocket('udp4');
+  const client = dgram.createSocket('udp4');
+  const received = [];
+
+  server.on('message', common.mustCall((buf, rinfo) => {
+    assert.strictEqual(rinfo.size, buf.length);
+    assert.strictEqual(rinfo.port, client.address().port);
+    received.push(buf);
+    if (received.length === expected.length) {
+      assert.deepStrictEqual(received, expected);
+      server.close();
+      client.close();
+    }
+  }, expected.length));
+
+  server.bind(0, common.localhostIPv4, common.mustCall(() => {
+    client.bind(0, common.localhostIPv4, common.mustCall(() => {
+      client.sendMany(messages, server.address().port, common.localhostIPv4,
+                      common.mustSucceed((bytes) => {
+                        assert.strictEqual(bytes, expectedBytes);
+                      }));
+    }));
+  }));
+}
+
+{
+  // Connected sockets.
+  const server = dgram.createSocket('udp4');
+  const client = dgram.createSocket('udp4');
+  let received = 0;
+
+  server.on('message', common.mustCall((buf) => {
+    assert.deepStrictEqual(buf, Buffer.from(`connected ${received++}`));
+    if (received === 3) {
+      server.close();
+      client.close();
+    }
+  }, 3));
+
+  server.bind(0, common.mustCall(() => {
+    client.connect(server.address().port, common.mustCall(() => {
+      assert.throws(() => client.sendMany([], 1234), {
+        code: 'ERR_SOCKET_DGRAM_IS_CONNECTED'
+      });
+      client.sendMany(['connected 0', 'connected 1', 'connected 2'],
+                      common.mustSucceed((bytes) => {
+                        assert.strictEqual(bytes, 33);
+                      }));
+    }));
+  }));
+}
+
+{
+  // Closing the socket in a 'message' listener stops the remaining datagrams
+  // of a batch from being emitted.
+  const server = dgram.createSocket('udp4');
+  const client = dgram.createSocket('udp4');
+
+  server.on('message', common.mustCall(() => {
+    server.close();
+  }));
+
+  server.bind(0, common.mustCall(() => {
+    client.sendMany(new Array(10).fill('x'), server.address().port,
+                    common.mustSucceed(() => client.close()));
+  }));
+}
+
+{
+  const socket = dgram.createSocket('udp4');
+  assert.throws(() => socket.sendMany('not an array', 1234), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.throws(() => socket.sendMany(['ok', 42], 1234), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    message: /"messages\[1\]"/
+  });
+  assert.throws(() => socket.sendMany(['ok']), {
+    code: 'ERR_SOCKET_BAD_PORT'
+  });
+  assert.throws(() => socket.sendMany(['ok'], 1234, 42), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  socket.close();
+}
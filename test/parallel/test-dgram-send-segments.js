@@ -0,0 +1,89 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+const segmentSize = 1000;
+const data = Buffer.alloc(10500);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+
+const expected = [];
+for (let offset = 0; offset < data.length; offset += segmentSize)
+  expected.push(data.slice(offset, offset + segmentSize));
+
+{
+  // Without GRO, every segment arrives as a datagram of its own.
+  const server = dgram.createSocket('udp4');
+  const client = dgram.createSocket('udp4');
+  const received = [];
+
+  server.on('message', common.mustCall((buf, rinfo) => {
+    assert.strictEqual(rinfo.size, buf.length);
+    assert.strictEqual(rinfo.segmentSize, undefined);
+    received.push(buf);
+    if (received.length === expected.length) {
+      assert.deepStrictEqual(received, expected);
+      server.close();
+      client.close();
+    }
+  }, expected.length));
+
+  server.bind(0, common.localhostIPv4, common.mustCall(() => {
+    client.sendSegments(data, segmentSize, server.address().port,
+                        common.localhostIPv4,
+                        common.mustSucceed((bytes) => {
+                          assert.strictEqual(bytes, data.length);
+                        }));
+  }));
+}
+
+{
+  // With GRO, segments may be coalesced, but the data stays the same.
+  const server = dgram.createSocket({ type: 'udp4', gro: true });
+  const client = dgram.createSocket('udp4');
+  const received = [];
+  let length = 0;
+
+  server.on('message', (buf, rinfo) => {
+    assert.strictEqual(rinfo.size, buf.length);
+    if (rinfo.segmentSize !== undefined) {
+      assert(common.isLinux);
+      assert.strictEqual(rinfo.segmentSize, segmentSize);
+    }
+    received.push(buf);
+    length += buf.length;
+    if (length === data.length) {
+      assert.deepStrictEqual(Buffer.concat(received), data);
+      server.close();
+      client.close();
+    }
+  });
+
+  server.bind(0, common.localhostIPv4, common.mustCall(() => {
+    client.connect(server.address().port, common.localhostIPv4,
+                   common.mustCall(() => {
+                     client.sendSegments(data, segmentSize,
+                                         common.mustSucceed());
+                   }));
+  }));
+}
+
+{
+  const socket = dgram.createSocket('udp4');
+  assert.throws(() => socket.sendSegments(42, 10, 1234), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  for (const size of [0, 65508, 1.5, '10']) {
+    assert.throws(() => socket.sendSegments('data', size, 1234), {
+      code: size === '10' ? 'ERR_INVALID_ARG_TYPE' : 'ERR_OUT_OF_RANGE'
+    });
+  }
+  assert.throws(() => socket.sendSegments('data', 10), {
+    code: 'ERR_SOCKET_BAD_PORT'
+  });
+  assert.throws(() => dgram.createSocket({ type: 'udp4', gro: 1 }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  socket.close();
+}
@@ -0,0 +1,137 @@
+// Flags: --experimental-fs-io-uring
+'use strict';
+
+// Checks that file system requests behave the same when they are submitted
+// through io_uring. On platforms or kernels without io_uring support, the
+// requests transparently use the threadpool and the checks still apply.
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { Worker, isMainThread } = require('worker_threads');
+const tmpdir = require('../common/tmpdir');
+
+if (isMainThread)
+  tmpdir.refresh();
+
+const filename = path.join(tmpdir.path,
+                           `io-uring-${isMainThread ? 'main' : 'worker'}.txt`);
+
+function compareStats(actual, expected) {
+  for (const key of ['dev', 'mode', 'nlink', 'uid', 'gid', 'rdev', 'ino',
+                     'size', 'blocks', 'mtimeMs', 'ctimeMs', 'birthtimeMs']) {
+    assert.strictEqual(actual[key], expected[key], key);
+  }
+}
+
+const data = Buffer.from('0123456789abcdefghijklmnopqrstuvwxyz');
+
+fs.open(filename, 'w+', common.mustSucceed((fd) => {
+  // Positional and vectored writes, plus a write at the current position.
+  fs.write(fd, data, 0, 10, 0, common.mustSucceed((written) => {
+    assert.strictEqual(written, 10);
+    fs.writev(fd, [data.slice(10, 20), data.slice(20)], 10,
+              common.mustSucceed((written) => {
+                assert.strictEqual(written, data.length - 10);
+                fs.write(fd, 'tail', common.mustSucceed((written) => {
+                  assert.strictEqual(written, 4);
+                  afterWrite(fd);
+                }));
+              }));
+  }));
+}));
+
+function afterWrite(fd) {
+  fs.fsync(fd, common.mustSucceed(() => {
+    fs.fdatasync(fd, common.mustSucceed(() => {
+      fs.fstat(fd, common.mustSucceed((stats) => {
+        compareStats(stats, fs.fstatSync(fd));
+        // The write at the current position went to offset 0.
+        assert.strictEqual(stats.size, data.length);
+        readBack(fd);
+      }));
+    }));
+  }));
+}
+
+function readBack(fd) {
+  const buf = Buffer.alloc(data.length);
+  fs.read(fd, buf, 0, buf.length, 0, common.mustSucceed((bytesRead) => {
+    assert.strictEqual(bytesRead, data.length);
+    assert.deepStrictEqual(buf, Buffer.concat([Buffer.from('tail'),
+                                               data.slice(4)]));
+    const bufs = [Buffer.alloc(3), Buffer.alloc(5)];
+    fs.readv(fd, bufs, 10, common.mustSucceed((bytesRead) => {
+      assert.strictEqual(bytesRead, 8);
+      assert.strictEqual(Buffer.concat(bufs).toString(), 'abcdefgh');
+      fs.close(fd, common.mustSucceed(() => {
+        assert.throws(() => fs.fstatSync(fd), { code: 'EBADF' });
+        checkPaths();
+      }));
+    }));
+  }));
+}
+
+function checkPaths() {
+  fs.stat(filename, common.mustSucceed((stats) => {
+    compareStats(stats, fs.statSync(filename));
+  }));
+  fs.lstat(filename, common.mustSucceed((stats) => {
+    compareStats(stats, fs.lstatSync(filename));
+  }));
+  fs.stat(filename, { bigint: true }, common.mustSucceed((stats) => {
+    assert.strictEqual(stats.size, BigInt(data.length));
+  }));
+
+  const missing = path.join(tmpdir.path, 'does-not-exist');
+  fs.stat(missing, common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ENOENT');
+    assert.strictEqual(err.syscall, 'stat');
+    assert.strictEqual(err.path, missing);
+  }));
+  fs.open(missing, 'r', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ENOENT');
+    assert.strictEqual(err.path, missing);
+  }));
+  fs.open(tmpdir.path, 'r', common.mustSucceed((dirfd) => {
+    fs.read(dirfd, Buffer.alloc(1), 0, 1, 0, common.mustCall((err) => {
+      assert.strictEqual(err.code, 'EISDIR');
+      fs.closeSync(dirfd);
+    }));
+  }));
+
+  // More requests than the ring can hold at once; the excess ones must
+  // fall back to the threadpool.
+  const count = 2000;
+  let done = 0;
+  for (let i = 0; i < count; i++) {
+    fs.stat(filename, common.mustSucceed(() => {
+      if (++done === count)
+        checkPromises().then(common.mustCall());
+    }));
+  }
+}
+
+async function checkPromises() {
+  const handle = await fs.promises.open(filename, 'r+');
+  const { bytesWritten } = await handle.write(Buffer.from('TAIL'), 0, 4, 0);
+  assert.strictEqual(bytesWritten, 4);
+  compareStats(await handle.stat(), await fs.promises.stat(filename));
+  assert.strictEqual((await handle.readFile()).toString().slice(0, 6),
+                     'TAIL45');
+  await handle.sync();
+  await handle.close();
+
+  const chunks = [];
+  for await (const chunk of fs.createReadStream(filename, { start: 10 }))
+    chunks.push(chunk);
+  assert.strictEqual(Buffer.concat(chunks).toString(),
+                     data.slice(10).toString());
+
+  if (isMainThread) {
+    // Each worker thread has its own event loop and ring.
+    const worker = new Worker(__filename);
+    worker.on('exit', common.mustCall((code) => assert.strictEqual(code, 0)));
+  }
+}
@@ -0,0 +1,105 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// The following tests validate base functionality for the fs.promises
+// FileHandle.hash method.
+
+const { open } = require('fs').promises;
+const { createHash } = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+const assert = require('assert');
+
+tmpdir.refresh();
+
+// Larger than the chunks in which the file is read.
+const data = Buffer.alloc(1024 * 1024 + 12345);
+for (let i = 0; i < data.length; i++)
+  data[i] = (i * 31) ^ (i >> 8);
+const filePath = path.resolve(tmpdir.path, 'tmp-hash-file.bin');
+fs.writeFileSync(filePath, data);
+
+function digest(algorithm, input, encoding) {
+  return createHash(algorithm).update(input).digest(encoding);
+}
+
+async function validateHash() {
+  const fileHandle = await open(filePath, 'r');
+  try {
+    assert.deepStrictEqual(await fileHandle.hash('sha256'),
+                           digest('sha256', data));
+    assert.deepStrictEqual(
+      await fileHandle.hash(['md5', 'sha256', 'sha512'], { encoding: 'hex' }),
+      [digest('md5', data, 'hex'),
+       digest('sha256', data, 'hex'),
+       digest('sha512', data, 'hex')]);
+    assert.deepStrictEqual(await fileHandle.hash([]), []);
+  } finally {
+    await fileHandle.close();
+  }
+}
+
+async function validatePositionAndLength() {
+  const fileHandle = await open(filePath, 'r');
+  try {
+    assert.strictEqual(
+      await fileHandle.hash('sha1', { position: 100, length: 600000,
+                                      encoding: 'base64' }),
+      digest('sha1', data.slice(100, 600100), 'base64'));
+    assert.strictEqual(
+      await fileHandle.hash('sha1', { position: data.length - 10,
+                                      length: 1000, encoding: 'hex' }),
+      digest('sha1', data.slice(data.length - 10), 'hex'));
+    assert.strictEqual(
+      await fileHandle.hash('sha1', { length: 0, encoding: 'hex' }),
+      digest('sha1', '', 'hex'));
+
+    // Without a position, the file is read from the current position, which
+    // is updated.
+    const { bytesRead } = await fileHandle.read(Buffer.alloc(10), 0, 10);
+    assert.strictEqual(bytesRead, 10);
+    assert.strictEqual(await fileHandle.hash('sha256', { encoding: 'hex' }),
+                       digest('sha256', data.slice(10), 'hex'));
+    assert.strictEqual(await fileHandle.hash('sha256', { encoding: 'hex' }),
+                       digest('sha256', '', 'hex'));
+  } finally {
+    await fileHandle.close();
+  }
+}
+
+async function validateErrors() {
+  const fileHandle = await open(filePath, 'r');
+  await assert.rejects(fileHandle.hash('not a hash'),
+                       { code: 'ERR_CRYPTO_INVALID_DIGEST' });
+  await assert.rejects(fileHandle.hash(['sha256', 1]),
+                       { code: 'ERR_INVALID_ARG_TYPE' });
+  await assert.rejects(fileHandle.hash('sha256', { position: -1 }),
+                       { code: 'ERR_OUT_OF_RANGE' });
+  await assert.rejects(fileHandle.hash('sha256', { length: 1.5 }),
+                       { code: 'ERR_OUT_OF_RANGE' });
+  await assert.rejects(fileHandle.hash('sha256', { encoding: 'nope' }),
+                       { code: 'ERR_UNKNOWN_ENCODING' });
+  await fileHandle.close();
+  await assert.rejects(fileHandle.hash('sha256'), { code: 'EBADF' });
+
+  const writeOnly = await open(path.resolve(tmpdir.path, 'write-only'), 'w');
+  await assert.rejects(writeOnly.hash('sha256'),
+                       { code: 'EBADF', syscall: 'read' });
+  await writeOnly.close();
+
+  if (common.isLinux) {
+    const directory = await open(tmpdir.path, 'r');
+    await assert.rejects(directory.hash('sha256'),
+                         { code: 'EISDIR', syscall: 'read' });
+    await directory.close();
+  }
+}
+
+validateHash()
+  .then(validatePositionAndLength)
+  .then(validateErrors)
+  .then(common.mustCall());
@@ -0,0 +1,89 @@
+'use strict';
+
+// A fs.ReadStream that is piped natively into a socket keeps behaving like a
+// Readable. Adding a 'data' listener, pausing it, or writing to the socket
+// hands the rest of the transfer to Readable.prototype.pipe().
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+const data = Buffer.alloc(3 * 1024 * 1024 + 123);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+const filename = path.join(tmpdir.path, 'pipe-socket-fallback.bin');
+fs.writeFileSync(filename, data);
+
+// Calls `onPipe(stream, socket)` right after piping the file into the socket,
+// and passes what the client received to `check()`.
+function test(onPipe, check, cb) {
+  const server = net.createServer(common.mustCall((socket) => {
+    const stream = fs.createReadStream(filename);
+    stream.pipe(socket);
+    onPipe(stream, socket);
+    stream.on('end', common.mustCall());
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const client = net.connect(server.address().port);
+    const chunks = [];
+    client.on('data', (chunk) => chunks.push(chunk));
+    client.on('end', common.mustCall(() => {
+      check(Buffer.concat(chunks));
+      client.end();
+      server.close(cb);
+    }));
+  }));
+}
+
+function testDataListener(cb) {
+  const chunks = [];
+  test((stream) => {
+    stream.on('data', (chunk) => chunks.push(chunk));
+  }, (received) => {
+    assert.deepStrictEqual(received, data);
+    assert.deepStrictEqual(Buffer.concat(chunks), data);
+  }, cb);
+}
+
+function testPause(cb) {
+  test((stream, socket) => {
+    stream.pause();
+    assert.strictEqual(stream.readableFlowing, false);
+    // Readable.prototype.pipe() takes over, and keeps the stream paused.
+    socket.once('pipe', common.mustCall(() => {
+      setImmediate(common.mustCall(() => {
+        assert.strictEqual(stream.isPaused(), true);
+        stream.resume();
+      }));
+    }));
+  }, (received) => {
+    assert.deepStrictEqual(received, data);
+  }, cb);
+}
+
+function testSocketWrite(cb) {
+  const trailer = Buffer.from('trailer');
+  let sent;
+  test((stream, socket) => {
+    socket.once('unpipe', common.mustCall(() => sent = stream.bytesRead));
+    socket.write(trailer);
+  }, (received) => {
+    assert.deepStrictEqual(received, Buffer.concat([
+      data.slice(0, sent),
+      trailer,
+      data.slice(sent),
+    ]));
+  }, cb);
+}
+
+testDataListener(common.mustCall(() => {
+  testPause(common.mustCall(() => {
+    testSocketWrite(common.mustCall());
+  }));
+}));
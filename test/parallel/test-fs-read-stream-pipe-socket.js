@@ -0,0 +1,97 @@
+'use strict';
+
+// Piping a fs.ReadStream into a TCP or pipe socket hands the transfer to a
+// native StreamPipe, which uses sendfile() where that is available. Check
+// that the receiving end gets exactly the requested range, and that the
+// ReadStream behaves like with a regular pipe.
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+// Several sendfile() chunks' worth of data.
+const data = Buffer.alloc(3 * 1024 * 1024 + 123);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+const filename = path.join(tmpdir.path, 'pipe-socket.bin');
+fs.writeFileSync(filename, data);
+
+const trailer = Buffer.from('trailer');
+
+function test(listenArg, { start, end, pipeEnd }, cb) {
+  const server = net.createServer(common.mustCall((socket) => {
+    const stream = fs.createReadStream(filename, { start, end });
+    socket.on('pipe', common.mustCall((src) => assert.strictEqual(src, stream)));
+    socket.on('unpipe', common.mustCall());
+    stream.on('end', common.mustCall(() => {
+      assert.strictEqual(stream.bytesRead, expected.length);
+      if (!pipeEnd)
+        socket.end(trailer);
+    }));
+    stream.on('close', common.mustCall());
+    stream.pipe(socket, { end: pipeEnd });
+    assert.strictEqual(stream.readableFlowing, true);
+    assert.deepStrictEqual(stream._readableState.pipes, [socket]);
+  }));
+
+  const expected = data.slice(start, end === undefined ? undefined : end + 1);
+  const received = pipeEnd ? expected : Buffer.concat([expected, trailer]);
+
+  server.listen(listenArg, common.mustCall(() => {
+    const address = typeof listenArg === 'string' ?
+      listenArg : server.address().port;
+    const client = net.connect(address);
+    const chunks = [];
+    client.on('data', (chunk) => chunks.push(chunk));
+    client.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(chunks), received);
+      client.end();
+      server.close(cb);
+    }));
+  }));
+}
+
+const cases = [
+  { pipeEnd: true },
+  { start: 1000, end: 2 * 1024 * 1024 + 7, pipeEnd: true },
+  { start: 5, pipeEnd: false },
+];
+
+function runTcp(i) {
+  if (i === cases.length)
+    return runPipe();
+  test(0, cases[i], common.mustCall(() => runTcp(i + 1)));
+}
+
+function runPipe() {
+  if (common.isWindows)
+    return;
+  test(common.PIPE, cases[1], common.mustCall(testErrors));
+}
+
+function testErrors() {
+  // A file that cannot be opened does not leave the socket corked.
+  const server = net.createServer(common.mustCall((socket) => {
+    const stream = fs.createReadStream(path.join(tmpdir.path, 'missing'));
+    stream.on('error', common.expectsError({ code: 'ENOENT' }));
+    socket.on('unpipe', common.mustCall(() => socket.end(trailer)));
+    stream.pipe(socket);
+  }));
+  server.listen(0, common.mustCall(() => {
+    const client = net.connect(server.address().port);
+    const chunks = [];
+    client.on('data', (chunk) => chunks.push(chunk));
+    client.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(chunks), trailer);
+      client.end();
+      server.close();
+    }));
+  }));
+}
+
+runTcp(0);
@@ -0,0 +1,81 @@
+// Flags: --expose-internals
+'use strict';
+
+// Checks the batched statMany() binding against the regular stat functions.
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { internalBinding } = require('internal/test/binding');
+const { getStatsFromBinding } = require('internal/fs/utils');
+const { UV_ENOENT } = internalBinding('uv');
+const tmpdir = require('../common/tmpdir');
+
+const binding = internalBinding('fs');
+const { kFsStatsFieldsNumber: kFields } = binding;
+
+tmpdir.refresh();
+
+const file = path.join(tmpdir.path, 'file');
+const link = path.join(tmpdir.path, 'link');
+const missing = path.join(tmpdir.path, 'missing');
+fs.writeFileSync(file, 'x'.repeat(100));
+const canSymlink = common.canCreateSymLink();
+if (canSymlink)
+  fs.symlinkSync(file, link);
+
+const paths = [file, missing, tmpdir.path, Buffer.from(file)];
+if (canSymlink)
+  paths.push(link);
+
+function compareStats(actual, expected) {
+  for (const key of ['dev', 'mode', 'nlink', 'uid', 'gid', 'rdev', 'ino',
+                     'size', 'blocks', 'mtimeMs', 'ctimeMs', 'birthtimeMs']) {
+    assert.strictEqual(actual[key], expected[key], key);
+  }
+}
+
+function check([stats, errors], { bigint, follow }) {
+  assert.strictEqual(stats.length, paths.length * kFields);
+  assert.strictEqual(errors.length, paths.length);
+  assert.ok(bigint ? stats instanceof BigUint64Array :
+    stats instanceof Float64Array);
+  assert.ok(errors instanceof Int32Array);
+
+  const statSync = follow ? fs.statSync : fs.lstatSync;
+  for (let i = 0; i < paths.length; i++) {
+    if (paths[i] === missing) {
+      assert.strictEqual(errors[i], UV_ENOENT);
+      continue;
+    }
+    assert.strictEqual(errors[i], 0);
+    compareStats(getStatsFromBinding(stats, i * kFields),
+                 statSync(paths[i], { bigint }));
+  }
+}
+
+for (const bigint of [false, true]) {
+  for (const follow of [false, true]) {
+    const options = { bigint, follow };
+
+    // Synchronous call.
+    check(binding.statMany(paths, bigint, follow), options);
+
+    // Callback-based call.
+    const req = new binding.FSReqCallback(bigint);
+    req.oncomplete = common.mustSucceed((result) => check(result, options));
+    binding.statMany(paths, bigint, follow, req);
+
+    // Promise-based call.
+    binding.statMany(paths, bigint, follow, binding.kUsePromises)
+      .then(common.mustCall((result) => check(result, options)));
+  }
+}
+
+// An empty list is valid and produces empty arrays.
+{
+  const [stats, errors] = binding.statMany([], false, true);
+  assert.strictEqual(stats.length, 0);
+  assert.strictEqual(errors.length, 0);
+}
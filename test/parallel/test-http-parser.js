@@ -271,6 +271,46 @@ function expectBody(expected) {
 }
 
 
+//
+// Test a large number of headers that arrive in many small pieces. All of
+// them are passed to kOnHeadersComplete at once.
+//
+{
+  const values = [];
+  let raw = 'GET /slow HTTP/1.1\r\n';
+  for (let i = 0; i < 100; i++) {
+    values.push(`${i}`.repeat(i % 7 + 1));
+    raw += `X-Header-${i}:  ${values[i]} \r\n`;
+  }
+  values.push('y'.repeat(4096));
+  raw += `X-Long: ${values[100]}\r\n\r\n`;
+  const request = Buffer.from(raw);
+
+  const onHeadersComplete = (versionMajor, versionMinor, headers,
+                             method, url) => {
+    assert.strictEqual(method, methods.indexOf('GET'));
+    assert.strictEqual(url, '/slow');
+    assert.strictEqual(headers.length, 2 * values.length);
+    for (let i = 0; i < 100; i++) {
+      assert.strictEqual(headers[2 * i], `X-Header-${i}`);
+      assert.strictEqual(headers[2 * i + 1], values[i]);
+    }
+    assert.strictEqual(headers[200], 'X-Long');
+    assert.strictEqual(headers[201], values[100]);
+  };
+
+  for (const pieceSize of [1, 3, 37]) {
+    const parser = newParser(REQUEST);
+    parser[kOnHeaders] = mustNotCall();
+    parser[kOnHeadersComplete] = mustCall(onHeadersComplete);
+    for (let i = 0; i < request.length; i += pieceSize) {
+      const piece = Buffer.from(request.slice(i, i + pieceSize));
+      parser.execute(piece, 0, piece.length);
+    }
+  }
+}
+
+
 //
 // Test request body
 //
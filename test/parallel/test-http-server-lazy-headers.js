@@ -0,0 +1,159 @@
+'use strict';
+
+// Checks that requests received by a server with `lazyHeaders` enabled
+// expose the same headers as those of a regular server, no matter whether
+// they are read through getHeader(), `headers` or `rawHeaders`.
+
+const common = require('../common');
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const request = 'GET / HTTP/1.1\r\n' +
+                'Host: localhost\r\n' +
+                'X-Foo: a\r\n' +
+                'x-foo: b\r\n' +
+                'Set-Cookie: c=1\r\n' +
+                'set-cookie: d=2\r\n' +
+                'Cookie: e=3\r\n' +
+                'Cookie: f=4\r\n' +
+                'Content-Type: text/plain\r\n' +
+                'content-type: text/html\r\n' +
+                'Empty:\r\n' +
+                'Trailing-Space: value  \r\n' +
+                'Connection: close\r\n' +
+                '\r\n';
+
+const expectedRaw = [
+  'Host', 'localhost',
+  'X-Foo', 'a',
+  'x-foo', 'b',
+  'Set-Cookie', 'c=1',
+  'set-cookie', 'd=2',
+  'Cookie', 'e=3',
+  'Cookie', 'f=4',
+  'Content-Type', 'text/plain',
+  'content-type', 'text/html',
+  'Empty', '',
+  'Trailing-Space', 'value',
+  'Connection', 'close',
+];
+
+const expectedHeaders = {
+  'host': 'localhost',
+  'x-foo': 'a, b',
+  'set-cookie': ['c=1', 'd=2'],
+  'cookie': 'e=3; f=4',
+  'content-type': 'text/plain',
+  'empty': '',
+  'trailing-space': 'value',
+  'connection': 'close',
+};
+
+function checkGetHeader(req) {
+  for (const [name, value] of Object.entries(expectedHeaders)) {
+    assert.deepStrictEqual(req.getHeader(name), value);
+    assert.deepStrictEqual(req.getHeader(name.toUpperCase()), value);
+  }
+  assert.strictEqual(req.getHeader('missing'), undefined);
+  assert.throws(() => req.getHeader(1), { code: 'ERR_INVALID_ARG_TYPE' });
+}
+
+const checks = [
+  // Only getHeader().
+  (req) => checkGetHeader(req),
+  // getHeader() first, then the full objects.
+  (req) => {
+    checkGetHeader(req);
+    assert.deepStrictEqual(req.rawHeaders, expectedRaw);
+    assert.deepStrictEqual(req.headers, expectedHeaders);
+    checkGetHeader(req);
+  },
+  // The full objects first.
+  (req) => {
+    assert.deepStrictEqual(req.headers, expectedHeaders);
+    assert.deepStrictEqual(req.rawHeaders, expectedRaw);
+    checkGetHeader(req);
+  },
+  // rawHeaders can be replaced.
+  (req) => {
+    req.rawHeaders = ['Foo', 'bar'];
+    assert.deepStrictEqual(req.rawHeaders, ['Foo', 'bar']);
+    assert.strictEqual(req.getHeader('foo'), 'bar');
+  },
+];
+
+function test(lazyHeaders, index) {
+  if (index === checks.length) {
+    if (!lazyHeaders)
+      test(true, 0);
+    return;
+  }
+
+  const server = http.createServer({ lazyHeaders }, common.mustCall((req) => {
+    checks[index](req);
+    req.resume();
+    req.on('end', common.mustCall(() => req.socket.end()));
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const client = net.connect(server.address().port);
+    client.end(request);
+    client.resume();
+    client.on('close', common.mustCall(() => {
+      server.close();
+      test(lazyHeaders, index + 1);
+    }));
+  }));
+}
+
+test(false, 0);
+
+// maxHeadersCount also applies to lazily decoded headers.
+{
+  const server = http.createServer({ lazyHeaders: true },
+                                   common.mustCall(onRequest));
+  function onRequest(req) {
+    assert.strictEqual(req.getHeader('host'), 'localhost');
+    assert.strictEqual(req.getHeader('x-foo'), 'a');
+    assert.strictEqual(req.getHeader('connection'), undefined);
+    assert.deepStrictEqual(req.headers, { 'host': 'localhost', 'x-foo': 'a' });
+    assert.deepStrictEqual(req.rawHeaders, expectedRaw);
+    req.socket.end();
+  }
+  server.maxHeadersCount = 2;
+  server.listen(0, common.mustCall(() => {
+    const client = net.connect(server.address().port);
+    client.end(request);
+    client.resume();
+    client.on('close', common.mustCall(() => server.close()));
+  }));
+}
+
+// Expect: 100-continue is handled for lazy requests as well.
+{
+  const server = http.createServer({ lazyHeaders: true },
+                                   common.mustCall(onRequest));
+  function onRequest(req, res) {
+    req.resume();
+    req.on('end', () => res.end('ok'));
+  }
+  server.listen(0, common.mustCall(() => {
+    const req = http.request({
+      port: server.address().port,
+      method: 'POST',
+      headers: { 'Expect': '100-continue' }
+    });
+    req.on('continue', common.mustCall(() => req.end('body')));
+    req.on('response', common.mustCall((res) => {
+      res.resume();
+      res.on('end', common.mustCall(() => server.close()));
+    }));
+  }));
+}
+
+for (const lazyHeaders of [1, 'true', null]) {
+  assert.throws(() => http.createServer({ lazyHeaders }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
@@ -0,0 +1,69 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const http2 = require('http2');
+
+// With the adaptiveWindow option, the receiving session grows its flow
+// control windows without affecting the data that is received.
+
+const payload = Buffer.alloc(8 * 1024 * 1024);
+for (let i = 0; i < payload.length; i++)
+  payload[i] = i % 251;
+
+const server = http2.createServer();
+server.on('stream', common.mustCall((stream) => {
+  assert.strictEqual(stream.session.state.adaptiveWindowSize, 0);
+  stream.respond();
+  stream.end(payload);
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`,
+                               { adaptiveWindow: true });
+  const req = client.request();
+  const chunks = [];
+  req.on('data', (chunk) => chunks.push(chunk));
+  req.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(chunks), payload);
+
+    // The window has grown beyond the default of 64 KiB - 1.
+    const state = client.state;
+    assert(state.adaptiveWindowSize > 65535, state.adaptiveWindowSize);
+    assert(state.adaptiveWindowSize <= 16 * 1024 * 1024,
+           state.adaptiveWindowSize);
+    assert(state.memoryUsage > 0, state.memoryUsage);
+    assert(state.totalMemoryUsage > 0, state.totalMemoryUsage);
+
+    // Without any budget left, the server rejects new streams.
+    http2.setMemoryBudget(0);
+    const rejected = client.request();
+    rejected.on('error', common.expectsError({
+      code: 'ERR_HTTP2_STREAM_ERROR',
+      message: 'Stream closed with error code NGHTTP2_ENHANCE_YOUR_CALM'
+    }));
+    rejected.on('close', common.mustCall(() => {
+      assert.strictEqual(rejected.rstCode,
+                         http2.constants.NGHTTP2_ENHANCE_YOUR_CALM);
+      http2.setMemoryBudget(Infinity);
+      client.close();
+      server.close();
+    }));
+    rejected.end();
+  }));
+}));
+
+// The memory budget is expressed in megabytes, like maxSessionMemory.
+http2.setMemoryBudget(Infinity);
+http2.setMemoryBudget(100);
+http2.setMemoryBudget(Infinity);
+for (const budget of ['10', null, {}]) {
+  assert.throws(() => http2.setMemoryBudget(budget),
+                { code: 'ERR_INVALID_ARG_TYPE' });
+}
+for (const budget of [-1, NaN]) {
+  assert.throws(() => http2.setMemoryBudget(budget),
+                { code: 'ERR_OUT_OF_RANGE' });
+}
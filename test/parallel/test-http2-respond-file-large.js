@@ -0,0 +1,68 @@
+'use strict';
+
+// Tests that large files are sent completely and in order, also when the
+// flow control window of the client is much smaller than the file, and that
+// destroying a stream while the file is still being read is handled.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const fs = require('fs');
+const http2 = require('http2');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+const fname = path.join(tmpdir.path, 'large-file');
+const data = Buffer.alloc(3 * 1024 * 1024 + 123);
+for (let i = 0; i < data.length; i += 4)
+  data.writeUInt32LE(i, i);
+fs.writeFileSync(fname, data);
+
+const server = http2.createServer();
+server.on('stream', common.mustCall((stream, headers) => {
+  if (headers[':path'] === '/fd') {
+    const fd = fs.openSync(fname, 'r');
+    stream.on('close', common.mustCall(() => fs.closeSync(fd)));
+    stream.respondWithFD(fd, {}, { offset: 1000, length: 2000000 });
+  } else {
+    stream.respondWithFile(fname);
+  }
+}, 4));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`, {
+    settings: { initialWindowSize: 16384 }
+  });
+
+  let pending = 4;
+  function done() {
+    if (--pending === 0) {
+      client.close();
+      server.close();
+    }
+  }
+
+  function get(urlPath, expected) {
+    const req = client.request({ ':path': urlPath });
+    const chunks = [];
+    req.on('data', (chunk) => chunks.push(chunk));
+    req.on('end', common.mustCall(() => {
+      assert(Buffer.concat(chunks).equals(expected));
+      done();
+    }));
+    req.end();
+  }
+
+  get('/', data);
+  get('/', data);
+  get('/fd', data.slice(1000, 2001000));
+
+  // Reset the stream while the file is being sent.
+  const req = client.request({ ':path': '/' });
+  req.once('data', common.mustCall(() => req.close()));
+  req.on('close', common.mustCall(done));
+  req.resume();
+  req.end();
+}));
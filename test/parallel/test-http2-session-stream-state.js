@@ -37,6 +37,9 @@ function onStream(stream, headers, flags) {
     assert.strictEqual(typeof state.outboundQueueSize, 'number');
     assert.strictEqual(typeof state.deflateDynamicTableSize, 'number');
     assert.strictEqual(typeof state.inflateDynamicTableSize, 'number');
+    assert.strictEqual(typeof state.memoryUsage, 'number');
+    assert.strictEqual(typeof state.totalMemoryUsage, 'number');
+    assert.strictEqual(typeof state.adaptiveWindowSize, 'number');
   }
 
   stream.respond({
@@ -84,6 +87,9 @@ server.on('listening', common.mustCall(() => {
       assert.strictEqual(typeof state.outboundQueueSize, 'number');
       assert.strictEqual(typeof state.deflateDynamicTableSize, 'number');
       assert.strictEqual(typeof state.inflateDynamicTableSize, 'number');
+      assert.strictEqual(typeof state.memoryUsage, 'number');
+      assert.strictEqual(typeof state.totalMemoryUsage, 'number');
+      assert.strictEqual(typeof state.adaptiveWindowSize, 'number');
     }
   }));
 
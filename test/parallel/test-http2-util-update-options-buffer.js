@@ -23,7 +23,8 @@ const IDX_OPTIONS_MAX_OUTSTANDING_PINGS = 6;
 const IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS = 7;
 const IDX_OPTIONS_MAX_SESSION_MEMORY = 8;
 const IDX_OPTIONS_MAX_SETTINGS = 9;
-const IDX_OPTIONS_FLAGS = 10;
+const IDX_OPTIONS_ADAPTIVE_WINDOW = 10;
+const IDX_OPTIONS_FLAGS = 11;
 
 {
   updateOptionsBuffer({
@@ -37,6 +38,7 @@ const IDX_OPTIONS_FLAGS = 10;
     maxOutstandingSettings: 8,
     maxSessionMemory: 9,
     maxSettings: 10,
+    adaptiveWindow: true,
   });
 
   strictEqual(optionsBuffer[IDX_OPTIONS_MAX_DEFLATE_DYNAMIC_TABLE_SIZE], 1);
@@ -49,6 +51,7 @@ const IDX_OPTIONS_FLAGS = 10;
   strictEqual(optionsBuffer[IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS], 8);
   strictEqual(optionsBuffer[IDX_OPTIONS_MAX_SESSION_MEMORY], 9);
   strictEqual(optionsBuffer[IDX_OPTIONS_MAX_SETTINGS], 10);
+  strictEqual(optionsBuffer[IDX_OPTIONS_ADAPTIVE_WINDOW], 1);
 
   const flags = optionsBuffer[IDX_OPTIONS_FLAGS];
 
@@ -61,6 +64,7 @@ const IDX_OPTIONS_FLAGS = 10;
   ok(flags & (1 << IDX_OPTIONS_MAX_OUTSTANDING_PINGS));
   ok(flags & (1 << IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS));
   ok(flags & (1 << IDX_OPTIONS_MAX_SETTINGS));
+  ok(flags & (1 << IDX_OPTIONS_ADAPTIVE_WINDOW));
 }
 
 {
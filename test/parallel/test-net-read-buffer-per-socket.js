@@ -0,0 +1,35 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+// Data that is read from a socket must not share memory with the data of
+// other sockets, and small chunks must not keep a large slab alive.
+
+const kMaxCopySize = 4096;
+
+const server = net.createServer((socket) => socket.pipe(socket));
+server.listen(0, common.mustCall(() => {
+  const arrayBuffers = [new Set(), new Set()];
+  let pending = arrayBuffers.length;
+
+  for (let i = 0; i < arrayBuffers.length; i++) {
+    const client = net.connect(server.address().port, () => {
+      client.write(Buffer.alloc(16, i));
+      client.end(Buffer.alloc(256 * 1024, i));
+    });
+    client.on('data', common.mustCallAtLeast((chunk) => {
+      assert(chunk.every((byte) => byte === i));
+      if (chunk.length <= kMaxCopySize)
+        assert.strictEqual(chunk.buffer.byteLength, chunk.length);
+      arrayBuffers[i].add(chunk.buffer);
+    }));
+    client.on('end', common.mustCall(() => {
+      if (--pending > 0)
+        return;
+      for (const arrayBuffer of arrayBuffers[0])
+        assert(!arrayBuffers[1].has(arrayBuffer));
+      server.close();
+    }));
+  }
+}));
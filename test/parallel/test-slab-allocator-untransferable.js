@@ -0,0 +1,47 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+const net = require('net');
+const { MessageChannel } = require('worker_threads');
+
+// Make sure that the slabs that socket data is read into are not
+// transferable. Later reads from the same socket still write into them.
+
+function checkUntransferable(chunk) {
+  const { buffer } = chunk;
+  const byteLength = buffer.byteLength;
+  const contents = Buffer.from(chunk);
+
+  const { port1, port2 } = new MessageChannel();
+  port1.postMessage(chunk, [ buffer ]);
+  port1.close();
+  port2.close();
+
+  // Verify that the slab ArrayBuffer has not actually been transferred:
+  assert.strictEqual(chunk.buffer, buffer);
+  assert.strictEqual(buffer.byteLength, byteLength);
+  assert.deepStrictEqual(chunk, contents);
+}
+
+{
+  const server = net.createServer(common.mustCall((socket) => {
+    socket.end('hello world');
+  }));
+  server.listen(0, common.mustCall(() => {
+    const client = net.connect(server.address().port);
+    client.on('data', common.mustCallAtLeast(checkUntransferable));
+    client.on('end', common.mustCall(() => server.close()));
+  }));
+}
+
+{
+  const socket = dgram.createSocket('udp4');
+  socket.on('message', common.mustCall((msg) => {
+    checkUntransferable(msg);
+    socket.close();
+  }));
+  socket.bind(0, common.mustCall(() => {
+    socket.send('hello world', socket.address().port, '127.0.0.1');
+  }));
+}
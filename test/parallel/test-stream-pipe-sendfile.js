@@ -0,0 +1,86 @@
+// Flags: --expose-internals
+'use strict';
+
+// Pipes a FileHandle into TCP and pipe sockets through a native StreamPipe,
+// which transfers the data with sendfile() where that is available, and
+// checks that the receiving end gets exactly the requested range.
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const path = require('path');
+const { internalBinding } = require('internal/test/binding');
+const { FileHandle } = internalBinding('fs');
+const { StreamPipe } = internalBinding('stream_pipe');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+// Several sendfile() chunks' worth of data.
+const data = Buffer.alloc(5 * 1024 * 1024 + 123);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+const filename = path.join(tmpdir.path, 'sendfile.bin');
+fs.writeFileSync(filename, data);
+
+function pipeFile(socket, offset, length) {
+  const handle = new FileHandle(fs.openSync(filename, 'r'), offset, length);
+  handle.onread = common.mustCall();  // Called once for EOF.
+  const pipe = new StreamPipe(handle, socket._handle);
+  pipe.onunpipe = common.mustCall(() => {
+    handle.close().then(common.mustCall());
+  });
+  pipe.start();
+}
+
+function test(listenArg, { offset, length, pause }, cb) {
+  const server = net.createServer(common.mustCall((socket) => {
+    pipeFile(socket, offset, length);
+  }));
+
+  server.listen(listenArg, common.mustCall(() => {
+    const address = typeof listenArg === 'string' ?
+      listenArg : server.address().port;
+    const client = net.connect(address);
+    const chunks = [];
+    client.on('data', (chunk) => chunks.push(chunk));
+    client.on('end', common.mustCall(() => {
+      const expected = data.slice(offset,
+                                  length >= 0 ? offset + length : undefined);
+      const actual = Buffer.concat(chunks);
+      assert.strictEqual(actual.length, expected.length);
+      assert(actual.equals(expected));
+      client.end();
+      server.close(cb);
+    }));
+
+    if (pause) {
+      // Let the socket buffers fill up, so that writes need to wait for
+      // the socket to become writable again.
+      client.pause();
+      setTimeout(() => client.resume(), 100);
+    }
+  }));
+}
+
+const cases = [
+  { offset: 0, length: -1 },
+  { offset: 1000, length: 2 * 1024 * 1024 + 7 },
+  { offset: 0, length: data.length + 1000 },
+  { offset: 0, length: -1, pause: true },
+];
+
+function runTcp(i) {
+  if (i === cases.length)
+    return runPipe();
+  test(0, cases[i], common.mustCall(() => runTcp(i + 1)));
+}
+
+function runPipe() {
+  if (common.isWindows)
+    return;
+  test(common.PIPE, cases[1], common.mustCall());
+}
+
+runTcp(0);
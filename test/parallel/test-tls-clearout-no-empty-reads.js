@@ -0,0 +1,44 @@
+// Flags: --expose-internals
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// Checks that TLSWrap only reports reads with data (or EOF) to JS. Reads
+// without data refresh the socket timeout and allocate a buffer for nothing.
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+const { internalBinding } = require('internal/test/binding');
+const { streamBaseState, kReadBytesOrError } = internalBinding('stream_wrap');
+
+const server = tls.createServer({
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem')
+}, common.mustCall((socket) => {
+  socket.write('a');
+  setImmediate(() => socket.end(Buffer.alloc(100000, 'b')));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = tls.connect({
+    port: server.address().port,
+    rejectUnauthorized: false
+  });
+
+  const onread = client._handle.onread;
+  const reads = [];
+  client._handle.onread = function(...args) {
+    reads.push(streamBaseState[kReadBytesOrError]);
+    return onread.apply(this, args);
+  };
+
+  let received = 0;
+  client.on('data', (chunk) => received += chunk.length);
+  client.on('end', common.mustCall(() => {
+    assert.strictEqual(received, 100001);
+    assert(!reads.includes(0), `Got empty reads: ${reads}`);
+    server.close();
+  }));
+}));
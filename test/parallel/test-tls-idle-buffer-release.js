@@ -0,0 +1,48 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// Checks that TLS connections give the memory for their encrypted data back
+// to the pool of the environment once they are idle, and that it is reported
+// in the tlsBufferPool section of the diagnostic report.
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+function getPoolStats() {
+  return process.report.getReport().tlsBufferPool;
+}
+
+const server = tls.createServer({
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem')
+}, common.mustCall((socket) => {
+  socket.pipe(socket);
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = tls.connect({
+    port: server.address().port,
+    rejectUnauthorized: false
+  }, common.mustCall(() => {
+    const payload = Buffer.alloc(256 * 1024, 'x');
+    let received = 0;
+    client.on('data', (chunk) => {
+      received += chunk.length;
+      if (received < payload.length)
+        return;
+      assert.strictEqual(received, payload.length);
+      // Wait for the echoed data to be fully acknowledged on both sides.
+      setTimeout(common.mustCall(() => {
+        const stats = getPoolStats();
+        assert.strictEqual(stats.inUseBytes, 0);
+        assert(stats.pooledBytes > 0);
+        client.end();
+        server.close();
+      }), common.platformTimeout(100));
+    });
+    client.write(payload);
+  }));
+}));
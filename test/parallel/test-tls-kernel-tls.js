@@ -0,0 +1,88 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// Checks that data is transferred unchanged in both directions when the
+// `kernelTLS` option is used, no matter whether the kernel actually took
+// over (Linux with the tls module and a TLSv1.2 AES-GCM cipher) or the
+// connection fell back to OpenSSL.
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+const payload = Buffer.alloc(1024 * 1024);
+for (let i = 0; i < payload.length; i++)
+  payload[i] = i % 251;
+
+function test(options, checkActive, next) {
+  const server = tls.createServer({
+    key: fixtures.readKey('agent1-key.pem'),
+    cert: fixtures.readKey('agent1-cert.pem'),
+    kernelTLS: true,
+    ...options
+  }, common.mustCall((socket) => {
+    // Echo everything back, which exercises writes on the server side.
+    socket.pipe(socket);
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false,
+      kernelTLS: true,
+      ...options
+    }, common.mustCall(() => {
+      // Written in several pieces, some of them before the switch could
+      // have happened.
+      client.write(payload.slice(0, 10));
+      setImmediate(() => {
+        checkActive(client._handle.isKernelTLSActive());
+        client.write(payload.slice(10, 65536));
+        client.end(payload.slice(65536));
+      });
+    }));
+
+    const chunks = [];
+    client.on('data', (chunk) => chunks.push(chunk));
+    client.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(chunks), payload);
+      server.close(next);
+    }));
+  }));
+}
+
+test({
+  maxVersion: 'TLSv1.2',
+  ciphers: 'ECDHE-RSA-AES128-GCM-SHA256'
+}, (active) => {
+  // Only Linux with the tls kernel module supports the offload.
+  if (!common.isLinux)
+    assert.strictEqual(active, false);
+}, common.mustCall(() => {
+  test({
+    maxVersion: 'TLSv1.2',
+    ciphers: 'ECDHE-RSA-AES256-GCM-SHA384'
+  }, (active) => {
+    if (!common.isLinux)
+      assert.strictEqual(active, false);
+  }, common.mustCall(() => {
+    // Ciphers and protocol versions that the offload does not support
+    // keep using OpenSSL.
+    test({
+      maxVersion: 'TLSv1.2',
+      ciphers: 'ECDHE-RSA-AES128-SHA256'
+    }, (active) => assert.strictEqual(active, false), common.mustCall(() => {
+      test({
+        minVersion: 'TLSv1.3'
+      }, (active) => assert.strictEqual(active, false), common.mustCall());
+    }));
+  }));
+}));
+
+for (const kernelTLS of [1, 'true', null]) {
+  assert.throws(() => tls.connect({ kernelTLS }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
@@ -0,0 +1,54 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// Writes batches of small and large buffers through a TLS socket, both
+// before and after the handshake has finished, and checks that the other
+// side receives them unchanged and in order.
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+const sizes = [1, 2000, 10, 16 * 1024, 3, 17, 100 * 1024, 0, 5, 1023, 1024];
+const buffers = sizes.map((size, i) => Buffer.alloc(size, i + 1));
+const batch = Buffer.concat(buffers);
+
+const server = tls.createServer({
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem')
+}, common.mustCall((socket) => {
+  const chunks = [];
+  socket.on('data', (chunk) => chunks.push(chunk));
+  socket.on('end', common.mustCall(() => {
+    const received = Buffer.concat(chunks);
+    assert.strictEqual(received.length, batch.length * 3);
+    for (let i = 0; i < 3; i++) {
+      assert.deepStrictEqual(
+        received.slice(i * batch.length, (i + 1) * batch.length), batch);
+    }
+    server.close();
+  }));
+}));
+
+function writeBatch(socket) {
+  socket.cork();
+  for (const buffer of buffers)
+    socket.write(buffer);
+  socket.uncork();
+}
+
+server.listen(0, common.mustCall(() => {
+  const client = tls.connect({
+    port: server.address().port,
+    rejectUnauthorized: false
+  }, common.mustCall(() => {
+    writeBatch(client);
+    writeBatch(client);
+    client.end();
+  }));
+  // Written before the handshake is done, so the data has to be kept around
+  // until it can be encrypted.
+  writeBatch(client);
+}));
@@ -0,0 +1,44 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const http2 = require('http2');
+const makeDuplexPair = require('../common/duplexpair');
+const { Worker, isMainThread, parentPort } = require('worker_threads');
+
+// Test that Workers can be terminated from the outside while a
+// .respondWithFile() operation has reads of the file pending.
+
+if (isMainThread) {
+  for (let i = 0; i < 10; i++) {
+    const worker = new Worker(__filename);
+    worker.once('message', common.mustCall(() => worker.terminate()));
+    worker.on('exit', common.mustCall());
+  }
+  return;
+}
+
+const server = http2.createServer();
+server.on('stream', common.mustCall((stream) => {
+  stream.respondWithFile(process.execPath);  // Use a large-ish file.
+}));
+
+const { clientSide, serverSide } = makeDuplexPair();
+server.emit('connection', serverSide);
+
+const client = http2.connect('http://localhost:80', {
+  createConnection: common.mustCall(() => clientSide)
+});
+
+const req = client.request();
+
+req.on('response', common.mustCall((headers) => {
+  assert.strictEqual(headers[':status'], 200);
+}));
+
+// Keep reading, so that the file keeps being read, until the Worker is gone.
+req.once('data', common.mustCall(() => parentPort.postMessage('data')));
+req.on('data', () => {});
+req.on('end', common.mustNotCall());
+req.end();
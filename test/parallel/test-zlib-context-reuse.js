@@ -0,0 +1,72 @@
+'use strict';
+// The state of closed zlib streams is reused by new streams with the same
+// parameters. Make sure that nothing carries over from one to the next.
+
+const common = require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+
+const input = Buffer.from('hello world, '.repeat(1000) + 'bye');
+const dictionary = Buffer.from('hello world, bye');
+
+const deflated = zlib.deflateSync(input);
+const gzipped = zlib.gzipSync(input);
+const withDictionary = zlib.deflateSync(input, { dictionary });
+assert.notDeepStrictEqual(withDictionary, deflated);
+
+for (let i = 0; i < 20; i++) {
+  // A dictionary only applies to the stream that it was passed to.
+  assert.deepStrictEqual(zlib.deflateSync(input, { dictionary }),
+                         withDictionary);
+  assert.deepStrictEqual(zlib.deflateSync(input), deflated);
+  assert.deepStrictEqual(zlib.gzipSync(input), gzipped);
+
+  assert.deepStrictEqual(zlib.inflateSync(withDictionary, { dictionary }),
+                         input);
+  assert.throws(() => zlib.inflateSync(withDictionary), {
+    code: 'Z_NEED_DICT'
+  });
+
+  // Unzip streams detect the format of their input anew.
+  assert.deepStrictEqual(zlib.unzipSync(gzipped), input);
+  assert.deepStrictEqual(zlib.unzipSync(deflated), input);
+
+  // Streams that failed do not affect the next one.
+  assert.throws(() => zlib.inflateSync(Buffer.from('not deflate data')), {
+    code: 'Z_DATA_ERROR'
+  });
+  assert.deepStrictEqual(zlib.inflateSync(deflated), input);
+
+  // Neither do streams that were closed halfway through.
+  const gunzip = zlib.createGunzip();
+  gunzip.write(gzipped.slice(0, gzipped.length >> 1));
+  gunzip.close();
+  assert.deepStrictEqual(zlib.gunzipSync(Buffer.concat([gzipped, gzipped])),
+                         Buffer.concat([input, input]));
+}
+
+// Changing the parameters of a stream does not affect later ones.
+{
+  const deflate = zlib.createDeflate();
+  deflate.params(zlib.constants.Z_BEST_SPEED, zlib.constants.Z_RLE,
+                 common.mustCall(() => {
+                   deflate.end(input);
+                   deflate.resume();
+                   deflate.on('close', common.mustCall(() => {
+                     assert.deepStrictEqual(zlib.deflateSync(input), deflated);
+                   }));
+                 }));
+}
+
+// Asynchronous streams.
+(function next(i) {
+  if (i === 20)
+    return;
+  zlib.deflate(input, common.mustSucceed((result) => {
+    assert.deepStrictEqual(result, deflated);
+    zlib.inflate(result, common.mustSucceed((result) => {
+      assert.deepStrictEqual(result, input);
+      next(i + 1);
+    }));
+  }));
+})(0);
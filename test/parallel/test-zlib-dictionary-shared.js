@@ -0,0 +1,126 @@
+'use strict';
+// Test dictionaries that are shared between streams, and training them.
+
+const common = require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+
+function makeSample(i) {
+  return JSON.stringify({
+    id: i * 7919 % 10007,
+    name: `user${i}`,
+    email: `user${i}@example.com`,
+    roles: ['reader', i % 3 === 0 ? 'writer' : 'guest'],
+    settings: { theme: i % 2 ? 'dark' : 'light', notifications: true },
+  });
+}
+
+const samples = [];
+for (let i = 0; i < 500; i++)
+  samples.push(makeSample(i));
+const input = Buffer.from(makeSample(1000));
+
+const trained = zlib.trainDictionarySync(samples);
+assert(Buffer.isBuffer(trained));
+assert(trained.length > 0 && trained.length <= 32 * 1024);
+assert(trained.includes('"notifications":true'));
+assert.deepStrictEqual(zlib.trainDictionarySync(samples), trained);
+assert(zlib.trainDictionarySync(samples, { size: 100 }).length <= 100);
+assert.strictEqual(zlib.trainDictionarySync([]).length, 0);
+assert.strictEqual(zlib.trainDictionarySync(samples, { size: 0 }).length, 0);
+zlib.trainDictionarySync(samples.map((sample) => Buffer.from(sample)));
+zlib.trainDictionarySync(samples.map((sample) => new Uint8Array(
+  Buffer.from(sample)).buffer));
+
+// The asynchronous version builds the same dictionary on the threadpool.
+zlib.trainDictionary(samples, common.mustSucceed((dictionary) => {
+  assert.deepStrictEqual(dictionary, trained);
+}));
+zlib.trainDictionary(samples, { size: 100 }, common.mustSucceed((result) => {
+  assert(result.length <= 100);
+}));
+
+const dictionary = new zlib.Dictionary(trained);
+assert.strictEqual(dictionary.size, trained.length);
+assert.strictEqual(new zlib.Dictionary(new ArrayBuffer(5)).size, 5);
+
+// A trained dictionary pays off for small inputs.
+const compressed = zlib.deflateSync(input, { dictionary });
+assert(compressed.length < zlib.deflateSync(input).length * 0.7,
+       `${compressed.length} vs. ${zlib.deflateSync(input).length}`);
+
+// Shared dictionaries behave exactly like the same data passed as a Buffer.
+for (const [compress, decompress] of [['deflate', 'inflate'],
+                                      ['deflateRaw', 'inflateRaw']]) {
+  const result = zlib[`${compress}Sync`](input, { dictionary });
+  assert.deepStrictEqual(
+    result, zlib[`${compress}Sync`](input, { dictionary: trained }));
+  assert.deepStrictEqual(
+    zlib[`${decompress}Sync`](result, { dictionary }), input);
+  assert.deepStrictEqual(
+    zlib[`${decompress}Sync`](result, { dictionary: trained }), input);
+
+  zlib[compress](input, { dictionary }, common.mustSucceed((result) => {
+    zlib[decompress](result, { dictionary }, common.mustSucceed((result) => {
+      assert.deepStrictEqual(result, input);
+    }));
+  }));
+}
+
+assert.throws(() => zlib.inflateSync(compressed), { code: 'Z_NEED_DICT' });
+assert.throws(() => zlib.inflateSync(compressed, {
+  dictionary: new zlib.Dictionary(Buffer.from('something else'))
+}), { code: 'Z_NEED_DICT', message: /Bad dictionary/ });
+
+// Many streams at once.
+for (let i = 0; i < 10; i++) {
+  const deflate = zlib.createDeflate({ dictionary });
+  const inflate = zlib.createInflate({ dictionary });
+  const sample = Buffer.from(makeSample(2000 + i));
+  const chunks = [];
+  deflate.pipe(inflate);
+  inflate.on('data', (chunk) => chunks.push(chunk));
+  inflate.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(chunks), sample);
+  }));
+  deflate.end(sample);
+}
+
+// Parallel compression uses the dictionary for the first block.
+zlib.deflate(Buffer.from(samples.join('')),
+             { dictionary, parallel: 2, blockSize: 4096 },
+             common.mustSucceed((result) => {
+               assert.strictEqual(
+                 zlib.inflateSync(result, { dictionary }).toString(),
+                 samples.join(''));
+             }));
+
+for (const data of [undefined, 'string', 1, {}, [1, 2]]) {
+  assert.throws(() => new zlib.Dictionary(data), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+assert.throws(() => zlib.deflateSync(input, {
+  dictionary: Object.create(zlib.Dictionary.prototype)
+}), { code: 'ERR_INVALID_ARG_TYPE' });
+
+assert.throws(() => zlib.trainDictionarySync('samples'), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => zlib.trainDictionarySync([1]), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  message: /samples\[0\]/
+});
+assert.throws(() => zlib.trainDictionarySync(samples, { size: -1 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+assert.throws(() => zlib.trainDictionarySync(samples, 'size'), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => zlib.trainDictionary(samples), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => zlib.trainDictionary(samples, {}), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
@@ -0,0 +1,220 @@
+'use strict';
+// Test compressing blocks of the input in parallel.
+
+const common = require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+
+// Text that compresses well, with back-references across block boundaries.
+const words = ['alpha', 'beta', 'gamma', 'delta', 'epsilon', 'zeta', 'eta'];
+const parts = [];
+let seed = 1;
+for (let i = 0; i < 40000; i++) {
+  seed = (seed * 1103515245 + 12345) % 2 ** 31;
+  parts.push(words[seed % words.length], seed % 1000);
+}
+const input = Buffer.from(parts.join(' '));
+
+const decompress = {
+  deflate: zlib.inflateSync,
+  deflateRaw: zlib.inflateRawSync,
+  gzip: zlib.gunzipSync,
+};
+
+for (const method of ['deflate', 'deflateRaw', 'gzip']) {
+  for (const [parallel, blockSize] of [[1, 64], [2, 1000], [4, 16 * 1024],
+                                       [3, 128 * 1024], [8, undefined]]) {
+    zlib[method](input, { parallel, blockSize }, common.mustSucceed((out) => {
+      assert.deepStrictEqual(decompress[method](out), input);
+    }));
+  }
+
+  // A single block is compressed like with an ordinary stream.
+  zlib[method](input, { parallel: 2, blockSize: input.length },
+               common.mustSucceed((out) => {
+                 assert.deepStrictEqual(out, zlib[`${method}Sync`](input));
+               }));
+
+  // Empty input.
+  zlib[method](Buffer.alloc(0), { parallel: 2 }, common.mustSucceed((out) => {
+    assert.deepStrictEqual(out, zlib[`${method}Sync`](Buffer.alloc(0)));
+  }));
+
+  // The smallest window size is supported.
+  if (method !== 'gzip') {
+    zlib[method](input, { parallel: 2, blockSize: 4096, windowBits: 8 },
+                 common.mustSucceed((out) => {
+                   assert.deepStrictEqual(decompress[method](out), input);
+                 }));
+  }
+}
+
+// The compression ratio stays close to that of a single stream.
+zlib.deflate(input, { parallel: 4, blockSize: 16 * 1024 },
+             common.mustSucceed((out) => {
+               const single = zlib.deflateSync(input);
+               assert(out.length < single.length * 1.1 + 64,
+                      `${out.length} vs. ${single.length}`);
+             }));
+
+// Dictionaries apply to the first block; later blocks are primed with the
+// preceding input.
+{
+  const dictionary = Buffer.from(words.join(' '));
+  for (const method of ['deflate', 'deflateRaw']) {
+    zlib[method](input, { parallel: 3, blockSize: 5000, dictionary },
+                 common.mustSucceed((out) => {
+                   const inflate = method === 'deflate' ?
+                     zlib.inflateSync : zlib.inflateRawSync;
+                   assert.deepStrictEqual(inflate(out, { dictionary }), input);
+                 }));
+  }
+}
+
+// Streams, including writes of various sizes and flushes in between.
+{
+  const gzip = zlib.createGzip({ parallel: 4, blockSize: 4096 });
+  assert.strictEqual(gzip._handle, undefined);
+  const chunks = [];
+  gzip.on('data', (chunk) => chunks.push(chunk));
+  gzip.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(zlib.gunzipSync(Buffer.concat(chunks)), input);
+    assert.strictEqual(gzip.bytesWritten, input.length);
+  }));
+
+  let offset = 0;
+  let size = 1;
+  (function write() {
+    if (offset >= input.length)
+      return gzip.end();
+    const chunk = input.slice(offset, offset + size);
+    offset += chunk.length;
+    size = size * 3 + 1;
+    if (size > 50000)
+      size = 7;
+    if (offset % 3 === 0) {
+      gzip.write(chunk);
+      gzip.flush(write);
+    } else {
+      gzip.write(chunk, write);
+    }
+  })();
+}
+
+// Everything written before a flush can be decompressed right away.
+{
+  const deflate = zlib.createDeflate({ parallel: 2, blockSize: 1024 });
+  const inflate = zlib.createInflate();
+  const text = input.slice(0, 10000);
+  deflate.pipe(inflate);
+  let received = '';
+  const onAllReceived = common.mustCall(() => deflate.end());
+  inflate.setEncoding('latin1');
+  inflate.on('data', (chunk) => {
+    received += chunk;
+    assert(received.length <= text.length);
+    if (received.length === text.length) {
+      assert.strictEqual(received, text.toString('latin1'));
+      onAllReceived();
+    }
+  });
+  deflate.write(text);
+  deflate.flush(common.mustCall());
+}
+
+// A Z_FINISH flush ends the compressed stream.
+{
+  const deflate = zlib.createDeflate({ parallel: 2, blockSize: 1024 });
+  const chunks = [];
+  deflate.on('data', (chunk) => chunks.push(chunk));
+  deflate.write(input.slice(0, 5000));
+  deflate.flush(zlib.constants.Z_FINISH, common.mustCall(() => {
+    assert.deepStrictEqual(zlib.inflateSync(Buffer.concat(chunks)),
+                           input.slice(0, 5000));
+    deflate.flush(common.mustCall(() => deflate.end()));
+  }));
+  deflate.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(zlib.inflateSync(Buffer.concat(chunks)),
+                           input.slice(0, 5000));
+  }));
+}
+
+{
+  const deflate = zlib.createDeflate({ parallel: 2 });
+  deflate.resume();
+  deflate.flush(zlib.constants.Z_FINISH);
+  deflate.write('more', common.expectsError({
+    code: 'ERR_STREAM_WRITE_AFTER_END'
+  }));
+  deflate.on('error', common.expectsError({
+    code: 'ERR_STREAM_WRITE_AFTER_END'
+  }));
+}
+
+// The streams are instances of the classes they replace and support params().
+{
+  const classes = {
+    createDeflate: zlib.Deflate,
+    createGzip: zlib.Gzip,
+    createDeflateRaw: zlib.DeflateRaw,
+  };
+  for (const [factory, ctor] of Object.entries(classes)) {
+    const stream = zlib[factory]({ parallel: 2 });
+    assert(stream instanceof ctor);
+    assert.strictEqual(stream.constructor, ctor);
+    assert.throws(() => stream.reset(), {
+      code: 'ERR_METHOD_NOT_IMPLEMENTED'
+    });
+    stream.destroy();
+    assert.strictEqual(stream._closed, true);
+  }
+
+  const deflate = zlib.createDeflate({ parallel: 2, blockSize: 1024 });
+  const chunks = [];
+  deflate.on('data', (chunk) => chunks.push(chunk));
+  deflate.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(zlib.inflateSync(Buffer.concat(chunks)), input);
+  }));
+  deflate.write(input.slice(0, 10000));
+  deflate.params(zlib.constants.Z_BEST_SPEED, zlib.constants.Z_FILTERED,
+                 common.mustCall(() => {
+                   assert.strictEqual(deflate._level,
+                                      zlib.constants.Z_BEST_SPEED);
+                   deflate.end(input.slice(10000));
+                 }));
+}
+
+// Streams can be closed while blocks are being compressed.
+{
+  const deflate = zlib.createDeflateRaw({ parallel: 2, blockSize: 1024 });
+  deflate.on('data', common.mustNotCall());
+  deflate.write(input);
+  deflate.close(common.mustCall());
+}
+
+// The option is rejected where it is not supported.
+{
+  const options = { parallel: 2 };
+  for (const fn of [() => new zlib.Gzip(options),
+                    () => zlib.Deflate(options),
+                    () => zlib.createGunzip(options),
+                    () => zlib.gunzip(input, options, common.mustNotCall()),
+                    () => zlib.gzipSync(input, options)]) {
+    assert.throws(fn, { code: 'ERR_INVALID_ARG_VALUE' });
+  }
+}
+
+zlib.gzip(input, { parallel: 2, maxOutputLength: 64 }, common.expectsError({
+  code: 'ERR_BUFFER_TOO_LARGE'
+}));
+
+for (const parallel of [0, -1, 1.5, '2', null]) {
+  assert.throws(() => zlib.createGzip({ parallel }), {
+    code: typeof parallel === 'number' ?
+      'ERR_OUT_OF_RANGE' : 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+assert.throws(() => zlib.createGzip({ parallel: 2, blockSize: 16 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
@@ -8,7 +8,8 @@ const input = '0123456789'.repeat(4);
 for (const [ compress, decompressor ] of [
   [ zlib.deflateRawSync, zlib.createInflateRaw ],
   [ zlib.deflateSync, zlib.createInflate ],
-  [ zlib.brotliCompressSync, zlib.createBrotliDecompress ]
+  [ zlib.brotliCompressSync, zlib.createBrotliDecompress ],
+  [ zlib.zstdCompressSync, zlib.createZstdDecompress ]
 ]) {
   const compressed = compress(input);
   const trailingData = Buffer.from('not valid compressed data');
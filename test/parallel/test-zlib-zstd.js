@@ -0,0 +1,181 @@
+'use strict';
+const common = require('../common');
+const fixtures = require('../common/fixtures');
+const assert = require('assert');
+const zlib = require('zlib');
+
+// Test some zstd-specific properties of the zstd streams that can not
+// be easily covered through expanding zlib-only tests.
+
+const sampleBuffer = fixtures.readSync('/pss-vectors.json');
+const {
+  ZSTD_c_checksumFlag,
+  ZSTD_c_compressionLevel,
+  ZSTD_c_enableLongDistanceMatching,
+  ZSTD_c_nbWorkers,
+  ZSTD_c_strategy,
+  ZSTD_d_windowLogMax,
+  ZSTD_e_flush,
+} = zlib.constants;
+
+assert.match(process.versions.zstd, /^\d+\.\d+\.\d+$/);
+
+{
+  // Test setting the compression level at stream creation:
+  const sizes = [];
+  for (const level of [1, 3, 9, 19]) {
+    const encoded = zlib.zstdCompressSync(sampleBuffer, {
+      params: {
+        [ZSTD_c_compressionLevel]: level
+      }
+    });
+    assert.deepStrictEqual(zlib.zstdDecompressSync(encoded), sampleBuffer);
+    sizes.push(encoded.length);
+  }
+
+  // Increasing the level should roughly correspond to decreasing compressed
+  // size:
+  for (let i = 0; i < sizes.length - 1; i++) {
+    assert(sizes[i + 1] <= sizes[i] * 1.05, sizes);  // 5 % margin of error.
+  }
+  assert(sizes[0] > sizes[sizes.length - 1], sizes);
+
+  // Negative levels trade compression ratio for speed.
+  const fast = zlib.zstdCompressSync(sampleBuffer, {
+    params: { [ZSTD_c_compressionLevel]: zlib.constants.ZSTD_MIN_LEVEL }
+  });
+  assert(fast.length > sizes[0], `${fast.length} > ${sizes[0]}`);
+  assert.deepStrictEqual(zlib.zstdDecompressSync(fast), sampleBuffer);
+}
+
+{
+  // Long-distance matching and worker threads produce regular zstd frames.
+  const input = Buffer.concat(new Array(16).fill(sampleBuffer));
+  for (const params of [
+    { [ZSTD_c_enableLongDistanceMatching]: true },
+    { [ZSTD_c_nbWorkers]: 2 },
+    { [ZSTD_c_nbWorkers]: 2, [ZSTD_c_enableLongDistanceMatching]: 1 },
+  ]) {
+    zlib.zstdCompress(input, { params }, common.mustSucceed((encoded) => {
+      zlib.zstdDecompress(encoded, common.mustSucceed((decoded) => {
+        assert.deepStrictEqual(decoded, input);
+      }));
+    }));
+  }
+}
+
+{
+  // Concatenated frames decompress like a single one, and trailing data that
+  // is not a frame is ignored.
+  const first = zlib.zstdCompressSync('Hello, ');
+  const second = zlib.zstdCompressSync('world!');
+  assert.strictEqual(
+    zlib.zstdDecompressSync(Buffer.concat([first, second])).toString(),
+    'Hello, world!');
+  assert.strictEqual(
+    zlib.zstdDecompressSync(
+      Buffer.concat([first, Buffer.from('trailing data')])).toString(),
+    'Hello, ');
+}
+
+{
+  // Flushing emits everything that was written so far.
+  const compress = zlib.createZstdCompress();
+  const decompress = zlib.createZstdDecompress();
+  compress.pipe(decompress);
+  decompress.once('data', common.mustCall((chunk) => {
+    assert.strictEqual(chunk.toString(), 'flushed');
+    compress.end();
+  }));
+  compress.write('flushed');
+  compress.flush(ZSTD_e_flush);
+}
+
+{
+  // Corrupt and truncated data. With a checksum, all corruption is detected.
+  const encoded = zlib.zstdCompressSync(sampleBuffer, {
+    params: { [ZSTD_c_checksumFlag]: true }
+  });
+  const corrupt = Buffer.from(encoded);
+  corrupt[corrupt.length >> 1] ^= 0xff;
+  assert.throws(() => zlib.zstdDecompressSync(corrupt), {
+    code: 'ERR_ZSTD_DECOMPRESSION_FAILED',
+  });
+  assert.throws(() => zlib.zstdDecompressSync(Buffer.from('not zstd data')), {
+    code: 'ERR_ZSTD_DECOMPRESSION_FAILED',
+  });
+  assert.throws(() => zlib.zstdDecompressSync(encoded.slice(0, -10)), {
+    code: 'Z_BUF_ERROR',
+    message: 'unexpected end of file'
+  });
+
+  // The window size can be limited on the decompression side.
+  const large = zlib.zstdCompressSync(Buffer.alloc(1 << 20));
+  assert.throws(() => zlib.zstdDecompressSync(large, {
+    params: { [ZSTD_d_windowLogMax]: 10 }
+  }), { code: 'ERR_ZSTD_DECOMPRESSION_FAILED' });
+}
+
+{
+  // Test that setting out-of-bounds option values or keys fails.
+  assert.throws(() => {
+    zlib.createZstdCompress({
+      params: {
+        10000: 0
+      }
+    });
+  }, {
+    code: 'ERR_ZSTD_INVALID_PARAM',
+    name: 'RangeError',
+    message: '10000 is not a valid zstd parameter'
+  });
+
+  // Compression parameters are not valid for decompression.
+  assert.throws(() => {
+    zlib.createZstdDecompress({
+      params: {
+        [ZSTD_c_nbWorkers]: 2
+      }
+    });
+  }, {
+    code: 'ERR_ZSTD_INVALID_PARAM',
+    name: 'RangeError',
+  });
+
+  // Test that accidentally using duplicate keys fails.
+  assert.throws(() => {
+    zlib.createZstdCompress({
+      params: {
+        [ZSTD_c_compressionLevel]: 3,
+        [`0${ZSTD_c_compressionLevel}`]: 3
+      }
+    });
+  }, {
+    code: 'ERR_ZSTD_INVALID_PARAM',
+    name: 'RangeError',
+    message: `0${ZSTD_c_compressionLevel} is not a valid zstd parameter`
+  });
+
+  assert.throws(() => {
+    zlib.createZstdCompress({
+      params: {
+        [ZSTD_c_compressionLevel]: '3'
+      }
+    });
+  }, {
+    code: 'ERR_INVALID_ARG_TYPE',
+    name: 'TypeError',
+  });
+
+  assert.throws(() => {
+    zlib.createZstdCompress({
+      params: {
+        [ZSTD_c_strategy]: 42
+      }
+    });
+  }, {
+    code: 'ERR_ZLIB_INITIALIZATION_FAILED',
+    name: 'Error',
+    message: 'Initialization failed'
+  });
+}
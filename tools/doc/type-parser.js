@@ -58,6 +58,7 @@ const customTypesMap = {
   'AsyncResource': 'async_hooks.html#async_hooks_class_asyncresource',
 
   'brotli options': 'zlib.html#zlib_class_brotlioptions',
+  'zstd options': 'zlib.html#zlib_class_zstdoptions',
 
   'Buffer': 'buffer.html#buffer_class_buffer',
 